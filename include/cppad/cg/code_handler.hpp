@@ -141,6 +141,11 @@ protected:
     bool _used;
     // a flag indicating whether or not to reuse the IDs of destroyed variables
     bool _reuseIDs;
+    /**
+     * whether or not the evaluation order is changed to reduce the number
+     * of temporary variables alive at the same time
+     */
+    bool _minimizeLiveTemporaries;
     // scope color/index counter
     ScopeIDType _scopeColorCount;
     // the current scope color/index counter
@@ -172,6 +177,34 @@ protected:
      * Auxiliary index (might not be used)
      */
     IndexOperationNode<Base>* _auxIterationIndexOp;
+    /**
+     * memory for the OperationNodes created by this handler
+     * (custom node classes are allocated individually)
+     */
+    ObjectArena<Node> _nodeArena;
+    /**
+     * whether or not makeNode() should reuse an existing node with the same
+     * operation, information, and arguments (hash-consing)
+     */
+    bool _hashConsing;
+    /**
+     * whether or not common subexpressions are merged before generating
+     * source code
+     */
+    bool _eliminateCSE;
+    /**
+     * the optimization passes applied before generating source code
+     * (not owned by this handler)
+     */
+    GraphOptimizer<Base>* _optimizer;
+    /**
+     * hash-consing table (structural hash <-> node)
+     */
+    std::unordered_multimap<size_t, Node*> _nodeTable;
+    /**
+     * index patterns created by loadGraph() (owned by this handler)
+     */
+    std::vector<std::unique_ptr<IndexPattern> > _loadedIndexPatterns;
 public:
 
     CodeHandler(size_t varCount = 50);
@@ -197,6 +230,73 @@ public:
      */
     inline bool isReuseVariableIDs() const;
 
+    /**
+     * Defines whether or not the evaluation order of the variables should
+     * be changed so that fewer temporary variables are alive at the same
+     * time (only used when variable IDs are reused).
+     * The variables required by each operation are evaluated in a depth
+     * first order where the dependencies which require more temporary
+     * variables are evaluated first (Sethi-Ullman numbering).
+     * It results in smaller work arrays (see getTemporaryVariableCount())
+     * and in a better cache usage for large models.
+     * The evaluation order is not changed for operation graphs with loops
+     * or conditional statements.
+     */
+    inline void setMinimizeLiveTemporaries(bool minimize);
+
+    /**
+     * Whether or not the evaluation order of the variables is changed so
+     * that fewer temporary variables are alive at the same time.
+     */
+    inline bool isMinimizeLiveTemporaries() const;
+
+    /**
+     * Defines whether or not makeNode() should return a previously created
+     * node with the same operation type, information, and arguments instead
+     * of creating a new node (hash-consing).
+     * Only operations without side effects are shared and the arguments of
+     * Add and Mul are considered in any order.
+     * It should be enabled before the operations are recorded.
+     *
+     * @warning shared nodes must not be modified afterwards
+     *          (e.g. with OperationNode::makeAlias()).
+     */
+    inline void setHashConsing(bool hashConsing);
+
+    /**
+     * Whether or not makeNode() reuses structurally identical nodes.
+     */
+    inline bool isHashConsing() const;
+
+    /**
+     * Defines whether or not eliminateCommonSubexpressions() should be
+     * called on the dependent variables at the beginning of generateCode().
+     */
+    inline void setEliminateCommonSubexpressions(bool eliminate);
+
+    /**
+     * Whether or not common subexpressions are merged at the beginning of
+     * generateCode().
+     */
+    inline bool isEliminateCommonSubexpressions() const;
+
+    /**
+     * Defines the optimization passes applied to the operation graph of
+     * the dependent variables in generateCode() (after the elimination of
+     * common subexpressions).
+     * The optimizer is not owned by this handler and it must exist while
+     * source code is generated.
+     *
+     * @param optimizer the optimization pipeline (nullptr to disable)
+     */
+    inline void setGraphOptimizer(GraphOptimizer<Base>* optimizer);
+
+    /**
+     * Provides the optimization passes applied to the operation graph in
+     * generateCode() (nullptr if there are none).
+     */
+    inline GraphOptimizer<Base>* getGraphOptimizer() const;
+
     /**
      * Marks the provided variables as being independent variables.
      *
@@ -351,6 +451,66 @@ public:
                                           size_t& bifurcations,
                                           size_t maxBifurcations = (std::numeric_limits<size_t>::max)());
 
+    /**
+     * Merges structurally identical operation nodes (same operation type,
+     * information, and arguments) used by the provided dependent variables.
+     * The arguments of Add and Mul are compared in any order and aliases
+     * are replaced by the node they refer to.
+     * Dependents which become duplicates of other nodes are updated to use
+     * the remaining node.
+     *
+     * @param dependent The dependent variables
+     * @return the number of nodes which were replaced
+     */
+    inline size_t eliminateCommonSubexpressions(ArrayView<CGB>& dependent);
+
+    /**************************************************************************
+     *                       Graph serialization
+     *************************************************************************/
+
+    /**
+     * Saves the operation graph managed by this handler in a compact binary
+     * format so that it can later be restored with loadGraph() without
+     * taping the model again.
+     * All managed nodes are saved (including index, loop, and print nodes),
+     * as well as the independent variables, the index patterns used by the
+     * nodes, and the names of the atomic functions.
+     * Loop models are not saved.
+     *
+     * @param out The binary output stream
+     * @param dependent The dependent variables
+     * @throws CGException if a node is not managed by this handler
+     */
+    inline void saveGraph(std::ostream& out,
+                          ArrayView<const CGB> dependent) const;
+
+    /**
+     * Replaces the operation graph in this handler by one saved with
+     * saveGraph().
+     * The data is only read during this call and therefore it can be
+     * provided by a memory mapped file.
+     *
+     * @param data The serialized graph
+     * @param size The number of bytes in data
+     * @param independent Will hold the independent variables
+     * @param dependent Will hold the dependent variables
+     * @param atomics The atomic functions used by the graph (matched by
+     *                name). Their IDs do not need to be the same as when
+     *                the graph was saved.
+     * @throws CGException if the data is not valid or an atomic function
+     *                     is missing
+     */
+    inline void loadGraph(const char* data,
+                          size_t size,
+                          std::vector<CGB>& independent,
+                          std::vector<CGB>& dependent,
+                          const std::vector<CGAbstractAtomicFun<Base>*>& atomics = std::vector<CGAbstractAtomicFun<Base>*>());
+
+    inline void loadGraph(std::istream& in,
+                          std::vector<CGB>& independent,
+                          std::vector<CGB>& dependent,
+                          const std::vector<CGAbstractAtomicFun<Base>*>& atomics = std::vector<CGAbstractAtomicFun<Base>*>());
+
     /**************************************************************************
      *                       Source code generation
      *************************************************************************/
@@ -618,6 +778,49 @@ protected:
 
     virtual Node* manageOperationNode(Node* code);
 
+    /**
+     * Creates a new OperationNode using the memory arena of this handler.
+     * The node must still be provided to manageOperationNode().
+     */
+    template<class... Args>
+    inline Node* newNode(Args&&... args);
+
+    /**
+     * Destroys an OperationNode and releases its memory.
+     */
+    inline void deleteNode(Node* node);
+
+    /**
+     * Finds a node in the hash-consing table equivalent to a node which
+     * would be created with the provided data.
+     *
+     * @param hash the structural hash (see hashNode())
+     * @return the equivalent node or nullptr if none was found
+     */
+    inline Node* findEquivalentNode(size_t hash,
+                                    CGOpCode op,
+                                    const std::vector<size_t>& info,
+                                    const Arg* args,
+                                    size_t nArgs) const;
+
+    static inline bool isHashConsingCandidate(CGOpCode op);
+
+    static inline size_t hashArgument(const Arg& arg);
+
+    static inline size_t hashNode(CGOpCode op,
+                                  const std::vector<size_t>& info,
+                                  const Arg* args,
+                                  size_t nArgs);
+
+    static inline bool isIdenticalArgument(const Arg& a1,
+                                           const Arg& a2);
+
+    static inline bool isStructurallyEqual(const Node& node,
+                                           CGOpCode op,
+                                           const std::vector<size_t>& info,
+                                           const Arg* args,
+                                           size_t nArgs);
+
     inline void addVector(CodeHandlerVectorSync<Base>* v);
 
     inline void removeVector(CodeHandlerVectorSync<Base>* v);
@@ -697,6 +900,16 @@ protected:
 
     inline void reduceTemporaryVariables(ArrayView<CGB>& dependent);
 
+    /**
+     * Changes the evaluation order of all variables so that fewer
+     * temporary variables are alive at the same time.
+     * The variables required by each variable are evaluated first, ordered
+     * by decreasing number of temporary variables needed to determine
+     * them (Sethi-Ullman numbering).
+     * Print operations keep their relative order.
+     */
+    inline void scheduleOperations();
+
     /**
      * Change operation order so that the total number of temporary variables is
      * reduced.
@@ -893,6 +1106,7 @@ protected:
     friend class CGAbstractAtomicFun<Base>;
     friend class BaseAbstractAtomicFun<Base>;
     friend class LoopModel<Base>;
+    friend class GraphRewritePass<Base>;
 
 };
 
@@ -38,13 +38,18 @@ CodeHandler<Base>::CodeHandler(size_t varCount) :
         _atomicFunctionsOrder(nullptr),
         _used(false),
         _reuseIDs(true),
+        _minimizeLiveTemporaries(false),
         _scopeColorCount(0),
         _currentScopeColor(0),
         _lang(nullptr),
         _minTemporaryVarID(0),
         _zeroDependents(false),
         _verbose(false),
-        _jobTimer(nullptr) {
+        _jobTimer(nullptr),
+        _nodeArena(std::min<size_t>(std::max<size_t>(varCount, 16), 1u << 16u)),
+        _hashConsing(false),
+        _eliminateCSE(false),
+        _optimizer(nullptr) {
     _codeBlocks.reserve(varCount);
     //_variableOrder.reserve(1 + varCount / 3);
     _scopedVariableOrder[0].reserve(1 + varCount / 3);
@@ -72,6 +77,49 @@ inline bool CodeHandler<Base>::isReuseVariableIDs() const {
     return _reuseIDs;
 }
 
+template<class Base>
+inline void CodeHandler<Base>::setMinimizeLiveTemporaries(bool minimize) {
+    _minimizeLiveTemporaries = minimize;
+}
+
+template<class Base>
+inline bool CodeHandler<Base>::isMinimizeLiveTemporaries() const {
+    return _minimizeLiveTemporaries;
+}
+
+template<class Base>
+inline void CodeHandler<Base>::setHashConsing(bool hashConsing) {
+    _hashConsing = hashConsing;
+    if (!hashConsing) {
+        _nodeTable.clear();
+    }
+}
+
+template<class Base>
+inline bool CodeHandler<Base>::isHashConsing() const {
+    return _hashConsing;
+}
+
+template<class Base>
+inline void CodeHandler<Base>::setEliminateCommonSubexpressions(bool eliminate) {
+    _eliminateCSE = eliminate;
+}
+
+template<class Base>
+inline bool CodeHandler<Base>::isEliminateCommonSubexpressions() const {
+    return _eliminateCSE;
+}
+
+template<class Base>
+inline void CodeHandler<Base>::setGraphOptimizer(GraphOptimizer<Base>* optimizer) {
+    _optimizer = optimizer;
+}
+
+template<class Base>
+inline GraphOptimizer<Base>* CodeHandler<Base>::getGraphOptimizer() const {
+    return _optimizer;
+}
+
 template<class Base>
 inline void CodeHandler<Base>::makeVariables(std::vector<AD<CGB> >& variables) {
     for (auto& v : variables) {
@@ -314,6 +362,22 @@ void CodeHandler<Base>::generateCode(std::ostream& out,
     }
     _used = true;
 
+    if (_eliminateCSE) {
+        eliminateCommonSubexpressions(dependent);
+    }
+
+    if (_optimizer != nullptr) {
+        _optimizer->optimize(*this, dependent);
+
+        // the passes might have created new nodes
+        _evaluationOrder.adjustSize();
+        _lastUsageOrder.adjustSize();
+        _totalUseCount.adjustSize();
+        _operationCount.adjustSize();
+        _varId.adjustSize();
+        _scope.adjustSize();
+    }
+
     /**
      * the first variable IDs are for the independent variables
      */
@@ -492,9 +556,11 @@ size_t CodeHandler<Base>::getTemporarySparseArraySize() const {
 template<class Base>
 void CodeHandler<Base>::reset() {
     for (Node* n : _codeBlocks) {
-        delete n;
+        deleteNode(n);
     }
     _codeBlocks.clear();
+    _nodeArena.clear();
+    _nodeTable.clear();
     _independentVariables.clear();
     _idCount = 1;
     _idArrayCount = 1;
@@ -502,6 +568,7 @@ void CodeHandler<Base>::reset() {
     _idAtomicCount = 1;
 
     _loops.reset();
+    _loadedIndexPatterns.clear();
 
     _used = false;
 }
@@ -522,38 +589,80 @@ inline void CodeHandler<Base>::resetNodes() {
 
 template<class Base>
 inline OperationNode<Base>* CodeHandler<Base>::cloneNode(const Node& n) {
-    return manageOperationNode(new Node(n));
+    return manageOperationNode(newNode(n));
 }
 
 template<class Base>
 inline OperationNode<Base>* CodeHandler<Base>::makeNode(CGOpCode op) {
-    return manageOperationNode(new Node(this, op));
+    return manageOperationNode(newNode(this, op));
 }
 
 template<class Base>
 inline OperationNode<Base>* CodeHandler<Base>::makeNode(CGOpCode op,
                                                         const Arg& arg) {
-    return manageOperationNode(new Node(this, op, arg));
+    if (_hashConsing && isHashConsingCandidate(op)) {
+        const std::vector<size_t> info;
+        size_t h = hashNode(op, info, &arg, 1);
+        Node* n = findEquivalentNode(h, op, info, &arg, 1);
+        if (n == nullptr) {
+            n = manageOperationNode(newNode(this, op, arg));
+            _nodeTable.emplace(h, n);
+        }
+        return n;
+    }
+
+    return manageOperationNode(newNode(this, op, arg));
 }
 
 template<class Base>
 inline OperationNode<Base>* CodeHandler<Base>::makeNode(CGOpCode op,
                                                         std::vector<Arg>&& args) {
-    return manageOperationNode(new Node(this, op, std::move(args)));
+    if (_hashConsing && isHashConsingCandidate(op)) {
+        const std::vector<size_t> info;
+        size_t h = hashNode(op, info, args.data(), args.size());
+        Node* n = findEquivalentNode(h, op, info, args.data(), args.size());
+        if (n == nullptr) {
+            n = manageOperationNode(newNode(this, op, std::move(args)));
+            _nodeTable.emplace(h, n);
+        }
+        return n;
+    }
+
+    return manageOperationNode(newNode(this, op, std::move(args)));
 }
 
 template<class Base>
 inline OperationNode<Base>* CodeHandler<Base>::makeNode(CGOpCode op,
                                                         std::vector<size_t>&& info,
                                                         std::vector<Arg>&& args) {
-    return manageOperationNode(new Node(this, op, std::move(info), std::move(args)));
+    if (_hashConsing && isHashConsingCandidate(op)) {
+        size_t h = hashNode(op, info, args.data(), args.size());
+        Node* n = findEquivalentNode(h, op, info, args.data(), args.size());
+        if (n == nullptr) {
+            n = manageOperationNode(newNode(this, op, std::move(info), std::move(args)));
+            _nodeTable.emplace(h, n);
+        }
+        return n;
+    }
+
+    return manageOperationNode(newNode(this, op, std::move(info), std::move(args)));
 }
 
 template<class Base>
 inline OperationNode<Base>* CodeHandler<Base>::makeNode(CGOpCode op,
                                                         const std::vector<size_t>& info,
                                                         const std::vector<Arg>& args) {
-    return manageOperationNode(new Node(this, op, info, args));
+    if (_hashConsing && isHashConsingCandidate(op)) {
+        size_t h = hashNode(op, info, args.data(), args.size());
+        Node* n = findEquivalentNode(h, op, info, args.data(), args.size());
+        if (n == nullptr) {
+            n = manageOperationNode(newNode(this, op, info, args));
+            _nodeTable.emplace(h, n);
+        }
+        return n;
+    }
+
+    return manageOperationNode(newNode(this, op, info, args));
 }
 
 template<class Base>
@@ -632,11 +741,33 @@ inline IndexAssignOperationNode<Base>* CodeHandler<Base>::makeIndexAssignNode(No
 template<class Base>
 inline OperationNode<Base>* CodeHandler<Base>::makeIndexDclrNode(const std::string& name) {
     CPPADCG_ASSERT_KNOWN(!name.empty(), "index name cannot be empty")
-    auto* n = manageOperationNode(new Node(this, CGOpCode::IndexDeclaration));
+    auto* n = manageOperationNode(newNode(this, CGOpCode::IndexDeclaration));
     n->setName(name);
     return n;
 }
 
+template<class Base>
+template<class... Args>
+inline OperationNode<Base>* CodeHandler<Base>::newNode(Args&&... args) {
+    void* mem = _nodeArena.allocate();
+    try {
+        return new(mem) Node(std::forward<Args>(args)...);
+    } catch (...) {
+        _nodeArena.deallocate(mem);
+        throw;
+    }
+}
+
+template<class Base>
+inline void CodeHandler<Base>::deleteNode(Node* node) {
+    if (_nodeArena.owns(node)) {
+        node->~Node();
+        _nodeArena.deallocate(node);
+    } else {
+        delete node; // custom node classes and nodes created outside this handler
+    }
+}
+
 template<class Base>
 inline size_t CodeHandler<Base>::getManagedNodesCount() const {
     return _codeBlocks.size();
@@ -655,8 +786,19 @@ inline void CodeHandler<Base>::deleteManagedNodes(size_t start, size_t end) {
     start = std::min<size_t>(start, _codeBlocks.size());
     end = std::min<size_t>(end, _codeBlocks.size());
 
+    if (!_nodeTable.empty()) {
+        for (auto it = _nodeTable.begin(); it != _nodeTable.end();) {
+            size_t pos = it->second->getHandlerPosition();
+            if (pos >= start && pos < end) {
+                it = _nodeTable.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
     for (size_t i = start; i < end; ++i) {
-        delete _codeBlocks[i];
+        deleteNode(_codeBlocks[i]);
     }
     _codeBlocks.erase(_codeBlocks.begin() + start, _codeBlocks.begin() + end);
 
@@ -702,6 +844,103 @@ inline void CodeHandler<Base>::findRandomIndexPatterns(IndexPattern* ip,
 /**************************************************************************
  *                      Operation graph manipulation
  *************************************************************************/
+template<class Base>
+inline size_t CodeHandler<Base>::eliminateCommonSubexpressions(ArrayView<CGB>& dependent) {
+    std::unordered_multimap<size_t, Node*> table;
+    std::vector<Node*> replacement(_codeBlocks.size(), nullptr);
+    size_t merged = 0;
+
+    auto resolve = [&replacement](Node* n) {
+        size_t p = n->getHandlerPosition();
+        if (p < replacement.size() && replacement[p] != nullptr)
+            return replacement[p];
+        return n;
+    };
+
+    auto startAnalysis = [this](OperationStackData<Base>& stackEl,
+                                OperationStack<Base>& stack) {
+        Node& node = stackEl.node();
+        if (isVisited(node))
+            return false;
+
+        markVisited(node);
+        stack.pushNodeArguments(node, 0);
+        return true;
+    };
+
+    auto endAnalysis = [&](OperationStackData<Base>& stackEl) {
+        Node& node = stackEl.node();
+        size_t pos = node.getHandlerPosition();
+        if (pos >= replacement.size())
+            return; // not managed by this handler
+
+        // all arguments have already been processed
+        auto& args = node.getArguments();
+        for (Arg& a : args) {
+            Node* arg = a.getOperation();
+            if (arg != nullptr) {
+                Node* rep = resolve(arg);
+                if (rep != arg)
+                    a = Arg(*rep);
+            }
+        }
+
+        CGOpCode op = node.getOperationType();
+        if (op == CGOpCode::Alias) {
+            if (args.size() == 1 && args[0].getOperation() != nullptr)
+                replacement[pos] = args[0].getOperation();
+
+        } else if (isHashConsingCandidate(op) && node.getName() == nullptr) {
+            const auto& info = node.getInfo();
+            size_t h = hashNode(op, info, args.data(), args.size());
+
+            auto range = table.equal_range(h);
+            for (auto it = range.first; it != range.second; ++it) {
+                if (isStructurallyEqual(*it->second, op, info, args.data(), args.size())) {
+                    replacement[pos] = it->second;
+                    merged++;
+                    break;
+                }
+            }
+
+            if (replacement[pos] == nullptr)
+                table.emplace(h, &node);
+        }
+    };
+
+    startNewOperationTreeVisit();
+
+    for (size_t i = 0; i < dependent.size(); ++i) {
+        Node* node = dependent[i].getOperationNode();
+        if (node != nullptr && !isVisited(*node)) {
+            depthFirstGraphNavigation(*node,
+                                      0,
+                                      startAnalysis,
+                                      endAnalysis,
+                                      true);
+        }
+    }
+
+    /**
+     * dependents which are duplicates of other nodes
+     * (aliases are kept since they are handled by the languages)
+     */
+    for (size_t i = 0; i < dependent.size(); ++i) {
+        Node* node = dependent[i].getOperationNode();
+        if (node != nullptr && node->getOperationType() != CGOpCode::Alias) {
+            Node* rep = resolve(node);
+            if (rep != node) {
+                CGB dep(*rep);
+                if (dependent[i].isValueDefined())
+                    dep.setValue(dependent[i].getValue());
+                dependent[i] = dep;
+            }
+        }
+    }
+
+    return merged;
+}
+
 template<class Base>
 inline bool CodeHandler<Base>::manageOperationNodeMemory(Node* code) {
     size_t pos = code->getHandlerPosition();
@@ -724,6 +963,141 @@ OperationNode<Base>* CodeHandler<Base>::manageOperationNode(Node* code) {
     return code;
 }
 
+template<class Base>
+inline OperationNode<Base>* CodeHandler<Base>::findEquivalentNode(size_t hash,
+                                                                  CGOpCode op,
+                                                                  const std::vector<size_t>& info,
+                                                                  const Arg* args,
+                                                                  size_t nArgs) const {
+    auto range = _nodeTable.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+        // nodes might have been modified after they were added to the table
+        if (isStructurallyEqual(*it->second, op, info, args, nArgs)) {
+            return it->second;
+        }
+    }
+    return nullptr;
+}
+
+template<class Base>
+inline bool CodeHandler<Base>::isHashConsingCandidate(CGOpCode op) {
+    // only operations without side effects which always produce the same
+    // result for the same arguments
+    switch (op) {
+        case CGOpCode::Abs:
+        case CGOpCode::Acos:
+        case CGOpCode::Acosh:
+        case CGOpCode::Add:
+        case CGOpCode::Asin:
+        case CGOpCode::Asinh:
+        case CGOpCode::Atan:
+        case CGOpCode::Atanh:
+        case CGOpCode::ComLt:
+        case CGOpCode::ComLe:
+        case CGOpCode::ComEq:
+        case CGOpCode::ComGe:
+        case CGOpCode::ComGt:
+        case CGOpCode::ComNe:
+        case CGOpCode::Cosh:
+        case CGOpCode::Cos:
+        case CGOpCode::Div:
+        case CGOpCode::Erf:
+        case CGOpCode::Erfc:
+        case CGOpCode::Exp:
+        case CGOpCode::Expm1:
+        case CGOpCode::Log:
+        case CGOpCode::Log1p:
+        case CGOpCode::Mul:
+        case CGOpCode::Pow:
+        case CGOpCode::Sign:
+        case CGOpCode::Sinh:
+        case CGOpCode::Sin:
+        case CGOpCode::Sqrt:
+        case CGOpCode::Sub:
+        case CGOpCode::Tanh:
+        case CGOpCode::Tan:
+        case CGOpCode::UnMinus:
+            return true;
+        default:
+            return false;
+    }
+}
+
+template<class Base>
+inline size_t CodeHandler<Base>::hashArgument(const Arg& arg) {
+    if (arg.getOperation() != nullptr) {
+        return std::hash<const void*>()(arg.getOperation());
+    } else {
+        return 0x9e3779b9; // all parameters share the same hash
+    }
+}
+
+template<class Base>
+inline size_t CodeHandler<Base>::hashNode(CGOpCode op,
+                                          const std::vector<size_t>& info,
+                                          const Arg* args,
+                                          size_t nArgs) {
+    size_t h = std::hash<int>()(int(op));
+
+    auto combine = [&h](size_t v) {
+        h ^= v + 0x9e3779b9 + (h << 6) + (h >> 2);
+    };
+
+    for (size_t i : info)
+        combine(i);
+
+    if ((op == CGOpCode::Add || op == CGOpCode::Mul) && nArgs == 2) {
+        // commutative operations: the hash must not depend on the argument order
+        size_t h0 = hashArgument(args[0]);
+        size_t h1 = hashArgument(args[1]);
+        combine(std::min(h0, h1));
+        combine(std::max(h0, h1));
+    } else {
+        for (size_t a = 0; a < nArgs; ++a)
+            combine(hashArgument(args[a]));
+    }
+
+    return h;
+}
+
+template<class Base>
+inline bool CodeHandler<Base>::isIdenticalArgument(const Arg& a1,
+                                                   const Arg& a2) {
+    if (a1.getOperation() != nullptr || a2.getOperation() != nullptr) {
+        return a1.getOperation() == a2.getOperation();
+    }
+    return a1.getParameter() != nullptr && a2.getParameter() != nullptr &&
+           CppAD::IdenticalEqualPar(*a1.getParameter(), *a2.getParameter());
+}
+
+template<class Base>
+inline bool CodeHandler<Base>::isStructurallyEqual(const Node& node,
+                                                   CGOpCode op,
+                                                   const std::vector<size_t>& info,
+                                                   const Arg* args,
+                                                   size_t nArgs) {
+    if (node.getOperationType() != op || node.getInfo() != info)
+        return false;
+
+    const auto& nArgs2 = node.getArguments();
+    if (nArgs2.size() != nArgs)
+        return false;
+
+    bool equal = true;
+    for (size_t a = 0; a < nArgs; ++a) {
+        if (!isIdenticalArgument(nArgs2[a], args[a])) {
+            equal = false;
+            break;
+        }
+    }
+
+    if (!equal && (op == CGOpCode::Add || op == CGOpCode::Mul) && nArgs == 2) {
+        equal = isIdenticalArgument(nArgs2[0], args[1]) && isIdenticalArgument(nArgs2[1], args[0]);
+    }
+
+    return equal;
+}
+
 template<class Base>
 inline void CodeHandler<Base>::addVector(CodeHandlerVectorSync<Base>* v) {
     _managedVectors.insert(v);
@@ -1635,6 +2009,10 @@ inline void CodeHandler<Base>::addToEvaluationQueue(Node& arg) {
 template<class Base>
 inline void CodeHandler<Base>::reduceTemporaryVariables(ArrayView<CGB>& dependent) {
 
+    if (_minimizeLiveTemporaries && _scopedVariableOrder.size() == 1 && _loops.endNodes.empty()) {
+        scheduleOperations();
+    }
+
     reorderOperations(dependent);
 
     /**
@@ -1712,6 +2090,118 @@ inline void CodeHandler<Base>::reduceTemporaryVariables(ArrayView<CGB>& dependen
     _idSparseArrayCount = sparseArrayComp.getIdCount();
 }
 
+template<class Base>
+inline void CodeHandler<Base>::scheduleOperations() {
+    const size_t n = _variableOrder.size();
+    if (n < 3)
+        return;
+
+    /**
+     * variables required by each variable (positions in _variableOrder)
+     */
+    findVariableDependencies();
+
+    std::vector<std::vector<size_t> > deps(n);
+    std::vector<size_t> consumers(n, 0);
+    size_t lastPrint = n;
+
+    for (size_t i = 0; i < n; i++) {
+        for (Node* d : _variableDependencies[i]) {
+            if (isIndependent(*d))
+                continue;
+
+            size_t order = getEvaluationOrder(*d);
+            if (order == 0 || order > i || _variableOrder[order - 1] != d) {
+                _variableDependencies.clear();
+                return; // unexpected evaluation order (keep the original order)
+            }
+            deps[i].push_back(order - 1);
+        }
+
+        if (_variableOrder[i]->getOperationType() == CGOpCode::Pri) {
+            // printed in the original order
+            if (lastPrint != n)
+                deps[i].push_back(lastPrint);
+            lastPrint = i;
+        }
+
+        for (size_t d : deps[i])
+            consumers[d]++;
+    }
+    _variableDependencies.clear();
+
+    /**
+     * number of temporary variables needed to evaluate each variable
+     * (Sethi-Ullman numbering)
+     */
+    std::vector<size_t> need(n, 1);
+    for (size_t i = 0; i < n; i++) {
+        auto& d = deps[i];
+        std::sort(d.begin(), d.end(), [&need](size_t a, size_t b) {
+            return need[a] > need[b] || (need[a] == need[b] && a < b);
+        });
+        d.erase(std::unique(d.begin(), d.end()), d.end());
+
+        for (size_t k = 0; k < d.size(); k++) {
+            need[i] = std::max<size_t>(need[i], need[d[k]] + k);
+        }
+    }
+
+    /**
+     * depth first evaluation starting from the variables which are not
+     * used by other variables
+     */
+    std::vector<size_t> newOrder;
+    newOrder.reserve(n);
+    std::vector<bool> added(n, false);
+    std::vector<std::pair<size_t, size_t> > stack; // variable position, next dependency
+
+    auto schedule = [&](size_t root) {
+        stack.emplace_back(root, 0);
+        added[root] = true;
+
+        while (!stack.empty()) {
+            size_t v = stack.back().first;
+            size_t& next = stack.back().second;
+            if (next < deps[v].size()) {
+                size_t d = deps[v][next];
+                next++;
+                if (!added[d]) {
+                    added[d] = true;
+                    stack.emplace_back(d, 0);
+                }
+            } else {
+                newOrder.push_back(v);
+                stack.pop_back();
+            }
+        }
+    };
+
+    for (size_t i = 0; i < n; i++) {
+        if (consumers[i] == 0 && !added[i])
+            schedule(i);
+    }
+
+    CPPADCG_ASSERT_UNKNOWN(newOrder.size() == n)
+
+    std::vector<Node*> oldOrder(_variableOrder);
+    for (size_t p = 0; p < n; p++) {
+        _variableOrder[p] = oldOrder[newOrder[p]];
+    }
+
+    /**
+     * update the evaluation order (also used by the operations which are
+     * part of the expression of each variable)
+     */
+    _evaluationOrder.fill(0);
+
+    for (size_t p = 0; p < n; p++) {
+        Node& var = *_variableOrder[p];
+        setEvaluationOrder(var, p + 1);
+        dependentAdded2EvaluationQueue(var);
+    }
+}
+
 template<class Base>
 inline void CodeHandler<Base>::reorderOperations(ArrayView<CGB>& dependent) {
     // determine the location of the last temporary variable used for each dependent
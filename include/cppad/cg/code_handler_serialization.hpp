@@ -0,0 +1,671 @@
+#ifndef CPPAD_CG_CODE_HANDLER_SERIALIZATION_INCLUDED
+#define CPPAD_CG_CODE_HANDLER_SERIALIZATION_INCLUDED
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2020 Joao Leal
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+
+namespace CppAD {
+namespace cg {
+
+/**
+ * Writes the binary representation of an operation graph.
+ *
+ * Layout (all values in the native byte order):
+ *  - header: magic "CPPADCG" + '\0', format version, sizeof(Base), byte order mark
+ *  - atomic functions: count, (id, name) ...
+ *  - index patterns: count, pattern ...
+ *  - loop dependent/independent index patterns: count, pattern index ...
+ *  - nodes: count, (operation, flags, [name], info, arguments, [extra]) ...
+ *  - independents: count, node index ...
+ *  - dependents: count, argument ...
+ */
+class GraphOutputStream {
+public:
+    enum : uint32_t {
+        VERSION = 1,
+        BYTE_ORDER_MARK = 0x01020304,
+        MAGIC_SIZE = 8
+    };
+
+    enum ArgumentType : uint8_t {
+        ARG_NODE = 0, ARG_PARAMETER = 1, ARG_EMPTY = 2
+    };
+private:
+    std::ostream& out_;
+public:
+
+    static inline const char* magic() {
+        return "CPPADCG"; // includes the terminating '\0'
+    }
+
+    inline explicit GraphOutputStream(std::ostream& out) :
+        out_(out) {
+    }
+
+    template<class T>
+    inline void write(const T& v) {
+        static_assert(std::is_trivially_copyable<T>::value, "only trivially copyable types can be written");
+        out_.write(reinterpret_cast<const char*> (&v), sizeof(T));
+    }
+
+    inline void writeSize(size_t v) {
+        write<uint64_t>(v);
+    }
+
+    inline void writeString(const std::string& s) {
+        writeSize(s.size());
+        out_.write(s.data(), s.size());
+    }
+
+    inline void writeIndexPattern(const IndexPattern& ip) {
+        IndexPatternType type = ip.getType();
+        write<uint8_t>(uint8_t(type));
+
+        switch (type) {
+            case IndexPatternType::Linear: {
+                const auto& lip = static_cast<const LinearIndexPattern&> (ip);
+                write<int64_t>(lip.getXOffset());
+                write<int64_t>(lip.getLinearSlopeDy());
+                write<int64_t>(lip.getLinearSlopeDx());
+                write<int64_t>(lip.getLinearConstantTerm());
+                break;
+            }
+            case IndexPatternType::Sectioned: {
+                const auto& sip = static_cast<const SectionedIndexPattern&> (ip);
+                writeSize(sip.getLinearSections().size());
+                for (const auto& it : sip.getLinearSections()) {
+                    writeSize(it.first);
+                    writeIndexPattern(*it.second);
+                }
+                break;
+            }
+            case IndexPatternType::Random1D: {
+                const auto& rip = static_cast<const Random1DIndexPattern&> (ip);
+                writeString(rip.getName());
+                writeSize(rip.getValues().size());
+                for (const auto& it : rip.getValues()) {
+                    writeSize(it.first);
+                    writeSize(it.second);
+                }
+                break;
+            }
+            case IndexPatternType::Random2D: {
+                const auto& rip = static_cast<const Random2DIndexPattern&> (ip);
+                writeString(rip.getName());
+                writeSize(rip.getValues().size());
+                for (const auto& it : rip.getValues()) {
+                    writeSize(it.first);
+                    writeSize(it.second.size());
+                    for (const auto& it2 : it.second) {
+                        writeSize(it2.first);
+                        writeSize(it2.second);
+                    }
+                }
+                break;
+            }
+            case IndexPatternType::Plane2D: {
+                const auto& pip = static_cast<const Plane2DIndexPattern&> (ip);
+                write<uint8_t>(pip.getPattern1() != nullptr);
+                if (pip.getPattern1() != nullptr)
+                    writeIndexPattern(*pip.getPattern1());
+                write<uint8_t>(pip.getPattern2() != nullptr);
+                if (pip.getPattern2() != nullptr)
+                    writeIndexPattern(*pip.getPattern2());
+                break;
+            }
+            default:
+                throw CGException("Unknown index pattern type");
+        }
+    }
+};
+
+/**
+ * Reads the binary representation of an operation graph directly from
+ * memory (e.g. a memory mapped file).
+ */
+class GraphInputStream {
+private:
+    const char* data_;
+    size_t size_;
+    size_t pos_;
+public:
+
+    inline GraphInputStream(const char* data,
+                            size_t size) :
+        data_(data),
+        size_(size),
+        pos_(0) {
+    }
+
+    inline bool atEnd() const {
+        return pos_ == size_;
+    }
+
+    template<class T>
+    inline T read() {
+        static_assert(std::is_trivially_copyable<T>::value, "only trivially copyable types can be read");
+        require(sizeof(T));
+        T v;
+        std::memcpy(&v, data_ + pos_, sizeof(T));
+        pos_ += sizeof(T);
+        return v;
+    }
+
+    /**
+     * Reads the number of elements of a collection stored after it.
+     */
+    inline size_t readSize() {
+        uint64_t v = read<uint64_t>();
+        if (v > size_) {
+            // no count can be larger than the data itself
+            throw CGException("Invalid operation graph: corrupted data at byte ", pos_);
+        }
+        return size_t(v);
+    }
+
+    /**
+     * Reads the position of an element in a collection.
+     *
+     * @param n the number of elements in the collection
+     */
+    inline size_t readIndex(size_t n) {
+        uint64_t v = read<uint64_t>();
+        if (v >= n) {
+            throw CGException("Invalid operation graph: invalid index (", v, ") at byte ", pos_);
+        }
+        return size_t(v);
+    }
+
+    /**
+     * Reads an unsigned value which is not related with the data size
+     * (e.g. the information of a node or an atomic function ID).
+     */
+    inline size_t readValue() {
+        uint64_t v = read<uint64_t>();
+        if (v > std::numeric_limits<size_t>::max()) {
+            throw CGException("Invalid operation graph: value too large at byte ", pos_);
+        }
+        return size_t(v);
+    }
+
+    inline std::string readString() {
+        size_t n = readSize();
+        require(n);
+        std::string s(data_ + pos_, n);
+        pos_ += n;
+        return s;
+    }
+
+    inline void readBytes(char* out, size_t n) {
+        require(n);
+        std::memcpy(out, data_ + pos_, n);
+        pos_ += n;
+    }
+
+    inline IndexPattern* readIndexPattern() {
+        auto type = IndexPatternType(read<uint8_t>());
+
+        switch (type) {
+            case IndexPatternType::Linear: {
+                long xOffset = long(read<int64_t>());
+                long dy = long(read<int64_t>());
+                long dx = long(read<int64_t>());
+                long b = long(read<int64_t>());
+                return new LinearIndexPattern(xOffset, dy, dx, b);
+            }
+            case IndexPatternType::Sectioned: {
+                std::map<size_t, IndexPattern*> sections;
+                try {
+                    size_t n = readSize();
+                    for (size_t i = 0; i < n; ++i) {
+                        size_t start = readValue();
+                        sections[start] = readIndexPattern();
+                    }
+                } catch (...) {
+                    deleteIndexPatterns(sections);
+                    throw;
+                }
+                return new SectionedIndexPattern(sections);
+            }
+            case IndexPatternType::Random1D: {
+                std::string name = readString();
+                std::map<size_t, size_t> values;
+                size_t n = readSize();
+                for (size_t i = 0; i < n; ++i) {
+                    size_t x = readValue();
+                    values[x] = readValue();
+                }
+                checkNotEmpty(n);
+                auto* ip = new Random1DIndexPattern(values);
+                ip->setName(name);
+                return ip;
+            }
+            case IndexPatternType::Random2D: {
+                std::string name = readString();
+                std::map<size_t, std::map<size_t, size_t> > values;
+                size_t n = readSize();
+                for (size_t i = 0; i < n; ++i) {
+                    std::map<size_t, size_t>& v2 = values[readValue()];
+                    size_t n2 = readSize();
+                    for (size_t i2 = 0; i2 < n2; ++i2) {
+                        size_t y = readValue();
+                        v2[y] = readValue();
+                    }
+                }
+                checkNotEmpty(n);
+                auto* ip = new Random2DIndexPattern(values);
+                ip->setName(name);
+                return ip;
+            }
+            case IndexPatternType::Plane2D: {
+                std::unique_ptr<IndexPattern> p1, p2;
+                if (read<uint8_t>())
+                    p1.reset(readIndexPattern());
+                if (read<uint8_t>())
+                    p2.reset(readIndexPattern());
+                checkNotEmpty(p1 != nullptr || p2 != nullptr);
+                return new Plane2DIndexPattern(p1.release(), p2.release());
+            }
+            default:
+                throw CGException("Invalid operation graph: unknown index pattern type at byte ", pos_);
+        }
+    }
+
+private:
+
+    inline void require(size_t n) const {
+        if (n > size_ - pos_) {
+            throw CGException("Invalid operation graph: unexpected end of data");
+        }
+    }
+
+    inline void checkNotEmpty(bool notEmpty) const {
+        if (!notEmpty) {
+            throw CGException("Invalid operation graph: empty index pattern at byte ", pos_);
+        }
+    }
+
+    template<class T>
+    static inline void deleteIndexPatterns(std::map<size_t, T*>& patterns) {
+        for (auto& it : patterns)
+            delete it.second;
+    }
+};
+
+/******************************************************************************
+ *                          CodeHandler save/load
+ *****************************************************************************/
+
+template<class Base>
+inline void CodeHandler<Base>::saveGraph(std::ostream& out,
+                                         ArrayView<const CGB> dependent) const {
+    static_assert(std::is_trivially_copyable<Base>::value, "Base must be trivially copyable");
+
+    GraphOutputStream os(out);
+
+    auto nodeIndex = [this](const Node* n) {
+        size_t pos = n->getHandlerPosition();
+        if (pos >= _codeBlocks.size() || _codeBlocks[pos] != n) {
+            throw CGException("Unable to save an operation graph with a node which is not managed by this handler");
+        }
+        return pos;
+    };
+
+    auto writeArg = [&](const Arg& arg) {
+        if (arg.getOperation() != nullptr) {
+            os.write<uint8_t>(GraphOutputStream::ARG_NODE);
+            os.writeSize(nodeIndex(arg.getOperation()));
+        } else if (arg.getParameter() != nullptr) {
+            os.write<uint8_t>(GraphOutputStream::ARG_PARAMETER);
+            os.write<Base>(*arg.getParameter());
+        } else {
+            os.write<uint8_t>(GraphOutputStream::ARG_EMPTY);
+        }
+    };
+
+    /**
+     * header
+     */
+    out.write(GraphOutputStream::magic(), GraphOutputStream::MAGIC_SIZE);
+    os.write<uint32_t>(uint32_t(GraphOutputStream::VERSION));
+    os.write<uint32_t>(sizeof(Base));
+    os.write<uint32_t>(uint32_t(GraphOutputStream::BYTE_ORDER_MARK));
+
+    /**
+     * atomic functions
+     */
+    os.writeSize(_atomicFunctions.size());
+    for (const auto& it : _atomicFunctions) {
+        os.writeSize(it.first);
+        os.writeString(it.second->atomic_name());
+    }
+
+    /**
+     * index patterns
+     */
+    std::vector<const IndexPattern*> patterns;
+    std::map<const IndexPattern*, size_t> pattern2Index;
+    auto addPattern = [&](const IndexPattern* ip) {
+        auto added = pattern2Index.emplace(ip, patterns.size());
+        if (added.second)
+            patterns.push_back(ip);
+        return added.first->second;
+    };
+
+    for (const Node* n : _codeBlocks) {
+        if (n->getOperationType() == CGOpCode::IndexAssign) {
+            addPattern(&static_cast<const IndexAssignOperationNode<Base>*> (n)->getIndexPattern());
+        }
+    }
+    for (const IndexPattern* ip : _loops.dependentIndexPatterns)
+        addPattern(ip);
+    for (const IndexPattern* ip : _loops.independentIndexPatterns)
+        addPattern(ip);
+
+    os.writeSize(patterns.size());
+    for (const IndexPattern* ip : patterns) {
+        os.writeIndexPattern(*ip);
+    }
+
+    os.writeSize(_loops.dependentIndexPatterns.size());
+    for (const IndexPattern* ip : _loops.dependentIndexPatterns)
+        os.writeSize(pattern2Index.at(ip));
+    os.writeSize(_loops.independentIndexPatterns.size());
+    for (const IndexPattern* ip : _loops.independentIndexPatterns)
+        os.writeSize(pattern2Index.at(ip));
+
+    /**
+     * nodes
+     */
+    os.writeSize(_codeBlocks.size());
+    for (const Node* n : _codeBlocks) {
+        CGOpCode op = n->getOperationType();
+        const std::string* name = n->getName();
+
+        os.write<uint32_t>(uint32_t(op));
+        os.write<uint32_t>(name != nullptr ? 1 : 0);
+        if (name != nullptr)
+            os.writeString(*name);
+
+        const std::vector<size_t>& info = n->getInfo();
+        os.writeSize(info.size());
+        for (size_t v : info)
+            os.writeSize(v);
+
+        const std::vector<Arg>& args = n->getArguments();
+        os.writeSize(args.size());
+        for (const Arg& a : args)
+            writeArg(a);
+
+        if (op == CGOpCode::IndexAssign) {
+            os.writeSize(pattern2Index.at(&static_cast<const IndexAssignOperationNode<Base>*> (n)->getIndexPattern()));
+        } else if (op == CGOpCode::Pri) {
+            const auto* pri = static_cast<const PrintOperationNode<Base>*> (n);
+            os.writeString(pri->getBeforeString());
+            os.writeString(pri->getAfterString());
+        }
+    }
+
+    /**
+     * independents and dependents
+     */
+    os.writeSize(_independentVariables.size());
+    for (const Node* n : _independentVariables)
+        os.writeSize(nodeIndex(n));
+
+    os.writeSize(dependent.size());
+    for (size_t i = 0; i < dependent.size(); ++i) {
+        writeArg(dependent[i].argument());
+    }
+
+    if (!out) {
+        throw CGException("Failed to write the operation graph");
+    }
+}
+
+template<class Base>
+inline void CodeHandler<Base>::loadGraph(std::istream& in,
+                                         std::vector<CGB>& independent,
+                                         std::vector<CGB>& dependent,
+                                         const std::vector<CGAbstractAtomicFun<Base>*>& atomics) {
+    std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    loadGraph(data.data(), data.size(), independent, dependent, atomics);
+}
+
+template<class Base>
+inline void CodeHandler<Base>::loadGraph(const char* data,
+                                         size_t size,
+                                         std::vector<CGB>& independent,
+                                         std::vector<CGB>& dependent,
+                                         const std::vector<CGAbstractAtomicFun<Base>*>& atomics) {
+    static_assert(std::is_trivially_copyable<Base>::value, "Base must be trivially copyable");
+
+    GraphInputStream is(data, size);
+
+    /**
+     * header
+     */
+    char magic[GraphOutputStream::MAGIC_SIZE];
+    is.readBytes(magic, sizeof(magic));
+    if (!std::equal(magic, magic + sizeof(magic), GraphOutputStream::magic())) {
+        throw CGException("Invalid operation graph: unknown file format");
+    }
+    uint32_t version = is.read<uint32_t>();
+    if (version != GraphOutputStream::VERSION) {
+        throw CGException("Unsupported operation graph format version (", version, ")");
+    }
+    if (is.read<uint32_t>() != sizeof(Base)) {
+        throw CGException("Invalid operation graph: the data type size does not match");
+    }
+    if (is.read<uint32_t>() != GraphOutputStream::BYTE_ORDER_MARK) {
+        throw CGException("Invalid operation graph: the byte order does not match");
+    }
+
+    reset();
+
+    /**
+     * atomic functions
+     */
+    std::map<size_t, size_t> atomicIds; // saved ID -> current ID
+    size_t nAtomics = is.readSize();
+    for (size_t i = 0; i < nAtomics; ++i) {
+        size_t id = is.readValue();
+        std::string name = is.readString();
+
+        CGAbstractAtomicFun<Base>* atomic = nullptr;
+        for (CGAbstractAtomicFun<Base>* a : atomics) {
+            if (a != nullptr && a->atomic_name() == name) {
+                atomic = a;
+                break;
+            }
+        }
+        if (atomic == nullptr) {
+            // it might have been registered in this handler before
+            for (const auto& it : _atomicFunctions) {
+                if (it.second->atomic_name() == name) {
+                    atomic = it.second;
+                    break;
+                }
+            }
+        }
+        if (atomic == nullptr) {
+            throw CGException("The atomic function '", name, "' used by the operation graph was not provided");
+        }
+        registerAtomicFunction(*atomic);
+        atomicIds[id] = atomic->getId();
+    }
+
+    /**
+     * index patterns
+     */
+    size_t nPatterns = is.readSize();
+    _loadedIndexPatterns.reserve(nPatterns);
+    for (size_t i = 0; i < nPatterns; ++i) {
+        _loadedIndexPatterns.emplace_back(is.readIndexPattern());
+    }
+
+    auto readPatternIndex = [&]() -> IndexPattern& {
+        return *_loadedIndexPatterns[is.readIndex(_loadedIndexPatterns.size())];
+    };
+
+    size_t nDepPatterns = is.readSize();
+    for (size_t i = 0; i < nDepPatterns; ++i)
+        _loops.addDependentIndexPattern(readPatternIndex());
+    size_t nIndepPatterns = is.readSize();
+    for (size_t i = 0; i < nIndepPatterns; ++i)
+        _loops.addIndependentIndexPattern(readPatternIndex(), i);
+
+    /**
+     * nodes (the arguments are only assigned once all nodes exist)
+     */
+    struct PendingArg {
+        uint8_t type;
+        size_t node;
+        Base parameter;
+    };
+
+    size_t nNodes = is.readSize();
+
+    // arguments may refer to nodes which are only read later
+    auto readArg = [&]() -> PendingArg {
+        PendingArg a{is.read<uint8_t>(), 0, Base()};
+        if (a.type == GraphOutputStream::ARG_NODE) {
+            a.node = is.readIndex(nNodes);
+        } else if (a.type == GraphOutputStream::ARG_PARAMETER) {
+            a.parameter = is.read<Base>();
+        } else if (a.type != GraphOutputStream::ARG_EMPTY) {
+            throw CGException("Invalid operation graph: unknown argument type");
+        }
+        return a;
+    };
+
+    _codeBlocks.reserve(nNodes);
+
+    std::vector<PendingArg> pendingArgs;
+    std::vector<size_t> argStart(nNodes + 1, 0);
+
+    // temporary nodes used to construct the custom node classes
+    std::unique_ptr<Node> indexDclPlaceholder = Node::makeTemporaryNode(CGOpCode::IndexDeclaration, {}, {});
+    LoopStartOperationNode<Base> loopStartPlaceholder(nullptr, *indexDclPlaceholder, 0);
+
+    for (size_t i = 0; i < nNodes; ++i) {
+        auto op = CGOpCode(is.read<uint32_t>());
+        if (op > CGOpCode::UserCustom) {
+            throw CGException("Invalid operation graph: unknown operation type");
+        }
+        uint32_t flags = is.read<uint32_t>();
+        std::string name;
+        if (flags & 1)
+            name = is.readString();
+
+        std::vector<size_t> info(is.readSize());
+        for (size_t& v : info)
+            v = is.readValue();
+
+        if ((op == CGOpCode::AtomicForward || op == CGOpCode::AtomicReverse) && !info.empty()) {
+            auto it = atomicIds.find(info[0]);
+            if (it == atomicIds.end())
+                throw CGException("Invalid operation graph: unknown atomic function ID (", info[0], ")");
+            info[0] = it->second;
+        }
+
+        argStart[i] = pendingArgs.size();
+        size_t nArgs = is.readSize();
+        for (size_t a = 0; a < nArgs; ++a)
+            pendingArgs.push_back(readArg());
+
+        Node* node;
+        switch (op) {
+            case CGOpCode::IndexAssign:
+                node = new IndexAssignOperationNode<Base>(this, *indexDclPlaceholder, readPatternIndex(), nullptr, nullptr);
+                break;
+            case CGOpCode::Index:
+                node = new IndexOperationNode<Base>(this, *indexDclPlaceholder);
+                break;
+            case CGOpCode::LoopStart:
+                node = new LoopStartOperationNode<Base>(this, *indexDclPlaceholder, 0);
+                break;
+            case CGOpCode::LoopEnd:
+                node = new LoopEndOperationNode<Base>(this, loopStartPlaceholder, std::vector<Arg>());
+                _loops.addLoopEndNode(*node);
+                break;
+            case CGOpCode::Pri: {
+                std::string before = is.readString();
+                std::string after = is.readString();
+                node = new PrintOperationNode<Base>(this, before, Arg(), after);
+                break;
+            }
+            default:
+                node = newNode(this, op);
+        }
+
+        node->info_ = std::move(info);
+        manageOperationNode(node);
+        if (flags & 1)
+            node->setName(name);
+    }
+    argStart[nNodes] = pendingArgs.size();
+
+    auto makeArg = [&](const PendingArg& a) -> Arg {
+        if (a.type == GraphOutputStream::ARG_NODE) {
+            return Arg(*_codeBlocks[a.node]);
+        } else if (a.type == GraphOutputStream::ARG_PARAMETER) {
+            return Arg(a.parameter);
+        }
+        return Arg();
+    };
+
+    for (size_t i = 0; i < nNodes; ++i) {
+        Node* node = _codeBlocks[i];
+        std::vector<Arg>& args = node->arguments_;
+        args.clear();
+        args.reserve(argStart[i + 1] - argStart[i]);
+        for (size_t a = argStart[i]; a < argStart[i + 1]; ++a) {
+            args.push_back(makeArg(pendingArgs[a]));
+        }
+
+        if (_hashConsing && isHashConsingCandidate(node->operation_)) {
+            _nodeTable.emplace(hashNode(node->operation_, node->info_, args.data(), args.size()), node);
+        }
+    }
+
+    /**
+     * independents and dependents
+     */
+    size_t nIndep = is.readSize();
+    independent.resize(nIndep);
+    _independentVariables.reserve(nIndep);
+    for (size_t j = 0; j < nIndep; ++j) {
+        size_t pos = is.readIndex(_codeBlocks.size());
+        if (_codeBlocks[pos]->getOperationType() != CGOpCode::Inv)
+            throw CGException("Invalid operation graph: invalid independent variable");
+        _independentVariables.push_back(_codeBlocks[pos]);
+        independent[j] = CGB(*_codeBlocks[pos]);
+    }
+
+    size_t nDep = is.readSize();
+    dependent.resize(nDep);
+    for (size_t i = 0; i < nDep; ++i) {
+        dependent[i] = createCG(makeArg(readArg()));
+    }
+
+    if (!is.atEnd()) {
+        throw CGException("Invalid operation graph: unexpected data after the dependent variables");
+    }
+}
+
+} // END cg namespace
+} // END CppAD namespace
+
+#endif
@@ -46,6 +46,7 @@ static_assert(false,
 #include <deque>
 #include <forward_list>
 #include <set>
+#include <unordered_map>
 #include <cstddef>
 #include <stdexcept>
 #include <cstdio>
@@ -55,6 +56,11 @@ static_assert(false,
 #include <cstring>
 #include <chrono>
 #include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <future>
+#include <atomic>
+#include <exception>
 #include <functional>
 
 // ---------------------------------------------------------------------------
@@ -94,6 +100,7 @@ static_assert(false,
 // ---------------------------------------------------------------------------
 // some utilities
 #include <cppad/cg/smart_containers.hpp>
+#include <cppad/cg/object_arena.hpp>
 #include <cppad/cg/ostream_config_restore.hpp>
 #include <cppad/cg/array_view.hpp>
 
@@ -147,6 +154,7 @@ static_assert(false,
 #include <cppad/cg/code_handler_impl.hpp>
 #include <cppad/cg/code_handler_vector.hpp>
 #include <cppad/cg/code_handler_loops.hpp>
+#include <cppad/cg/code_handler_serialization.hpp>
 
 // ---------------------------------------------------------------------------
 #include <cppad/cg/base_double.hpp>
@@ -176,6 +184,17 @@ static_assert(false,
 #include <cppad/cg/graph_mod.hpp>
 #include <cppad/cg/operation_node_name_streambuf.hpp>
 
+// ---------------------------------------------------------------------------
+// operation graph optimization
+#include <cppad/cg/optimizer/graph_optimization_pass.hpp>
+#include <cppad/cg/optimizer/graph_rewrite_pass.hpp>
+#include <cppad/cg/optimizer/constant_folding_pass.hpp>
+#include <cppad/cg/optimizer/algebraic_simplification_pass.hpp>
+#include <cppad/cg/optimizer/power_reduction_pass.hpp>
+#include <cppad/cg/optimizer/exp_log_cancellation_pass.hpp>
+#include <cppad/cg/optimizer/reciprocal_division_pass.hpp>
+#include <cppad/cg/optimizer/graph_optimizer.hpp>
+
 // ---------------------------------------------------------------------------
 // atomic function utilities
 #include <cppad/cg/custom_position.hpp>
@@ -205,12 +224,17 @@ static_assert(false,
 #include <cppad/cg/lang/c/language_c_double.hpp>
 #include <cppad/cg/lang/c/language_c_float.hpp>
 #include <cppad/cg/lang/c/language_c_loops.hpp>
+#include <cppad/cg/lang/c/language_c_lanes.hpp>
 #include <cppad/cg/lang/c/lang_c_default_var_name_gen.hpp>
 #include <cppad/cg/lang/c/lang_c_default_hessian_var_name_gen.hpp>
 #include <cppad/cg/lang/c/lang_c_default_reverse2_var_name_gen.hpp>
 #include <cppad/cg/lang/c/lang_c_custom_var_name_gen.hpp>
 #include <cppad/cg/lang/c/lang_c_util.hpp>
 
+// bytecode language
+#include <cppad/cg/lang/bytecode/bytecode_program.hpp>
+#include <cppad/cg/lang/bytecode/language_bytecode.hpp>
+
 //
 #include <cppad/cg/model/threadpool/multi_threading_type.hpp>
 #include <cppad/cg/model/threadpool/thread_pool_schedule_strategy.hpp>
@@ -219,9 +243,11 @@ static_assert(false,
 #include <cppad/cg/model/generic_model_external_function_wrapper.hpp>
 #include <cppad/cg/model/model_library_processor.hpp>
 #include <cppad/cg/model/model_library.hpp>
+#include <cppad/cg/model/sparse_output_layout.hpp>
 #include <cppad/cg/model/generic_model.hpp>
 #include <cppad/cg/model/functor_generic_model.hpp>
 #include <cppad/cg/model/functor_model_library.hpp>
+#include <cppad/cg/model/reloadable_model_library.hpp>
 #include <cppad/cg/model/save_files_model_library_processor.hpp>
 
 // automated static library creation
@@ -250,6 +276,7 @@ static_assert(false,
 #include <cppad/cg/model/model_c_source_gen_rev2.hpp>
 #include <cppad/cg/model/model_c_source_gen_jac.hpp>
 #include <cppad/cg/model/model_c_source_gen_hes.hpp>
+#include <cppad/cg/model/model_c_source_gen_color.hpp>
 #include <cppad/cg/model/patterns/model_c_source_gen_loops.hpp>
 #include <cppad/cg/model/patterns/model_c_source_gen_loops_for0.hpp>
 #include <cppad/cg/model/patterns/model_c_source_gen_loops_for1.hpp>
@@ -261,6 +288,11 @@ static_assert(false,
 #include <cppad/cg/model/patterns/model_c_source_gen_loops_hess_r2.hpp>
 #include <cppad/cg/model/patterns/hessian_with_loops_info.hpp>
 
+// bytecode model libraries (no compiler required)
+#include <cppad/cg/model/bytecode/bytecode_generic_model.hpp>
+#include <cppad/cg/model/bytecode/bytecode_model_library.hpp>
+#include <cppad/cg/model/bytecode/bytecode_model_library_processor.hpp>
+
 // automated dynamic library creation
 #include <cppad/cg/model/dynamic_lib/dynamiclib.hpp>
 #include <cppad/cg/model/dynamic_lib/dynamic_library_processor.hpp>
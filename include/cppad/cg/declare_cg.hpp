@@ -71,6 +71,18 @@ class BidirGraph;
 template<class Base>
 class ScopePathElement;
 
+/***************************************************************************
+ * Graph optimization
+ **************************************************************************/
+template<class Base>
+class GraphOptimizationPass;
+
+template<class Base>
+class GraphRewritePass;
+
+template<class Base>
+class GraphOptimizer;
+
 /***************************************************************************
  * Nodes
  **************************************************************************/
@@ -125,6 +137,9 @@ class LangStreamOperation;
 template<class Base>
 class LanguageC;
 
+template<class Base>
+class LanguageBytecode;
+
 template<class Base>
 class VariableNameGenerator;
 
@@ -146,6 +161,9 @@ class ModelLibraryProcessor;
 template<class Base>
 class FunctorGenericModel;
 
+template<class Base>
+class BytecodeModelLibraryProcessor;
+
 /***************************************************************************
  * Dynamic model compilation
  **************************************************************************/
@@ -292,6 +310,37 @@ enum class JacobianADMode {
     Forward, Reverse, Automatic
 };
 
+/**
+ * Memory layout of the arrays used in batched (multi-point) model
+ * evaluations
+ */
+enum class BatchLayout {
+    /**
+     * Arrays of structures: the values of each point are contiguous
+     * (a[p * size + j])
+     */
+    AoS,
+    /**
+     * Structure of arrays: the values of each element for all points are
+     * contiguous (a[j * nPoints + p])
+     */
+    SoA
+};
+
+/**
+ * Compressed storage formats of sparse matrices
+ */
+enum class SparseFormat {
+    /**
+     * Compressed sparse row: row pointers and column indexes
+     */
+    CSR,
+    /**
+     * Compressed sparse column: column pointers and row indexes
+     */
+    CSC
+};
+
 /**
  * Index pattern types
  */
@@ -39,7 +39,10 @@ class EvaluatorBase;
  *
  * This class should not be instantiated directly.
  *
- * @todo implement nonrecursive algorithm (so that there will never be any stack limit issues)
+ * By default nodes are evaluated recursively starting from the dependent
+ * variables.
+ * An iterative evaluation can be enabled with setIterative() which avoids
+ * any stack limit issues on deep operation graphs (see setIterative()).
  */
 template<class ScalarIn, class ScalarOut, class ActiveOut, class FinalEvaluatorType>
 class EvaluatorBase {
@@ -49,12 +52,43 @@ protected:
 protected:
     CodeHandler<ScalarIn>& handler_;
     const ActiveOut* indep_;
-    CodeHandlerVector<ScalarIn, std::unique_ptr<ActiveOut>> evals_;
+    /**
+     * The evaluation result of each node (points to an element in values_)
+     */
+    CodeHandlerVector<ScalarIn, ActiveOut*> evals_;
+    /**
+     * Storage for the evaluation results indexed by the node position in
+     * the handler (reused across evaluations)
+     */
+    std::vector<ActiveOut> values_;
+    /**
+     * Storage for the evaluation results of nodes created during the
+     * evaluation
+     */
+    std::deque<ActiveOut> extraValues_;
     std::map<size_t, std::vector<ActiveOut>* > evalsArrays_;
     std::map<size_t, std::vector<ActiveOut>* > evalsSparseArrays_;
     bool underEval_;
     size_t depth_;
     SourceCodePath path_;
+    /**
+     * Whether or not to evaluate the nodes in a loop using a topological
+     * order instead of a recursive traversal
+     */
+    bool iterative_;
+    /**
+     * The positions of the nodes in a topological order (arguments before
+     * the nodes which use them) for the dependents in orderDeps_
+     */
+    std::vector<size_t> order_;
+    /**
+     * The positions of the dependent nodes used to determine order_
+     */
+    std::vector<size_t> orderDeps_;
+    /**
+     * The number of nodes in the handler when order_ was determined
+     */
+    size_t orderNodeCount_;
 public:
 
     /**
@@ -65,7 +99,9 @@ public:
         indep_(nullptr),
         evals_(handler),
         underEval_(false),
-        depth_(0) { // not really required (but it avoids warnings)
+        depth_(0), // not really required (but it avoids warnings)
+        iterative_(false),
+        orderNodeCount_(0) {
     }
 
     inline virtual ~EvaluatorBase() {
@@ -79,6 +115,27 @@ public:
         return underEval_;
     }
 
+    /**
+     * Defines whether or not the operation graph is evaluated iteratively.
+     * In this mode a topological order of the nodes is determined (once
+     * for the same dependent variables and handler size) and the nodes are
+     * evaluated in a loop, which avoids deep recursions.
+     * This mode should not be used by evaluators which depend on the path
+     * used to reach each node (e.g. EvaluatorSolve).
+     *
+     * @param iterative whether or not to use an iterative evaluation
+     */
+    inline void setIterative(bool iterative) {
+        iterative_ = iterative;
+    }
+
+    /**
+     * @return whether or not the operation graph is evaluated iteratively
+     */
+    inline bool isIterative() const {
+        return iterative_;
+    }
+
     /**
      * Performs all the operations required to calculate the dependent
      * variables with a (potentially) new data type
@@ -154,6 +211,9 @@ public:
 
         clear(); // clean-up from any previous call that might have failed
         evals_.adjustSize();
+        if (values_.size() < handler_.getManagedNodesCount()) {
+            values_.resize(handler_.getManagedNodesCount());
+        }
 
         depth_ = 0;
         path_.clear();
@@ -170,6 +230,19 @@ public:
             indep_ = indepNew;
             thisOps.analyzeOutIndeps(indep_, indepSize);
 
+            if (iterative_) {
+                determineEvaluationOrder(depOld, depSize);
+
+                const std::vector<OperationNode<ScalarIn>*>& nodes = handler_.getManagedNodes();
+                for (size_t p : order_) {
+                    OperationNode<ScalarIn>& node = *nodes[p];
+                    if (!isEvaluatedByUser(node.getOperationType())) {
+                        // all arguments have already been evaluated
+                        evalOperations(node);
+                    }
+                }
+            }
+
             for (size_t i = 0; i < depSize; i++) {
                 CPPADCG_ASSERT_UNKNOWN(depth_ == 0);
                 depNew[i] = evalCG(depOld[i]);
@@ -196,6 +269,7 @@ protected:
      */
     inline void clear() {
         evals_.clear();
+        extraValues_.clear();
 
         for (const auto& p : evalsArrays_) {
             delete p.second;
@@ -213,6 +287,87 @@ protected:
         // empty
     }
 
+    /**
+     * Determines a topological order for the nodes required to evaluate
+     * the dependents (without recursion).
+     * The previous order is reused if the dependents and the number of
+     * nodes in the handler did not change (a stale order is never wrong
+     * since evalOperations() still evaluates any missing argument).
+     */
+    inline void determineEvaluationOrder(const CG<ScalarIn>* depOld,
+                                         size_t depSize) {
+        size_t nNodes = handler_.getManagedNodesCount();
+
+        if (orderNodeCount_ == nNodes && orderDeps_.size() == depSize) {
+            bool same = true;
+            for (size_t i = 0; i < depSize && same; ++i) {
+                same = orderDeps_[i] == dependentPosition(depOld[i]);
+            }
+            if (same)
+                return;
+        }
+
+        order_.clear();
+        order_.reserve(nNodes);
+        orderDeps_.resize(depSize);
+        orderNodeCount_ = nNodes;
+
+        std::vector<bool> visited(nNodes, false);
+        std::vector<std::pair<OperationNode<ScalarIn>*, size_t> > stack; // node, next argument
+
+        for (size_t i = 0; i < depSize; ++i) {
+            OperationNode<ScalarIn>* dep = depOld[i].getOperationNode();
+            orderDeps_[i] = dependentPosition(depOld[i]);
+            if (dep == nullptr)
+                continue;
+            if (orderDeps_[i] >= nNodes)
+                throw CGException("A dependent variable is not managed by the code handler of the evaluator");
+            if (visited[dep->getHandlerPosition()])
+                continue;
+
+            visited[dep->getHandlerPosition()] = true;
+            stack.emplace_back(dep, 0);
+
+            while (!stack.empty()) {
+                OperationNode<ScalarIn>* node = stack.back().first;
+                const std::vector<Argument<ScalarIn> >& args = node->getArguments();
+                size_t& a = stack.back().second;
+
+                if (a < args.size()) {
+                    OperationNode<ScalarIn>* arg = args[a].getOperation();
+                    a++;
+                    if (arg != nullptr) {
+                        CPPADCG_ASSERT_KNOWN(arg->getHandlerPosition() < nNodes, "this node is not managed by the code handler")
+                        if (!visited[arg->getHandlerPosition()]) {
+                            visited[arg->getHandlerPosition()] = true;
+                            stack.emplace_back(arg, 0);
+                        }
+                    }
+                } else {
+                    order_.push_back(node->getHandlerPosition());
+                    stack.pop_back();
+                }
+            }
+        }
+    }
+
+    static inline size_t dependentPosition(const CG<ScalarIn>& dep) {
+        const OperationNode<ScalarIn>* node = dep.getOperationNode();
+        return node != nullptr ? node->getHandlerPosition() : (std::numeric_limits<size_t>::max)();
+    }
+
+    /**
+     * Whether or not the nodes of an operation type are only evaluated by
+     * the nodes which use them (e.g. arrays are evaluated by array
+     * elements)
+     */
+    static inline bool isEvaluatedByUser(CGOpCode op) {
+        return op == CGOpCode::ArrayCreation ||
+               op == CGOpCode::SparseArrayCreation ||
+               op == CGOpCode::AtomicForward ||
+               op == CGOpCode::AtomicReverse;
+    }
+
     inline ActiveOut evalCG(const CG<ScalarIn>& dep) {
         if (dep.isParameter()) {
             // parameter
@@ -256,7 +411,7 @@ protected:
         ActiveOut result = thisOps.evalOperation(node);
 
         // save it for reuse
-        ActiveOut* resultPtr = saveEvaluation(node, ActiveOut(result));
+        ActiveOut* resultPtr = saveEvaluation(node, std::move(result));
 
         depth_--;
         path_.pop_back();
@@ -266,11 +421,19 @@ protected:
 
     inline ActiveOut* saveEvaluation(const OperationNode<ScalarIn>& node,
                                      ActiveOut&& result) {
-        std::unique_ptr<ActiveOut>& resultPtr = evals_[node];
+        ActiveOut*& resultPtr = evals_[node];
         CPPADCG_ASSERT_UNKNOWN(resultPtr == nullptr); // not supposed to override existing result
-        resultPtr.reset(new ActiveOut(std::move(result)));
 
-        ActiveOut* resultPtr2 = resultPtr.get(); // do not use a reference (just in case evals_ is resized)
+        size_t p = node.getHandlerPosition();
+        if (p < values_.size()) {
+            values_[p] = std::move(result);
+            resultPtr = &values_[p];
+        } else {
+            extraValues_.push_back(std::move(result));
+            resultPtr = &extraValues_.back();
+        }
+
+        ActiveOut* resultPtr2 = resultPtr; // do not use a reference (just in case evals_ is resized)
 
         FinalEvaluatorType& thisOps = static_cast<FinalEvaluatorType&>(*this);
         thisOps.processActiveOut(node, *resultPtr2);
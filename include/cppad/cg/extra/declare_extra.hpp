@@ -129,6 +129,24 @@ template<class VectorSet, class VectorSize>
 inline void generateSparsitySet(const VectorSize& row,
                                 const VectorSize& col,
                                 VectorSet& sparsity);
+
+/***********************************************************************
+ * Sparsity coloring
+ **********************************************************************/
+
+template<class VectorSet>
+inline size_t colorSparsityColumns(const VectorSet& sparsity,
+                                   size_t n,
+                                   std::vector<size_t>& color);
+
+template<class VectorSet>
+inline size_t colorSparsityRows(const VectorSet& sparsity,
+                                size_t n,
+                                std::vector<size_t>& color);
+
+template<class VectorSet>
+inline size_t colorSparsityStar(const VectorSet& sparsity,
+                                std::vector<size_t>& color);
 }
 }
 
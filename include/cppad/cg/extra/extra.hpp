@@ -19,5 +19,6 @@
 
 #include <cppad/cg/extra/sparse_forjac_hessian.hpp>
 #include <cppad/cg/extra/sparsity.hpp>
+#include <cppad/cg/extra/sparsity_coloring.hpp>
 
 #endif
@@ -0,0 +1,203 @@
+#ifndef CPPAD_CG_SPARSITY_COLORING_INCLUDED
+#define CPPAD_CG_SPARSITY_COLORING_INCLUDED
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2020 Joao Leal
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+
+namespace CppAD {
+namespace cg {
+
+/**
+ * Colors the columns of a sparsity pattern so that columns with the same
+ * color do not have elements in the same row (structurally orthogonal
+ * columns).
+ * A greedy (distance-2) coloring is used with the natural column order.
+ *
+ * @param sparsity the sparsity pattern (the column indexes of each row)
+ * @param n the number of columns
+ * @param color the color of each column (n for columns without any element)
+ * @return the number of colors
+ */
+template<class VectorSet>
+inline size_t colorSparsityColumns(const VectorSet& sparsity,
+                                   size_t n,
+                                   std::vector<size_t>& color) {
+    const size_t m = sparsity.size();
+
+    // rows of each column
+    std::vector<std::vector<size_t> > colRows(n);
+    for (size_t i = 0; i < m; i++) {
+        for (size_t j : sparsity[i]) {
+            CPPADCG_ASSERT_KNOWN(j < n, "Invalid column index in the sparsity pattern")
+            colRows[j].push_back(i);
+        }
+    }
+
+    color.assign(n, n);
+    std::vector<size_t> forbidden(n + 1, n); // the last column which forbid each color
+    size_t nColors = 0;
+
+    for (size_t j = 0; j < n; j++) {
+        if (colRows[j].empty())
+            continue;
+
+        for (size_t i : colRows[j]) {
+            for (size_t j2 : sparsity[i]) {
+                if (color[j2] != n)
+                    forbidden[color[j2]] = j;
+            }
+        }
+
+        size_t c = 0;
+        while (forbidden[c] == j)
+            c++;
+        color[j] = c;
+        nColors = std::max<size_t>(nColors, c + 1);
+    }
+
+    return nColors;
+}
+
+/**
+ * Colors the rows of a sparsity pattern so that rows with the same
+ * color do not have elements in the same column (structurally orthogonal
+ * rows).
+ *
+ * @param sparsity the sparsity pattern (the column indexes of each row)
+ * @param n the number of columns
+ * @param color the color of each row (m for rows without any element)
+ * @return the number of colors
+ */
+template<class VectorSet>
+inline size_t colorSparsityRows(const VectorSet& sparsity,
+                                size_t n,
+                                std::vector<size_t>& color) {
+    const size_t m = sparsity.size();
+
+    std::vector<std::set<size_t> > transpose(n);
+    for (size_t i = 0; i < m; i++) {
+        for (size_t j : sparsity[i]) {
+            transpose[j].insert(i);
+        }
+    }
+
+    return colorSparsityColumns(transpose, m, color);
+}
+
+/**
+ * Star coloring of the columns of a symmetric sparsity pattern (e.g. the
+ * pattern of a Hessian).
+ * Adjacent columns (i.e. columns i and j for a non-zero element (i, j))
+ * always have different colors and every path with 4 columns uses at
+ * least 3 colors.
+ * Each non-zero element can then be directly determined either from
+ * row i and the direction of the color of column j, or from row j and the
+ * direction of the color of column i.
+ *
+ * Only the elements present in the sparsity pattern are considered, the
+ * missing symmetric elements are added.
+ *
+ * @param sparsity the sparsity pattern (the column indexes of each row)
+ * @param color the color of each column (n for columns without any element)
+ * @return the number of colors
+ */
+template<class VectorSet>
+inline size_t colorSparsityStar(const VectorSet& sparsity,
+                                std::vector<size_t>& color) {
+    const size_t n = sparsity.size();
+    const size_t none = n;
+
+    std::vector<std::vector<size_t> > adj(n);
+    std::vector<bool> used(n, false);
+    for (size_t i = 0; i < n; i++) {
+        for (size_t j : sparsity[i]) {
+            CPPADCG_ASSERT_KNOWN(j < n, "Invalid column index in a symmetric sparsity pattern")
+            used[i] = true;
+            used[j] = true;
+            if (i != j) {
+                adj[i].push_back(j);
+                adj[j].push_back(i);
+            }
+        }
+    }
+    for (auto& a : adj) {
+        std::sort(a.begin(), a.end());
+        a.erase(std::unique(a.begin(), a.end()), a.end());
+    }
+
+    color.assign(n, none);
+    std::vector<size_t> forbidden(n + 1, none); // the last column which forbid each color
+    size_t nColors = 0;
+
+    for (size_t v = 0; v < n; v++) {
+        if (!used[v])
+            continue;
+
+        // distance-1 coloring
+        for (size_t w : adj[v]) {
+            if (color[w] != none)
+                forbidden[color[w]] = v;
+        }
+
+        // v at the end of a two-colored path v-w-x-y
+        for (size_t w : adj[v]) {
+            if (color[w] == none)
+                continue;
+            for (size_t x : adj[w]) {
+                if (x == v || color[x] == none || forbidden[color[x]] == v)
+                    continue;
+                for (size_t y : adj[x]) {
+                    if (y != w && y != v && color[y] == color[w]) {
+                        forbidden[color[x]] = v;
+                        break;
+                    }
+                }
+            }
+        }
+
+        // v in the middle of a two-colored path w-v-x-y
+        for (size_t x : adj[v]) {
+            if (color[x] == none)
+                continue;
+
+            bool repeated = false;
+            for (size_t w : adj[v]) {
+                if (w != x && color[w] == color[x]) {
+                    repeated = true;
+                    break;
+                }
+            }
+            if (!repeated)
+                continue;
+
+            for (size_t y : adj[x]) {
+                if (y != v && color[y] != none)
+                    forbidden[color[y]] = v;
+            }
+        }
+
+        size_t c = 0;
+        while (forbidden[c] == v)
+            c++;
+        color[v] = c;
+        nColors = std::max<size_t>(nColors, c + 1);
+    }
+
+    return nColors;
+}
+
+} // END cg namespace
+} // END CppAD namespace
+
+#endif
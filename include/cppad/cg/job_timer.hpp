@@ -68,6 +68,7 @@ public:
     static const JobType DEFAULT;
     static const JobType LOOP_DETECTION;
     static const JobType GRAPH;
+    static const JobType GRAPH_OPTIMIZATION;
     static const JobType SOURCE_FOR_MODEL;
     static const JobType SOURCE_GENERATION;
     static const JobType COMPILING_FOR_MODEL;
@@ -88,6 +89,9 @@ const JobType JobTypeHolder<T>::LOOP_DETECTION("starting loop detection", "ended
 template<int T>
 const JobType JobTypeHolder<T>::GRAPH("creating operation graph for", "created operation graph for");
 
+template<int T>
+const JobType JobTypeHolder<T>::GRAPH_OPTIMIZATION("optimizing operation graph with", "optimized operation graph with");
+
 template<int T>
 const JobType JobTypeHolder<T>::SOURCE_FOR_MODEL("source-code for model", "source-code for model");
 
@@ -139,10 +143,11 @@ private:
 public:
 
     inline Job(const JobType& type,
-               const std::string& name) :
+               const std::string& name,
+               std::chrono::steady_clock::time_point beginTime = std::chrono::steady_clock::now()) :
         _type(&type),
         _name(name),
-        _beginTime(std::chrono::steady_clock::now()),
+        _beginTime(beginTime),
         _nestedJobs(false) {
     }
 
@@ -257,11 +262,22 @@ public:
         return _listeners.erase(&l) > 0;
     }
 
+    /**
+     * Registers the start of a new job.
+     *
+     * @param jobName the name of the job
+     * @param type the job type
+     * @param prefix a text to print before the job description
+     * @param beginTime the time when the job actually started (useful for
+     *                  jobs which were executed in other threads and are
+     *                  only reported once they complete)
+     */
     inline void startingJob(const std::string& jobName,
                             const JobType& type = JobTypeHolder<>::DEFAULT,
-                            const std::string& prefix = "") {
+                            const std::string& prefix = "",
+                            std::chrono::steady_clock::time_point beginTime = std::chrono::steady_clock::now()) {
 
-        _jobs.push_back(Job(type, jobName));
+        _jobs.push_back(Job(type, jobName, beginTime));
 
         if (_verbose) {
             OStreamConfigRestore osr(std::cout);
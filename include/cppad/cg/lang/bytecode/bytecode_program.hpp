@@ -0,0 +1,388 @@
+#ifndef CPPAD_CG_BYTECODE_PROGRAM_INCLUDED
+#define CPPAD_CG_BYTECODE_PROGRAM_INCLUDED
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2020 Joao Leal
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+
+/**
+ * Threaded dispatch (computed goto) is used by the interpreter when the
+ * compiler supports it.
+ */
+#if defined(__GNUC__) && !defined(CPPADCG_BYTECODE_NO_THREADED_DISPATCH)
+#define CPPADCG_BYTECODE_THREADED_DISPATCH 1
+#endif
+
+namespace CppAD {
+namespace cg {
+
+/**
+ * Operations of the bytecode interpreter
+ */
+enum class BytecodeOp : uint32_t {
+    End,      // end of the program
+    Assign,   // r = a
+    Abs,      // r = abs(a)
+    Acos,     // r = acos(a)
+    Acosh,    // r = acosh(a)
+    Asin,     // r = asin(a)
+    Asinh,    // r = asinh(a)
+    Atan,     // r = atan(a)
+    Atanh,    // r = atanh(a)
+    Cosh,     // r = cosh(a)
+    Cos,      // r = cos(a)
+    Erf,      // r = erf(a)
+    Erfc,     // r = erfc(a)
+    Exp,      // r = exp(a)
+    Expm1,    // r = expm1(a)
+    Log,      // r = log(a)
+    Log1p,    // r = log1p(a)
+    Sign,     // r = (a > 0)? 1: ((a == 0)? 0: -1)
+    Sinh,     // r = sinh(a)
+    Sin,      // r = sin(a)
+    Sqrt,     // r = sqrt(a)
+    Tanh,     // r = tanh(a)
+    Tan,      // r = tan(a)
+    UnMinus,  // r = -a
+    Add,      // r = a + b
+    Sub,      // r = a - b
+    Mul,      // r = a * b
+    Div,      // r = a / b
+    Pow,      // r = pow(a, b)
+    ComLt,    // r = a < b ? c: d
+    ComLe,    // r = a <= b ? c: d
+    ComEq,    // r = a == b ? c: d
+    ComGe,    // r = a >= b ? c: d
+    ComGt,    // r = a > b ? c: d
+    ComNe,    // r = a != b ? c: d
+    NumberOp  // total number of operation types
+};
+
+/**
+ * Provides the number of arguments of a bytecode operation
+ * (excluding the result register).
+ */
+inline size_t getBytecodeArgumentCount(BytecodeOp op) {
+    if (op == BytecodeOp::End) {
+        return 0;
+    } else if (op < BytecodeOp::Add) {
+        return 1;
+    } else if (op < BytecodeOp::ComLt) {
+        return 2;
+    } else {
+        return 4;
+    }
+}
+
+/**
+ * A register based program which evaluates an operation graph without
+ * the need of a compiler.
+ *
+ * The code is a stream of instructions [operation, result, arguments...]
+ * terminated by BytecodeOp::End.
+ * The registers are organized as:
+ *  - the values of the input arrays (one after the other),
+ *  - the dependent and temporary variables,
+ *  - the constants.
+ *
+ * Programs are immutable once created and evaluate() can be called
+ * concurrently from several threads.
+ *
+ * @author Joao Leal
+ */
+template<class Base>
+class BytecodeProgram {
+    friend class LanguageBytecode<Base>;
+public:
+    /**
+     * Programs with up to this number of registers are evaluated without
+     * any memory allocation.
+     */
+    static const size_t STACK_REGISTERS = 256;
+private:
+    std::vector<uint32_t> _code;
+    std::vector<Base> _constants;
+    size_t _registerCount;
+    std::vector<size_t> _inputSizes;
+    std::vector<uint32_t> _outputs;
+public:
+
+    inline BytecodeProgram() :
+        _code(1, uint32_t(BytecodeOp::End)),
+        _registerCount(0) {
+    }
+
+    /**
+     * @return the total number of registers (including inputs and constants)
+     */
+    inline size_t getRegisterCount() const {
+        return _registerCount;
+    }
+
+    /**
+     * @return the number of values of each input array
+     */
+    inline const std::vector<size_t>& getInputSizes() const {
+        return _inputSizes;
+    }
+
+    /**
+     * @return the number of output values
+     */
+    inline size_t getOutputSize() const {
+        return _outputs.size();
+    }
+
+    /**
+     * @return the number of instructions (excluding the end of the program)
+     */
+    inline size_t getInstructionCount() const {
+        size_t count = 0;
+        for (size_t pc = 0; BytecodeOp(_code[pc]) != BytecodeOp::End; ++count) {
+            pc += 2 + getBytecodeArgumentCount(BytecodeOp(_code[pc]));
+        }
+        return count;
+    }
+
+    /**
+     * Evaluates the program.
+     *
+     * @param in the input arrays (their sizes must match getInputSizes())
+     * @param out the output array (with getOutputSize() elements)
+     */
+    inline void evaluate(const Base* const* in,
+                         Base* out) const {
+        Base stackRegs[STACK_REGISTERS];
+        std::vector<Base> heapRegs;
+        Base* r = stackRegs;
+        if (_registerCount > STACK_REGISTERS) {
+            heapRegs.resize(_registerCount);
+            r = heapRegs.data();
+        }
+
+        size_t p = 0;
+        for (size_t k = 0; k < _inputSizes.size(); ++k) {
+            std::copy(in[k], in[k] + _inputSizes[k], r + p);
+            p += _inputSizes[k];
+        }
+        std::copy(_constants.begin(), _constants.end(), r + (_registerCount - _constants.size()));
+
+        run(r);
+
+        for (size_t i = 0; i < _outputs.size(); ++i) {
+            out[i] = r[_outputs[i]];
+        }
+    }
+
+    /**
+     * Writes this program to a binary stream.
+     */
+    inline void save(GraphOutputStream& out) const {
+        out.write<uint64_t>(_registerCount);
+        out.writeSize(_inputSizes.size());
+        for (size_t s : _inputSizes)
+            out.write<uint64_t>(s);
+        out.writeSize(_constants.size());
+        for (const Base& c : _constants)
+            out.write<Base>(c);
+        out.writeSize(_outputs.size());
+        for (uint32_t o : _outputs)
+            out.write<uint32_t>(o);
+        out.writeSize(_code.size());
+        for (uint32_t c : _code)
+            out.write<uint32_t>(c);
+    }
+
+    /**
+     * Reads a program written by save().
+     * The program is validated so that corrupted data cannot lead to
+     * accesses outside the registers.
+     */
+    inline void load(GraphInputStream& in) {
+        _registerCount = size_t(in.read<uint64_t>());
+        _inputSizes.resize(in.readSize());
+        size_t nIn = 0;
+        for (size_t& s : _inputSizes) {
+            s = size_t(in.read<uint64_t>());
+            nIn += s;
+        }
+        _constants.resize(in.readSize());
+        for (Base& c : _constants)
+            c = in.read<Base>();
+        _outputs.resize(in.readSize());
+        for (uint32_t& o : _outputs)
+            o = in.read<uint32_t>();
+        _code.resize(in.readSize());
+        for (uint32_t& c : _code)
+            c = in.read<uint32_t>();
+
+        if (nIn + _constants.size() > _registerCount) {
+            throw CGException("Invalid bytecode: too few registers");
+        }
+        for (uint32_t o : _outputs) {
+            if (o >= _registerCount)
+                throw CGException("Invalid bytecode: invalid output register");
+        }
+        size_t pc = 0;
+        while (true) {
+            if (pc >= _code.size() || _code[pc] >= uint32_t(BytecodeOp::NumberOp))
+                throw CGException("Invalid bytecode: invalid operation at position ", pc);
+            auto op = BytecodeOp(_code[pc]);
+            if (op == BytecodeOp::End)
+                break;
+            size_t end = pc + 2 + getBytecodeArgumentCount(op);
+            if (end > _code.size())
+                throw CGException("Invalid bytecode: truncated instruction at position ", pc);
+            for (size_t k = pc + 1; k < end; ++k) {
+                if (_code[k] >= _registerCount)
+                    throw CGException("Invalid bytecode: invalid register at position ", k);
+            }
+            pc = end;
+        }
+        if (pc + 1 != _code.size())
+            throw CGException("Invalid bytecode: data after the end of the program");
+    }
+
+private:
+
+    inline void run(Base* r) const {
+        using std::abs;
+        using std::acos;
+        using std::asin;
+        using std::atan;
+        using std::cosh;
+        using std::cos;
+        using std::exp;
+        using std::log;
+        using std::sinh;
+        using std::sin;
+        using std::sqrt;
+        using std::tanh;
+        using std::tan;
+        using std::pow;
+        using std::acosh;
+        using std::asinh;
+        using std::atanh;
+        using std::erf;
+        using std::erfc;
+        using std::expm1;
+        using std::log1p;
+
+        const uint32_t* pc = _code.data();
+
+#ifdef CPPADCG_BYTECODE_THREADED_DISPATCH
+        // must follow the order of BytecodeOp
+        static const void* const dispatch[] = {
+            &&op_End, &&op_Assign, &&op_Abs, &&op_Acos, &&op_Acosh, &&op_Asin,
+            &&op_Asinh, &&op_Atan, &&op_Atanh, &&op_Cosh, &&op_Cos, &&op_Erf,
+            &&op_Erfc, &&op_Exp, &&op_Expm1, &&op_Log, &&op_Log1p, &&op_Sign,
+            &&op_Sinh, &&op_Sin, &&op_Sqrt, &&op_Tanh, &&op_Tan, &&op_UnMinus,
+            &&op_Add, &&op_Sub, &&op_Mul, &&op_Div, &&op_Pow,
+            &&op_ComLt, &&op_ComLe, &&op_ComEq, &&op_ComGe, &&op_ComGt, &&op_ComNe
+        };
+        static_assert(sizeof(dispatch) / sizeof(dispatch[0]) == size_t(BytecodeOp::NumberOp),
+                      "invalid dispatch table");
+
+#define CPPADCG_BC_OP(name) op_##name
+#define CPPADCG_BC_NEXT() goto *dispatch[*pc]
+
+        CPPADCG_BC_NEXT();
+#else
+#define CPPADCG_BC_OP(name) case BytecodeOp::name
+#define CPPADCG_BC_NEXT() continue
+
+        while (true) {
+            switch (BytecodeOp(*pc)) {
+#endif
+
+#define CPPADCG_BC_UNARY(name, expr) \
+        CPPADCG_BC_OP(name): { \
+            const Base& a = r[pc[2]]; \
+            r[pc[1]] = expr; \
+            pc += 3; \
+            CPPADCG_BC_NEXT(); \
+        }
+#define CPPADCG_BC_BINARY(name, expr) \
+        CPPADCG_BC_OP(name): { \
+            const Base& a = r[pc[2]]; \
+            const Base& b = r[pc[3]]; \
+            r[pc[1]] = expr; \
+            pc += 4; \
+            CPPADCG_BC_NEXT(); \
+        }
+#define CPPADCG_BC_COMPARE(name, cmp) \
+        CPPADCG_BC_OP(name): { \
+            r[pc[1]] = (r[pc[2]] cmp r[pc[3]]) ? r[pc[4]] : r[pc[5]]; \
+            pc += 6; \
+            CPPADCG_BC_NEXT(); \
+        }
+
+        CPPADCG_BC_UNARY(Assign, a)
+        CPPADCG_BC_UNARY(Abs, abs(a))
+        CPPADCG_BC_UNARY(Acos, acos(a))
+        CPPADCG_BC_UNARY(Acosh, acosh(a))
+        CPPADCG_BC_UNARY(Asin, asin(a))
+        CPPADCG_BC_UNARY(Asinh, asinh(a))
+        CPPADCG_BC_UNARY(Atan, atan(a))
+        CPPADCG_BC_UNARY(Atanh, atanh(a))
+        CPPADCG_BC_UNARY(Cosh, cosh(a))
+        CPPADCG_BC_UNARY(Cos, cos(a))
+        CPPADCG_BC_UNARY(Erf, erf(a))
+        CPPADCG_BC_UNARY(Erfc, erfc(a))
+        CPPADCG_BC_UNARY(Exp, exp(a))
+        CPPADCG_BC_UNARY(Expm1, expm1(a))
+        CPPADCG_BC_UNARY(Log, log(a))
+        CPPADCG_BC_UNARY(Log1p, log1p(a))
+        CPPADCG_BC_UNARY(Sign, a > Base(0) ? Base(1) : (a == Base(0) ? Base(0) : Base(-1)))
+        CPPADCG_BC_UNARY(Sinh, sinh(a))
+        CPPADCG_BC_UNARY(Sin, sin(a))
+        CPPADCG_BC_UNARY(Sqrt, sqrt(a))
+        CPPADCG_BC_UNARY(Tanh, tanh(a))
+        CPPADCG_BC_UNARY(Tan, tan(a))
+        CPPADCG_BC_UNARY(UnMinus, -a)
+        CPPADCG_BC_BINARY(Add, a + b)
+        CPPADCG_BC_BINARY(Sub, a - b)
+        CPPADCG_BC_BINARY(Mul, a * b)
+        CPPADCG_BC_BINARY(Div, a / b)
+        CPPADCG_BC_BINARY(Pow, pow(a, b))
+        CPPADCG_BC_COMPARE(ComLt, <)
+        CPPADCG_BC_COMPARE(ComLe, <=)
+        CPPADCG_BC_COMPARE(ComEq, ==)
+        CPPADCG_BC_COMPARE(ComGe, >=)
+        CPPADCG_BC_COMPARE(ComGt, >)
+        CPPADCG_BC_COMPARE(ComNe, !=)
+
+        CPPADCG_BC_OP(End):
+            return;
+
+#ifndef CPPADCG_BYTECODE_THREADED_DISPATCH
+                default:
+                    CPPADCG_ASSERT_UNKNOWN(false)
+                    return;
+            }
+        }
+#endif
+
+#undef CPPADCG_BC_COMPARE
+#undef CPPADCG_BC_BINARY
+#undef CPPADCG_BC_UNARY
+#undef CPPADCG_BC_NEXT
+#undef CPPADCG_BC_OP
+    }
+
+};
+
+} // END cg namespace
+} // END CppAD namespace
+
+#endif
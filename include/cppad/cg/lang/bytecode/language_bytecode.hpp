@@ -0,0 +1,285 @@
+#ifndef CPPAD_CG_LANGUAGE_BYTECODE_INCLUDED
+#define CPPAD_CG_LANGUAGE_BYTECODE_INCLUDED
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2020 Joao Leal
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+
+namespace CppAD {
+namespace cg {
+
+/**
+ * Lowers an operation graph into a BytecodeProgram which can be evaluated
+ * without a compiler.
+ * No source code is written to the output stream provided to the
+ * CodeHandler.
+ *
+ * The variable IDs assigned by the CodeHandler (after the reduction of
+ * temporary variables) are used directly as register indexes.
+ * Only scalar operations are supported (no atomic functions, arrays,
+ * loops, or conditional blocks).
+ *
+ * @author Joao Leal
+ */
+template<class Base>
+class LanguageBytecode : public Language<Base> {
+public:
+    using Node = OperationNode<Base>;
+    using Arg = Argument<Base>;
+protected:
+    // the program being created
+    BytecodeProgram<Base>* _program;
+    // the number of independent variables in each input array
+    std::vector<size_t> _inputSizes;
+    // information from the code handler
+    LanguageGenerationData<Base>* _info;
+    // the values of the constants
+    std::vector<Base> _constants;
+    // the register used by each constant
+    std::map<Base, uint32_t> _constantRegister;
+    // the first register used for constants
+    size_t _constantOffset;
+public:
+
+    /**
+     * Creates a bytecode language
+     *
+     * @param program where the bytecode will be saved
+     * @param inputSizes the number of independent variables in each
+     *                   input array (if empty all independent variables
+     *                   are provided in a single array)
+     */
+    explicit LanguageBytecode(BytecodeProgram<Base>& program,
+                              std::vector<size_t> inputSizes = std::vector<size_t>()) :
+        _program(&program),
+        _inputSizes(std::move(inputSizes)),
+        _info(nullptr),
+        _constantOffset(0) {
+    }
+
+    inline virtual ~LanguageBytecode() = default;
+
+protected:
+
+    void generateSourceCode(std::ostream& out,
+                            std::unique_ptr<LanguageGenerationData<Base> > info) override {
+        _info = info.get();
+        _constants.clear();
+        _constantRegister.clear();
+
+        const std::vector<Node*>& variableOrder = _info->variableOrder;
+        size_t n = _info->independent.size();
+
+        if (_inputSizes.empty()) {
+            _inputSizes.push_back(n);
+        }
+        size_t nIn = 0;
+        for (size_t s : _inputSizes)
+            nIn += s;
+        CPPADCG_ASSERT_KNOWN(nIn == n, "The size of the input arrays does not match the number of independent variables")
+
+        /**
+         * the registers of the variables are defined by their IDs
+         */
+        size_t maxId = _info->minTemporaryVarID - 1;
+        for (const Node* node : variableOrder) {
+            maxId = std::max<size_t>(maxId, _info->varId[*node]);
+        }
+        _constantOffset = maxId;
+
+        std::vector<uint32_t>& code = _program->_code;
+        code.clear();
+        code.reserve(variableOrder.size() * 4 + 1);
+
+        for (Node* node : variableOrder) {
+            CGOpCode op = node->getOperationType();
+            const std::vector<Arg>& args = node->getArguments();
+            BytecodeOp bop = getBytecodeOperation(op);
+
+            CPPADCG_ASSERT_KNOWN(args.size() == getBytecodeArgumentCount(bop),
+                                 "Invalid number of arguments for a bytecode operation")
+
+            code.push_back(uint32_t(bop));
+            code.push_back(getVariableRegister(*node));
+            for (const Arg& a : args) {
+                code.push_back(getArgumentRegister(a));
+            }
+        }
+        code.push_back(uint32_t(BytecodeOp::End));
+
+        /**
+         * dependent variables
+         */
+        const ArrayView<CG<Base> >& dependent = _info->dependent;
+        std::vector<uint32_t>& outputs = _program->_outputs;
+        outputs.resize(dependent.size());
+        for (size_t i = 0; i < dependent.size(); ++i) {
+            const CG<Base>& dep = dependent[i];
+            if (dep.getOperationNode() != nullptr) {
+                outputs[i] = getVariableRegister(*dep.getOperationNode());
+            } else {
+                CPPADCG_ASSERT_KNOWN(dep.isParameter(), "Invalid dependent variable")
+                outputs[i] = getConstantRegister(dep.getValue());
+            }
+        }
+
+        /**
+         * constants
+         */
+        _program->_registerCount = _constantOffset + _constants.size();
+        _program->_constants.swap(_constants);
+        _program->_inputSizes = _inputSizes;
+
+        _info = nullptr;
+    }
+
+    bool createsNewVariable(const Node& var,
+                            size_t totalUseCount,
+                            size_t opCount) const override {
+        // every operation writes its result into a register
+        return true;
+    }
+
+    bool requiresVariableArgument(enum CGOpCode op,
+                                  size_t argIndex) const override {
+        return false;
+    }
+
+    bool requiresVariableDependencies() const override {
+        return false;
+    }
+
+    inline uint32_t getVariableRegister(const Node& node) const {
+        size_t id = _info->varId[node];
+        CPPADCG_ASSERT_UNKNOWN(id > 0 && id <= _constantOffset)
+        return toRegister(id - 1);
+    }
+
+    inline uint32_t getArgumentRegister(const Arg& arg) {
+        if (arg.getParameter() != nullptr) {
+            return getConstantRegister(*arg.getParameter());
+        }
+
+        const Node* node = arg.getOperation();
+        CPPADCG_ASSERT_UNKNOWN(node != nullptr)
+        // aliases are always followed
+        while (node->getOperationType() == CGOpCode::Alias) {
+            node = node->getArguments()[0].getOperation();
+        }
+        return getVariableRegister(*node);
+    }
+
+    inline uint32_t getConstantRegister(const Base& value) {
+        bool isNaN = value != value; // cannot be used as a key
+        if (!isNaN) {
+            auto it = _constantRegister.find(value);
+            if (it != _constantRegister.end())
+                return it->second;
+        }
+
+        uint32_t r = toRegister(_constantOffset + _constants.size());
+        _constants.push_back(value);
+        if (!isNaN)
+            _constantRegister[value] = r;
+        return r;
+    }
+
+    static inline uint32_t toRegister(size_t r) {
+        if (r >= (std::numeric_limits<uint32_t>::max)()) {
+            throw CGException("Too many variables for the bytecode interpreter");
+        }
+        return uint32_t(r);
+    }
+
+    static inline BytecodeOp getBytecodeOperation(CGOpCode op) {
+        switch (op) {
+            case CGOpCode::Alias:
+            case CGOpCode::Assign:
+                return BytecodeOp::Assign;
+            case CGOpCode::Abs:
+                return BytecodeOp::Abs;
+            case CGOpCode::Acos:
+                return BytecodeOp::Acos;
+            case CGOpCode::Acosh:
+                return BytecodeOp::Acosh;
+            case CGOpCode::Asin:
+                return BytecodeOp::Asin;
+            case CGOpCode::Asinh:
+                return BytecodeOp::Asinh;
+            case CGOpCode::Atan:
+                return BytecodeOp::Atan;
+            case CGOpCode::Atanh:
+                return BytecodeOp::Atanh;
+            case CGOpCode::Cosh:
+                return BytecodeOp::Cosh;
+            case CGOpCode::Cos:
+                return BytecodeOp::Cos;
+            case CGOpCode::Erf:
+                return BytecodeOp::Erf;
+            case CGOpCode::Erfc:
+                return BytecodeOp::Erfc;
+            case CGOpCode::Exp:
+                return BytecodeOp::Exp;
+            case CGOpCode::Expm1:
+                return BytecodeOp::Expm1;
+            case CGOpCode::Log:
+                return BytecodeOp::Log;
+            case CGOpCode::Log1p:
+                return BytecodeOp::Log1p;
+            case CGOpCode::Sign:
+                return BytecodeOp::Sign;
+            case CGOpCode::Sinh:
+                return BytecodeOp::Sinh;
+            case CGOpCode::Sin:
+                return BytecodeOp::Sin;
+            case CGOpCode::Sqrt:
+                return BytecodeOp::Sqrt;
+            case CGOpCode::Tanh:
+                return BytecodeOp::Tanh;
+            case CGOpCode::Tan:
+                return BytecodeOp::Tan;
+            case CGOpCode::UnMinus:
+                return BytecodeOp::UnMinus;
+            case CGOpCode::Add:
+                return BytecodeOp::Add;
+            case CGOpCode::Sub:
+                return BytecodeOp::Sub;
+            case CGOpCode::Mul:
+                return BytecodeOp::Mul;
+            case CGOpCode::Div:
+                return BytecodeOp::Div;
+            case CGOpCode::Pow:
+                return BytecodeOp::Pow;
+            case CGOpCode::ComLt:
+                return BytecodeOp::ComLt;
+            case CGOpCode::ComLe:
+                return BytecodeOp::ComLe;
+            case CGOpCode::ComEq:
+                return BytecodeOp::ComEq;
+            case CGOpCode::ComGe:
+                return BytecodeOp::ComGe;
+            case CGOpCode::ComGt:
+                return BytecodeOp::ComGt;
+            case CGOpCode::ComNe:
+                return BytecodeOp::ComNe;
+            default:
+                throw CGException("Operation '", op, "' is not supported by the bytecode interpreter");
+        }
+    }
+
+};
+
+} // END cg namespace
+} // END CppAD namespace
+
+#endif
@@ -110,6 +110,12 @@ protected:
     std::vector<const LoopStartOperationNode<Base>*> _currentLoops;
     // the maximum precision used to print values
     size_t _parameterPrecision;
+    // atomic functions called directly (maps atomic function names to the prefix of their C functions)
+    std::map<std::string, std::string> _directAtomicFunctions;
+    // whether or not to generate code which helps compilers to vectorize loops
+    bool _loopVectorization;
+    // the temporary variables declared inside each loop which can be vectorized
+    std::map<const LoopStartOperationNode<Base>*, std::vector<std::string> > _vectorizedLoops;
 private:
     std::vector<std::string> funcArgDcl_;
     std::vector<std::string> localFuncArgDcl_;
@@ -142,7 +148,8 @@ public:
         _maxAssignmentsPerFunction(0),
         _maxOperationsPerAssignment((std::numeric_limits<size_t>::max)()),
         _sources(nullptr),
-        _parameterPrecision(std::numeric_limits<Base>::digits10) {
+        _parameterPrecision(std::numeric_limits<Base>::digits10),
+        _loopVectorization(false) {
     }
 
     inline virtual ~LanguageC() = default;
@@ -238,6 +245,52 @@ public:
         _parameterPrecision = p;
     }
 
+    /**
+     * Defines atomic functions which are called directly by the generated
+     * code instead of through the LangCAtomicFun structure (e.g. other
+     * models compiled into the same library).
+     * For each of these atomic functions the following C functions must
+     * be available:
+     *  - int <prefix>_forward(int q, int p, const Array tx[], Array* ty,
+     *                         struct LangCAtomicFun atomicFun)
+     *  - int <prefix>_reverse(int p, const Array tx[], Array* px,
+     *                         const Array py[], struct LangCAtomicFun atomicFun)
+     *
+     * @param functions maps the atomic function names to the prefix of the
+     *                  C functions
+     */
+    inline void setDirectAtomicFunctions(const std::map<std::string, std::string>& functions) {
+        _directAtomicFunctions = functions;
+    }
+
+    inline const std::map<std::string, std::string>& getDirectAtomicFunctions() const {
+        return _directAtomicFunctions;
+    }
+
+    /**
+     * Whether or not the generated code helps compilers to vectorize loops.
+     */
+    inline bool isLoopVectorization() const {
+        return _loopVectorization;
+    }
+
+    /**
+     * Defines whether or not to generate code which helps compilers to
+     * vectorize loops (e.g. created from patterns in the model equations).
+     * Loops which only evaluate expressions and assign a different element
+     * of the dependent variables in each iteration are marked as free of
+     * loop-carried dependencies and their temporary variables are declared
+     * inside the loop.
+     * The arrays with the independent and dependent variables are declared
+     * as restrict pointers and, therefore, the input and output arrays
+     * provided to the generated functions must not overlap.
+     *
+     * @param vectorize whether or not to generate vectorization hints
+     */
+    inline void setLoopVectorization(bool vectorize) {
+        _loopVectorization = vectorize;
+    }
+
     /**
      * Defines the maximum number of assignment per generated function.
      * Zero means it is disabled (no limit).
@@ -421,7 +474,7 @@ public:
 
         _ss << _spaces << "//dependent variables\n";
         for (size_t i = 0; i < depArg.size(); i++) {
-            _ss << _spaces << argumentDeclaration(depArg[i]) << " = " << _outArgName << "[" << i << "];\n";
+            _ss << _spaces << noAliasArgumentDeclaration(depArg[i]) << " = " << _outArgName << "[" << i << "];\n";
         }
 
         std::string code = _ss.str();
@@ -436,7 +489,7 @@ public:
 
         _ss << _spaces << "//independent variables\n";
         for (size_t i = 0; i < indArg.size(); i++) {
-            _ss << _spaces << "const " << argumentDeclaration(indArg[i]) << " = " << _inArgName << "[" << i << "];\n";
+            _ss << _spaces << "const " << noAliasArgumentDeclaration(indArg[i]) << " = " << _inArgName << "[" << i << "];\n";
         }
 
         std::string code = _ss.str();
@@ -679,6 +732,7 @@ protected:
         _atomicFuncArrays.clear();
         _streamStack.clear();
         _dependentIDs.clear();
+        _vectorizedLoops.clear();
 
         // save some info
         _info = std::move(info);
@@ -805,6 +859,9 @@ protected:
                 }
             }
 
+            // temporary variables which are local to loops
+            prepareVectorizedLoops(variableOrder);
+
             /**
              * Source code generation magic!
              */
@@ -864,7 +921,7 @@ protected:
             CPPADCG_ASSERT_KNOWN(tmpArg[0].array,
                                  "The temporary variables must be saved in an array in order to generate multiple functions")
 
-            _code << ATOMICFUN_STRUCT_DEFINITION << "\n\n";
+            printSourceHeader(_code);
             // forward declarations
             std::string localFuncArgDcl2 = implode(localFuncArgDcl_, ", ");
             for (auto & localFuncName : localFuncNames) {
@@ -927,9 +984,7 @@ protected:
          */
         if (createFunction) {
             if (localFuncNames.empty()) {
-                _ss << "#include <math.h>\n"
-                        "#include <stdio.h>\n\n"
-                    << ATOMICFUN_STRUCT_DEFINITION << "\n\n";
+                printSourceHeader(_ss);
                 printFunctionDeclaration(_ss, "void", _functionName, funcArgDcl_);
                 _ss << " {\n";
                 _nameGen->customFunctionVariableDeclarations(_ss);
@@ -1037,6 +1092,31 @@ protected:
         _streamStack << ";\n";
     }
 
+    /**
+     * Prints the includes and the type definitions required by each
+     * generated source file.
+     */
+    virtual void printSourceHeader(std::ostringstream& out) {
+        out << "#include <math.h>\n"
+               "#include <stdio.h>\n\n"
+            << ATOMICFUN_STRUCT_DEFINITION << "\n\n";
+
+        if (_info != nullptr && !_directAtomicFunctions.empty()) {
+            bool declared = false;
+            for (const auto& it : _info->atomicFunctionId2Name) {
+                auto itDirect = _directAtomicFunctions.find(it.second);
+                if (itDirect == _directAtomicFunctions.end())
+                    continue;
+                const std::string& prefix = itDirect->second;
+                out << "int " << prefix << "_forward(int q, int p, const Array tx[], Array* ty, " << generateArgumentAtomicDcl() << ");\n"
+                       "int " << prefix << "_reverse(int p, const Array tx[], Array* px, const Array py[], " << generateArgumentAtomicDcl() << ");\n";
+                declared = true;
+            }
+            if (declared)
+                out << "\n";
+        }
+    }
+
     virtual std::string argumentDeclaration(const FuncArgument& funcArg) const {
         std::string dcl = _baseTypeName;
         if (funcArg.array) {
@@ -1045,15 +1125,25 @@ protected:
         return dcl + " " + funcArg.name;
     }
 
+    /**
+     * Declaration of an array which is not accessed through any other
+     * pointer in the generated function (restrict) when loop vectorization
+     * is enabled.
+     */
+    virtual std::string noAliasArgumentDeclaration(const FuncArgument& funcArg) const {
+        if (!_loopVectorization || !funcArg.array)
+            return argumentDeclaration(funcArg);
+
+        return _baseTypeName + "* __restrict " + funcArg.name;
+    }
+
     virtual void saveLocalFunction(std::vector<std::string>& localFuncNames,
                                    bool zeroDependentArray) {
         _ss << _functionName << "__" << (localFuncNames.size() + 1);
         std::string funcName = _ss.str();
         _ss.str("");
 
-        _ss << "#include <math.h>\n"
-                "#include <stdio.h>\n\n"
-                << ATOMICFUN_STRUCT_DEFINITION << "\n\n";
+        printSourceHeader(_ss);
         printFunctionDeclaration(_ss, "void", funcName, localFuncArgDcl_);
         _ss << " {\n";
         _nameGen->customFunctionVariableDeclarations(_ss);
@@ -1818,11 +1908,21 @@ protected:
         printArrayStructInit(_ATOMIC_TY, *ty[p]); // also does indentation
         _ss.str("");
 
-        _streamStack << _indentation << "atomicFun.forward(atomicFun.libModel, "
-                     << atomicIndex << ", " << q << ", " << p << ", "
-                     << _ATOMIC_TX << ", &" << _ATOMIC_TY << "); // "
-                     << _info->atomicFunctionId2Name.at(id)
-                     << "\n";
+        const std::string& atomicName = _info->atomicFunctionId2Name.at(id);
+        auto itDirect = _directAtomicFunctions.find(atomicName);
+        if (itDirect != _directAtomicFunctions.end()) {
+            _streamStack << _indentation << itDirect->second << "_forward("
+                         << q << ", " << p << ", "
+                         << _ATOMIC_TX << ", &" << _ATOMIC_TY << ", " << _atomicArgName << "); // "
+                         << atomicName
+                         << "\n";
+        } else {
+            _streamStack << _indentation << "atomicFun.forward(atomicFun.libModel, "
+                         << atomicIndex << ", " << q << ", " << p << ", "
+                         << _ATOMIC_TX << ", &" << _ATOMIC_TY << "); // "
+                         << atomicName
+                         << "\n";
+        }
 
         /**
          * the values of ty are now changed
@@ -1866,11 +1966,21 @@ protected:
         printArrayStructInit(_ATOMIC_PX, *px[0]); // also does indentation
         _ss.str("");
 
-        _streamStack << _indentation << "atomicFun.reverse(atomicFun.libModel, "
-                     << atomicIndex << ", " << p << ", "
-                     << _ATOMIC_TX << ", &" << _ATOMIC_PX << ", " << _ATOMIC_PY << "); // "
-                     << _info->atomicFunctionId2Name.at(id)
-                     << "\n";
+        const std::string& atomicName = _info->atomicFunctionId2Name.at(id);
+        auto itDirect = _directAtomicFunctions.find(atomicName);
+        if (itDirect != _directAtomicFunctions.end()) {
+            _streamStack << _indentation << itDirect->second << "_reverse("
+                         << p << ", "
+                         << _ATOMIC_TX << ", &" << _ATOMIC_PX << ", " << _ATOMIC_PY << ", " << _atomicArgName << "); // "
+                         << atomicName
+                         << "\n";
+        } else {
+            _streamStack << _indentation << "atomicFun.reverse(atomicFun.libModel, "
+                         << atomicIndex << ", " << p << ", "
+                         << _ATOMIC_TX << ", &" << _ATOMIC_PX << ", " << _ATOMIC_PY << "); // "
+                         << atomicName
+                         << "\n";
+        }
 
         /**
          * the values of px are now changed
@@ -1917,11 +2027,20 @@ protected:
             iterationCount = oss.str();
         }
 
+        auto itVec = _vectorizedLoops.find(&lnode);
+        if (itVec != _vectorizedLoops.end()) {
+            printLoopVectorizationHint();
+        }
+
         _streamStack << _spaces << "for("
                      << jj << " = 0; "
                      << jj << " < " << iterationCount << "; "
                      << jj << "++) {\n";
         _indentation += _spaces;
+
+        if (itVec != _vectorizedLoops.end() && !itVec->second.empty()) {
+            _streamStack << _indentation << _baseTypeName << " " << implode(itVec->second, ", ") << ";\n";
+        }
     }
 
     virtual void pushLoopEnd(Node& node) {
@@ -1935,6 +2054,47 @@ protected:
     }
 
 
+    /**
+     * Determines the loops which can be vectorized and declares their
+     * temporary variables inside the loop so that there are no
+     * dependencies between iterations.
+     */
+    virtual void prepareVectorizedLoops(const std::vector<Node*>& variableOrder);
+
+    /**
+     * Whether or not the iterations of a loop are independent.
+     *
+     * @param variableOrder the variable evaluation order
+     * @param start the position of the loop start in variableOrder
+     * @param end the position of the loop end in variableOrder
+     * @param lastUsage the last position in variableOrder where each
+     *                  variable is used
+     * @param temporaries the temporary variables assigned inside the loop
+     *                    (output)
+     */
+    virtual bool isVectorizableLoop(const std::vector<Node*>& variableOrder,
+                                    size_t start,
+                                    size_t end,
+                                    const std::map<const Node*, size_t>& lastUsage,
+                                    std::vector<Node*>& temporaries) const;
+
+    static inline void markLastUsage(const Node& node,
+                                     size_t pos,
+                                     const std::set<const Node*>& assigned,
+                                     std::map<const Node*, size_t>& lastUsage);
+
+    /**
+     * Prints the directives which allow compilers to vectorize the next
+     * loop without checking for dependencies between iterations.
+     */
+    virtual void printLoopVectorizationHint() {
+        _streamStack << "#if defined(__clang__)\n"
+                        "#pragma clang loop vectorize(assume_safety)\n"
+                        "#elif defined(__GNUC__)\n"
+                        "#pragma GCC ivdep\n"
+                        "#endif\n";
+    }
+
     virtual size_t printLoopIndexDeps(const std::vector<Node*>& variableOrder,
                                       size_t pos);
 
@@ -0,0 +1,387 @@
+#ifndef CPPAD_CG_LANGUAGE_C_LANES_INCLUDED
+#define CPPAD_CG_LANGUAGE_C_LANES_INCLUDED
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2020 Joao Leal
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+
+namespace CppAD {
+namespace cg {
+
+/**
+ * Generates C code where each variable is a vector of lanes (GCC/Clang
+ * vector extensions) so that a single call evaluates the model at several
+ * points simultaneously.
+ *
+ * The independent and dependent arrays contain one lane vector per
+ * variable: the value of variable j for point l is in[0][j][l].
+ * Lane vectors only require the alignment of the scalar type.
+ *
+ * Atomic functions are not supported.
+ *
+ * @author Joao Leal
+ */
+template<class Base>
+class LanguageCLanes : public LanguageC<Base> {
+public:
+    using Node = OperationNode<Base>;
+    using Arg = Argument<Base>;
+protected:
+    // the scalar type name (e.g. "double")
+    const std::string _scalarTypeName;
+    // the number of points evaluated simultaneously
+    const size_t _lanes;
+public:
+
+    /**
+     * Creates a C language source code generator which uses lane vectors
+     *
+     * @param scalarTypeName scalar data type (e.g. double)
+     * @param lanes the number of points evaluated simultaneously
+     *              (must be a power of 2)
+     * @param spaces number of spaces for indentations
+     */
+    explicit LanguageCLanes(const std::string& scalarTypeName,
+                            size_t lanes,
+                            size_t spaces = 3) :
+        LanguageC<Base>(createLaneTypeName(scalarTypeName, lanes), spaces),
+        _scalarTypeName(scalarTypeName),
+        _lanes(lanes) {
+        CPPADCG_ASSERT_KNOWN(lanes > 0 && (lanes & (lanes - 1)) == 0,
+                             "The number of lanes must be a power of 2")
+    }
+
+    /**
+     * @return the number of points evaluated simultaneously
+     */
+    inline size_t getLanes() const {
+        return _lanes;
+    }
+
+    /**
+     * @return the scalar type name (e.g. "double")
+     */
+    inline const std::string& getScalarTypeName() const {
+        return _scalarTypeName;
+    }
+
+    /**
+     * @return the name of the lane vector type used in the generated code
+     */
+    inline const std::string& getLaneTypeName() const {
+        return this->_baseTypeName;
+    }
+
+    static inline std::string createLaneTypeName(const std::string& scalarTypeName,
+                                                 size_t lanes) {
+        std::string name = "cppadcg_" + scalarTypeName + std::to_string(lanes);
+        std::replace(name.begin(), name.end(), ' ', '_');
+        return name;
+    }
+
+protected:
+
+    void printSourceHeader(std::ostringstream& out) override {
+        const std::string& t = this->_baseTypeName;
+
+        out << "#include <math.h>\n"
+               "#include <stdio.h>\n\n";
+
+        out << "typedef " << _scalarTypeName << " " << t
+            << " __attribute__((vector_size(" << _lanes * sizeof(Base) << "), aligned(" << sizeof(Base) << ")));\n\n";
+
+        // broadcast
+        out << "static inline " << t << " " << t << "_set(" << _scalarTypeName << " v) {\n"
+               "   " << t << " r = {";
+        for (size_t l = 0; l < _lanes; ++l) {
+            if (l > 0) out << ", ";
+            out << "v";
+        }
+        out << "};\n"
+               "   return r;\n"
+               "}\n\n";
+
+        for (CGOpCode op : unaryFunctions()) {
+            printLaneFunction(out, functionSuffix(op), 1, scalarFunctionName(op) + "(a[l])");
+        }
+        printLaneFunction(out, "pow", 2, this->powFuncName() + "(a[l], b[l])");
+        printLaneFunction(out, "sign", 1, "a[l] > 0 ? 1 : (a[l] < 0 ? -1 : 0)");
+
+        for (CGOpCode op : {CGOpCode::ComLt, CGOpCode::ComLe, CGOpCode::ComEq,
+                            CGOpCode::ComGe, CGOpCode::ComGt, CGOpCode::ComNe}) {
+            printLaneFunction(out, comparisonSuffix(op), 4,
+                              "a[l] " + this->getComparison(op) + " b[l] ? c[l] : d[l]");
+        }
+
+        out << LanguageC<Base>::ATOMICFUN_STRUCT_DEFINITION << "\n\n";
+    }
+
+    void pushUnaryFunction(Node& op) override {
+        CPPADCG_ASSERT_KNOWN(op.getArguments().size() == 1, "Invalid number of arguments for unary function")
+
+        this->_streamStack << laneFunctionName(functionSuffix(op.getOperationType())) << "(";
+        this->push(op.getArguments()[0]);
+        this->_streamStack << ")";
+    }
+
+    void pushPowFunction(Node& op) override {
+        CPPADCG_ASSERT_KNOWN(op.getArguments().size() == 2, "Invalid number of arguments for pow() function")
+
+        this->_streamStack << laneFunctionName("pow") << "(";
+        this->push(op.getArguments()[0]);
+        this->_streamStack << ", ";
+        this->push(op.getArguments()[1]);
+        this->_streamStack << ")";
+    }
+
+    void pushSignFunction(Node& op) override {
+        CPPADCG_ASSERT_KNOWN(op.getArguments().size() == 1, "Invalid number of arguments for sign() function")
+
+        this->_streamStack << laneFunctionName("sign") << "(";
+        this->push(op.getArguments()[0]);
+        this->_streamStack << ")";
+    }
+
+    /**
+     * Conditional expressions select the value of each lane without
+     * branching.
+     */
+    void pushConditionalAssignment(Node& node) override {
+        CPPADCG_ASSERT_UNKNOWN(this->getVariableID(node) > 0)
+
+        const std::vector<Arg>& args = node.getArguments();
+        CPPADCG_ASSERT_KNOWN(args.size() == 4, "Invalid number of arguments for a conditional expression")
+
+        bool isDep = this->isDependent(node);
+        const std::string& varName = this->createVariableName(node);
+
+        this->pushAssignmentStart(node, varName, isDep);
+        this->_streamStack << laneFunctionName(comparisonSuffix(node.getOperationType())) << "(";
+        for (size_t a = 0; a < 4; ++a) {
+            if (a > 0) this->_streamStack << ", ";
+            this->push(args[a]);
+        }
+        this->_streamStack << ")";
+        this->pushAssignmentEnd(node);
+    }
+
+    void pushPrintOperation(const Node& node) override {
+        CPPADCG_ASSERT_KNOWN(node.getOperationType() == CGOpCode::Pri, "Invalid node type")
+        CPPADCG_ASSERT_KNOWN(node.getArguments().size() >= 1, "Invalid number of arguments for print operation")
+
+        const auto& pnode = static_cast<const PrintOperationNode<Base>&> (node);
+        std::string before = pnode.getBeforeString();
+        replaceString(before, "\n", "\\n");
+        replaceString(before, "\"", "\\\"");
+        std::string after = pnode.getAfterString();
+        replaceString(after, "\n", "\\n");
+        replaceString(after, "\"", "\\\"");
+
+        // one print per lane
+        const std::vector<Arg>& args = pnode.getArguments();
+        for (size_t l = 0; l < _lanes; l++) {
+            this->_streamStack << this->_indentation << "fprintf(stderr, \"" << before << this->getPrintfBaseFormat() << after << "\"";
+            for (size_t a = 0; a < args.size(); a++) {
+                this->_streamStack << ", (";
+                this->push(args[a]);
+                this->_streamStack << ")[" << l << "]";
+            }
+            this->_streamStack << ");\n";
+        }
+    }
+
+    void pushAtomicForwardOp(Node& atomicFor) override {
+        throw CGException("Atomic functions are not supported by lane vectors (", this->_baseTypeName, ")");
+    }
+
+    void pushAtomicReverseOp(Node& atomicRev) override {
+        throw CGException("Atomic functions are not supported by lane vectors (", this->_baseTypeName, ")");
+    }
+
+    void printParameter(const Base& value) override {
+        this->_code << this->_baseTypeName << "_set(";
+        this->writeParameter(value, this->_code);
+        this->_code << ")";
+    }
+
+    void pushParameter(const Base& value) override {
+        this->_streamStack << this->_baseTypeName << "_set(";
+        this->writeParameter(value, this->_streamStack);
+        this->_streamStack << ")";
+    }
+
+    inline std::string laneFunctionName(const std::string& suffix) const {
+        return this->_baseTypeName + "_" + suffix;
+    }
+
+    /**
+     * Prints a function which applies an expression to each lane.
+     * The arguments are named a, b, c, and d.
+     */
+    inline void printLaneFunction(std::ostringstream& out,
+                                  const std::string& suffix,
+                                  size_t nArgs,
+                                  const std::string& expression) const {
+        const std::string& t = this->_baseTypeName;
+
+        out << "static inline " << t << " " << laneFunctionName(suffix) << "(";
+        for (size_t a = 0; a < nArgs; ++a) {
+            if (a > 0) out << ", ";
+            out << t << " " << char('a' + a);
+        }
+        out << ") {\n"
+               "   " << t << " r;\n"
+               "   int l;\n"
+               "   for(l = 0; l < " << _lanes << "; l++) r[l] = " << expression << ";\n"
+               "   return r;\n"
+               "}\n\n";
+    }
+
+    static inline const std::vector<CGOpCode>& unaryFunctions() {
+        static const std::vector<CGOpCode> ops{CGOpCode::Abs, CGOpCode::Acos, CGOpCode::Asin, CGOpCode::Atan,
+                                               CGOpCode::Cosh, CGOpCode::Cos, CGOpCode::Exp, CGOpCode::Log,
+                                               CGOpCode::Sinh, CGOpCode::Sin, CGOpCode::Sqrt, CGOpCode::Tanh,
+                                               CGOpCode::Tan
+#if CPPAD_USE_CPLUSPLUS_2011
+                                               , CGOpCode::Erf, CGOpCode::Erfc, CGOpCode::Asinh, CGOpCode::Acosh,
+                                               CGOpCode::Atanh, CGOpCode::Expm1, CGOpCode::Log1p
+#endif
+        };
+        return ops;
+    }
+
+    static inline std::string functionSuffix(CGOpCode op) {
+        switch (op) {
+            case CGOpCode::Abs:
+                return "abs";
+            case CGOpCode::Acos:
+                return "acos";
+            case CGOpCode::Asin:
+                return "asin";
+            case CGOpCode::Atan:
+                return "atan";
+            case CGOpCode::Cosh:
+                return "cosh";
+            case CGOpCode::Cos:
+                return "cos";
+            case CGOpCode::Exp:
+                return "exp";
+            case CGOpCode::Log:
+                return "log";
+            case CGOpCode::Sinh:
+                return "sinh";
+            case CGOpCode::Sin:
+                return "sin";
+            case CGOpCode::Sqrt:
+                return "sqrt";
+            case CGOpCode::Tanh:
+                return "tanh";
+            case CGOpCode::Tan:
+                return "tan";
+#if CPPAD_USE_CPLUSPLUS_2011
+            case CGOpCode::Erf:
+                return "erf";
+            case CGOpCode::Erfc:
+                return "erfc";
+            case CGOpCode::Asinh:
+                return "asinh";
+            case CGOpCode::Acosh:
+                return "acosh";
+            case CGOpCode::Atanh:
+                return "atanh";
+            case CGOpCode::Expm1:
+                return "expm1";
+            case CGOpCode::Log1p:
+                return "log1p";
+#endif
+            default:
+                throw CGException("Unknown function name for operation code '", op, "'.");
+        }
+    }
+
+    /**
+     * @return the name of the scalar function used by each lane
+     */
+    inline const std::string& scalarFunctionName(CGOpCode op) {
+        switch (op) {
+            case CGOpCode::Abs:
+                return this->absFuncName();
+            case CGOpCode::Acos:
+                return this->acosFuncName();
+            case CGOpCode::Asin:
+                return this->asinFuncName();
+            case CGOpCode::Atan:
+                return this->atanFuncName();
+            case CGOpCode::Cosh:
+                return this->coshFuncName();
+            case CGOpCode::Cos:
+                return this->cosFuncName();
+            case CGOpCode::Exp:
+                return this->expFuncName();
+            case CGOpCode::Log:
+                return this->logFuncName();
+            case CGOpCode::Sinh:
+                return this->sinhFuncName();
+            case CGOpCode::Sin:
+                return this->sinFuncName();
+            case CGOpCode::Sqrt:
+                return this->sqrtFuncName();
+            case CGOpCode::Tanh:
+                return this->tanhFuncName();
+            case CGOpCode::Tan:
+                return this->tanFuncName();
+#if CPPAD_USE_CPLUSPLUS_2011
+            case CGOpCode::Erf:
+                return this->erfFuncName();
+            case CGOpCode::Erfc:
+                return this->erfcFuncName();
+            case CGOpCode::Asinh:
+                return this->asinhFuncName();
+            case CGOpCode::Acosh:
+                return this->acoshFuncName();
+            case CGOpCode::Atanh:
+                return this->atanhFuncName();
+            case CGOpCode::Expm1:
+                return this->expm1FuncName();
+            case CGOpCode::Log1p:
+                return this->log1pFuncName();
+#endif
+            default:
+                throw CGException("Unknown function name for operation code '", op, "'.");
+        }
+    }
+
+    static inline std::string comparisonSuffix(CGOpCode op) {
+        switch (op) {
+            case CGOpCode::ComLt:
+                return "lt";
+            case CGOpCode::ComLe:
+                return "le";
+            case CGOpCode::ComEq:
+                return "eq";
+            case CGOpCode::ComGe:
+                return "ge";
+            case CGOpCode::ComGt:
+                return "gt";
+            case CGOpCode::ComNe:
+                return "ne";
+            default:
+                throw CGException("Invalid comparison operator code '", op, "'.");
+        }
+    }
+};
+
+} // END cg namespace
+} // END CppAD namespace
+
+#endif
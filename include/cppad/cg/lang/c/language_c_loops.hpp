@@ -19,6 +19,132 @@
 namespace CppAD {
 namespace cg {
 
+template<class Base>
+void LanguageC<Base>::prepareVectorizedLoops(const std::vector<OperationNode<Base>*>& variableOrder) {
+    if (!_loopVectorization)
+        return;
+
+    const std::vector<FuncArgument>& tmpArg = _nameGen->getTemporary();
+    if (!tmpArg[0].array)
+        return; // temporary variables are already local variables
+
+    std::map<const OperationNode<Base>*, size_t> lastUsage;
+    bool lastUsageDetermined = false;
+
+    std::vector<size_t> loopStarts;
+    std::vector<OperationNode<Base>*> temporaries;
+
+    for (size_t i = 0; i < variableOrder.size(); ++i) {
+        CGOpCode op = variableOrder[i]->getOperationType();
+        if (op == CGOpCode::LoopStart) {
+            loopStarts.push_back(i);
+            continue;
+        } else if (op != CGOpCode::LoopEnd) {
+            continue;
+        }
+
+        CPPADCG_ASSERT_UNKNOWN(!loopStarts.empty())
+        size_t start = loopStarts.back();
+        loopStarts.pop_back();
+
+        if (!lastUsageDetermined) {
+            std::set<const OperationNode<Base>*> assigned(variableOrder.begin(), variableOrder.end());
+            for (size_t p = 0; p < variableOrder.size(); ++p) {
+                markLastUsage(*variableOrder[p], p, assigned, lastUsage);
+            }
+            lastUsageDetermined = true;
+        }
+
+        temporaries.clear();
+        if (!isVectorizableLoop(variableOrder, start, i, lastUsage, temporaries))
+            continue;
+
+        // the same variable ID is always associated with the same local variable
+        std::map<size_t, std::string> localNames;
+        for (OperationNode<Base>* node : temporaries) {
+            size_t id = getVariableID(*node);
+            std::string& name = localNames[id];
+            if (name.empty())
+                name = tmpArg[0].name + "_" + std::to_string(id);
+            node->setName(name);
+        }
+
+        const auto& loopStart = static_cast<const LoopStartOperationNode<Base>&> (*variableOrder[start]);
+        std::vector<std::string>& names = _vectorizedLoops[&loopStart];
+        for (const auto& it : localNames)
+            names.push_back(it.second);
+    }
+}
+
+template<class Base>
+bool LanguageC<Base>::isVectorizableLoop(const std::vector<OperationNode<Base>*>& variableOrder,
+                                         size_t start,
+                                         size_t end,
+                                         const std::map<const OperationNode<Base>*, size_t>& lastUsage,
+                                         std::vector<OperationNode<Base>*>& temporaries) const {
+    for (size_t i = start + 1; i < end; ++i) {
+        OperationNode<Base>* node = variableOrder[i];
+
+        switch (node->getOperationType()) {
+            case CGOpCode::LoopIndexedDep:
+                if (node->getInfo()[1] == 1)
+                    return false; // several iterations can add to the same element
+                continue;
+            case CGOpCode::LoopStart: // nested loop
+            case CGOpCode::LoopEnd:
+            case CGOpCode::AtomicForward:
+            case CGOpCode::AtomicReverse:
+            case CGOpCode::ArrayCreation:
+            case CGOpCode::SparseArrayCreation:
+            case CGOpCode::ArrayElement:
+            case CGOpCode::TmpDcl:
+            case CGOpCode::LoopIndexedTmp: // accumulation across iterations
+            case CGOpCode::Pri:
+            case CGOpCode::StartIf:
+            case CGOpCode::ElseIf:
+            case CGOpCode::Else:
+            case CGOpCode::EndIf:
+            case CGOpCode::CondResult:
+            case CGOpCode::DependentMultiAssign:
+            case CGOpCode::DependentRefRhs:
+                return false;
+            default:
+                break;
+        }
+
+        if (isDependent(*node))
+            return false; // the same element would be assigned in every iteration
+
+        if (requiresVariableName(*node)) {
+            auto it = lastUsage.find(node);
+            if (it != lastUsage.end() && it->second >= end)
+                return false; // also used after the loop
+
+            temporaries.push_back(node);
+        }
+    }
+
+    return true;
+}
+
+template<class Base>
+void LanguageC<Base>::markLastUsage(const OperationNode<Base>& node,
+                                    size_t pos,
+                                    const std::set<const OperationNode<Base>*>& assigned,
+                                    std::map<const OperationNode<Base>*, size_t>& lastUsage) {
+    for (const Argument<Base>& arg : node.getArguments()) {
+        const OperationNode<Base>* a = arg.getOperation();
+        if (a == nullptr)
+            continue;
+
+        if (assigned.find(a) != assigned.end()) {
+            lastUsage[a] = pos;
+        } else {
+            markLastUsage(*a, pos, assigned, lastUsage); // printed inside the expression of node
+        }
+    }
+}
+
 template<class Base>
 void LanguageC<Base>::pushLoopIndexedDep(OperationNode <Base>& node) {
     CPPADCG_ASSERT_KNOWN(node.getArguments().size() >= 1, "Invalid number of arguments for loop indexed dependent operation")
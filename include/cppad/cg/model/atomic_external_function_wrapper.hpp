@@ -40,17 +40,19 @@ public:
         size_t n = tx[0].size;
 
         CppAD::vector<bool> vx, vy;
+        // local buffers so that the model can be evaluated by several threads
+        CppAD::vector<Base> tx2, ty2;
 
-        convert(tx, libModel._tx, n, p, p + 1);
+        convert(tx, tx2, n, p, p + 1);
 
         size_t ty_size = m * (p + 1);
-        libModel._ty.resize(ty_size);
+        ty2.resize(ty_size);
 
-        std::fill(&libModel._ty[0], &libModel._ty[0] + ty_size, Base(0));
+        std::fill(&ty2[0], &ty2[0] + ty_size, Base(0));
 
-        bool ret = atomic_->forward(q, p, vx, vy, libModel._tx, libModel._ty);
+        bool ret = atomic_->forward(q, p, vx, vy, tx2, ty2);
 
-        convertAdd(libModel._ty, ty, m, p, p);
+        convertAdd(ty2, ty, m, p, p);
 
         return ret;
     }
@@ -63,30 +65,32 @@ public:
         size_t m = py[0].size;
         size_t n = tx[0].size;
 
-        convert(tx, libModel._tx, n, p, p + 1);
+        CppAD::vector<Base> tx2, ty2, px2, py2;
 
-        libModel._ty.resize(m * (p + 1));
-        std::fill(&libModel._ty[0], &libModel._ty[0] + libModel._ty.size(), Base(0));
+        convert(tx, tx2, n, p, p + 1);
 
-        convert(py, libModel._py, m, p, p + 1);
+        ty2.resize(m * (p + 1));
+        std::fill(&ty2[0], &ty2[0] + ty2.size(), Base(0));
+
+        convert(py, py2, m, p, p + 1);
 
         size_t px_size = n * (p + 1);
-        libModel._px.resize(px_size);
+        px2.resize(px_size);
 
-        std::fill(&libModel._px[0], &libModel._px[0] + px_size, Base(0));
+        std::fill(&px2[0], &px2[0] + px_size, Base(0));
 
 #ifndef NDEBUG
         if (libModel._evalAtomicForwardOne4CppAD) {
             // only required in order to avoid an issue with a validation inside CppAD
             CppAD::vector<bool> vx, vy;
-            if (!atomic_->forward(p, p, vx, vy, libModel._tx, libModel._ty))
+            if (!atomic_->forward(p, p, vx, vy, tx2, ty2))
                 return false;
         }
 #endif
 
-        bool ret = atomic_->reverse(p, libModel._tx, libModel._ty, libModel._px, libModel._py);
+        bool ret = atomic_->reverse(p, tx2, ty2, px2, py2);
 
-        convertAdd(libModel._px, px, n, p, 0); // k=0 for both p=0 and p=1
+        convertAdd(px2, px, n, p, 0); // k=0 for both p=0 and p=1
 
         return ret;
     }
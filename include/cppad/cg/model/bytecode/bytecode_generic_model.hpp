@@ -0,0 +1,567 @@
+#ifndef CPPAD_CG_BYTECODE_GENERIC_MODEL_INCLUDED
+#define CPPAD_CG_BYTECODE_GENERIC_MODEL_INCLUDED
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2020 Joao Leal
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+
+namespace CppAD {
+namespace cg {
+
+/**
+ * The bytecode programs and sparsity information of a model.
+ * It is shared (read-only) by all the BytecodeGenericModel objects of
+ * the same model.
+ *
+ * @author Joao Leal
+ */
+template<class Base>
+class BytecodeModelData {
+public:
+    std::string name;
+    // number of independent variables
+    size_t n;
+    // number of dependent variables
+    size_t m;
+    // zero order forward mode (null if not available)
+    std::unique_ptr<BytecodeProgram<Base> > zero;
+    // sparse Jacobian (null if not available)
+    std::unique_ptr<BytecodeProgram<Base> > sparseJacobian;
+    std::vector<size_t> jacRows;
+    std::vector<size_t> jacCols;
+    // whether or not the sparse Jacobian contains all the non-zero elements
+    bool fullJacobian;
+    // sparse Hessian (null if not available)
+    std::unique_ptr<BytecodeProgram<Base> > sparseHessian;
+    std::vector<size_t> hessRows;
+    std::vector<size_t> hessCols;
+    // whether or not the sparse Hessian contains all the non-zero elements
+    bool fullHessian;
+public:
+
+    inline BytecodeModelData() :
+        n(0),
+        m(0),
+        fullJacobian(false),
+        fullHessian(false) {
+    }
+
+    inline void save(GraphOutputStream& out) const {
+        out.writeString(name);
+        out.write<uint64_t>(n);
+        out.write<uint64_t>(m);
+        saveProgram(out, zero.get());
+        saveProgram(out, sparseJacobian.get());
+        saveIndexes(out, jacRows);
+        saveIndexes(out, jacCols);
+        out.write<uint8_t>(fullJacobian);
+        saveProgram(out, sparseHessian.get());
+        saveIndexes(out, hessRows);
+        saveIndexes(out, hessCols);
+        out.write<uint8_t>(fullHessian);
+    }
+
+    inline void load(GraphInputStream& in) {
+        name = in.readString();
+        n = size_t(in.read<uint64_t>());
+        m = size_t(in.read<uint64_t>());
+        zero = loadProgram(in);
+        sparseJacobian = loadProgram(in);
+        loadIndexes(in, jacRows, m);
+        loadIndexes(in, jacCols, n);
+        fullJacobian = in.read<uint8_t>() != 0;
+        sparseHessian = loadProgram(in);
+        loadIndexes(in, hessRows, n);
+        loadIndexes(in, hessCols, n);
+        fullHessian = in.read<uint8_t>() != 0;
+
+        checkSizes(zero.get(), n, m);
+        checkSizes(sparseJacobian.get(), n, jacRows.size());
+        checkSizes(sparseHessian.get(), n + m, hessRows.size());
+        if (jacRows.size() != jacCols.size() || hessRows.size() != hessCols.size()) {
+            throw CGException("Invalid bytecode model '", name, "': invalid sparsity");
+        }
+    }
+
+private:
+
+    static inline void saveProgram(GraphOutputStream& out,
+                                   const BytecodeProgram<Base>* program) {
+        out.write<uint8_t>(program != nullptr);
+        if (program != nullptr)
+            program->save(out);
+    }
+
+    static inline std::unique_ptr<BytecodeProgram<Base> > loadProgram(GraphInputStream& in) {
+        std::unique_ptr<BytecodeProgram<Base> > program;
+        if (in.read<uint8_t>()) {
+            program.reset(new BytecodeProgram<Base>());
+            program->load(in);
+        }
+        return program;
+    }
+
+    static inline void saveIndexes(GraphOutputStream& out,
+                                   const std::vector<size_t>& idx) {
+        out.writeSize(idx.size());
+        for (size_t i : idx)
+            out.write<uint64_t>(i);
+    }
+
+    static inline void loadIndexes(GraphInputStream& in,
+                                   std::vector<size_t>& idx,
+                                   size_t size) {
+        idx.resize(in.readSize());
+        for (size_t& i : idx) {
+            i = size_t(in.read<uint64_t>());
+            if (i >= size)
+                throw CGException("Invalid bytecode model: invalid sparsity index");
+        }
+    }
+
+    inline void checkSizes(const BytecodeProgram<Base>* program,
+                           size_t nIn,
+                           size_t nOut) const {
+        if (program == nullptr)
+            return;
+
+        size_t s = 0;
+        for (size_t si : program->getInputSizes())
+            s += si;
+        if (s != nIn || program->getOutputSize() != nOut) {
+            throw CGException("Invalid bytecode model '", name, "': invalid program dimensions");
+        }
+    }
+};
+
+/**
+ * A model evaluated by a bytecode interpreter (no compiler is required).
+ *
+ * Only the zero order forward mode, the Jacobian, and the Hessian (dense
+ * and sparse) are available.
+ * The evaluation methods do not modify the object and the same model
+ * data can be shared by several threads.
+ *
+ * @author Joao Leal
+ */
+template<class Base>
+class BytecodeGenericModel : public GenericModel<Base> {
+protected:
+    std::shared_ptr<const BytecodeModelData<Base> > _data;
+    // no atomic functions are used
+    const std::vector<std::string> _atomicNames;
+public:
+
+    explicit BytecodeGenericModel(std::shared_ptr<const BytecodeModelData<Base> > data) :
+        _data(std::move(data)) {
+        CPPADCG_ASSERT_KNOWN(_data != nullptr, "Invalid model data")
+    }
+
+    BytecodeGenericModel(const BytecodeGenericModel&) = delete;
+    BytecodeGenericModel& operator=(const BytecodeGenericModel&) = delete;
+
+    virtual ~BytecodeGenericModel() = default;
+
+    const std::string& getName() const override {
+        return _data->name;
+    }
+
+    size_t Domain() const override {
+        return _data->n;
+    }
+
+    size_t Range() const override {
+        return _data->m;
+    }
+
+    const std::vector<std::string>& getAtomicFunctionNames() override {
+        return _atomicNames;
+    }
+
+    bool addAtomicFunction(atomic_base<Base>& atomic) override {
+        return false;
+    }
+
+    bool addExternalModel(GenericModel<Base>& atomic) override {
+        return false;
+    }
+
+    // Jacobian sparsity
+    bool isJacobianSparsityAvailable() override {
+        return _data->sparseJacobian != nullptr;
+    }
+
+    std::vector<bool> JacobianSparsityBool() override {
+        CPPADCG_ASSERT_KNOWN(isJacobianSparsityAvailable(), "No Jacobian sparsity available in the bytecode model")
+        return toSparsityBool(_data->m, _data->n, _data->jacRows, _data->jacCols);
+    }
+
+    std::vector<std::set<size_t> > JacobianSparsitySet() override {
+        CPPADCG_ASSERT_KNOWN(isJacobianSparsityAvailable(), "No Jacobian sparsity available in the bytecode model")
+        return toSparsitySet(_data->m, _data->jacRows, _data->jacCols);
+    }
+
+    void JacobianSparsity(std::vector<size_t>& equations,
+                          std::vector<size_t>& variables) override {
+        CPPADCG_ASSERT_KNOWN(isJacobianSparsityAvailable(), "No Jacobian sparsity available in the bytecode model")
+        equations = _data->jacRows;
+        variables = _data->jacCols;
+    }
+
+    // Hessian sparsity
+    bool isHessianSparsityAvailable() override {
+        return _data->sparseHessian != nullptr;
+    }
+
+    std::vector<bool> HessianSparsityBool() override {
+        CPPADCG_ASSERT_KNOWN(isHessianSparsityAvailable(), "No Hessian sparsity available in the bytecode model")
+        return toSparsityBool(_data->n, _data->n, _data->hessRows, _data->hessCols);
+    }
+
+    std::vector<std::set<size_t> > HessianSparsitySet() override {
+        CPPADCG_ASSERT_KNOWN(isHessianSparsityAvailable(), "No Hessian sparsity available in the bytecode model")
+        return toSparsitySet(_data->n, _data->hessRows, _data->hessCols);
+    }
+
+    void HessianSparsity(std::vector<size_t>& rows,
+                         std::vector<size_t>& cols) override {
+        CPPADCG_ASSERT_KNOWN(isHessianSparsityAvailable(), "No Hessian sparsity available in the bytecode model")
+        rows = _data->hessRows;
+        cols = _data->hessCols;
+    }
+
+    bool isEquationHessianSparsityAvailable() override {
+        return false;
+    }
+
+    std::vector<bool> HessianSparsityBool(size_t i) override {
+        throw CGException("The Hessian sparsity of individual equations is not available in bytecode models");
+    }
+
+    std::vector<std::set<size_t> > HessianSparsitySet(size_t i) override {
+        throw CGException("The Hessian sparsity of individual equations is not available in bytecode models");
+    }
+
+    void HessianSparsity(size_t i,
+                         std::vector<size_t>& rows,
+                         std::vector<size_t>& cols) override {
+        throw CGException("The Hessian sparsity of individual equations is not available in bytecode models");
+    }
+
+    /***********************************************************************
+     *                        Forward zero
+     **********************************************************************/
+
+    bool isForwardZeroAvailable() override {
+        return _data->zero != nullptr;
+    }
+
+    void ForwardZero(ArrayView<const Base> x,
+                     ArrayView<Base> dep) override {
+        CPPADCG_ASSERT_KNOWN(_data->zero != nullptr, "No zero order forward mode available in the bytecode model")
+        CPPADCG_ASSERT_KNOWN(dep.size() == _data->m, "Invalid dependent array size")
+        CPPADCG_ASSERT_KNOWN(x.size() == _data->n, "Invalid independent array size")
+
+        const Base* in[1] = {x.data()};
+        _data->zero->evaluate(in, dep.data());
+    }
+
+    void ForwardZero(const std::vector<const Base*>& x,
+                     ArrayView<Base> dep) override {
+        CPPADCG_ASSERT_KNOWN(_data->zero != nullptr, "No zero order forward mode available in the bytecode model")
+        CPPADCG_ASSERT_KNOWN(x.size() == 1, "The number of independent variable arrays is invalid")
+        CPPADCG_ASSERT_KNOWN(dep.size() == _data->m, "Invalid dependent array size")
+
+        _data->zero->evaluate(x.data(), dep.data());
+    }
+
+    void ForwardZero(const CppAD::vector<bool>& vx,
+                     CppAD::vector<bool>& vy,
+                     ArrayView<const Base> tx,
+                     ArrayView<Base> ty) override {
+        ForwardZero(tx, ty);
+
+        if (vx.size() > 0) {
+            CPPADCG_ASSERT_KNOWN(vx.size() >= _data->n, "Invalid vx size")
+            CPPADCG_ASSERT_KNOWN(vy.size() >= _data->m, "Invalid vy size")
+            CPPADCG_ASSERT_KNOWN(isJacobianSparsityAvailable(), "No Jacobian sparsity available in the bytecode model")
+            for (size_t e = 0; e < _data->jacRows.size(); e++) {
+                if (vx[_data->jacCols[e]])
+                    vy[_data->jacRows[e]] = true;
+            }
+        }
+    }
+
+    /***********************************************************************
+     *                        Dense Jacobian and Hessian
+     **********************************************************************/
+
+    bool isJacobianAvailable() override {
+        return _data->sparseJacobian != nullptr && _data->fullJacobian;
+    }
+
+    void Jacobian(ArrayView<const Base> x,
+                  ArrayView<Base> jac) override {
+        CPPADCG_ASSERT_KNOWN(isJacobianAvailable(), "No dense Jacobian available in the bytecode model")
+        SparseJacobian(x, jac);
+    }
+
+    bool isHessianAvailable() override {
+        return _data->sparseHessian != nullptr && _data->fullHessian;
+    }
+
+    void Hessian(ArrayView<const Base> x,
+                 ArrayView<const Base> w,
+                 ArrayView<Base> hess) override {
+        CPPADCG_ASSERT_KNOWN(isHessianAvailable(), "No dense Hessian available in the bytecode model")
+        SparseHessian(x, w, hess);
+    }
+
+    /***********************************************************************
+     *                   Directional derivatives (not available)
+     **********************************************************************/
+
+    bool isForwardOneAvailable() override {
+        return false;
+    }
+
+    void ForwardOne(ArrayView<const Base> tx,
+                    ArrayView<Base> ty) override {
+        throwUnavailable("first-order forward mode");
+    }
+
+    bool isSparseForwardOneAvailable() override {
+        return false;
+    }
+
+    void ForwardOne(ArrayView<const Base> x,
+                    size_t tx1Nnz, const size_t idx[], const Base tx1[],
+                    ArrayView<Base> ty1) override {
+        throwUnavailable("first-order forward mode");
+    }
+
+    bool isReverseOneAvailable() override {
+        return false;
+    }
+
+    bool isSparseReverseOneAvailable() override {
+        return false;
+    }
+
+    void ReverseOne(ArrayView<const Base> tx,
+                    ArrayView<const Base> ty,
+                    ArrayView<Base> px,
+                    ArrayView<const Base> py) override {
+        throwUnavailable("first-order reverse mode");
+    }
+
+    void ReverseOne(ArrayView<const Base> x,
+                    ArrayView<Base> px,
+                    size_t pyNnz, const size_t idx[], const Base py[]) override {
+        throwUnavailable("first-order reverse mode");
+    }
+
+    bool isReverseTwoAvailable() override {
+        return false;
+    }
+
+    bool isSparseReverseTwoAvailable() override {
+        return false;
+    }
+
+    void ReverseTwo(ArrayView<const Base> tx,
+                    ArrayView<const Base> ty,
+                    ArrayView<Base> px,
+                    ArrayView<const Base> py) override {
+        throwUnavailable("second-order reverse mode");
+    }
+
+    void ReverseTwo(ArrayView<const Base> x,
+                    size_t tx1Nnz, const size_t idx[], const Base tx1[],
+                    ArrayView<Base> px2,
+                    ArrayView<const Base> py2) override {
+        throwUnavailable("second-order reverse mode");
+    }
+
+    /***********************************************************************
+     *                        Sparse Jacobian
+     **********************************************************************/
+
+    bool isSparseJacobianAvailable() override {
+        return _data->sparseJacobian != nullptr;
+    }
+
+    void SparseJacobian(ArrayView<const Base> x,
+                        ArrayView<Base> jac) override {
+        CPPADCG_ASSERT_KNOWN(_data->sparseJacobian != nullptr, "No sparse Jacobian available in the bytecode model")
+        CPPADCG_ASSERT_KNOWN(x.size() == _data->n, "Invalid independent array size")
+        CPPADCG_ASSERT_KNOWN(jac.size() == _data->m * _data->n, "Invalid Jacobian size")
+
+        std::vector<Base> compressed(_data->jacRows.size());
+        const Base* in[1] = {x.data()};
+        _data->sparseJacobian->evaluate(in, compressed.data());
+
+        createDenseFromSparse(compressed, _data->n, _data->jacRows, _data->jacCols, jac);
+    }
+
+    void SparseJacobian(const std::vector<Base>& x,
+                        std::vector<Base>& jac,
+                        std::vector<size_t>& row,
+                        std::vector<size_t>& col) override {
+        CPPADCG_ASSERT_KNOWN(_data->sparseJacobian != nullptr, "No sparse Jacobian available in the bytecode model")
+        CPPADCG_ASSERT_KNOWN(x.size() == _data->n, "Invalid independent array size")
+
+        jac.resize(_data->jacRows.size());
+        row = _data->jacRows;
+        col = _data->jacCols;
+
+        const Base* in[1] = {x.data()};
+        _data->sparseJacobian->evaluate(in, jac.data());
+    }
+
+    void SparseJacobian(ArrayView<const Base> x,
+                        ArrayView<Base> jac,
+                        size_t const** row,
+                        size_t const** col) override {
+        CPPADCG_ASSERT_KNOWN(x.size() == _data->n, "Invalid independent array size")
+
+        std::vector<const Base*> in{x.data()};
+        SparseJacobian(in, jac, row, col);
+    }
+
+    void SparseJacobian(const std::vector<const Base*>& x,
+                        ArrayView<Base> jac,
+                        size_t const** row,
+                        size_t const** col) override {
+        CPPADCG_ASSERT_KNOWN(_data->sparseJacobian != nullptr, "No sparse Jacobian available in the bytecode model")
+        CPPADCG_ASSERT_KNOWN(x.size() == 1, "The number of independent variable arrays is invalid")
+        CPPADCG_ASSERT_KNOWN(jac.size() == _data->jacRows.size(), "Invalid number of non-zero elements in Jacobian")
+
+        *row = _data->jacRows.data();
+        *col = _data->jacCols.data();
+
+        _data->sparseJacobian->evaluate(x.data(), jac.data());
+    }
+
+    /***********************************************************************
+     *                        Sparse Hessian
+     **********************************************************************/
+
+    bool isSparseHessianAvailable() override {
+        return _data->sparseHessian != nullptr;
+    }
+
+    void SparseHessian(ArrayView<const Base> x,
+                       ArrayView<const Base> w,
+                       ArrayView<Base> hess) override {
+        CPPADCG_ASSERT_KNOWN(_data->sparseHessian != nullptr, "No sparse Hessian available in the bytecode model")
+        CPPADCG_ASSERT_KNOWN(x.size() == _data->n, "Invalid independent array size")
+        CPPADCG_ASSERT_KNOWN(w.size() == _data->m, "Invalid multiplier array size")
+        CPPADCG_ASSERT_KNOWN(hess.size() == _data->n * _data->n, "Invalid Hessian size")
+
+        std::vector<Base> compressed(_data->hessRows.size());
+        const Base* in[2] = {x.data(), w.data()};
+        _data->sparseHessian->evaluate(in, compressed.data());
+
+        createDenseFromSparse(compressed, _data->n, _data->hessRows, _data->hessCols, hess);
+    }
+
+    void SparseHessian(const std::vector<Base>& x,
+                       const std::vector<Base>& w,
+                       std::vector<Base>& hess,
+                       std::vector<size_t>& row,
+                       std::vector<size_t>& col) override {
+        CPPADCG_ASSERT_KNOWN(_data->sparseHessian != nullptr, "No sparse Hessian available in the bytecode model")
+        CPPADCG_ASSERT_KNOWN(x.size() == _data->n, "Invalid independent array size")
+        CPPADCG_ASSERT_KNOWN(w.size() == _data->m, "Invalid multiplier array size")
+
+        hess.resize(_data->hessRows.size());
+        row = _data->hessRows;
+        col = _data->hessCols;
+
+        const Base* in[2] = {x.data(), w.data()};
+        _data->sparseHessian->evaluate(in, hess.data());
+    }
+
+    void SparseHessian(ArrayView<const Base> x,
+                       ArrayView<const Base> w,
+                       ArrayView<Base> hess,
+                       size_t const** row,
+                       size_t const** col) override {
+        CPPADCG_ASSERT_KNOWN(x.size() == _data->n, "Invalid independent array size")
+
+        std::vector<const Base*> in{x.data()};
+        SparseHessian(in, w, hess, row, col);
+    }
+
+    void SparseHessian(const std::vector<const Base*>& x,
+                       ArrayView<const Base> w,
+                       ArrayView<Base> hess,
+                       size_t const** row,
+                       size_t const** col) override {
+        CPPADCG_ASSERT_KNOWN(_data->sparseHessian != nullptr, "No sparse Hessian available in the bytecode model")
+        CPPADCG_ASSERT_KNOWN(x.size() == 1, "The number of independent variable arrays is invalid")
+        CPPADCG_ASSERT_KNOWN(w.size() == _data->m, "Invalid multiplier array size")
+        CPPADCG_ASSERT_KNOWN(hess.size() == _data->hessRows.size(), "Invalid number of non-zero elements in Hessian")
+
+        *row = _data->hessRows.data();
+        *col = _data->hessCols.data();
+
+        const Base* in[2] = {x[0], w.data()};
+        _data->sparseHessian->evaluate(in, hess.data());
+    }
+
+protected:
+
+    static inline std::vector<bool> toSparsityBool(size_t nrows,
+                                                   size_t ncols,
+                                                   const std::vector<size_t>& rows,
+                                                   const std::vector<size_t>& cols) {
+        std::vector<bool> s(nrows * ncols, false);
+        for (size_t e = 0; e < rows.size(); e++) {
+            s[rows[e] * ncols + cols[e]] = true;
+        }
+        return s;
+    }
+
+    static inline std::vector<std::set<size_t> > toSparsitySet(size_t nrows,
+                                                              const std::vector<size_t>& rows,
+                                                              const std::vector<size_t>& cols) {
+        std::vector<std::set<size_t> > s(nrows);
+        for (size_t e = 0; e < rows.size(); e++) {
+            s[rows[e]].insert(cols[e]);
+        }
+        return s;
+    }
+
+    static inline void createDenseFromSparse(const std::vector<Base>& compressed,
+                                             size_t ncols,
+                                             const std::vector<size_t>& rows,
+                                             const std::vector<size_t>& cols,
+                                             ArrayView<Base> mat) {
+        mat.fill(Base(0));
+
+        for (size_t e = 0; e < compressed.size(); e++) {
+            mat[rows[e] * ncols + cols[e]] = compressed[e];
+        }
+    }
+
+    inline void throwUnavailable(const std::string& mode) const {
+        throw CGException("The ", mode, " is not available in the bytecode model '", _data->name, "'");
+    }
+};
+
+} // END cg namespace
+} // END CppAD namespace
+
+#endif
@@ -0,0 +1,219 @@
+#ifndef CPPAD_CG_BYTECODE_MODEL_LIBRARY_INCLUDED
+#define CPPAD_CG_BYTECODE_MODEL_LIBRARY_INCLUDED
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2020 Joao Leal
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+
+namespace CppAD {
+namespace cg {
+
+/**
+ * A model library whose models are evaluated by a bytecode interpreter.
+ * It does not require a compiler nor a linker and it can be saved to
+ * (and loaded from) a binary file.
+ *
+ * Models are always evaluated by the calling thread (there is no thread
+ * pool).
+ *
+ * @author Joao Leal
+ */
+template<class Base>
+class BytecodeModelLibrary : public ModelLibrary<Base> {
+public:
+    enum : uint32_t {
+        VERSION = 1,
+        MAGIC_SIZE = 8
+    };
+protected:
+    std::map<std::string, std::shared_ptr<const BytecodeModelData<Base> > > _models;
+public:
+
+    static inline const char* magic() {
+        return "CGBYTEC"; // includes the terminating '\0'
+    }
+
+    inline BytecodeModelLibrary() = default;
+
+    /**
+     * Loads a library previously written with save().
+     *
+     * @param in the input stream
+     */
+    inline explicit BytecodeModelLibrary(std::istream& in) {
+        std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        load(data.data(), data.size());
+    }
+
+    /**
+     * Loads a library previously written with save() directly from memory
+     * (e.g. a memory mapped file).
+     *
+     * @param data the library data
+     * @param size the number of bytes in data
+     */
+    inline BytecodeModelLibrary(const char* data,
+                                size_t size) {
+        load(data, size);
+    }
+
+    BytecodeModelLibrary(const BytecodeModelLibrary&) = delete;
+    BytecodeModelLibrary& operator=(const BytecodeModelLibrary&) = delete;
+
+    virtual ~BytecodeModelLibrary() = default;
+
+    /**
+     * Adds a new model to this library.
+     *
+     * @param data the model data
+     */
+    inline void addModel(std::shared_ptr<const BytecodeModelData<Base> > data) {
+        CPPADCG_ASSERT_KNOWN(data != nullptr, "Invalid model data")
+        if (_models.find(data->name) != _models.end()) {
+            throw CGException("Another model with the name '", data->name, "' already exists");
+        }
+        _models[data->name] = std::move(data);
+    }
+
+    std::set<std::string> getModelNames() override {
+        std::set<std::string> names;
+        for (const auto& it : _models) {
+            names.insert(it.first);
+        }
+        return names;
+    }
+
+    /**
+     * Creates a new BytecodeGenericModel object that can be used to
+     * evaluate the model.
+     * The model data is shared by all the objects created for the same
+     * model.
+     *
+     * @param modelName The model name.
+     * @return The model object or nullptr if no model exists with the
+     *         provided name.
+     */
+    std::unique_ptr<GenericModel<Base>> model(const std::string& modelName) override {
+        auto it = _models.find(modelName);
+        if (it == _models.end()) {
+            return std::unique_ptr<GenericModel<Base>>();
+        }
+        return std::unique_ptr<GenericModel<Base>>(new BytecodeGenericModel<Base>(it->second));
+    }
+
+    /**
+     * Writes the bytecode of all the models of this library.
+     *
+     * @param out the output stream (should be opened in binary mode)
+     */
+    inline void save(std::ostream& out) const {
+        GraphOutputStream s(out);
+        out.write(magic(), MAGIC_SIZE);
+        s.write<uint32_t>(VERSION);
+        s.write<uint32_t>(sizeof(Base));
+        s.write<uint32_t>(GraphOutputStream::BYTE_ORDER_MARK);
+
+        s.writeSize(_models.size());
+        for (const auto& it : _models) {
+            it.second->save(s);
+        }
+
+        if (!out) {
+            throw CGException("Failed to save the bytecode model library");
+        }
+    }
+
+    /**
+     * The bytecode interpreter does not use a thread pool.
+     */
+    void setThreadPoolDisabled(bool disabled) override {
+    }
+
+    bool isThreadPoolDisabled() const override {
+        return true;
+    }
+
+    unsigned int getThreadNumber() const override {
+        return 1;
+    }
+
+    void setThreadNumber(unsigned int n) override {
+    }
+
+    ThreadPoolScheduleStrategy getThreadPoolSchedulerStrategy() const override {
+        return ThreadPoolScheduleStrategy::DYNAMIC;
+    }
+
+    void setThreadPoolSchedulerStrategy(ThreadPoolScheduleStrategy s) override {
+    }
+
+    void setThreadPoolVerbose(bool v) override {
+    }
+
+    bool isThreadPoolVerbose() const override {
+        return false;
+    }
+
+    void setThreadPoolGuidedMaxWork(float v) override {
+    }
+
+    float getThreadPoolGuidedMaxWork() const override {
+        return 1.0;
+    }
+
+    void setThreadPoolNumberOfTimeMeas(unsigned int n) override {
+    }
+
+    unsigned int getThreadPoolNumberOfTimeMeas() const override {
+        return 0;
+    }
+
+protected:
+
+    inline void load(const char* data,
+                     size_t size) {
+        GraphInputStream s(data, size);
+
+        char header[MAGIC_SIZE];
+        s.readBytes(header, MAGIC_SIZE);
+        if (std::memcmp(header, magic(), MAGIC_SIZE) != 0) {
+            throw CGException("Invalid bytecode model library: unknown format");
+        }
+        if (s.read<uint32_t>() != VERSION) {
+            throw CGException("Invalid bytecode model library: unsupported version");
+        }
+        if (s.read<uint32_t>() != sizeof(Base)) {
+            throw CGException("Invalid bytecode model library: incompatible base type");
+        }
+        if (s.read<uint32_t>() != GraphOutputStream::BYTE_ORDER_MARK) {
+            throw CGException("Invalid bytecode model library: incompatible byte order");
+        }
+
+        size_t nModels = s.readSize();
+        for (size_t i = 0; i < nModels; ++i) {
+            std::shared_ptr<BytecodeModelData<Base> > model(new BytecodeModelData<Base>());
+            model->load(s);
+            addModel(std::move(model));
+        }
+
+        if (!s.atEnd()) {
+            throw CGException("Invalid bytecode model library: unexpected data at the end");
+        }
+    }
+
+};
+
+} // END cg namespace
+} // END CppAD namespace
+
+#endif
@@ -0,0 +1,138 @@
+#ifndef CPPAD_CG_BYTECODE_MODEL_LIBRARY_PROCESSOR_INCLUDED
+#define CPPAD_CG_BYTECODE_MODEL_LIBRARY_PROCESSOR_INCLUDED
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2020 Joao Leal
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+
+namespace CppAD {
+namespace cg {
+
+/**
+ * Creates model libraries evaluated by a bytecode interpreter which do not
+ * require a compiler.
+ *
+ * The same operation graphs used for the generation of C source code
+ * are lowered into bytecode after the elimination of common
+ * subexpressions and the reduction of temporary variables.
+ * Only the zero order forward mode, the sparse Jacobian, and the sparse
+ * Hessian are created (depending on the options of each ModelCSourceGen).
+ * Atomic functions and loops are not supported.
+ *
+ * @author Joao Leal
+ */
+template<class Base>
+class BytecodeModelLibraryProcessor : public ModelLibraryProcessor<Base> {
+public:
+
+    inline explicit BytecodeModelLibraryProcessor(ModelLibraryCSourceGen<Base>& modelLibraryHelper) :
+        ModelLibraryProcessor<Base>(modelLibraryHelper) {
+    }
+
+    inline virtual ~BytecodeModelLibraryProcessor() = default;
+
+    /**
+     * Creates a new model library with the bytecode of all models.
+     *
+     * @return the new model library
+     */
+    std::unique_ptr<BytecodeModelLibrary<Base>> create() {
+        std::unique_ptr<BytecodeModelLibrary<Base>> lib(new BytecodeModelLibrary<Base>());
+
+        for (const auto& p : this->modelLibraryHelper_->getModels()) {
+            this->modelLibraryHelper_->startingJob("bytecode for model '" + p.first + "'");
+
+            lib->addModel(createModel(*p.second));
+
+            this->modelLibraryHelper_->finishedJob();
+        }
+
+        return lib;
+    }
+
+protected:
+
+    virtual std::shared_ptr<const BytecodeModelData<Base> > createModel(ModelCSourceGen<Base>& model) {
+        ADFun<CG<Base> >& fun = model._fun;
+
+        std::shared_ptr<BytecodeModelData<Base> > data(new BytecodeModelData<Base>());
+        data->name = model.getName();
+        data->n = fun.Domain();
+        data->m = fun.Range();
+
+        if (model.isCreateForwardZero()) {
+            CodeHandler<Base> handler;
+            prepareCodeHandler(model, handler);
+            std::vector<CG<Base> > dep = model.prepareForward0(handler);
+            data->zero = createProgram(handler, dep, {data->n}, "model");
+        }
+
+        if (model.isCreateSparseJacobian() || model.isCreateJacobian()) {
+            model.determineJacobianSparsity();
+
+            CodeHandler<Base> handler;
+            prepareCodeHandler(model, handler);
+            std::vector<CG<Base> > jac = model.prepareSparseJacobian(handler, model.isSparseJacobianForwardMode());
+            data->sparseJacobian = createProgram(handler, jac, {data->n}, "sparse Jacobian");
+            data->jacRows = model._jacSparsity.rows;
+            data->jacCols = model._jacSparsity.cols;
+            data->fullJacobian = !model._custom_jac.defined;
+        }
+
+        if (model.isCreateSparseHessian() || model.isCreateHessian()) {
+            model.determineHessianSparsity();
+
+            CodeHandler<Base> handler;
+            prepareCodeHandler(model, handler);
+            std::vector<CG<Base> > hess = model.prepareSparseHessian(handler);
+            data->sparseHessian = createProgram(handler, hess, {data->n, data->m}, "sparse Hessian");
+            data->hessRows = model._hessSparsity.rows;
+            data->hessCols = model._hessSparsity.cols;
+            data->fullHessian = !model._custom_hess.defined;
+        }
+
+        return data;
+    }
+
+    /**
+     * Applies the options of the model to a code handler, but common
+     * subexpressions are always eliminated since the interpreter
+     * evaluates every instruction.
+     */
+    static inline void prepareCodeHandler(const ModelCSourceGen<Base>& model,
+                                          CodeHandler<Base>& handler) {
+        model.prepareCodeHandler(handler);
+        handler.setEliminateCommonSubexpressions(true);
+    }
+
+    static inline std::unique_ptr<BytecodeProgram<Base> > createProgram(CodeHandler<Base>& handler,
+                                                                       std::vector<CG<Base> >& dep,
+                                                                       std::vector<size_t> inputSizes,
+                                                                       const std::string& jobName) {
+        std::unique_ptr<BytecodeProgram<Base> > program(new BytecodeProgram<Base>());
+
+        LanguageBytecode<Base> lang(*program, std::move(inputSizes));
+        LangCDefaultVariableNameGenerator<Base> nameGen; // names are not used
+
+        std::ostringstream code;
+        handler.generateCode(code, lang, dep, nameGen, jobName);
+
+        return program;
+    }
+
+};
+
+} // END cg namespace
+} // END CppAD namespace
+
+#endif
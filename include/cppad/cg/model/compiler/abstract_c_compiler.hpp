@@ -31,6 +31,8 @@ protected:
     std::string _path; // the path to the gcc executable
     std::string _tmpFolder;
     std::string _sourcesFolder; // path where source files are saved
+    std::string _cacheFolder; // path where compiled files are cached (empty if disabled)
+    std::string _compilerVersion; // output of the compiler for --version (used in the cache keys)
     std::set<std::string> _ofiles; // compiled object files
     std::set<std::string> _sfiles; // compiled source files
     std::vector<std::string> _compileFlags;
@@ -38,6 +40,8 @@ protected:
     std::vector<std::string> _linkFlags;
     bool _verbose;
     bool _saveToDiskFirst;
+    bool _linkTimeOptimization;
+    size_t _maxJobs; // maximum number of compiler processes running concurrently
 public:
 
     AbstractCCompiler(const std::string& compilerPath) :
@@ -45,7 +49,9 @@ public:
         _tmpFolder("cppadcg_tmp"),
         _sourcesFolder("cppadcg_sources"),
         _verbose(false),
-        _saveToDiskFirst(false) {
+        _saveToDiskFirst(false),
+        _linkTimeOptimization(false),
+        _maxJobs(getDefaultMaxJobs()) {
     }
 
     AbstractCCompiler(const AbstractCCompiler& orig) = delete;
@@ -57,6 +63,7 @@ public:
 
     void setCompilerPath(const std::string& path) {
         _path = path;
+        _compilerVersion.clear();
     }
 
     const std::string& getTemporaryFolder() const override {
@@ -83,6 +90,29 @@ public:
         _sourcesFolder = srcFolder;
     }
 
+    /**
+     * Provides the path to the folder used to cache compiled files.
+     *
+     * @return path to the cache folder (empty if caching is disabled)
+     */
+    const std::string& getCacheFolder() const {
+        return _cacheFolder;
+    }
+
+    /**
+     * Defines a folder where compiled files are kept between runs.
+     * Files are stored under a hash of the source code, the compiler path
+     * and version, and the compilation flags so that a source file which did not change
+     * is not compiled again.
+     * The folder is not removed by cleanup().
+     *
+     * @param cacheFolder path to the cache folder (an empty path disables
+     *                    the cache)
+     */
+    void setCacheFolder(const std::string& cacheFolder) {
+        _cacheFolder = cacheFolder;
+    }
+
     const std::set<std::string>& getObjectFiles() const override {
         return _ofiles;
     }
@@ -135,6 +165,50 @@ public:
         _verbose = verbose;
     }
 
+    /**
+     * Whether or not link-time optimization is used.
+     */
+    bool isLinkTimeOptimization() const {
+        return _linkTimeOptimization;
+    }
+
+    /**
+     * Defines whether or not to use link-time optimization.
+     * The compiler can then inline functions from different source files
+     * (e.g. the functions called by the sparse Jacobian and Hessian) when
+     * the dynamic library is linked.
+     * Static libraries created from these object files can only be
+     * optimized when linked if the archiver supports the compiler plugin
+     * (e.g. gcc-ar or llvm-ar).
+     *
+     * @param lto whether or not to use link-time optimization
+     */
+    void setLinkTimeOptimization(bool lto) {
+        _linkTimeOptimization = lto;
+    }
+
+    /**
+     * Provides the maximum number of compiler processes which can be
+     * executed concurrently while compiling source files.
+     *
+     * @return the maximum number of concurrent compilation jobs
+     */
+    size_t getMaxJobs() const {
+        return _maxJobs;
+    }
+
+    /**
+     * Defines the maximum number of compiler processes which can be
+     * executed concurrently while compiling source files.
+     *
+     * @param maxJobs the maximum number of concurrent compilation jobs
+     *                (1 compiles one file at a time, 0 uses the number of
+     *                hardware threads)
+     */
+    void setMaxJobs(size_t maxJobs) {
+        _maxJobs = maxJobs == 0 ? getDefaultMaxJobs() : maxJobs;
+    }
+
     /**
      * Compiles the provided C source code.
      *
@@ -182,17 +256,39 @@ public:
             std::cout << std::endl;
         }
 
-        std::ostringstream os;
-
         if (_saveToDiskFirst) {
             system::createFolder(_sourcesFolder);
         }
 
-        // compile each source code file into a different object file
+        if (!_cacheFolder.empty()) {
+            system::createFolder(_cacheFolder);
+            if (_compilerVersion.empty()) {
+                // determined before any compilation thread uses it
+                _compilerVersion = getCompilerVersionInfo();
+            }
+        }
+
+        std::vector<const std::pair<const std::string, std::string>*> jobs;
+        std::vector<std::string> files;
+        jobs.reserve(sources.size());
+        files.reserve(sources.size());
         for (it = sources.begin(); it != sources.end(); ++it) {
+            jobs.push_back(&*it);
+            files.push_back(system::createPath(this->_tmpFolder, it->first + outputExtension));
+            outputFiles.insert(files.back());
+        }
+
+        if (_maxJobs > 1 && jobs.size() > 1) {
+            compileSourcesConcurrently(jobs, files, posIndepCode, timer, countWidth, maxsize);
+            return;
+        }
+
+        std::ostringstream os;
+
+        // compile each source code file into a different object file
+        for (size_t i = 0; i < jobs.size(); ++i) {
             count++;
-            std::string file = system::createPath(this->_tmpFolder, it->first + outputExtension);
-            outputFiles.insert(file);
+            const std::string& file = files[i];
 
             steady_clock::time_point beginTime;
 
@@ -215,20 +311,7 @@ public:
                 std::cout.fill(f); // restore fill character
             }
 
-            if (_saveToDiskFirst) {
-                // save a new source file to disk
-                std::ofstream sourceFile;
-                std::string srcfile = system::createPath(_sourcesFolder, it->first);
-                sourceFile.open(srcfile.c_str());
-                sourceFile << it->second;
-                sourceFile.close();
-
-                // compile the file
-                compileFile(srcfile, file, posIndepCode);
-            } else {
-                 // compile without saving the source code to disk
-                compileSource(it->second, file, posIndepCode);
-            }
+            compileSourceJob(*jobs[i], file, posIndepCode);
 
             if (timer != nullptr) {
                 timer->finishedJob();
@@ -269,6 +352,272 @@ public:
 
 protected:
 
+    static size_t getDefaultMaxJobs() {
+        return std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    }
+
+    /**
+     * Provides the flags used to compile and link when link-time
+     * optimization is enabled.
+     */
+    virtual std::vector<std::string> getLinkTimeOptimizationFlags() const {
+        return {"-flto"};
+    }
+
+    /**
+     * Adds the link-time optimization flags to the arguments of the
+     * compiler, if it is enabled.
+     */
+    inline void addLinkTimeOptimizationFlags(std::vector<std::string>& args) const {
+        if (_linkTimeOptimization) {
+            std::vector<std::string> flags = getLinkTimeOptimizationFlags();
+            args.insert(args.end(), flags.begin(), flags.end());
+        }
+    }
+
+    /**
+     * Compiles a single source file, saving it to disk first if requested.
+     *
+     * @param source the name and the content of the source file
+     * @param output the compiled output file name (the object file path)
+     */
+    virtual void compileSourceJob(const std::pair<const std::string, std::string>& source,
+                                  const std::string& output,
+                                  bool posIndepCode) {
+        std::string cached;
+        if (!_cacheFolder.empty()) {
+            cached = system::createPath(_cacheFolder, getCacheKey(source.second, output, posIndepCode));
+            if (system::isFile(cached)) {
+                copyFile(cached, output);
+                return;
+            }
+        }
+
+        if (_saveToDiskFirst) {
+            // save a new source file to disk
+            std::ofstream sourceFile;
+            std::string srcfile = system::createPath(_sourcesFolder, source.first);
+            sourceFile.open(srcfile.c_str());
+            sourceFile << source.second;
+            sourceFile.close();
+
+            // compile the file
+            compileFile(srcfile, output, posIndepCode);
+        } else {
+            // compile without saving the source code to disk
+            compileSource(source.second, output, posIndepCode);
+        }
+
+        if (!cached.empty()) {
+            // the file is renamed only once fully written so that other
+            // processes (and threads) never use an incomplete cached file
+            static std::atomic<unsigned long> tmpCounter(0);
+            std::string tmp = cached + "." + std::to_string(system::getProcessId()) + "_" + std::to_string(tmpCounter++) + ".tmp";
+            copyFile(output, tmp);
+            if (std::rename(tmp.c_str(), cached.c_str()) != 0) {
+                std::remove(tmp.c_str());
+            }
+        }
+    }
+
+    /**
+     * Determines the name of a cached compiled file.
+     *
+     * @param source the content of the source file
+     * @param output the compiled output file name
+     * @return the name of the file in the cache folder
+     */
+    virtual std::string getCacheKey(const std::string& source,
+                                    const std::string& output,
+                                    bool posIndepCode) const {
+        uint64_t h = 14695981039346656037ull; // FNV-1a offset basis
+
+        auto hash = [&h](const std::string& str) {
+            for (char c : str) {
+                h ^= (unsigned char) c;
+                h *= 1099511628211ull; // FNV-1a prime
+            }
+            h ^= 0xff; // separator
+            h *= 1099511628211ull;
+        };
+
+        hash(_path);
+        hash(_compilerVersion);
+        for (const std::string& f : _compileFlags)
+            hash(f);
+        if (_linkTimeOptimization) {
+            for (const std::string& f : getLinkTimeOptimizationFlags())
+                hash(f);
+        }
+        hash(posIndepCode ? "-fPIC" : "");
+        hash(source);
+
+        std::string extension;
+        std::string filename = system::filenameFromPath(output);
+        size_t p = filename.rfind('.');
+        if (p != std::string::npos)
+            extension = filename.substr(p);
+
+        std::ostringstream key;
+        key << std::hex << std::setw(16) << std::setfill('0') << h << "_" << std::dec << source.size() << extension;
+        return key.str();
+    }
+
+    /**
+     * Provides the version information of the compiler used to identify
+     * the cached compiled files.
+     *
+     * @return the output of the compiler for the --version argument
+     */
+    virtual std::string getCompilerVersionInfo() const {
+        std::vector<std::string> args {"--version"};
+        std::string output;
+        system::callExecutable(_path, args, &output);
+        return output;
+    }
+
+    static void copyFile(const std::string& from,
+                         const std::string& to) {
+        std::ifstream in(from.c_str(), std::ios::binary);
+        if (!in) {
+            throw CGException("Failed to read file '", from, "'");
+        }
+        std::ofstream out(to.c_str(), std::ios::binary | std::ios::trunc);
+        out << in.rdbuf();
+        out.close();
+        if (!out) {
+            throw CGException("Failed to write file '", to, "'");
+        }
+    }
+
+    /**
+     * Compiles several source files using up to getMaxJobs() concurrent
+     * compiler processes.
+     * Progress is only reported from the calling thread (once each file
+     * is compiled) so that the job timer keeps a consistent job stack.
+     * No new compilations are started after the first failure and the
+     * exception of that failure is rethrown once running jobs finish.
+     */
+    virtual void compileSourcesConcurrently(const std::vector<const std::pair<const std::string, std::string>*>& jobs,
+                                            const std::vector<std::string>& files,
+                                            bool posIndepCode,
+                                            JobTimer* timer,
+                                            size_t countWidth,
+                                            size_t maxsize) {
+        using namespace std::chrono;
+
+        /**
+         * a compiled file which was still not reported
+         */
+        struct CompiledJob {
+            size_t index;
+            steady_clock::time_point beginTime;
+        };
+
+        const size_t n = jobs.size();
+        std::mutex mutex;
+        std::condition_variable finished;
+        std::deque<CompiledJob> compiled;
+        std::exception_ptr error;
+        std::atomic<size_t> next(0);
+        std::atomic<bool> abort(false);
+        size_t running = std::min(_maxJobs, n);
+
+        auto worker = [&]() {
+            while (!abort) {
+                size_t i = next++;
+                if (i >= n)
+                    break;
+
+                steady_clock::time_point beginTime = steady_clock::now();
+                try {
+                    compileSourceJob(*jobs[i], files[i], posIndepCode);
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (error == nullptr)
+                        error = std::current_exception();
+                    abort = true;
+                    break;
+                }
+
+                std::lock_guard<std::mutex> lock(mutex);
+                compiled.push_back(CompiledJob{i, beginTime});
+                finished.notify_one();
+            }
+
+            std::lock_guard<std::mutex> lock(mutex);
+            running--;
+            finished.notify_one();
+        };
+
+        std::vector<std::thread> threads;
+        threads.reserve(running);
+
+        auto joinAll = [&]() {
+            abort = true;
+            for (std::thread& t : threads) {
+                if (t.joinable())
+                    t.join();
+            }
+        };
+
+        try {
+            size_t nThreads = running;
+            for (size_t t = 0; t < nThreads; ++t) {
+                threads.emplace_back(worker);
+            }
+
+            std::ostringstream os;
+            size_t count = 0;
+
+            std::unique_lock<std::mutex> lock(mutex);
+            while (true) {
+                finished.wait(lock, [&]() { return !compiled.empty() || running == 0; });
+
+                if (compiled.empty() || error != nullptr)
+                    break;
+
+                CompiledJob job = compiled.front();
+                compiled.pop_front();
+                lock.unlock();
+
+                count++;
+                const std::string& file = files[job.index];
+
+                if (timer != nullptr || _verbose) {
+                    os << "[" << std::setw(countWidth) << std::setfill(' ') << std::right << count
+                            << "/" << n << "]";
+                }
+
+                if (timer != nullptr) {
+                    timer->startingJob("'" + file + "'", JobTypeHolder<>::COMPILING, os.str(), job.beginTime);
+                    timer->finishedJob();
+                } else if (_verbose) {
+                    OStreamConfigRestore osr(std::cout);
+                    duration<float> dt = steady_clock::now() - job.beginTime;
+                    std::cout << os.str() << " compiling "
+                            << std::setw(maxsize + 9) << std::setfill('.') << std::left
+                            << ("'" + file + "' ") << " "
+                            << "done [" << std::fixed << std::setprecision(3)
+                            << dt.count() << "]" << std::endl;
+                }
+                os.str("");
+
+                lock.lock();
+            }
+        } catch (...) {
+            abort = true;
+            joinAll();
+            throw;
+        }
+
+        joinAll();
+
+        if (error != nullptr) {
+            std::rethrow_exception(error);
+        }
+    }
+
     /**
      * Compiles a single source file into an object file.
      *
@@ -100,6 +100,7 @@ public:
 
         std::vector<std::string> args;
         args.insert(args.end(), this->_compileLibFlags.begin(), this->_compileLibFlags.end());
+        this->addLinkTimeOptimizationFlags(args);
         args.push_back(linkerFlags); // Pass suitable options to linker
         args.push_back("-o"); // Output file name
         args.push_back(library); // Output file name
@@ -165,6 +166,7 @@ protected:
         args.push_back("-x");
         args.push_back("c"); // C source files
         args.insert(args.end(), this->_compileFlags.begin(), this->_compileFlags.end());
+        this->addLinkTimeOptimizationFlags(args);
         args.push_back("-c");
         args.push_back("-");
         if (posIndepCode) {
@@ -183,6 +185,7 @@ protected:
         args.push_back("-x");
         args.push_back("c"); // C source files
         args.insert(args.end(), this->_compileFlags.begin(), this->_compileFlags.end());
+        this->addLinkTimeOptimizationFlags(args);
         if (posIndepCode) {
             args.push_back("-fPIC"); // position-independent code for dynamic linking
         }
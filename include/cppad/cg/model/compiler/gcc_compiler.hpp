@@ -59,6 +59,7 @@ public:
 
         std::vector<std::string> args;
         args.insert(args.end(), this->_compileLibFlags.begin(), this->_compileLibFlags.end());
+        this->addLinkTimeOptimizationFlags(args);
         args.push_back(linkerFlags); // Pass suitable options to linker
         args.push_back("-o"); // Output file name
         args.push_back(library); // Output file name
@@ -83,6 +84,12 @@ public:
 
 protected:
 
+    std::vector<std::string> getLinkTimeOptimizationFlags() const override {
+        return {"-flto",
+                "-ffat-lto-objects", // object files can also be used without link-time optimization (e.g. with ar)
+                "-fno-semantic-interposition"}; // allows inlining of the exported functions in shared libraries
+    }
+
     /**
      * Compiles a single source file into an object file
      *
@@ -96,6 +103,7 @@ protected:
         args.push_back("-x");
         args.push_back("c"); // C source files
         args.insert(args.end(), this->_compileFlags.begin(), this->_compileFlags.end());
+        this->addLinkTimeOptimizationFlags(args);
         args.push_back("-c");
         args.push_back("-");
         if (posIndepCode) {
@@ -114,6 +122,7 @@ protected:
         args.push_back("-x");
         args.push_back("c"); // C source files
         args.insert(args.end(), this->_compileFlags.begin(), this->_compileFlags.end());
+        this->addLinkTimeOptimizationFlags(args);
         if (posIndepCode) {
             args.push_back("-fPIC"); // position-independent code for dynamic linking
         }
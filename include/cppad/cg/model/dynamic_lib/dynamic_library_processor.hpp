@@ -101,7 +101,12 @@ public:
     }
 
     /**
-     * System dependent custom options
+     * System dependent custom options.
+     *
+     * Linux: "dlOpenMode" defines the flags used to open the library with
+     * dlopen (either "lazy", "now", or the integer value of the flags).
+     * "lazy" avoids the relocation of all the functions in the library
+     * when it is opened.
      */
     inline std::map<std::string, std::string>& getOptions() {
         return _options;
@@ -26,7 +26,14 @@ std::unique_ptr<DynamicLib<Base>> DynamicModelLibraryProcessor<Base>::loadDynami
     if (it == _options.end()) {
         lib.reset(new LinuxDynamicLib<Base>(_libraryName + system::SystemInfo<>::DYNAMIC_LIB_EXTENSION));
     } else {
-        int dlOpenMode = std::stoi(it->second);
+        int dlOpenMode;
+        if (it->second == "lazy") {
+            dlOpenMode = RTLD_LAZY; // symbols are bound only when first used
+        } else if (it->second == "now") {
+            dlOpenMode = RTLD_NOW;
+        } else {
+            dlOpenMode = std::stoi(it->second);
+        }
         lib.reset(new LinuxDynamicLib<Base>(_libraryName + system::SystemInfo<>::DYNAMIC_LIB_EXTENSION, dlOpenMode));
     }
     return lib;
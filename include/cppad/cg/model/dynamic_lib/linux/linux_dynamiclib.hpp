@@ -38,6 +38,14 @@ protected:
     std::set<LinuxDynamicLibModel<Base>*> _models;
 public:
 
+    /**
+     * Opens a dynamic library.
+     *
+     * @param dynLibName the path to the dynamic library
+     * @param dlOpenMode the flags used by dlopen; RTLD_LAZY can be used to
+     *                   defer the binding of functions until they are first
+     *                   used (models only look up the functions they use)
+     */
     explicit LinuxDynamicLib(std::string dynLibName,
                              int dlOpenMode = RTLD_NOW) :
         _dynLibName(std::move(dynLibName)),
@@ -80,6 +88,8 @@ public:
     }
 
     void* loadFunction(const std::string& functionName, bool required = true) override {
+        dlerror(); // clear any previous error (e.g. from a missing optional function)
+
         void* functor = dlsym(_dynLibHandle, functionName.c_str());
 
         if (required) {
@@ -23,10 +23,26 @@ namespace cg {
 
 /**
  * A model which can be accessed through function pointers.
- * This class is not thread-safe and it should not be used simultaneously in
- * different threads.
- * Multiple instances of this class for the same model from the same model
- * library object can be used simultaneously in different threads.
+ *
+ * The evaluation methods do not modify the state of the model: the arrays of
+ * input/output pointers and any compressed buffers are created for each call
+ * (on the stack, unless they are larger than usual).
+ * Therefore, once all the atomic functions have been added, the same model
+ * object can be evaluated simultaneously from different threads as long as
+ * the atomic functions (and external models) are also thread-safe.
+ * Atomic functions based on CppAD::atomic_base require
+ * CppAD::thread_alloc::parallel_setup() to be used from several threads.
+ * The methods which change the model (e.g. addAtomicFunction()) must not be
+ * called while the model is being evaluated.
+ * This does not apply to libraries generated with
+ * MultiThreadingType::PTHREADS: their sparse Jacobian/Hessian functions keep
+ * the job timings and the job ordering in static variables and all of them
+ * share a single process-wide thread pool, so these functions must not be
+ * called from several threads at the same time (for any model of the
+ * library).
+ *
+ * The functions of the model are only looked up in the library when they
+ * are first needed (see resolveFunctions()).
  *
  * @author Joao Leal
  */
@@ -35,62 +51,250 @@ class FunctorGenericModel : public GenericModel<Base> {
 protected:
     static constexpr const char* ERROR_LIBRARY_NOT_READY = "The model library is not ready. The model library that"
                                                            " provided this model might have been closed or deleted.";
+protected:
+
+    /**
+     * The array of pointers to the input (or output) arrays passed to a
+     * model function.
+     * A new one is created for each call so that the model can be evaluated
+     * simultaneously by several threads; the pointers are kept on the stack
+     * unless there are more arrays than usual.
+     */
+    template<class T>
+    class ArgumentArray {
+    private:
+        static constexpr size_t STACK_SIZE = 4;
+        T* _stack[STACK_SIZE];
+        std::vector<T*> _heap;
+        T** _data;
+    public:
+        inline explicit ArgumentArray(size_t size) :
+            _data(_stack) {
+            if (size > STACK_SIZE) {
+                _heap.resize(size, nullptr);
+                _data = _heap.data();
+            } else {
+                std::fill(_stack, _stack + STACK_SIZE, nullptr);
+            }
+        }
+
+        ArgumentArray(const ArgumentArray&) = delete;
+        ArgumentArray& operator=(const ArgumentArray&) = delete;
+
+        inline T*& operator[](size_t i) {
+            return _data[i];
+        }
+
+        inline T* const* data() const {
+            return _data;
+        }
+    };
+
+    /**
+     * A temporary array for the compressed (sparse) values returned by a
+     * model function.
+     * Like ArgumentArray, it is kept on the stack unless it is larger than
+     * usual, so that most evaluations do not allocate memory (a
+     * thread_local buffer could be overwritten by a model evaluated inside
+     * an atomic function).
+     */
+    class CompressedArray {
+    private:
+        static constexpr size_t STACK_SIZE = 64;
+        Base _stack[STACK_SIZE];
+        std::vector<Base> _heap;
+        Base* _data;
+    public:
+        inline explicit CompressedArray(size_t size) :
+            _data(_stack) {
+            if (size > STACK_SIZE) {
+                _heap.resize(size);
+                _data = _heap.data();
+            } else {
+                std::fill(_stack, _stack + size, Base(0));
+            }
+        }
+
+        CompressedArray(const CompressedArray&) = delete;
+        CompressedArray& operator=(const CompressedArray&) = delete;
+
+        inline Base& operator[](size_t i) {
+            return _data[i];
+        }
+
+        inline const Base& operator[](size_t i) const {
+            return _data[i];
+        }
+
+        inline Base* data() {
+            return _data;
+        }
+    };
+
+    /**
+     * A pointer to a function in the compiled model which is only resolved
+     * (e.g. with dlsym) when it is used for the first time.
+     * Models in libraries with many models and functions can therefore be
+     * created without looking up the symbols which are never used.
+     *
+     * The function is resolved only once, under a lock, so that it can be
+     * used for the first time simultaneously from several threads even
+     * when loadFunction() itself is not thread-safe (e.g. LLVM).
+     */
+    template<class FunctionPtr>
+    class LazyFunction {
+    private:
+        FunctorGenericModel* const _model;
+        /// the function name without the model name prefix
+        const std::string _suffix;
+        mutable std::atomic<void*> _ptr;
+        mutable std::atomic<bool> _resolved;
+        mutable std::mutex _mutex;
+    public:
+        inline LazyFunction(FunctorGenericModel* model,
+                            std::string suffix) :
+            _model(model),
+            _suffix(std::move(suffix)),
+            _ptr(nullptr),
+            _resolved(false) {
+        }
+
+        LazyFunction(const LazyFunction&) = delete;
+        LazyFunction& operator=(const LazyFunction&) = delete;
+
+        /**
+         * Provides the function pointer (resolved if required).
+         *
+         * @return the function pointer or nullptr if the function does not
+         *         exist in the compiled model
+         */
+        inline FunctionPtr get() const {
+            if (!_resolved.load(std::memory_order_acquire)) {
+                std::lock_guard<std::mutex> lock(_mutex);
+                if (!_resolved.load(std::memory_order_relaxed)) {
+                    void* ptr = nullptr;
+                    if (_model->_isLibraryReady) {
+                        ptr = _model->loadFunction(_model->_name + "_" + _suffix, false);
+                    }
+                    _ptr.store(ptr, std::memory_order_relaxed);
+                    _resolved.store(true, std::memory_order_release);
+                }
+            }
+            return reinterpret_cast<FunctionPtr>(_ptr.load(std::memory_order_relaxed));
+        }
+
+        inline FunctionPtr operator*() const {
+            return get();
+        }
+
+        /**
+         * Whether or not the function has already been resolved.
+         */
+        inline bool isResolved() const {
+            return _resolved.load(std::memory_order_acquire);
+        }
+
+        /**
+         * Marks the function as unavailable (e.g. the library was closed).
+         */
+        inline LazyFunction& operator=(std::nullptr_t) {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _ptr.store(nullptr, std::memory_order_relaxed);
+            _resolved.store(true, std::memory_order_release);
+            return *this;
+        }
+
+        inline bool operator==(std::nullptr_t) const {
+            return get() == nullptr;
+        }
+
+        inline bool operator!=(std::nullptr_t) const {
+            return get() != nullptr;
+        }
+    };
+
+    /**
+     * A sparsity pattern provided by the compiled model.
+     * The arrays belong to the dynamic library.
+     */
+    struct SparsityPattern {
+        unsigned long const* rows = nullptr;
+        unsigned long const* cols = nullptr;
+        unsigned long nnz = 0;
+    };
+
 protected:
     bool _isLibraryReady;
     /// the model name
     const std::string _name;
     size_t _m;
     size_t _n;
-    std::vector<const Base*> _in;
-    std::vector<const Base*> _inHess;
-    std::vector<Base*> _out;
+    /// the number of input arrays of the model functions
+    size_t _inSize;
+    /// the number of output arrays of the model functions
+    size_t _outSize;
     LangCAtomicFun _atomicFuncArg;
     std::vector<std::string> _atomicNames; // names of the atomic/external functions required by this model
     std::vector<ExternalFunctionWrapper<Base>* > _atomic;
+    // whether or not each atomic function is called directly by the generated code (another model in the library)
+    std::vector<bool> _linkedAtomic;
     size_t _missingAtomicFunctions;
-    CppAD::vector<Base> _tx, _ty, _px, _py;
     // original model function
-    void (*_zero)(Base const*const*, Base * const*, LangCAtomicFun);
+    LazyFunction<void (*)(Base const*const*, Base * const*, LangCAtomicFun)> _zero;
     // first order forward mode
-    int (*_forwardOne)(Base const tx[], Base ty[], LangCAtomicFun);
+    LazyFunction<int (*)(Base const tx[], Base ty[], LangCAtomicFun)> _forwardOne;
     // first order reverse mode
-    int (*_reverseOne)(Base const tx[], Base const ty[], Base px[], Base const py[], LangCAtomicFun);
+    LazyFunction<int (*)(Base const tx[], Base const ty[], Base px[], Base const py[], LangCAtomicFun)> _reverseOne;
     // second order reverse mode
-    int (*_reverseTwo)(Base const tx[], Base const ty[], Base px[], Base const py[], LangCAtomicFun);
+    LazyFunction<int (*)(Base const tx[], Base const ty[], Base px[], Base const py[], LangCAtomicFun)> _reverseTwo;
     // jacobian function in the dynamic library
-    void (*_jacobian)(Base const*const*, Base * const*, LangCAtomicFun);
+    LazyFunction<void (*)(Base const*const*, Base * const*, LangCAtomicFun)> _jacobian;
     // hessian function in the dynamic library
-    void (*_hessian)(Base const*const*, Base * const*, LangCAtomicFun);
+    LazyFunction<void (*)(Base const*const*, Base * const*, LangCAtomicFun)> _hessian;
     //
-    int (*_sparseForwardOne)(unsigned long, Base const *const *, Base * const *, LangCAtomicFun);
+    LazyFunction<int (*)(unsigned long, Base const *const *, Base * const *, LangCAtomicFun)> _sparseForwardOne;
     //
-    int (*_sparseReverseOne)(unsigned long, Base const *const *, Base * const *, LangCAtomicFun);
+    LazyFunction<int (*)(unsigned long, Base const *const *, Base * const *, LangCAtomicFun)> _sparseReverseOne;
     //
-    int (*_sparseReverseTwo)(unsigned long, Base const *const *, Base * const *, LangCAtomicFun);
+    LazyFunction<int (*)(unsigned long, Base const *const *, Base * const *, LangCAtomicFun)> _sparseReverseTwo;
     // sparse jacobian function in the dynamic library
-    void (*_sparseJacobian)(Base const*const*, Base * const*, LangCAtomicFun);
+    LazyFunction<void (*)(Base const*const*, Base * const*, LangCAtomicFun)> _sparseJacobian;
     // sparse hessian function in the dynamic library
-    void (*_sparseHessian)(Base const*const*, Base * const*, LangCAtomicFun);
+    LazyFunction<void (*)(Base const*const*, Base * const*, LangCAtomicFun)> _sparseHessian;
+    // batch (multi-point) versions of the model, sparse jacobian, and sparse hessian functions
+    typedef void (*BatchFunction)(unsigned long, Base const*const*, unsigned long const*, Base * const*, unsigned long const*, LangCAtomicFun);
+    LazyFunction<BatchFunction> _zeroBatch;
+    LazyFunction<BatchFunction> _sparseJacobianBatch;
+    LazyFunction<BatchFunction> _sparseHessianBatch;
+    // elapsed times measured by the thread pool for the multithreaded sparse jacobian and sparse hessian
+    typedef void (*JobTimingsFunction)(float const**, unsigned long const**, unsigned long const**, unsigned long*, unsigned int*);
+    LazyFunction<JobTimingsFunction> _sparseJacobianJobTimings;
+    LazyFunction<JobTimingsFunction> _sparseHessianJobTimings;
     //
-    void (*_forwardOneSparsity)(unsigned long, unsigned long const**, unsigned long*);
+    LazyFunction<void (*)(unsigned long, unsigned long const**, unsigned long*)> _forwardOneSparsity;
     //
-    void (*_reverseOneSparsity)(unsigned long, unsigned long const**, unsigned long*);
+    LazyFunction<void (*)(unsigned long, unsigned long const**, unsigned long*)> _reverseOneSparsity;
     //
-    void (*_reverseTwoSparsity)(unsigned long, unsigned long const**, unsigned long*);
+    LazyFunction<void (*)(unsigned long, unsigned long const**, unsigned long*)> _reverseTwoSparsity;
     // jacobian sparsity function in the dynamic library
-    void (*_jacobianSparsity)(unsigned long const** row,
-            unsigned long const** col,
-            unsigned long * nnz);
+    LazyFunction<void (*)(unsigned long const** row,
+                          unsigned long const** col,
+                          unsigned long * nnz)> _jacobianSparsity;
     // hessian sparsity function in the dynamic library
-    void (*_hessianSparsity)(unsigned long const** row,
-            unsigned long const** col,
-            unsigned long * nnz);
-    void (*_hessianSparsity2)(unsigned long i,
-            unsigned long const** row,
-            unsigned long const** col,
-            unsigned long * nnz);
+    LazyFunction<void (*)(unsigned long const** row,
+                          unsigned long const** col,
+                          unsigned long * nnz)> _hessianSparsity;
+    LazyFunction<void (*)(unsigned long i,
+                          unsigned long const** row,
+                          unsigned long const** col,
+                          unsigned long * nnz)> _hessianSparsity2;
     void (*_atomicFunctions)(const char*** names,
             unsigned long * n);
+    // the Jacobian and Hessian sparsity patterns (requested only once from the dynamic library)
+    SparsityPattern _jacSparsityCache;
+    std::once_flag _jacSparsityLoaded;
+    SparsityPattern _hessSparsityCache;
+    std::once_flag _hessSparsityLoaded;
 
 public:
 
@@ -121,6 +325,33 @@ public:
                 (atomic, atomic.getName());
     }
 
+    /**
+     * Resolves all the functions of this model immediately instead of
+     * doing it when each function is first used.
+     * This can be used to detect incomplete libraries early or to avoid
+     * the symbol lookup cost during the first evaluations.
+     *
+     * @throws CGException if the library is not consistent
+     */
+    virtual void resolveFunctions() {
+        CPPADCG_ASSERT_KNOWN(_isLibraryReady, ERROR_LIBRARY_NOT_READY)
+
+        CPPADCG_ASSERT_KNOWN((_sparseForwardOne == nullptr) == (_forwardOneSparsity == nullptr), "Missing functions in the dynamic library")
+        CPPADCG_ASSERT_KNOWN((_sparseForwardOne == nullptr) == (_forwardOne == nullptr), "Missing functions in the dynamic library")
+        CPPADCG_ASSERT_KNOWN((_sparseReverseOne == nullptr) == (_reverseOneSparsity == nullptr), "Missing functions in the dynamic library")
+        CPPADCG_ASSERT_KNOWN((_sparseReverseOne == nullptr) == (_reverseOne == nullptr), "Missing functions in the dynamic library")
+        CPPADCG_ASSERT_KNOWN((_sparseReverseTwo == nullptr) == (_reverseTwoSparsity == nullptr), "Missing functions in the dynamic library")
+        CPPADCG_ASSERT_KNOWN((_sparseReverseTwo == nullptr) == (_reverseTwo == nullptr), "Missing functions in the dynamic library")
+        CPPADCG_ASSERT_KNOWN((_sparseJacobian == nullptr) || (_jacobianSparsity != nullptr), "Missing functions in the dynamic library")
+        CPPADCG_ASSERT_KNOWN((_sparseHessian == nullptr) || (_hessianSparsity != nullptr), "Missing functions in the dynamic library")
+        CPPADCG_ASSERT_KNOWN((_zeroBatch == nullptr) || (_zero != nullptr), "Missing functions in the dynamic library")
+        CPPADCG_ASSERT_KNOWN((_sparseJacobianBatch == nullptr) || (_sparseJacobian != nullptr), "Missing functions in the dynamic library")
+        CPPADCG_ASSERT_KNOWN((_sparseHessianBatch == nullptr) || (_sparseHessian != nullptr), "Missing functions in the dynamic library")
+        _jacobian.get();
+        _hessian.get();
+        _hessianSparsity2.get();
+    }
+
     // Jacobian sparsity
     bool isJacobianSparsityAvailable() override {
         return _jacobianSparsity != nullptr;
@@ -132,7 +363,7 @@ public:
 
         unsigned long const* row, *col;
         unsigned long nnz;
-        (*_jacobianSparsity)(&row, &col, &nnz);
+        loadJacobianSparsity(&row, &col, &nnz);
 
         bool set_type = true;
         std::vector<bool> s;
@@ -148,7 +379,7 @@ public:
 
         unsigned long const* row, *col;
         unsigned long nnz;
-        (*_jacobianSparsity)(&row, &col, &nnz);
+        loadJacobianSparsity(&row, &col, &nnz);
 
         std::set<size_t> set_type;
         std::vector<std::set<size_t> > s;
@@ -165,7 +396,7 @@ public:
 
         unsigned long const* row, *col;
         unsigned long nnz;
-        (*_jacobianSparsity)(&row, &col, &nnz);
+        loadJacobianSparsity(&row, &col, &nnz);
 
         equations.resize(nnz);
         variables.resize(nnz);
@@ -185,7 +416,7 @@ public:
 
         unsigned long const* row, *col;
         unsigned long nnz;
-        (*_hessianSparsity)(&row, &col, &nnz);
+        loadHessianSparsity(&row, &col, &nnz);
 
         bool set_type = true;
         std::vector<bool> s;
@@ -201,7 +432,7 @@ public:
 
         unsigned long const* row, *col;
         unsigned long nnz;
-        (*_hessianSparsity)(&row, &col, &nnz);
+        loadHessianSparsity(&row, &col, &nnz);
 
         std::set<size_t> set_type;
         std::vector<std::set<size_t> > s;
@@ -218,7 +449,7 @@ public:
 
         unsigned long const* row, *col;
         unsigned long nnz;
-        (*_hessianSparsity)(&row, &col, &nnz);
+        loadHessianSparsity(&row, &col, &nnz);
 
         rows.resize(nnz);
         cols.resize(nnz);
@@ -300,29 +531,32 @@ public:
                      ArrayView<Base> dep) override {
         CPPADCG_ASSERT_KNOWN(_isLibraryReady, ERROR_LIBRARY_NOT_READY)
         CPPADCG_ASSERT_KNOWN(_zero != nullptr, "No zero order forward function defined in the dynamic library")
-        CPPADCG_ASSERT_KNOWN(_in.size() == 1, "The number of independent variable arrays is higher than 1,"
+        CPPADCG_ASSERT_KNOWN(_inSize == 1, "The number of independent variable arrays is higher than 1,"
                              " please use the variable size methods")
         CPPADCG_ASSERT_KNOWN(dep.size() == _m, "Invalid dependent array size")
         CPPADCG_ASSERT_KNOWN(x.size() == _n, "Invalid independent array size")
         CPPADCG_ASSERT_KNOWN(_missingAtomicFunctions == 0, "Some atomic functions used by the compiled model have not been specified yet")
 
-        _in[0] = x.data();
-        _out[0] = dep.data();
+        ArgumentArray<const Base> in(_inSize);
+        ArgumentArray<Base> out(_outSize);
+        in[0] = x.data();
+        out[0] = dep.data();
 
-        (*_zero)(&_in[0], &_out[0], _atomicFuncArg);
+        (*_zero)(in.data(), out.data(), _atomicFuncArg);
     }
 
     void ForwardZero(const std::vector<const Base*> &x,
                      ArrayView<Base> dep) override {
         CPPADCG_ASSERT_KNOWN(_isLibraryReady, ERROR_LIBRARY_NOT_READY)
         CPPADCG_ASSERT_KNOWN(_zero != nullptr, "No zero order forward function defined in the dynamic library")
-        CPPADCG_ASSERT_KNOWN(_in.size() == x.size(), "The number of independent variable arrays is invalid")
+        CPPADCG_ASSERT_KNOWN(_inSize == x.size(), "The number of independent variable arrays is invalid")
         CPPADCG_ASSERT_KNOWN(dep.size() == _m, "Invalid dependent array size")
         CPPADCG_ASSERT_KNOWN(_missingAtomicFunctions == 0, "Some atomic functions used by the compiled model have not been specified yet")
 
-        _out[0] = dep.data();
+        ArgumentArray<Base> out(_outSize);
+        out[0] = dep.data();
 
-        (*_zero)(&x[0], &_out[0], _atomicFuncArg);
+        (*_zero)(&x[0], out.data(), _atomicFuncArg);
     }
 
     void ForwardZero(const CppAD::vector<bool>& vx,
@@ -331,16 +565,18 @@ public:
                      ArrayView<Base> ty) override {
         CPPADCG_ASSERT_KNOWN(_isLibraryReady, ERROR_LIBRARY_NOT_READY)
         CPPADCG_ASSERT_KNOWN(_zero != nullptr, "No zero order forward function defined in the dynamic library")
-        CPPADCG_ASSERT_KNOWN(_in.size() == 1, "The number of independent variable arrays is higher than 1,"
+        CPPADCG_ASSERT_KNOWN(_inSize == 1, "The number of independent variable arrays is higher than 1,"
                              " please use the variable size methods")
         CPPADCG_ASSERT_KNOWN(tx.size() == _n, "Invalid independent array size")
         CPPADCG_ASSERT_KNOWN(ty.size() == _m, "Invalid dependent array size")
         CPPADCG_ASSERT_KNOWN(_missingAtomicFunctions == 0, "Some atomic functions used by the compiled model have not been specified yet")
 
-        _in[0] = tx.data();
-        _out[0] = ty.data();
+        ArgumentArray<const Base> in(_inSize);
+        ArgumentArray<Base> out(_outSize);
+        in[0] = tx.data();
+        out[0] = ty.data();
 
-        (*_zero)(&_in[0], &_out[0], _atomicFuncArg);
+        (*_zero)(in.data(), out.data(), _atomicFuncArg);
 
         if (vx.size() > 0) {
             CPPADCG_ASSERT_KNOWN(vx.size() >= _n, "Invalid vx size")
@@ -366,17 +602,18 @@ public:
                   ArrayView<Base> jac) override {
         CPPADCG_ASSERT_KNOWN(_isLibraryReady, ERROR_LIBRARY_NOT_READY)
         CPPADCG_ASSERT_KNOWN(_jacobian != nullptr, "No Jacobian function defined in the dynamic library")
-        CPPADCG_ASSERT_KNOWN(_in.size() == 1, "The number of independent variable arrays is higher than 1,"
+        CPPADCG_ASSERT_KNOWN(_inSize == 1, "The number of independent variable arrays is higher than 1,"
                              " please use the variable size methods")
         CPPADCG_ASSERT_KNOWN(x.size() == _n, "Invalid independent array size")
         CPPADCG_ASSERT_KNOWN(jac.size() == _m * _n, "Invalid Jacobian array size")
         CPPADCG_ASSERT_KNOWN(_missingAtomicFunctions == 0, "Some atomic functions used by the compiled model have not been specified yet")
 
+        ArgumentArray<const Base> in(_inSize);
+        ArgumentArray<Base> out(_outSize);
+        in[0] = x.data();
+        out[0] = jac.data();
 
-        _in[0] = x.data();
-        _out[0] = jac.data();
-
-        (*_jacobian)(&_in[0], &_out[0], _atomicFuncArg);
+        (*_jacobian)(in.data(), out.data(), _atomicFuncArg);
     }
 
     bool isHessianAvailable() override {
@@ -389,18 +626,20 @@ public:
                  ArrayView<Base> hess) override {
         CPPADCG_ASSERT_KNOWN(_isLibraryReady, ERROR_LIBRARY_NOT_READY)
         CPPADCG_ASSERT_KNOWN(_hessian != nullptr, "No Hessian function defined in the dynamic library")
-        CPPADCG_ASSERT_KNOWN(_in.size() == 1, "The number of independent variable arrays is higher than 1,"
+        CPPADCG_ASSERT_KNOWN(_inSize == 1, "The number of independent variable arrays is higher than 1,"
                              " please use the variable size methods")
         CPPADCG_ASSERT_KNOWN(x.size() == _n, "Invalid independent array size")
         CPPADCG_ASSERT_KNOWN(w.size() == _m, "Invalid multiplier array size")
         CPPADCG_ASSERT_KNOWN(hess.size() == _n * _n, "Invalid Hessian size")
         CPPADCG_ASSERT_KNOWN(_missingAtomicFunctions == 0, "Some atomic functions used by the compiled model have not been specified yet")
 
-        _inHess[0] = x.data();
-        _inHess[1] = w.data();
-        _out[0] = hess.data();
+        ArgumentArray<const Base> in(_inSize + 1);
+        ArgumentArray<Base> out(_outSize);
+        in[0] = x.data();
+        in[1] = w.data();
+        out[0] = hess.data();
 
-        (*_hessian)(&_inHess[0], &_out[0], _atomicFuncArg);
+        (*_hessian)(in.data(), out.data(), _atomicFuncArg);
     }
 
     bool isForwardOneAvailable() override {
@@ -443,18 +682,19 @@ public:
         unsigned long const* pos;
         size_t nnz = 0;
 
-        _ty.resize(_m);
-        Base* compressed = &_ty[0];
+        CompressedArray compressed(_m);
 
-        _inHess[0] = x.data();
-        _out[0] = compressed;
+        ArgumentArray<const Base> in(_inSize + 1);
+        ArgumentArray<Base> out(_outSize);
+        in[0] = x.data();
+        out[0] = compressed.data();
 
         for (size_t ej = 0; ej < tx1Nnz; ej++) {
             size_t j = idx[ej];
             (*_forwardOneSparsity)(j, &pos, &nnz);
 
-            _inHess[1] = &tx1[ej];
-            int ret = (*_sparseForwardOne)(j, &_inHess[0], &_out[0], _atomicFuncArg);
+            in[1] = &tx1[ej];
+            int ret = (*_sparseForwardOne)(j, in.data(), out.data(), _atomicFuncArg);
 
             CPPADCG_ASSERT_KNOWN(ret == 0, "First-order forward mode failed.") // generic failure
 
@@ -509,18 +749,19 @@ public:
         unsigned long const* pos;
         size_t nnz = 0;
 
-        _px.resize(_n);
-        Base* compressed = &_px[0];
+        CompressedArray compressed(_n);
 
-        _inHess[0] = x.data();
-        _out[0] = compressed;
+        ArgumentArray<const Base> in(_inSize + 1);
+        ArgumentArray<Base> out(_outSize);
+        in[0] = x.data();
+        out[0] = compressed.data();
 
         for (size_t ei = 0; ei < pyNnz; ei++) {
             size_t i = idx[ei];
             (*_reverseOneSparsity)(i, &pos, &nnz);
 
-            _inHess[1] = &py[ei];
-            int ret = (*_sparseReverseOne)(i, &_inHess[0], &_out[0], _atomicFuncArg);
+            in[1] = &py[ei];
+            int ret = (*_sparseReverseOne)(i, in.data(), out.data(), _atomicFuncArg);
 
             CPPADCG_ASSERT_KNOWN(ret == 0, "First-order reverse mode failed.")
 
@@ -543,7 +784,7 @@ public:
 
         CPPADCG_ASSERT_KNOWN(_isLibraryReady, ERROR_LIBRARY_NOT_READY)
         CPPADCG_ASSERT_KNOWN(_reverseTwo != nullptr, "No sparse reverse two function defined in the dynamic library")
-        CPPADCG_ASSERT_KNOWN(_in.size() == 1, "The number of independent variable arrays is higher than 1")
+        CPPADCG_ASSERT_KNOWN(_inSize == 1, "The number of independent variable arrays is higher than 1")
         CPPADCG_ASSERT_KNOWN(tx.size() >= k1 * _n, "Invalid tx size")
         CPPADCG_ASSERT_KNOWN(ty.size() >= k1 * _m, "Invalid ty size")
         CPPADCG_ASSERT_KNOWN(px.size() >= k1 * _n, "Invalid px size")
@@ -579,20 +820,20 @@ public:
         unsigned long const* pos;
         size_t nnz = 0;
 
-        _px.resize(_n);
-        Base* compressed = &_px[0];
+        CompressedArray compressed(_n);
 
         const Base * in[3];
         in[0] = x.data();
         in[2] = py2.data();
-        _out[0] = compressed;
+        ArgumentArray<Base> out(_outSize);
+        out[0] = compressed.data();
 
         for (size_t ej = 0; ej < tx1Nnz; ej++) {
             size_t j = idx[ej];
             (*_reverseTwoSparsity)(j, &pos, &nnz);
 
             in[1] = &tx1[ej];
-            int ret = (*_sparseReverseTwo)(j, &in[0], &_out[0], _atomicFuncArg);
+            int ret = (*_sparseReverseTwo)(j, &in[0], out.data(), _atomicFuncArg);
 
             CPPADCG_ASSERT_KNOWN(ret == 0, "Second-order reverse mode failed.") // generic failure
 
@@ -612,7 +853,7 @@ public:
                         ArrayView<Base> jac) override {
         CPPADCG_ASSERT_KNOWN(_isLibraryReady, ERROR_LIBRARY_NOT_READY)
         CPPADCG_ASSERT_KNOWN(_sparseJacobian != nullptr, "No sparse jacobian function defined in the dynamic library")
-        CPPADCG_ASSERT_KNOWN(_in.size() == 1, "The number of independent variable arrays is higher than 1,"
+        CPPADCG_ASSERT_KNOWN(_inSize == 1, "The number of independent variable arrays is higher than 1,"
                              " please use the variable size methods")
         CPPADCG_ASSERT_KNOWN(x.size() == _n, "Invalid independent array size")
         CPPADCG_ASSERT_KNOWN(jac.size() == _m * _n, "Invalid Jacobian size")
@@ -621,15 +862,17 @@ public:
         unsigned long const* row;
         unsigned long const* col;
         unsigned long nnz;
-        (*_jacobianSparsity)(&row, &col, &nnz);
+        loadJacobianSparsity(&row, &col, &nnz);
 
-        CppAD::vector<Base> compressed(nnz);
+        CompressedArray compressed(nnz);
 
         if (nnz > 0) {
-            _in[0] = x.data();
-            _out[0] = &compressed[0];
+            ArgumentArray<const Base> in(_inSize);
+            ArgumentArray<Base> out(_outSize);
+            in[0] = x.data();
+            out[0] = compressed.data();
 
-            (*_sparseJacobian)(&_in[0], &_out[0], _atomicFuncArg);
+            (*_sparseJacobian)(in.data(), out.data(), _atomicFuncArg);
         }
 
         createDenseFromSparse(compressed,
@@ -645,24 +888,26 @@ public:
                         std::vector<size_t>& col) override {
         CPPADCG_ASSERT_KNOWN(_isLibraryReady, ERROR_LIBRARY_NOT_READY)
         CPPADCG_ASSERT_KNOWN(_sparseJacobian != nullptr, "No sparse Jacobian function defined in the dynamic library")
-        CPPADCG_ASSERT_KNOWN(_in.size() == 1, "The number of independent variable arrays is higher than 1,"
+        CPPADCG_ASSERT_KNOWN(_inSize == 1, "The number of independent variable arrays is higher than 1,"
                              " please use the variable size methods")
         CPPADCG_ASSERT_KNOWN(_missingAtomicFunctions == 0, "Some atomic functions used by the compiled model have not been specified yet")
 
         unsigned long const* drow;
         unsigned long const* dcol;
         unsigned long nnz;
-        (*_jacobianSparsity)(&drow, &dcol, &nnz);
+        loadJacobianSparsity(&drow, &dcol, &nnz);
 
         jac.resize(nnz);
         row.resize(nnz);
         col.resize(nnz);
 
         if (nnz > 0) {
-            _in[0] = &x[0];
-            _out[0] = &jac[0];
+            ArgumentArray<const Base> in(_inSize);
+            ArgumentArray<Base> out(_outSize);
+            in[0] = &x[0];
+            out[0] = &jac[0];
 
-            (*_sparseJacobian)(&_in[0], &_out[0], _atomicFuncArg);
+            (*_sparseJacobian)(in.data(), out.data(), _atomicFuncArg);
             std::copy(drow, drow + nnz, row.begin());
             std::copy(dcol, dcol + nnz, col.begin());
         }
@@ -674,7 +919,7 @@ public:
                         size_t const** col) override {
         CPPADCG_ASSERT_KNOWN(_isLibraryReady, ERROR_LIBRARY_NOT_READY)
         CPPADCG_ASSERT_KNOWN(_sparseJacobian != nullptr, "No sparse Jacobian function defined in the dynamic library")
-        CPPADCG_ASSERT_KNOWN(_in.size() == 1, "The number of independent variable arrays is higher than 1,"
+        CPPADCG_ASSERT_KNOWN(_inSize == 1, "The number of independent variable arrays is higher than 1,"
                              " please use the variable size methods")
         CPPADCG_ASSERT_KNOWN(x.size() == _n, "Invalid independent array size")
         CPPADCG_ASSERT_KNOWN(_missingAtomicFunctions == 0, "Some atomic functions used by the compiled model have not been specified yet")
@@ -682,16 +927,18 @@ public:
         unsigned long const* drow;
         unsigned long const* dcol;
         unsigned long nnz;
-        (*_jacobianSparsity)(&drow, &dcol, &nnz);
+        loadJacobianSparsity(&drow, &dcol, &nnz);
         CPPADCG_ASSERT_KNOWN(nnz == jac.size(), "Invalid number of non-zero elements in Jacobian")
         *row = drow;
         *col = dcol;
 
         if (nnz > 0) {
-            _in[0] = x.data();
-            _out[0] = jac.data();
+            ArgumentArray<const Base> in(_inSize);
+            ArgumentArray<Base> out(_outSize);
+            in[0] = x.data();
+            out[0] = jac.data();
 
-            (*_sparseJacobian)(&_in[0], &_out[0], _atomicFuncArg);
+            (*_sparseJacobian)(in.data(), out.data(), _atomicFuncArg);
         }
     }
 
@@ -701,21 +948,22 @@ public:
                         size_t const** col) override {
         CPPADCG_ASSERT_KNOWN(_isLibraryReady, ERROR_LIBRARY_NOT_READY)
         CPPADCG_ASSERT_KNOWN(_sparseJacobian != nullptr, "No sparse Jacobian function defined in the dynamic library")
-        CPPADCG_ASSERT_KNOWN(_in.size() == x.size(), "The number of independent variable arrays is invalid")
+        CPPADCG_ASSERT_KNOWN(_inSize == x.size(), "The number of independent variable arrays is invalid")
         CPPADCG_ASSERT_KNOWN(_missingAtomicFunctions == 0, "Some atomic functions used by the compiled model have not been specified yet")
 
         unsigned long const* drow;
         unsigned long const* dcol;
         unsigned long nnz;
-        (*_jacobianSparsity)(&drow, &dcol, &nnz);
+        loadJacobianSparsity(&drow, &dcol, &nnz);
         CPPADCG_ASSERT_KNOWN(nnz == jac.size(), "Invalid number of non-zero elements in Jacobian")
         *row = drow;
         *col = dcol;
 
         if (nnz > 0) {
-            _out[0] = jac.data();
+            ArgumentArray<Base> out(_outSize);
+            out[0] = jac.data();
 
-            (*_sparseJacobian)(&x[0], &_out[0], _atomicFuncArg);
+            (*_sparseJacobian)(&x[0], out.data(), _atomicFuncArg);
         }
     }
 
@@ -733,21 +981,23 @@ public:
         CPPADCG_ASSERT_KNOWN(x.size() == _n, "Invalid independent array size")
         CPPADCG_ASSERT_KNOWN(w.size() == _m, "Invalid multiplier array size")
         // CPPADCG_ASSERT_KNOWN(hess.size() == _n * _n, "Invalid Hessian size")
-        CPPADCG_ASSERT_KNOWN(_in.size() == 1, "The number of independent variable arrays is higher than 1,"
+        CPPADCG_ASSERT_KNOWN(_inSize == 1, "The number of independent variable arrays is higher than 1,"
                              " please use the variable size methods")
         CPPADCG_ASSERT_KNOWN(_missingAtomicFunctions == 0, "Some atomic functions used by the compiled model have not been specified yet")
 
         unsigned long const* row, *col;
         unsigned long nnz;
-        (*_hessianSparsity)(&row, &col, &nnz);
+        loadHessianSparsity(&row, &col, &nnz);
 
-        CppAD::vector<Base> compressed(nnz);
+        CompressedArray compressed(nnz);
         if (nnz > 0) {
-            _inHess[0] = x.data();
-            _inHess[1] = w.data();
-            _out[0] = &compressed[0];
+            ArgumentArray<const Base> in(_inSize + 1);
+            ArgumentArray<Base> out(_outSize);
+            in[0] = x.data();
+            in[1] = w.data();
+            out[0] = compressed.data();
 
-            (*_sparseHessian)(&_inHess[0], &_out[0], _atomicFuncArg);
+            (*_sparseHessian)(in.data(), out.data(), _atomicFuncArg);
         }
 
         createDenseFromSparse(compressed,
@@ -766,13 +1016,13 @@ public:
         CPPADCG_ASSERT_KNOWN(_sparseHessian != nullptr, "No sparse Hessian function defined in the dynamic library")
         CPPADCG_ASSERT_KNOWN(x.size() == _n, "Invalid independent array size")
         CPPADCG_ASSERT_KNOWN(w.size() == _m, "Invalid multiplier array size")
-        CPPADCG_ASSERT_KNOWN(_in.size() == 1, "The number of independent variable arrays is higher than 1,"
+        CPPADCG_ASSERT_KNOWN(_inSize == 1, "The number of independent variable arrays is higher than 1,"
                              " please use the variable size methods")
         CPPADCG_ASSERT_KNOWN(_missingAtomicFunctions == 0, "Some atomic functions used by the compiled model have not been specified yet")
 
         unsigned long const* drow, *dcol;
         unsigned long nnz;
-        (*_hessianSparsity)(&drow, &dcol, &nnz);
+        loadHessianSparsity(&drow, &dcol, &nnz);
 
         hess.resize(nnz);
         row.resize(nnz);
@@ -782,11 +1032,13 @@ public:
             std::copy(drow, drow + nnz, row.begin());
             std::copy(dcol, dcol + nnz, col.begin());
 
-            _inHess[0] = &x[0];
-            _inHess[1] = &w[0];
-            _out[0] = &hess[0];
+            ArgumentArray<const Base> in(_inSize + 1);
+            ArgumentArray<Base> out(_outSize);
+            in[0] = &x[0];
+            in[1] = &w[0];
+            out[0] = &hess[0];
 
-            (*_sparseHessian)(&_inHess[0], &_out[0], _atomicFuncArg);
+            (*_sparseHessian)(in.data(), out.data(), _atomicFuncArg);
         }
     }
 
@@ -797,7 +1049,7 @@ public:
                        size_t const** col) override {
         CPPADCG_ASSERT_KNOWN(_isLibraryReady, ERROR_LIBRARY_NOT_READY)
         CPPADCG_ASSERT_KNOWN(_sparseHessian != nullptr, "No sparse Hessian function defined in the dynamic library")
-        CPPADCG_ASSERT_KNOWN(_in.size() == 1, "The number of independent variable arrays is higher than 1,"
+        CPPADCG_ASSERT_KNOWN(_inSize == 1, "The number of independent variable arrays is higher than 1,"
                              " please use the variable size methods")
         CPPADCG_ASSERT_KNOWN(x.size() == _n, "Invalid independent array size")
         CPPADCG_ASSERT_KNOWN(w.size() == _m, "Invalid multiplier array size")
@@ -805,17 +1057,19 @@ public:
 
         unsigned long const* drow, *dcol;
         unsigned long nnz;
-        (*_hessianSparsity)(&drow, &dcol, &nnz);
+        loadHessianSparsity(&drow, &dcol, &nnz);
         CPPADCG_ASSERT_KNOWN(nnz == hess.size(), "Invalid number of non-zero elements in Hessian")
         *row = drow;
         *col = dcol;
 
         if (nnz > 0) {
-            _inHess[0] = x.data();
-            _inHess[1] = w.data();
-            _out[0] = hess.data();
+            ArgumentArray<const Base> in(_inSize + 1);
+            ArgumentArray<Base> out(_outSize);
+            in[0] = x.data();
+            in[1] = w.data();
+            out[0] = hess.data();
 
-            (*_sparseHessian)(&_inHess[0], &_out[0], _atomicFuncArg);
+            (*_sparseHessian)(in.data(), out.data(), _atomicFuncArg);
         }
     }
 
@@ -826,26 +1080,143 @@ public:
                        size_t const** col) override {
         CPPADCG_ASSERT_KNOWN(_isLibraryReady, ERROR_LIBRARY_NOT_READY)
         CPPADCG_ASSERT_KNOWN(_sparseHessian != nullptr, "No sparse Hessian function defined in the dynamic library")
-        CPPADCG_ASSERT_KNOWN(_in.size() == x.size(), "The number of independent variable arrays is invalid")
+        CPPADCG_ASSERT_KNOWN(_inSize == x.size(), "The number of independent variable arrays is invalid")
         CPPADCG_ASSERT_KNOWN(w.size() == _m, "Invalid multiplier array size")
         CPPADCG_ASSERT_KNOWN(_missingAtomicFunctions == 0, "Some atomic functions used by the compiled model have not been specified yet")
 
         unsigned long const* drow, *dcol;
         unsigned long nnz;
-        (*_hessianSparsity)(&drow, &dcol, &nnz);
+        loadHessianSparsity(&drow, &dcol, &nnz);
         CPPADCG_ASSERT_KNOWN(nnz == hess.size(), "Invalid number of non-zero elements in Hessian")
         *row = drow;
         *col = dcol;
 
         if (nnz > 0) {
-            std::copy(x.begin(), x.end(), _inHess.begin());
-            _inHess.back() = w.data(); // the index might not be 1
-            _out[0] = hess.data();
+            ArgumentArray<const Base> in(_inSize + 1);
+            ArgumentArray<Base> out(_outSize);
+            std::copy(x.begin(), x.end(), in.data());
+            in[_inSize] = w.data(); // the index might not be 1
+            out[0] = hess.data();
+
+            (*_sparseHessian)(in.data(), out.data(), _atomicFuncArg);
+        }
+    }
+
+    /// evaluate the model at several points
+
+    void ForwardZeroBatch(size_t nPoints,
+                          ArrayView<const Base> x,
+                          ArrayView<Base> dep,
+                          BatchLayout layout = BatchLayout::AoS) override {
+        if (_zeroBatch == nullptr) {
+            // the library was compiled without batch functions
+            GenericModel<Base>::ForwardZeroBatch(nPoints, x, dep, layout);
+            return;
+        }
+        CPPADCG_ASSERT_KNOWN(_isLibraryReady, ERROR_LIBRARY_NOT_READY)
+        CPPADCG_ASSERT_KNOWN(_inSize == 1, "The number of independent variable arrays is higher than 1,"
+                             " please use the variable size methods")
+        CPPADCG_ASSERT_KNOWN(x.size() == nPoints * _n, "Invalid independent array size")
+        CPPADCG_ASSERT_KNOWN(dep.size() == nPoints * _m, "Invalid dependent array size")
+        CPPADCG_ASSERT_KNOWN(_missingAtomicFunctions == 0, "Some atomic functions used by the compiled model have not been specified yet")
+
+        evalBatch(*_zeroBatch, _inSize, nPoints, x, ArrayView<const Base>(), false, dep, _m, layout);
+    }
+
+    /// calculate sparse Jacobians at several points
+
+    void SparseJacobianBatch(size_t nPoints,
+                             ArrayView<const Base> x,
+                             ArrayView<Base> jac,
+                             BatchLayout layout = BatchLayout::AoS) override {
+        if (_sparseJacobianBatch == nullptr) {
+            GenericModel<Base>::SparseJacobianBatch(nPoints, x, jac, layout);
+            return;
+        }
+        CPPADCG_ASSERT_KNOWN(_isLibraryReady, ERROR_LIBRARY_NOT_READY)
+        CPPADCG_ASSERT_KNOWN(_inSize == 1, "The number of independent variable arrays is higher than 1,"
+                             " please use the variable size methods")
+        CPPADCG_ASSERT_KNOWN(x.size() == nPoints * _n, "Invalid independent array size")
+        CPPADCG_ASSERT_KNOWN(_missingAtomicFunctions == 0, "Some atomic functions used by the compiled model have not been specified yet")
+
+        unsigned long const* row;
+        unsigned long const* col;
+        unsigned long nnz;
+        loadJacobianSparsity(&row, &col, &nnz);
+        CPPADCG_ASSERT_KNOWN(jac.size() == nPoints * nnz, "Invalid number of non-zero elements in Jacobian")
+
+        if (nnz > 0) {
+            evalBatch(*_sparseJacobianBatch, _inSize, nPoints, x, ArrayView<const Base>(), false, jac, nnz, layout);
+        }
+    }
 
-            (*_sparseHessian)(&_inHess[0], &_out[0], _atomicFuncArg);
+    /// calculate sparse Hessians at several points
+
+    void SparseHessianBatch(size_t nPoints,
+                            ArrayView<const Base> x,
+                            ArrayView<const Base> w,
+                            ArrayView<Base> hess,
+                            BatchLayout layout = BatchLayout::AoS) override {
+        if (_sparseHessianBatch == nullptr) {
+            GenericModel<Base>::SparseHessianBatch(nPoints, x, w, hess, layout);
+            return;
+        }
+        const bool sharedW = w.size() == _m;
+        CPPADCG_ASSERT_KNOWN(_isLibraryReady, ERROR_LIBRARY_NOT_READY)
+        CPPADCG_ASSERT_KNOWN(_inSize == 1, "The number of independent variable arrays is higher than 1,"
+                             " please use the variable size methods")
+        CPPADCG_ASSERT_KNOWN(x.size() == nPoints * _n, "Invalid independent array size")
+        CPPADCG_ASSERT_KNOWN(sharedW || w.size() == nPoints * _m, "Invalid multiplier array size")
+        CPPADCG_ASSERT_KNOWN(_missingAtomicFunctions == 0, "Some atomic functions used by the compiled model have not been specified yet")
+
+        unsigned long const* row;
+        unsigned long const* col;
+        unsigned long nnz;
+        loadHessianSparsity(&row, &col, &nnz);
+        CPPADCG_ASSERT_KNOWN(hess.size() == nPoints * nnz, "Invalid number of non-zero elements in Hessian")
+
+        if (nnz > 0) {
+            evalBatch(*_sparseHessianBatch, _inSize + 1, nPoints, x, w, sharedW, hess, nnz, layout);
         }
     }
 
+    /**
+     * Provides the elapsed times of the jobs of the multithreaded sparse
+     * Jacobian measured by the pthread pool of the model library (see
+     * ModelLibrary::setThreadPoolNumberOfTimeMeas()).
+     * These times can be provided to
+     * ModelCSourceGen::setSparseJacobianJobTimings() so that the next
+     * version of the library uses jobs with similar evaluation times.
+     * The time of a job with several columns (or rows) is divided evenly
+     * among them.
+     * This method should not be called while the sparse Jacobian is being
+     * evaluated.
+     *
+     * @return the elapsed time (in seconds) of each column (forward mode)
+     *         or row (reverse mode) of the Jacobian; empty if no time has
+     *         been measured yet or if the sparse Jacobian is not
+     *         multithreaded
+     */
+    std::map<size_t, float> getSparseJacobianJobTimings() {
+        return loadJobTimings(_sparseJacobianJobTimings);
+    }
+
+    /**
+     * Provides the elapsed times of the jobs of the multithreaded sparse
+     * Hessian measured by the pthread pool of the model library.
+     * These times can be provided to
+     * ModelCSourceGen::setSparseHessianJobTimings().
+     * This method should not be called while the sparse Hessian is being
+     * evaluated.
+     *
+     * @return the elapsed time (in seconds) of each row of the Hessian;
+     *         empty if no time has been measured yet or if the sparse
+     *         Hessian is not multithreaded
+     */
+    std::map<size_t, float> getSparseHessianJobTimings() {
+        return loadJobTimings(_sparseHessianJobTimings);
+    }
+
 protected:
 
     /**
@@ -858,25 +1229,32 @@ protected:
         _name(std::move(name)),
         _m(0),
         _n(0),
+        _inSize(0),
+        _outSize(0),
         _atomicFuncArg{nullptr}, // not really required
         _missingAtomicFunctions(0),
-        _zero(nullptr),
-        _forwardOne(nullptr),
-        _reverseOne(nullptr),
-        _reverseTwo(nullptr),
-        _jacobian(nullptr),
-        _hessian(nullptr),
-        _sparseForwardOne(nullptr),
-        _sparseReverseOne(nullptr),
-        _sparseReverseTwo(nullptr),
-        _sparseJacobian(nullptr),
-        _sparseHessian(nullptr),
-        _forwardOneSparsity(nullptr),
-        _reverseOneSparsity(nullptr),
-        _reverseTwoSparsity(nullptr),
-        _jacobianSparsity(nullptr),
-        _hessianSparsity(nullptr),
-        _hessianSparsity2(nullptr),
+        _zero(this, ModelCSourceGen<Base>::FUNCTION_FORWAD_ZERO),
+        _forwardOne(this, ModelCSourceGen<Base>::FUNCTION_FORWARD_ONE),
+        _reverseOne(this, ModelCSourceGen<Base>::FUNCTION_REVERSE_ONE),
+        _reverseTwo(this, ModelCSourceGen<Base>::FUNCTION_REVERSE_TWO),
+        _jacobian(this, ModelCSourceGen<Base>::FUNCTION_JACOBIAN),
+        _hessian(this, ModelCSourceGen<Base>::FUNCTION_HESSIAN),
+        _sparseForwardOne(this, ModelCSourceGen<Base>::FUNCTION_SPARSE_FORWARD_ONE),
+        _sparseReverseOne(this, ModelCSourceGen<Base>::FUNCTION_SPARSE_REVERSE_ONE),
+        _sparseReverseTwo(this, ModelCSourceGen<Base>::FUNCTION_SPARSE_REVERSE_TWO),
+        _sparseJacobian(this, ModelCSourceGen<Base>::FUNCTION_SPARSE_JACOBIAN),
+        _sparseHessian(this, ModelCSourceGen<Base>::FUNCTION_SPARSE_HESSIAN),
+        _zeroBatch(this, ModelCSourceGen<Base>::FUNCTION_FORWAD_ZERO + ModelCSourceGen<Base>::FUNCTION_BATCH_SUFFIX),
+        _sparseJacobianBatch(this, ModelCSourceGen<Base>::FUNCTION_SPARSE_JACOBIAN + ModelCSourceGen<Base>::FUNCTION_BATCH_SUFFIX),
+        _sparseHessianBatch(this, ModelCSourceGen<Base>::FUNCTION_SPARSE_HESSIAN + ModelCSourceGen<Base>::FUNCTION_BATCH_SUFFIX),
+        _sparseJacobianJobTimings(this, ModelCSourceGen<Base>::FUNCTION_SPARSE_JACOBIAN + ModelCSourceGen<Base>::FUNCTION_JOB_TIMINGS_SUFFIX),
+        _sparseHessianJobTimings(this, ModelCSourceGen<Base>::FUNCTION_SPARSE_HESSIAN + ModelCSourceGen<Base>::FUNCTION_JOB_TIMINGS_SUFFIX),
+        _forwardOneSparsity(this, ModelCSourceGen<Base>::FUNCTION_FORWARD_ONE_SPARSITY),
+        _reverseOneSparsity(this, ModelCSourceGen<Base>::FUNCTION_REVERSE_ONE_SPARSITY),
+        _reverseTwoSparsity(this, ModelCSourceGen<Base>::FUNCTION_REVERSE_TWO_SPARSITY),
+        _jacobianSparsity(this, ModelCSourceGen<Base>::FUNCTION_JACOBIAN_SPARSITY),
+        _hessianSparsity(this, ModelCSourceGen<Base>::FUNCTION_HESSIAN_SPARSITY),
+        _hessianSparsity2(this, ModelCSourceGen<Base>::FUNCTION_HESSIAN_SPARSITY2),
         _atomicFunctions(nullptr) {
 
     }
@@ -909,9 +1287,8 @@ protected:
         unsigned int outSize = 0;
         (*infoFunc)(&dynamicLibBaseName, &_m, &_n, &inSize, &outSize);
 
-        _in.resize(inSize);
-        _inHess.resize(inSize + 1);
-        _out.resize(outSize);
+        _inSize = inSize;
+        _outSize = outSize;
 
         CPPADCG_ASSERT_KNOWN(local == std::string(dynamicLibBaseName),
                              (std::string("Invalid data type in dynamic library. Expected '") + local
@@ -924,35 +1301,14 @@ protected:
         _isLibraryReady = true;
     }
 
+    /**
+     * Loads the functions required to create the model.
+     * The other functions of the model are only resolved when they are
+     * used for the first time (see resolveFunctions()).
+     */
     virtual void loadFunctions() {
-        _zero = reinterpret_cast<decltype(_zero)>(loadFunction(_name + "_" + ModelCSourceGen<Base>::FUNCTION_FORWAD_ZERO, false));
-        _forwardOne = reinterpret_cast<decltype(_forwardOne)>(loadFunction(_name + "_" + ModelCSourceGen<Base>::FUNCTION_FORWARD_ONE, false));
-        _reverseOne = reinterpret_cast<decltype(_reverseOne)>(loadFunction(_name + "_" + ModelCSourceGen<Base>::FUNCTION_REVERSE_ONE, false));
-        _reverseTwo = reinterpret_cast<decltype(_reverseTwo)>(loadFunction(_name + "_" + ModelCSourceGen<Base>::FUNCTION_REVERSE_TWO, false));
-        _jacobian = reinterpret_cast<decltype(_jacobian)>(loadFunction(_name + "_" + ModelCSourceGen<Base>::FUNCTION_JACOBIAN, false));
-        _hessian = reinterpret_cast<decltype(_hessian)>(loadFunction(_name + "_" + ModelCSourceGen<Base>::FUNCTION_HESSIAN, false));
-        _sparseForwardOne = reinterpret_cast<decltype(_sparseForwardOne)>(loadFunction(_name + "_" + ModelCSourceGen<Base>::FUNCTION_SPARSE_FORWARD_ONE, false));
-        _sparseReverseOne = reinterpret_cast<decltype(_sparseReverseOne)>(loadFunction(_name + "_" + ModelCSourceGen<Base>::FUNCTION_SPARSE_REVERSE_ONE, false));
-        _sparseReverseTwo = reinterpret_cast<decltype(_sparseReverseTwo)>(loadFunction(_name + "_" + ModelCSourceGen<Base>::FUNCTION_SPARSE_REVERSE_TWO, false));
-        _sparseJacobian = reinterpret_cast<decltype(_sparseJacobian)>(loadFunction(_name + "_" + ModelCSourceGen<Base>::FUNCTION_SPARSE_JACOBIAN, false));
-        _sparseHessian = reinterpret_cast<decltype(_sparseHessian)>(loadFunction(_name + "_" + ModelCSourceGen<Base>::FUNCTION_SPARSE_HESSIAN, false));
-        _forwardOneSparsity = reinterpret_cast<decltype(_forwardOneSparsity)>(loadFunction(_name + "_" + ModelCSourceGen<Base>::FUNCTION_FORWARD_ONE_SPARSITY, false));
-        _reverseOneSparsity = reinterpret_cast<decltype(_reverseOneSparsity)>(loadFunction(_name + "_" + ModelCSourceGen<Base>::FUNCTION_REVERSE_ONE_SPARSITY, false));
-        _reverseTwoSparsity = reinterpret_cast<decltype(_reverseTwoSparsity)>(loadFunction(_name + "_" + ModelCSourceGen<Base>::FUNCTION_REVERSE_TWO_SPARSITY, false));
-        _jacobianSparsity = reinterpret_cast<decltype(_jacobianSparsity)>(loadFunction(_name + "_" + ModelCSourceGen<Base>::FUNCTION_JACOBIAN_SPARSITY, false));
-        _hessianSparsity = reinterpret_cast<decltype(_hessianSparsity)>(loadFunction(_name + "_" + ModelCSourceGen<Base>::FUNCTION_HESSIAN_SPARSITY, false));
-        _hessianSparsity2 = reinterpret_cast<decltype(_hessianSparsity2)>(loadFunction(_name + "_" + ModelCSourceGen<Base>::FUNCTION_HESSIAN_SPARSITY2, false));
         _atomicFunctions = reinterpret_cast<decltype(_atomicFunctions)>(loadFunction(_name + "_" + ModelCSourceGen<Base>::FUNCTION_ATOMIC_FUNC_NAMES, true));
 
-        CPPADCG_ASSERT_KNOWN((_sparseForwardOne == nullptr) == (_forwardOneSparsity == nullptr), "Missing functions in the dynamic library")
-        CPPADCG_ASSERT_KNOWN((_sparseForwardOne == nullptr) == (_forwardOne == nullptr), "Missing functions in the dynamic library")
-        CPPADCG_ASSERT_KNOWN((_sparseReverseOne == nullptr) == (_reverseOneSparsity == nullptr), "Missing functions in the dynamic library")
-        CPPADCG_ASSERT_KNOWN((_sparseReverseOne == nullptr) == (_reverseOne == nullptr), "Missing functions in the dynamic library")
-        CPPADCG_ASSERT_KNOWN((_sparseReverseTwo == nullptr) == (_reverseTwoSparsity == nullptr), "Missing functions in the dynamic library")
-        CPPADCG_ASSERT_KNOWN((_sparseReverseTwo == nullptr) == (_reverseTwo == nullptr), "Missing functions in the dynamic library")
-        CPPADCG_ASSERT_KNOWN((_sparseJacobian == nullptr) || (_jacobianSparsity != nullptr), "Missing functions in the dynamic library")
-        CPPADCG_ASSERT_KNOWN((_sparseHessian == nullptr) || (_hessianSparsity != nullptr), "Missing functions in the dynamic library")
-
         /**
          * Prepare the atomic functions argument
          */
@@ -970,6 +1326,87 @@ protected:
         _atomicFuncArg.reverse = &atomicReverse;
 
         _missingAtomicFunctions = n;
+
+        /**
+         * atomic functions called directly by the generated code do not
+         * have to be provided
+         */
+        _linkedAtomic.assign(n, false);
+        void (*linkedAtomicFunctions)(const char***, unsigned long*);
+        linkedAtomicFunctions = reinterpret_cast<decltype(linkedAtomicFunctions)>(loadFunction(_name + "_" + ModelCSourceGen<Base>::FUNCTION_LINKED_ATOMIC_FUNC_NAMES, false));
+        if (linkedAtomicFunctions != nullptr) {
+            const char** linkedNames;
+            unsigned long nLinked;
+            (*linkedAtomicFunctions)(&linkedNames, &nLinked);
+            for (unsigned long l = 0; l < nLinked; ++l) {
+                for (unsigned long i = 0; i < n; ++i) {
+                    if (!_linkedAtomic[i] && _atomicNames[i] == linkedNames[l]) {
+                        _linkedAtomic[i] = true;
+                        _missingAtomicFunctions--;
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    /**
+     * Provides the Jacobian sparsity pattern of the compiled model.
+     * The pattern is only requested from the library once.
+     */
+    inline void loadJacobianSparsity(unsigned long const** rows,
+                                     unsigned long const** cols,
+                                     unsigned long* nnz) {
+        CPPADCG_ASSERT_KNOWN(_jacobianSparsity != nullptr, "No Jacobian sparsity function defined in the dynamic library")
+        std::call_once(_jacSparsityLoaded, [this]() {
+            (*_jacobianSparsity)(&_jacSparsityCache.rows, &_jacSparsityCache.cols, &_jacSparsityCache.nnz);
+        });
+        *rows = _jacSparsityCache.rows;
+        *cols = _jacSparsityCache.cols;
+        *nnz = _jacSparsityCache.nnz;
+    }
+
+    /**
+     * Provides the Hessian sparsity pattern of the compiled model.
+     * The pattern is only requested from the library once.
+     */
+    inline void loadHessianSparsity(unsigned long const** rows,
+                                    unsigned long const** cols,
+                                    unsigned long* nnz) {
+        CPPADCG_ASSERT_KNOWN(_hessianSparsity != nullptr, "No Hessian sparsity function defined in the dynamic library")
+        std::call_once(_hessSparsityLoaded, [this]() {
+            (*_hessianSparsity)(&_hessSparsityCache.rows, &_hessSparsityCache.cols, &_hessSparsityCache.nnz);
+        });
+        *rows = _hessSparsityCache.rows;
+        *cols = _hessSparsityCache.cols;
+        *nnz = _hessSparsityCache.nnz;
+    }
+
+    inline std::map<size_t, float> loadJobTimings(const LazyFunction<JobTimingsFunction>& jobTimings) {
+        CPPADCG_ASSERT_KNOWN(_isLibraryReady, ERROR_LIBRARY_NOT_READY)
+
+        std::map<size_t, float> timings;
+        if (jobTimings == nullptr)
+            return timings; // not multithreaded with pthreads
+
+        float const* elapsed;
+        unsigned long const* jobStart;
+        unsigned long const* indexes;
+        unsigned long nJobs;
+        unsigned int nMeas;
+        (*jobTimings)(&elapsed, &jobStart, &indexes, &nJobs, &nMeas);
+
+        if (nMeas == 0)
+            return timings;
+
+        for (unsigned long k = 0; k < nJobs; ++k) {
+            unsigned long size = jobStart[k + 1] - jobStart[k];
+            for (unsigned long e = jobStart[k]; e < jobStart[k + 1]; ++e) {
+                timings[indexes[e]] = elapsed[k] / size;
+            }
+        }
+
+        return timings;
     }
 
     template <class VectorSet>
@@ -1000,7 +1437,7 @@ protected:
         }
     }
 
-    inline void createDenseFromSparse(const CppAD::vector<Base>& compressed,
+    inline void createDenseFromSparse(const CompressedArray& compressed,
                                       unsigned long nrows, unsigned long ncols,
                                       unsigned long const* rows, unsigned long const* cols,
                                       unsigned long nnz,
@@ -1013,6 +1450,88 @@ protected:
         }
     }
 
+    /**
+     * Calls a batch function from the dynamic library.
+     * Arrays with a structure of arrays layout are converted to (and from)
+     * the arrays of structures layout used by the generated code.
+     *
+     * @param batch the batch function
+     * @param inSize the number of input arrays (the multipliers, if used,
+     *               are the last input)
+     * @param nPoints the number of points
+     * @param x the independent variables of all points
+     * @param w the multipliers (empty if not used)
+     * @param sharedW whether or not the same multipliers are used by all
+     *                points
+     * @param result the output of all points
+     * @param outSize the number of output elements of each point
+     * @param layout the memory layout of x, w, and result
+     */
+    inline void evalBatch(BatchFunction batch,
+                          size_t inSize,
+                          size_t nPoints,
+                          ArrayView<const Base> x,
+                          ArrayView<const Base> w,
+                          bool sharedW,
+                          ArrayView<Base> result,
+                          size_t outSize,
+                          BatchLayout layout) const {
+        if (nPoints == 0)
+            return;
+
+        std::vector<Base> xAoS, wAoS, outAoS;
+        const Base* xp = x.data();
+        const Base* wp = w.data();
+        Base* outp = result.data();
+
+        if (layout == BatchLayout::SoA && nPoints > 1) {
+            xAoS.resize(x.size());
+            transposeBatch(_n, nPoints, xp, xAoS.data());
+            xp = xAoS.data();
+            if (!w.empty() && !sharedW) {
+                wAoS.resize(w.size());
+                transposeBatch(_m, nPoints, wp, wAoS.data());
+                wp = wAoS.data();
+            }
+            outAoS.resize(result.size());
+            outp = outAoS.data();
+        }
+
+        ArgumentArray<const Base> in(inSize);
+        ArgumentArray<Base> out(_outSize);
+        std::vector<unsigned long> inStride(inSize, 0);
+        std::vector<unsigned long> outStride(_outSize, 0);
+
+        in[0] = xp;
+        inStride[0] = _n;
+        if (!w.empty()) {
+            in[inSize - 1] = wp;
+            inStride.back() = sharedW ? 0 : _m;
+        }
+        out[0] = outp;
+        outStride[0] = outSize;
+
+        (*batch)(nPoints, in.data(), &inStride[0], out.data(), &outStride[0], _atomicFuncArg);
+
+        if (!outAoS.empty()) {
+            transposeBatch(nPoints, outSize, outAoS.data(), result.data());
+        }
+    }
+
+    /**
+     * Transposes a row-major matrix.
+     */
+    static inline void transposeBatch(size_t nrows,
+                                      size_t ncols,
+                                      const Base* src,
+                                      Base* dst) {
+        for (size_t r = 0; r < nrows; ++r) {
+            for (size_t c = 0; c < ncols; ++c) {
+                dst[c * nrows + r] = src[r * ncols + c];
+            }
+        }
+    }
+
     virtual void modelLibraryClosed() {
         _isLibraryReady = false;
         _zero = nullptr;
@@ -1026,6 +1545,11 @@ protected:
         _sparseReverseTwo = nullptr;
         _sparseJacobian = nullptr;
         _sparseHessian = nullptr;
+        _zeroBatch = nullptr;
+        _sparseJacobianBatch = nullptr;
+        _sparseHessianBatch = nullptr;
+        _sparseJacobianJobTimings = nullptr;
+        _sparseHessianJobTimings = nullptr;
         _forwardOneSparsity = nullptr;
         _reverseOneSparsity = nullptr;
         _reverseTwoSparsity = nullptr;
@@ -1043,7 +1567,8 @@ private:
         for (size_t i = 0; i < n; i++) {
             if (name == _atomicNames[i]) {
                 if (_atomic[i] == nullptr) {
-                    _missingAtomicFunctions--;
+                    if (!_linkedAtomic[i])
+                        _missingAtomicFunctions--;
                 } else {
                     delete _atomic[i];
                 }
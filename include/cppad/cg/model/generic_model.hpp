@@ -30,6 +30,10 @@ protected:
     CGAtomicGenericModel<Base>* _atomic;
     // whether or not to evaluate forward mode of atomics during a reverse sweep
     bool _evalAtomicForwardOne4CppAD;
+    // the sparse Jacobian structure of the caller
+    std::unique_ptr<SparseOutputLayout> _jacLayout;
+    // the sparse Hessian structure of the caller
+    std::unique_ptr<SparseOutputLayout> _hessLayout;
 public:
 
     GenericModel() :
@@ -676,6 +680,88 @@ public:
                                 size_t const** row,
                                 size_t const** col) = 0;
 
+    /**
+     * Defines the sparse Jacobian structure used by the caller so that
+     * SparseJacobianToLayout() places the values directly in the caller's
+     * value array.
+     * The position of each element is only determined here, once.
+     *
+     * The values are written directly (without any copy) when the model
+     * already uses the same order (e.g. when the library was generated
+     * with ModelCSourceGen::setCustomSparseJacobianElements() using the
+     * same structure).
+     *
+     * @param format the format of the caller structure
+     * @param ptr the row (CSR) or column (CSC) pointers
+     * @param idx the column (CSR) or row (CSC) indexes
+     * @throws CGException if an element of the model sparsity is not part
+     *                     of the provided structure
+     */
+    inline void setSparseJacobianLayout(SparseFormat format,
+                                        ArrayView<const size_t> ptr,
+                                        ArrayView<const size_t> idx) {
+        std::vector<size_t> rows, cols;
+        JacobianSparsity(rows, cols);
+        _jacLayout.reset(new SparseOutputLayout(rows, cols, format, ptr, idx));
+    }
+
+    /**
+     * Defines the sparse Jacobian structure used by the caller through the
+     * row and column indexes of each element in the caller's value array.
+     *
+     * @param row the row indexes of the caller structure
+     * @param col the column indexes of the caller structure
+     * @throws CGException if an element of the model sparsity is not part
+     *                     of the provided structure
+     */
+    inline void setSparseJacobianLayout(const std::vector<size_t>& row,
+                                        const std::vector<size_t>& col) {
+        std::vector<size_t> rows, cols;
+        JacobianSparsity(rows, cols);
+        _jacLayout.reset(new SparseOutputLayout(rows, cols, row, col));
+    }
+
+    /**
+     * @return the sparse Jacobian structure of the caller or nullptr if
+     *         it was not defined
+     */
+    inline const SparseOutputLayout* getSparseJacobianLayout() const {
+        return _jacLayout.get();
+    }
+
+    inline void clearSparseJacobianLayout() {
+        _jacLayout.reset();
+    }
+
+    /**
+     * Determines the sparse Jacobian and places its values in the order
+     * of the structure defined with setSparseJacobianLayout().
+     * Elements of that structure which are not part of the model
+     * sparsity are set to zero.
+     *
+     * @param x independent variable array (must have n elements)
+     * @param values the values of the caller structure
+     */
+    virtual void SparseJacobianToLayout(ArrayView<const Base> x,
+                                        ArrayView<Base> values) {
+        if (_jacLayout == nullptr) {
+            throw CGException("No sparse Jacobian layout was defined for model '", getName(), "'");
+        }
+        CPPADCG_ASSERT_KNOWN(values.size() == _jacLayout->getTargetSize(), "Invalid Jacobian array size")
+
+        size_t const* row;
+        size_t const* col;
+
+        if (_jacLayout->isIdentity()) {
+            SparseJacobian(x, values, &row, &col);
+        } else {
+            // call-local so that the model can still be used from several threads
+            std::vector<Base> jac(_jacLayout->getModelSize());
+            SparseJacobian(x, ArrayView<Base>(jac), &row, &col);
+            _jacLayout->scatter(ArrayView<const Base>(jac), values);
+        }
+    }
+
     /***********************************************************************
      *                        Sparse Hessians
      **********************************************************************/
@@ -745,6 +831,222 @@ public:
                                size_t const** row,
                                size_t const** col) = 0;
 
+    /**
+     * Defines the sparse Hessian structure used by the caller so that
+     * SparseHessianToLayout() places the values directly in the caller's
+     * value array.
+     * Since the Hessian is symmetric, the caller structure can contain
+     * either triangle or both triangles, independently of the elements
+     * computed by the model.
+     *
+     * The values are written directly (without any copy) when the model
+     * already uses the same order (e.g. when the library was generated
+     * with ModelCSourceGen::setCustomSparseHessianElements() using the
+     * same structure).
+     *
+     * @param format the format of the caller structure
+     * @param ptr the row (CSR) or column (CSC) pointers
+     * @param idx the column (CSR) or row (CSC) indexes
+     * @throws CGException if an element of the model sparsity (or its
+     *                     symmetric) is not part of the provided structure
+     */
+    inline void setSparseHessianLayout(SparseFormat format,
+                                       ArrayView<const size_t> ptr,
+                                       ArrayView<const size_t> idx) {
+        std::vector<size_t> rows, cols;
+        HessianSparsity(rows, cols);
+        _hessLayout.reset(new SparseOutputLayout(rows, cols, format, ptr, idx, true));
+    }
+
+    /**
+     * Defines the sparse Hessian structure used by the caller through the
+     * row and column indexes of each element in the caller's value array.
+     *
+     * @param row the row indexes of the caller structure
+     * @param col the column indexes of the caller structure
+     * @throws CGException if an element of the model sparsity (or its
+     *                     symmetric) is not part of the provided structure
+     */
+    inline void setSparseHessianLayout(const std::vector<size_t>& row,
+                                       const std::vector<size_t>& col) {
+        std::vector<size_t> rows, cols;
+        HessianSparsity(rows, cols);
+        _hessLayout.reset(new SparseOutputLayout(rows, cols, row, col, true));
+    }
+
+    /**
+     * @return the sparse Hessian structure of the caller or nullptr if
+     *         it was not defined
+     */
+    inline const SparseOutputLayout* getSparseHessianLayout() const {
+        return _hessLayout.get();
+    }
+
+    inline void clearSparseHessianLayout() {
+        _hessLayout.reset();
+    }
+
+    /**
+     * Determines the sparse weighted sum of the Hessians and places its
+     * values in the order of the structure defined with
+     * setSparseHessianLayout().
+     * Elements of that structure which are not part of the model
+     * sparsity are set to zero.
+     *
+     * @param x independent variable array (must have n elements)
+     * @param w equation multipliers (must have m elements)
+     * @param values the values of the caller structure
+     */
+    virtual void SparseHessianToLayout(ArrayView<const Base> x,
+                                       ArrayView<const Base> w,
+                                       ArrayView<Base> values) {
+        if (_hessLayout == nullptr) {
+            throw CGException("No sparse Hessian layout was defined for model '", getName(), "'");
+        }
+        CPPADCG_ASSERT_KNOWN(values.size() == _hessLayout->getTargetSize(), "Invalid Hessian array size")
+
+        size_t const* row;
+        size_t const* col;
+
+        if (_hessLayout->isIdentity()) {
+            SparseHessian(x, w, values, &row, &col);
+        } else {
+            std::vector<Base> hess(_hessLayout->getModelSize());
+            SparseHessian(x, w, ArrayView<Base>(hess), &row, &col);
+            _hessLayout->scatter(ArrayView<const Base>(hess), values);
+        }
+    }
+
+    /***********************************************************************
+     *                    Batched (multi-point) evaluation
+     **********************************************************************/
+
+    /**
+     * Evaluates the dependent model variables (zero-order) at several
+     * points.
+     *
+     * @param nPoints The number of points
+     * @param x The independent variables of all points
+     *          (nPoints * n elements)
+     * @param dep The dependent variables of all points
+     *            (nPoints * m elements)
+     * @param layout The memory layout used by x and dep
+     */
+    virtual void ForwardZeroBatch(size_t nPoints,
+                                  ArrayView<const Base> x,
+                                  ArrayView<Base> dep,
+                                  BatchLayout layout = BatchLayout::AoS) {
+        const size_t n = Domain();
+        const size_t m = Range();
+        CPPADCG_ASSERT_KNOWN(x.size() == nPoints * n, "Invalid independent array size")
+        CPPADCG_ASSERT_KNOWN(dep.size() == nPoints * m, "Invalid dependent array size")
+
+        if (layout == BatchLayout::AoS) {
+            for (size_t p = 0; p < nPoints; ++p) {
+                ForwardZero(x.segment(p * n, n), dep.segment(p * m, m));
+            }
+        } else {
+            std::vector<Base> xp(n), yp(m);
+            for (size_t p = 0; p < nPoints; ++p) {
+                gatherPoint(nPoints, p, x, xp);
+                ForwardZero(ArrayView<const Base>(xp), ArrayView<Base>(yp));
+                scatterPoint(nPoints, p, yp, dep);
+            }
+        }
+    }
+
+    /**
+     * Determines the sparse Jacobian at several points.
+     * The non-zero elements of each point are provided in the order
+     * defined by JacobianSparsity(rows, cols).
+     *
+     * @param nPoints The number of points
+     * @param x The independent variables of all points
+     *          (nPoints * n elements)
+     * @param jac The values of the sparse Jacobians of all points
+     *            (nPoints * nnz elements)
+     * @param layout The memory layout used by x and jac
+     */
+    virtual void SparseJacobianBatch(size_t nPoints,
+                                     ArrayView<const Base> x,
+                                     ArrayView<Base> jac,
+                                     BatchLayout layout = BatchLayout::AoS) {
+        const size_t n = Domain();
+        CPPADCG_ASSERT_KNOWN(x.size() == nPoints * n, "Invalid independent array size")
+        CPPADCG_ASSERT_KNOWN(nPoints == 0 || jac.size() % nPoints == 0, "Invalid Jacobian array size")
+
+        if (nPoints == 0)
+            return;
+
+        const size_t nnz = jac.size() / nPoints;
+        size_t const* row;
+        size_t const* col;
+
+        if (layout == BatchLayout::AoS) {
+            for (size_t p = 0; p < nPoints; ++p) {
+                SparseJacobian(x.segment(p * n, n), jac.segment(p * nnz, nnz), &row, &col);
+            }
+        } else {
+            std::vector<Base> xp(n), jp(nnz);
+            for (size_t p = 0; p < nPoints; ++p) {
+                gatherPoint(nPoints, p, x, xp);
+                SparseJacobian(ArrayView<const Base>(xp), ArrayView<Base>(jp), &row, &col);
+                scatterPoint(nPoints, p, jp, jac);
+            }
+        }
+    }
+
+    /**
+     * Determines the sparse weighted sum of the Hessians at several points.
+     * The non-zero elements of each point are provided in the order
+     * defined by HessianSparsity(rows, cols).
+     *
+     * @param nPoints The number of points
+     * @param x The independent variables of all points
+     *          (nPoints * n elements)
+     * @param w The equation multipliers of all points (nPoints * m
+     *          elements) or the multipliers shared by all points
+     *          (m elements)
+     * @param hess The values of the sparse Hessians of all points
+     *             (nPoints * nnz elements)
+     * @param layout The memory layout used by x, w and hess
+     */
+    virtual void SparseHessianBatch(size_t nPoints,
+                                    ArrayView<const Base> x,
+                                    ArrayView<const Base> w,
+                                    ArrayView<Base> hess,
+                                    BatchLayout layout = BatchLayout::AoS) {
+        const size_t n = Domain();
+        const size_t m = Range();
+        const bool sharedW = w.size() == m;
+        CPPADCG_ASSERT_KNOWN(x.size() == nPoints * n, "Invalid independent array size")
+        CPPADCG_ASSERT_KNOWN(sharedW || w.size() == nPoints * m, "Invalid multiplier array size")
+        CPPADCG_ASSERT_KNOWN(nPoints == 0 || hess.size() % nPoints == 0, "Invalid Hessian array size")
+
+        if (nPoints == 0)
+            return;
+
+        const size_t nnz = hess.size() / nPoints;
+        size_t const* row;
+        size_t const* col;
+
+        if (layout == BatchLayout::AoS) {
+            for (size_t p = 0; p < nPoints; ++p) {
+                SparseHessian(x.segment(p * n, n), sharedW ? w : w.segment(p * m, m),
+                              hess.segment(p * nnz, nnz), &row, &col);
+            }
+        } else {
+            std::vector<Base> xp(n), wp(w.begin(), w.begin() + m), hp(nnz);
+            for (size_t p = 0; p < nPoints; ++p) {
+                gatherPoint(nPoints, p, x, xp);
+                if (!sharedW)
+                    gatherPoint(nPoints, p, w, wp);
+                SparseHessian(ArrayView<const Base>(xp), ArrayView<const Base>(wp), ArrayView<Base>(hp), &row, &col);
+                scatterPoint(nPoints, p, hp, hess);
+            }
+        }
+    }
+
     /**
      * Provides a wrapper for this compiled model allowing it to be used as
      * an atomic function. The model must not be deleted while the atomic
@@ -758,6 +1060,34 @@ public:
         }
         return *_atomic;
     }
+
+protected:
+
+    /**
+     * Copies the values of a single point from an array with a
+     * structure of arrays layout (BatchLayout::SoA).
+     */
+    static inline void gatherPoint(size_t nPoints,
+                                   size_t p,
+                                   ArrayView<const Base> soa,
+                                   std::vector<Base>& point) {
+        for (size_t j = 0; j < point.size(); ++j) {
+            point[j] = soa[j * nPoints + p];
+        }
+    }
+
+    /**
+     * Copies the values of a single point into an array with a
+     * structure of arrays layout (BatchLayout::SoA).
+     */
+    static inline void scatterPoint(size_t nPoints,
+                                    size_t p,
+                                    const std::vector<Base>& point,
+                                    ArrayView<Base> soa) {
+        for (size_t j = 0; j < point.size(); ++j) {
+            soa[j * nPoints + p] = point[j];
+        }
+    }
 };
 
 } // END cg namespace
@@ -59,6 +59,7 @@ protected:
     }
 
     void* loadFunction(const std::string& functionName, bool required = true) override {
+        std::lock_guard<std::mutex> lock(_dynLib->_loadMutex);
         return _dynLib->loadFunction(functionName, required);
     }
 
@@ -31,6 +31,11 @@ template<class Base>
 class LlvmModelLibrary : public FunctorModelLibrary<Base> {
 protected:
     std::set<LlvmModel<Base>*> _models;
+    /**
+     * serializes the optimization and compilation of functions (LLVM does
+     * not support concurrent calls) requested by different models
+     */
+    std::mutex _loadMutex;
 public:
     inline virtual ~LlvmModelLibrary() {
         // do not call clean-up here
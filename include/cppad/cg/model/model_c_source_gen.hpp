@@ -59,7 +59,11 @@ public:
     static const std::string FUNCTION_REVERSE_ONE_SPARSITY;
     static const std::string FUNCTION_REVERSE_TWO_SPARSITY;
     static const std::string FUNCTION_INFO;
+    static const std::string FUNCTION_BATCH_SUFFIX;
+    static const std::string FUNCTION_JOB_TIMINGS_SUFFIX;
     static const std::string FUNCTION_ATOMIC_FUNC_NAMES;
+    static const std::string FUNCTION_LINKED_ATOMIC_FUNC_NAMES;
+    static const std::string FUNCTION_DIRECT_ATOMIC;
 protected:
     static const std::string CONST;
 
@@ -161,6 +165,31 @@ protected:
      * the maximum precision used to print values
      */
     size_t _parameterPrecision;
+    /**
+     * whether or not the generated code should help compilers to vectorize
+     * loops
+     */
+    bool _loopVectorization;
+    /**
+     * whether or not the code handlers reuse structurally identical
+     * operation nodes while the model is evaluated (hash-consing)
+     */
+    bool _hashConsing;
+    /**
+     * whether or not common subexpressions are merged before the source
+     * code of each function is generated
+     */
+    bool _eliminateCSE;
+    /**
+     * whether or not the evaluation order of the variables is changed so
+     * that fewer temporary variables are alive at the same time
+     */
+    bool _minimizeLiveTemporaries;
+    /**
+     * the optimization passes applied to the operation graph of each
+     * function before generating source code (not owned by this object)
+     */
+    GraphOptimizer<Base>* _graphOptimizer;
     /**
      * Typical values of the independent vector
      */
@@ -193,6 +222,11 @@ protected:
     bool _reverseOne;
     /// generate source code for reverse second order mode
     bool _reverseTwo;
+    /**
+     * generate source code for functions which evaluate the zero order
+     * model, the sparse Jacobian, and the sparse Hessian at several points
+     */
+    bool _batch;
     /**
      * whether or not the sparse Jacobian should reuse the forward or reverse
      * one functions when _sparseJacobian is true
@@ -203,6 +237,17 @@ protected:
      * functions when _sparseHessian is true
      */
     bool _sparseHessianReusesRev2;
+    /**
+     * whether or not the sparse Jacobian should be evaluated with one
+     * compressed directional function for each group of structurally
+     * orthogonal columns (or rows)
+     */
+    bool _sparseJacobianColoring;
+    /**
+     * whether or not the sparse Hessian should be evaluated with one
+     * compressed directional function for each color of a star coloring
+     */
+    bool _sparseHessianColoring;
     JacobianADMode _jacMode;
     /**
      * Custom Jacobian element indexes
@@ -226,6 +271,17 @@ protected:
      * Maps each atomic function ID to information regarding how the atomic function is used
      */
     std::map<size_t, AtomicUseInfo<Base> >* _atomicsInfo;
+    /**
+     * Atomic functions which are other models in the same library and
+     * which are called directly by the generated code
+     * (maps the atomic function names to the prefix of their C functions)
+     */
+    std::map<std::string, std::string> _directAtomicFunctions;
+    /**
+     * whether or not to generate the functions used by other models in the
+     * same library to call this model directly as an atomic function
+     */
+    bool _directAtomic;
     /**
      * A string cache for code generation
      */
@@ -238,10 +294,35 @@ protected:
      * the maximum number of operations per variable assignment
      */
     size_t _maxOperationsPerAssignment;
+    /**
+     * Elapsed times (in seconds) previously measured for the jobs of the
+     * multithreaded sparse Jacobian (column or row index -> time)
+     */
+    std::map<size_t, float> _jacJobTimings;
+    /**
+     * Elapsed times (in seconds) previously measured for the jobs of the
+     * multithreaded sparse Hessian (row index -> time)
+     */
+    std::map<size_t, float> _hessJobTimings;
+    /**
+     * the maximum number of threads used to generate the source code of
+     * the directional functions (forward one, reverse one, reverse two)
+     */
+    size_t _maxSourceGenerationJobs;
     /**
      *
      */
     std::vector<std::set<size_t> > _relatedDepCandidates;
+    /**
+     * whether or not to determine the groups of related dependents from
+     * the structure of their expressions when none are provided
+     */
+    bool _detectRelatedDependents;
+    /**
+     * the minimum number of dependents in an automatically detected group
+     * of related dependents
+     */
+    size_t _minRelatedDependents;
     /**
      * Maps the column groups of each loop model to the set of columns
      * (loop->group->{columns->{compressed forward 1 position} })
@@ -296,6 +377,11 @@ public:
         _name(std::move(model)),
         _baseTypeName(ModelCSourceGen<Base>::baseTypeName()),
         _parameterPrecision(std::numeric_limits<Base>::digits10),
+        _loopVectorization(false),
+        _hashConsing(false),
+        _eliminateCSE(false),
+        _minimizeLiveTemporaries(false),
+        _graphOptimizer(nullptr),
         _multiThreading(true),
         _zero(true),
         _zeroEvaluated(false),
@@ -307,12 +393,19 @@ public:
         _forwardOne(false),
         _reverseOne(false),
         _reverseTwo(false),
+        _batch(false),
         _sparseJacobianReusesOne(true),
         _sparseHessianReusesRev2(true),
+        _sparseJacobianColoring(false),
+        _sparseHessianColoring(false),
         _jacMode(JacobianADMode::Automatic),
         _atomicsInfo(nullptr),
+        _directAtomic(false),
         _maxAssignPerFunc(20000),
         _maxOperationsPerAssignment(1000),
+        _maxSourceGenerationJobs(1),
+        _detectRelatedDependents(false),
+        _minRelatedDependents(2),
         _jobTimer(nullptr) {
 
         CPPADCG_ASSERT_KNOWN(!_name.empty(), "Model name cannot be empty");
@@ -367,6 +460,33 @@ public:
         return _relatedDepCandidates;
     }
 
+    /**
+     * Whether or not the groups of related dependents are determined
+     * automatically when none are provided with setRelatedDependents().
+     */
+    inline bool isDetectRelatedDependents() const {
+        return _detectRelatedDependents;
+    }
+
+    /**
+     * Defines whether or not to determine the groups of related dependents
+     * automatically, from the structure of their expressions, when none
+     * are provided with setRelatedDependents().
+     * Dependents in the same group are only placed in a loop if they
+     * really share the same expression pattern.
+     * The detected groups are available through getRelatedDependents()
+     * once the source code is generated.
+     *
+     * @param detect whether or not to detect the related dependents
+     * @param minGroupSize the minimum number of dependents with the same
+     *                     expression structure required to create a group
+     */
+    inline void setDetectRelatedDependents(bool detect,
+                                           size_t minGroupSize = 2) {
+        _detectRelatedDependents = detect;
+        _minRelatedDependents = minGroupSize;
+    }
+
     /**
      * Provides the maximum precision used to print constant values in the
      * generated source code
@@ -387,15 +507,124 @@ public:
         _parameterPrecision = p;
     }
 
+    /**
+     * Whether or not the generated source code helps compilers to vectorize
+     * the loops created from patterns in the model equations.
+     */
+    inline bool isLoopVectorization() const {
+        return _loopVectorization;
+    }
+
+    /**
+     * Defines whether or not the generated source code should help
+     * compilers to vectorize the loops created from patterns in the model
+     * equations (see LanguageC::setLoopVectorization()).
+     * The input and output arrays provided to the generated functions must
+     * not overlap.
+     *
+     * @param vectorize whether or not to generate vectorization hints
+     */
+    inline void setLoopVectorization(bool vectorize) {
+        _loopVectorization = vectorize;
+    }
+
+    /**
+     * Whether or not structurally identical operations are shared while
+     * the model is evaluated to generate source code.
+     */
+    inline bool isHashConsing() const {
+        return _hashConsing;
+    }
+
+    /**
+     * Defines whether or not structurally identical operations should be
+     * shared while the model is evaluated to generate source code
+     * (see CodeHandler::setHashConsing()).
+     * It is not used for models with loops.
+     *
+     * @param hashConsing whether or not to reuse identical operations
+     */
+    inline void setHashConsing(bool hashConsing) {
+        _hashConsing = hashConsing;
+    }
+
+    /**
+     * Whether or not common subexpressions are merged before the source
+     * code of each function is generated.
+     */
+    inline bool isEliminateCommonSubexpressions() const {
+        return _eliminateCSE;
+    }
+
+    /**
+     * Defines whether or not common subexpressions should be merged before
+     * the source code of each function is generated
+     * (see CodeHandler::setEliminateCommonSubexpressions()).
+     *
+     * @param eliminate whether or not to merge common subexpressions
+     */
+    inline void setEliminateCommonSubexpressions(bool eliminate) {
+        _eliminateCSE = eliminate;
+    }
+
+    /**
+     * Whether or not the evaluation order of the variables in the generated
+     * functions is changed so that fewer temporary variables are alive at
+     * the same time.
+     */
+    inline bool isMinimizeLiveTemporaries() const {
+        return _minimizeLiveTemporaries;
+    }
+
+    /**
+     * Defines whether or not the evaluation order of the variables in the
+     * generated functions should be changed so that fewer temporary
+     * variables are alive at the same time
+     * (see CodeHandler::setMinimizeLiveTemporaries()).
+     *
+     * @param minimize whether or not to reduce the size of the work arrays
+     */
+    inline void setMinimizeLiveTemporaries(bool minimize) {
+        _minimizeLiveTemporaries = minimize;
+    }
+
+    /**
+     * Provides the optimization passes applied to the operation graph of
+     * each function before its source code is generated.
+     *
+     * @return the optimizer (nullptr if there is none)
+     */
+    inline GraphOptimizer<Base>* getGraphOptimizer() const {
+        return _graphOptimizer;
+    }
+
+    /**
+     * Defines the optimization passes applied to the operation graph of
+     * each function before its source code is generated
+     * (see CodeHandler::setGraphOptimizer()).
+     * They are also used by the models created with
+     * BytecodeModelLibraryProcessor.
+     * The optimizer is not owned by this object and it must exist while
+     * source code is generated.
+     * Source code is generated by a single thread when an optimizer is
+     * used (see setMaxSourceGenerationJobs()).
+     *
+     * @param optimizer the optimization pipeline (nullptr to disable)
+     */
+    inline void setGraphOptimizer(GraphOptimizer<Base>* optimizer) {
+        _graphOptimizer = optimizer;
+    }
+
     /**
      * Returns whether or not multithreading directives can be generated to
      * parallelize the sparse Jacobian and sparse Hessian evaluation.
      * Multithreaded code is only generated if requested by the model library.
-     * For the sparse Jacobian, the _sparseJacobianReusesOne must be enabled,
-     * at least one of _forwardOne and _reverseOne must be enabled, and loop
+     * For the sparse Jacobian, either coloring must be enabled or
+     * _sparseJacobianReusesOne and at least one of _forwardOne and
+     * _reverseOne must be enabled, and loop detection must be disabled.
+     * For the sparse Hessian, either coloring or both
+     * _sparseHessianReusesRev2 and _reverseTwo must be enabled and loop
      * detection must be disabled.
-     * For the sparse Hessian, the _sparseHessianReusesRev2 and _reverseTwo
-     * must be enabled and loop detection must be disabled.
      *
      * @return whether or not multithreading can be used for this model
      */
@@ -407,11 +636,12 @@ public:
      * Defines whether or not multithreading directives can be generated to
      * parallelize the sparse Jacobian and sparse Hessian evaluation.
      * Multithreaded code is only generated if requested by the model library.
-     * For the sparse Jacobian, the _sparseJacobianReusesOne must be enabled,
-     * at least one of _forwardOne and _reverseOne must be enabled, and loop
+     * For the sparse Jacobian, either coloring must be enabled or
+     * _sparseJacobianReusesOne and at least one of _forwardOne and
+     * _reverseOne must be enabled, and loop detection must be disabled.
+     * For the sparse Hessian, either coloring or both
+     * _sparseHessianReusesRev2 and _reverseTwo must be enabled and loop
      * detection must be disabled.
-     * For the sparse Hessian, the _sparseHessianReusesRev2 and _reverseTwo
-     * must be enabled and loop detection must be disabled.
      *
      * @param multiThreading whether or not multithreading can be used for this
      *                       model
@@ -421,11 +651,62 @@ public:
     }
 
     inline bool isJacobianMultiThreadingEnabled() const {
-        return _multiThreading && _loopTapes.empty() && _sparseJacobian && _sparseJacobianReusesOne && (_forwardOne || _reverseOne);
+        return _multiThreading && _loopTapes.empty() && _sparseJacobian &&
+                (_sparseJacobianColoring || (_sparseJacobianReusesOne && (_forwardOne || _reverseOne)));
     }
 
     inline bool isHessianMultiThreadingEnabled() const {
-        return _multiThreading && _loopTapes.empty() && _sparseHessian && _sparseHessianReusesRev2 && _reverseTwo;
+        return _multiThreading && _loopTapes.empty() && _sparseHessian &&
+                (_sparseHessianColoring || (_sparseHessianReusesRev2 && _reverseTwo));
+    }
+
+    /**
+     * Provides the elapsed times of the jobs of the multithreaded sparse
+     * Jacobian used to group its columns (or rows) into jobs.
+     *
+     * @return the elapsed time of each column (forward mode) or row
+     *         (reverse mode) of the Jacobian
+     */
+    inline const std::map<size_t, float>& getSparseJacobianJobTimings() const {
+        return _jacJobTimings;
+    }
+
+    /**
+     * Defines the elapsed times of the jobs of the multithreaded sparse
+     * Jacobian measured by a previously compiled version of this model
+     * (see FunctorGenericModel::getSparseJacobianJobTimings()).
+     * Columns (or rows) which are fast to evaluate are grouped into the
+     * same job so that all jobs take approximately the same time and the
+     * thread pool starts with an ordering based on these times.
+     * An empty map disables the grouping.
+     *
+     * @param timings the elapsed time of each column (forward mode) or row
+     *                (reverse mode) of the Jacobian
+     */
+    inline void setSparseJacobianJobTimings(std::map<size_t, float> timings) {
+        _jacJobTimings = std::move(timings);
+    }
+
+    /**
+     * Provides the elapsed times of the jobs of the multithreaded sparse
+     * Hessian used to group its rows into jobs.
+     *
+     * @return the elapsed time of each row of the Hessian
+     */
+    inline const std::map<size_t, float>& getSparseHessianJobTimings() const {
+        return _hessJobTimings;
+    }
+
+    /**
+     * Defines the elapsed times of the jobs of the multithreaded sparse
+     * Hessian measured by a previously compiled version of this model
+     * (see FunctorGenericModel::getSparseHessianJobTimings()).
+     * An empty map disables the grouping.
+     *
+     * @param timings the elapsed time of each row of the Hessian
+     */
+    inline void setSparseHessianJobTimings(std::map<size_t, float> timings) {
+        _hessJobTimings = std::move(timings);
     }
 
     /**
@@ -562,6 +843,36 @@ public:
         _sparseHessianReusesRev2 = reuse;
     }
 
+    /**
+     * Determines whether or not the sparse Hessian is evaluated using a
+     * star coloring of the Hessian sparsity pattern.
+     *
+     * @return true if the sparse Hessian uses coloring, false otherwise
+     */
+    inline bool isSparseHessianColoring() const {
+        return _sparseHessianColoring;
+    }
+
+    /**
+     * Defines whether or not the sparse Hessian is evaluated using a star
+     * coloring of the Hessian sparsity pattern.
+     * Columns of the Hessian with the same color share a single compressed
+     * second order directional function (a forward one followed by a
+     * reverse two sweep) and each element is then directly recovered from
+     * one of these functions.
+     * The number of generated (and evaluated) functions is the number of
+     * colors instead of the number of variables, which can be much
+     * smaller for banded models.
+     * This option takes precedence over the reuse of the reverse two
+     * functions and it is ignored when loops are used.
+     *
+     * @param coloring true if the sparse Hessian should use coloring,
+     *                 false otherwise
+     */
+    inline void setSparseHessianColoring(bool coloring) {
+        _sparseHessianColoring = coloring;
+    }
+
     /**
      * Determines whether or not to generate source-code for a function that
      * provides the Hessian sparsity pattern for each equation/dependent,
@@ -655,6 +966,37 @@ public:
         _sparseJacobianReusesOne = reuse;
     }
 
+    /**
+     * Determines whether or not the sparse Jacobian is evaluated using a
+     * coloring of the columns (forward mode) or rows (reverse mode) of the
+     * Jacobian sparsity pattern.
+     *
+     * @return true if the sparse Jacobian uses coloring, false otherwise
+     */
+    inline bool isSparseJacobianColoring() const {
+        return _sparseJacobianColoring;
+    }
+
+    /**
+     * Defines whether or not the sparse Jacobian is evaluated using a
+     * coloring of the columns (forward mode) or rows (reverse mode) of the
+     * Jacobian sparsity pattern.
+     * Structurally orthogonal columns (or rows) share a single compressed
+     * directional function and, therefore, the number of generated (and
+     * evaluated) functions is the number of colors instead of the number
+     * of columns (or rows).
+     * This option takes precedence over the reuse of the forward one and
+     * reverse one functions and it is ignored when loops are used.
+     * The job timings of a multithreaded sparse Jacobian refer to colors
+     * when this option is enabled.
+     *
+     * @param coloring true if the sparse Jacobian should use coloring,
+     *                 false otherwise
+     */
+    inline void setSparseJacobianColoring(bool coloring) {
+        _sparseJacobianColoring = coloring;
+    }
+
     /**
      * Determines whether or not to generate source-code for a function
      * that evaluates the original model.
@@ -677,6 +1019,34 @@ public:
         _zero = create;
     }
 
+    /**
+     * Determines whether or not to generate source-code for functions
+     * which evaluate several points in a single call (batch evaluation).
+     *
+     * @return true if batch functions are created for the zero order
+     *         model, the sparse Jacobian, and the sparse Hessian
+     *         (when these are also created), false otherwise
+     */
+    inline bool isCreateBatchEvaluation() const {
+        return _batch;
+    }
+
+    /**
+     * Defines whether or not to generate source-code for functions
+     * which evaluate several points in a single call (batch evaluation).
+     * A batch function loops over the points in the generated code and
+     * avoids the overhead of calling the compiled model once per point.
+     * It is created for the zero order model, the sparse Jacobian, and the
+     * sparse Hessian when the generation of these functions is also
+     * enabled.
+     *
+     * @param create true if the batch functions should be created,
+     *               false otherwise
+     */
+    inline void setCreateBatchEvaluation(bool create) {
+        _batch = create;
+    }
+
     /**
      * Determines whether or not to generate source-code for the
      * first-order forward mode that is used for the evaluation of the
@@ -818,6 +1188,26 @@ public:
         _custom_jac = Position(elements);
     }
 
+    /**
+     * Specifies a user defined Jacobian sparsity to be computed using a
+     * compressed sparse row (CSR) or column (CSC) structure.
+     * The generated sparse Jacobian will provide the values in the order
+     * of that structure, which allows GenericModel::SparseJacobianToLayout()
+     * to write them directly into the caller's value array.
+     * The elements must be a subset of the full Jacobian sparsity pattern.
+     *
+     * @param format the format of the structure
+     * @param ptr the row (CSR) or column (CSC) pointers
+     * @param idx the column (CSR) or row (CSC) indexes
+     */
+    inline void setCustomSparseJacobianElements(SparseFormat format,
+                                                ArrayView<const size_t> ptr,
+                                                ArrayView<const size_t> idx) {
+        std::vector<size_t> row, col;
+        SparseOutputLayout::toTriplets(format, ptr, idx, row, col);
+        _custom_jac = Position(row, col);
+    }
+
     /**
      * Specifies a user defined Hessian sparsity to be computed.
      * This can be used, for instance, to request only half of the Hessian
@@ -851,6 +1241,26 @@ public:
         _custom_hess = Position(elements);
     }
 
+    /**
+     * Specifies a user defined Hessian sparsity to be computed using a
+     * compressed sparse row (CSR) or column (CSC) structure.
+     * The generated sparse Hessian will provide the values in the order
+     * of that structure, which allows GenericModel::SparseHessianToLayout()
+     * to write them directly into the caller's value array.
+     * The elements must be a subset of the full Hessian sparsity pattern.
+     *
+     * @param format the format of the structure
+     * @param ptr the row (CSR) or column (CSC) pointers
+     * @param idx the column (CSR) or row (CSC) indexes
+     */
+    inline void setCustomSparseHessianElements(SparseFormat format,
+                                               ArrayView<const size_t> ptr,
+                                               ArrayView<const size_t> idx) {
+        std::vector<size_t> row, col;
+        SparseOutputLayout::toTriplets(format, ptr, idx, row, col);
+        _custom_hess = Position(row, col);
+    }
+
     /**
      * The maximum number of assignment per generated function.
      * Zero means it is disabled (no limit).
@@ -877,6 +1287,37 @@ public:
         _maxAssignPerFunc = maxAssignPerFunc;
     }
 
+    /**
+     * Provides the maximum number of threads used to generate the source
+     * code of the functions for each Jacobian row/column and each Hessian
+     * row (used by the sparse Jacobian and sparse Hessian).
+     *
+     * @return the maximum number of concurrent source generation jobs
+     */
+    inline size_t getMaxSourceGenerationJobs() const {
+        return _maxSourceGenerationJobs;
+    }
+
+    /**
+     * Defines the maximum number of threads used to generate the source
+     * code of the functions for each Jacobian row/column and each Hessian
+     * row (used by the sparse Jacobian and sparse Hessian).
+     * Each thread uses its own copy of the operation graph, therefore more
+     * memory is required.
+     * Models with atomic functions or loops, and models with a graph
+     * optimizer (passes can keep state), are always processed by a single
+     * thread.
+     * The same number of threads is used to detect the equation patterns
+     * of the groups of related dependents (see setRelatedDependents()).
+     *
+     * @param maxJobs the maximum number of concurrent source generation
+     *                jobs (1 generates one function at a time, 0 uses the
+     *                number of hardware threads)
+     */
+    inline void setMaxSourceGenerationJobs(size_t maxJobs) {
+        _maxSourceGenerationJobs = maxJobs == 0 ? std::max<size_t>(std::thread::hardware_concurrency(), 1) : maxJobs;
+    }
+
     /**
      * The maximum number of operations per variable assignment.
      *
@@ -928,22 +1369,110 @@ protected:
     virtual void generateSources(MultiThreadingType multiThreadingType,
                                  JobTimer* timer = nullptr);
 
+    /**
+     * Applies the options of this model to a code handler used to generate
+     * source code (it must be called before any operation is recorded).
+     */
+    inline void prepareCodeHandler(CodeHandler<Base>& handler) const {
+        // loop models change the arguments of existing nodes
+        handler.setHashConsing(_hashConsing && _loopTapes.empty());
+        handler.setEliminateCommonSubexpressions(_eliminateCSE);
+        handler.setMinimizeLiveTemporaries(_minimizeLiveTemporaries);
+        handler.setGraphOptimizer(_graphOptimizer);
+    }
+
+    /**
+     * The source code of a function which evaluates a subset of the
+     * dependents of an operation graph
+     */
+    struct DirectionalFunction {
+        /// the function name
+        std::string name;
+        /// the name of the job used to report progress
+        std::string jobName;
+        std::vector<CGBase> dependents;
+    };
+
+    /**
+     * Generates the source code for a function using a code handler.
+     * It may be called concurrently for different handlers.
+     */
+    using DirectionalCodeGenerator = std::function<void(CodeHandler<Base>& handler,
+                                                        LanguageC<Base>& langC,
+                                                        std::vector<CGBase>& dependents,
+                                                        std::vector<std::string>& atomicFunctions,
+                                                        const std::string& jobName)>;
+
+    virtual void generateDirectionalSources(CodeHandler<Base>& handler,
+                                            std::vector<DirectionalFunction>& functions,
+                                            const DirectionalCodeGenerator& generate);
+
     virtual void generateLoops();
 
     virtual void generateInfoSource();
 
     virtual void generateAtomicFuncNames();
 
+    /**
+     * Generates a function which calls a model function for several
+     * points. The location of each point in the input and output arrays is
+     * defined by a stride (a stride of zero shares the same array with all
+     * points).
+     *
+     * @param function the name of the model function (without the model
+     *                 name)
+     * @param nIn the number of input arrays of the model function
+     * @param nOut the number of output arrays used by the model function
+     * @param nOutTotal the number of output arrays of the model function
+     */
+    virtual void generateBatchSource(const std::string& function,
+                                     size_t nIn,
+                                     size_t nOut,
+                                     size_t nOutTotal);
+
     virtual bool isAtomicsUsed();
 
     virtual const std::map<size_t, AtomicUseInfo<Base> >& getAtomicsInfo();
 
+    /**
+     * Whether or not the generated code of this model can be called
+     * directly by other models in the same library as an atomic function
+     * (it must use a single input and output array and the zero order
+     * model must be generated).
+     */
+    virtual bool isDirectAtomicSupported();
+
+    /**
+     * Generates the functions used by other models in the same library to
+     * call this model directly as an atomic function:
+     *  - <name>_direct_atomic_forward(q, p, tx, ty, atomicFun)
+     *  - <name>_direct_atomic_reverse(p, tx, px, py, atomicFun)
+     * They evaluate the zero order model and the sparse forward/reverse
+     * directional functions (when they are generated) without leaving the
+     * generated code. Like the LangCAtomicFun callbacks, they return zero
+     * on failure (e.g. an order which was not generated).
+     */
+    virtual void generateDirectAtomicSource();
+
+    /**
+     * Generates the function which lists the atomic functions called
+     * directly by the generated code (these do not have to be provided
+     * when the model is loaded).
+     */
+    virtual void generateLinkedAtomicFuncNames();
+
     /***********************************************************************
      * zero order (the original model)
      **********************************************************************/
 
     virtual void generateZeroSource();
 
+    /**
+     * Generates the operation graph for the zero order model
+     * (creates the independent variables in the handler)
+     */
+    virtual std::vector<CGBase> prepareForward0(CodeHandler<Base>& handler);
+
     /**
      * Generates the operation graph for the zero order model with loops
      */
@@ -960,6 +1489,19 @@ protected:
 
     virtual void generateSparseJacobianSource(bool forward);
 
+    /**
+     * Whether or not forward mode should be used for the sparse Jacobian
+     * (the sparsity must have already been determined)
+     */
+    virtual bool isSparseJacobianForwardMode();
+
+    /**
+     * Generates the operation graph for the sparse Jacobian
+     * (creates the independent variables in the handler)
+     */
+    virtual std::vector<CGBase> prepareSparseJacobian(CodeHandler<Base>& handler,
+                                                      bool forward);
+
     virtual void generateSparseJacobianForRevSource(bool forward,
                                                     MultiThreadingType multiThreadingType);
 
@@ -977,6 +1519,15 @@ protected:
                                                                       const std::string& revForSuffix,
                                                                       bool forward,
                                                                       MultiThreadingType multiThreadingType);
+
+    /**
+     * Generates a sparse Jacobian which uses one compressed directional
+     * function for each color of the columns (forward mode) or rows
+     * (reverse mode) of the Jacobian.
+     */
+    virtual void generateSparseJacobianColoredSource(bool forward,
+                                                     MultiThreadingType multiThreadingType);
+
     /**
      * Generates a sparse Jacobian using loops.
      *
@@ -1061,6 +1612,12 @@ protected:
 
     virtual void generateSparseHessianSourceDirectly();
 
+    /**
+     * Generates the operation graph for the sparse Hessian
+     * (creates the independent variables and the multipliers in the handler)
+     */
+    virtual std::vector<CGBase> prepareSparseHessian(CodeHandler<Base>& handler);
+
     virtual void generateSparseHessianSourceFromRev2(MultiThreadingType multiThreadingType);
 
     virtual std::string generateSparseHessianRev2SingleThreadSource(const std::string& functionName,
@@ -1076,6 +1633,19 @@ protected:
                                                                    const std::string& rev2Suffix,
                                                                    MultiThreadingType multiThreadingType);
 
+    /**
+     * Generates a sparse Hessian which uses one compressed second order
+     * directional function for each color of a star coloring of the
+     * Hessian.
+     */
+    virtual void generateSparseHessianColoredSource(MultiThreadingType multiThreadingType);
+
+    /**
+     * Determines which compressed array positions can be written directly
+     * into the output (ordered and without repeated locations).
+     */
+    static inline void determineCompressedOrder(std::map<size_t, CompressedVectorInfo>& info);
+
     virtual void determineSecondOrderElements4Eval(std::vector<size_t>& userRows,
                                                    std::vector<size_t>& userCols);
 
@@ -1282,6 +1852,12 @@ protected:
     static void printFileStartPThreads(std::ostringstream& cache,
                                        const std::string& baseTypeName);
 
+    static void printFileJobTimingsPThreads(std::ostringstream& cache,
+                                            const std::string& functionName,
+                                            const std::map<size_t, CompressedVectorInfo>& info,
+                                            const std::vector<std::vector<size_t> >& jobs,
+                                            const std::vector<float>& jobTimes);
+
     static void printFunctionStartPThreads(std::ostringstream& cache,
                                            size_t size);
 
@@ -1299,6 +1875,21 @@ protected:
     static void printLoopEndOpenMP(std::ostringstream& cache,
                                    size_t size);
 
+    static inline std::vector<std::vector<size_t> > groupJobsByElapsedTime(const std::map<size_t, CompressedVectorInfo>& info,
+                                                                          const std::map<size_t, float>& timings,
+                                                                          std::vector<float>& jobTimes);
+
+    inline void printJobFunctions(std::ostringstream& cache,
+                                  const std::string& functionName,
+                                  const std::map<size_t, CompressedVectorInfo>& info,
+                                  const std::string& function,
+                                  const std::string& suffix,
+                                  const std::vector<std::vector<size_t> >& jobs,
+                                  const std::string& argsDcl,
+                                  const std::string& atomicArg,
+                                  std::vector<std::string>& jobFunctions,
+                                  std::vector<size_t>& jobOffsets);
+
     /**
      *
      */
@@ -1312,6 +1903,9 @@ protected:
 
     friend class
     ModelLibraryProcessor<Base>;
+
+    friend class
+    BytecodeModelLibraryProcessor<Base>;
 };
 
 } // END cg namespace
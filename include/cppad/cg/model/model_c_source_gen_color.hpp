@@ -0,0 +1,417 @@
+#ifndef CPPAD_CG_MODEL_C_SOURCE_GEN_COLOR_INCLUDED
+#define CPPAD_CG_MODEL_C_SOURCE_GEN_COLOR_INCLUDED
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2020 Joao Leal
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+
+namespace CppAD {
+namespace cg {
+
+template<class Base>
+void ModelCSourceGen<Base>::determineCompressedOrder(std::map<size_t, CompressedVectorInfo>& info) {
+    for (auto& it : info) {
+        const std::vector<size_t>& els = it.second.indexes;
+        const std::vector<std::set<size_t> >& location = it.second.locations;
+        CPPADCG_ASSERT_UNKNOWN(els.size() == location.size());
+        CPPADCG_ASSERT_UNKNOWN(els.size() > 0);
+
+        bool passed = true;
+        size_t start = *location[0].begin();
+        for (size_t e = 0; e < els.size(); e++) {
+            if (location[e].size() > 1) {
+                passed = false; // too many elements
+                break;
+            }
+            if (*location[e].begin() != start + e) {
+                passed = false; // wrong order
+                break;
+            }
+        }
+        it.second.ordered = passed;
+    }
+}
+
+template<class Base>
+void ModelCSourceGen<Base>::generateSparseJacobianColoredSource(bool forward,
+                                                                MultiThreadingType multiThreadingType) {
+    using std::vector;
+
+    const size_t m = _fun.Range();
+    const size_t n = _fun.Domain();
+    const SparsitySetType& sparsity = _jacSparsity.sparsity;
+    const std::vector<size_t>& rows = _jacSparsity.rows;
+    const std::vector<size_t>& cols = _jacSparsity.cols;
+
+    /**
+     * forward mode: colors of the columns (the compressed values are rows)
+     * reverse mode: colors of the rows (the compressed values are columns)
+     */
+    std::vector<size_t> color;
+    size_t nColors;
+    size_t nColored;
+    if (forward) {
+        nColors = colorSparsityColumns(sparsity, n, color);
+        nColored = n;
+    } else {
+        nColors = colorSparsityRows(sparsity, n, color);
+        nColored = m;
+    }
+
+    // jacInfo[color].indexes{rows (forward) or columns (reverse)}
+    std::map<size_t, CompressedVectorInfo> jacInfo;
+    std::map<size_t, std::map<size_t, size_t> > compressedPos;
+    std::set<size_t> zeros; // structural zeros requested by the user
+
+    for (size_t e = 0; e < rows.size(); e++) {
+        size_t i = rows[e];
+        size_t j = cols[e];
+        size_t c = forward ? color[j] : color[i];
+        if (c == nColored || sparsity[i].find(j) == sparsity[i].end()) {
+            zeros.insert(e);
+            continue;
+        }
+
+        size_t index = forward ? i : j;
+        CompressedVectorInfo& info = jacInfo[c];
+        std::map<size_t, size_t>& pos = compressedPos[c];
+        auto itPos = pos.find(index);
+        if (itPos == pos.end()) {
+            pos[index] = info.indexes.size();
+            info.indexes.push_back(index);
+            info.locations.emplace_back();
+            info.locations.back().insert(e);
+        } else {
+            info.locations[itPos->second].insert(e);
+        }
+    }
+
+    if (!zeros.empty()) {
+        // all the structural zeros are provided by the first color
+        CompressedVectorInfo& info = jacInfo[0];
+        info.indexes.push_back(forward ? m : n);
+        info.locations.push_back(zeros);
+    }
+
+    if (jacInfo.empty()) {
+        generateSparseJacobianSource(forward); // nothing to compress
+        return;
+    }
+
+    determineCompressedOrder(jacInfo);
+
+    size_t maxCompressedSize = 0;
+    for (const auto& it : jacInfo) {
+        if (it.second.indexes.size() > maxCompressedSize && !it.second.ordered)
+            maxCompressedSize = it.second.indexes.size();
+    }
+
+    /**
+     * Generate one compressed directional function for each color
+     */
+    std::string functionName = _name + "_" + FUNCTION_SPARSE_JACOBIAN;
+    std::string colorSuffix = "color";
+
+    startingJob("'sparse Jacobian (" + std::to_string(nColors) + " colors)'", JobTimer::GRAPH);
+
+    CodeHandler<Base> handler;
+    handler.setJobTimer(_jobTimer);
+    prepareCodeHandler(handler);
+
+    vector<CGBase> indVars(n);
+    handler.makeVariables(indVars);
+    if (_x.size() > 0) {
+        for (size_t j = 0; j < n; j++) {
+            indVars[j].setValue(_x[j]);
+        }
+    }
+
+    CGBase seed;
+    handler.makeVariable(seed);
+    if (_x.size() > 0) {
+        seed.setValue(Base(1.0));
+    }
+
+    _fun.Forward(0, indVars);
+
+    std::vector<DirectionalFunction> functions;
+    functions.reserve(jacInfo.size());
+    for (const auto& it : jacInfo) {
+        size_t c = it.first;
+        const CompressedVectorInfo& info = it.second;
+
+        vector<CGBase> compressed;
+        if (forward) {
+            vector<CGBase> dx(n, Base(0));
+            for (size_t j = 0; j < n; j++) {
+                if (color[j] == c)
+                    dx[j] = seed;
+            }
+            compressed = _fun.Forward(1, dx);
+        } else {
+            vector<CGBase> py(m, Base(0));
+            for (size_t i = 0; i < m; i++) {
+                if (color[i] == c)
+                    py[i] = seed;
+            }
+            compressed = _fun.Reverse(1, py);
+        }
+
+        DirectionalFunction f;
+        f.name = functionName + "_" + colorSuffix + std::to_string(c);
+        f.jobName = "sparse Jacobian (color " + std::to_string(c) + ")";
+        f.dependents.resize(info.indexes.size());
+        for (size_t k = 0; k < info.indexes.size(); k++) {
+            size_t index = info.indexes[k];
+            if (index < compressed.size()) {
+                f.dependents[k] = compressed[index];
+            } else {
+                f.dependents[k] = CGBase(Base(0)); // structural zeros
+            }
+        }
+        functions.push_back(std::move(f));
+    }
+
+    finishedJob();
+
+    startingJob("'sparse Jacobian colors'", JobTimer::SOURCE_GENERATION);
+
+    std::string seedName = forward ? "dx" : "py";
+    generateDirectionalSources(handler, functions, [this, n, seedName](CodeHandler<Base>& h,
+                                                                       LanguageC<Base>& langC,
+                                                                       vector<CGBase>& dependents,
+                                                                       std::vector<std::string>& atomicFunctions,
+                                                                       const std::string& subJobName) {
+        std::ostringstream code;
+        std::unique_ptr<VariableNameGenerator<Base> > nameGen(createVariableNameGenerator("jac"));
+        LangCDefaultHessianVarNameGenerator<Base> nameGenHess(nameGen.get(), seedName, n);
+
+        h.generateCode(code, langC, dependents, nameGenHess, atomicFunctions, subJobName);
+    });
+
+    finishedJob();
+
+    /**
+     * the sparse Jacobian calls the compressed functions
+     */
+    if (!_multiThreading || multiThreadingType == MultiThreadingType::NONE) {
+        _sources[functionName + ".c"] = generateSparseJacobianForRevSingleThreadSource(functionName, jacInfo, maxCompressedSize, functionName, colorSuffix, forward);
+    } else {
+        _sources[functionName + ".c"] = generateSparseJacobianForRevMultiThreadSource(functionName, jacInfo, maxCompressedSize, functionName, colorSuffix, forward, multiThreadingType);
+    }
+
+    _cache.str("");
+}
+
+template<class Base>
+void ModelCSourceGen<Base>::generateSparseHessianColoredSource(MultiThreadingType multiThreadingType) {
+    using std::vector;
+
+    const size_t m = _fun.Range();
+    const size_t n = _fun.Domain();
+    const SparsitySetType& sparsity = _hessSparsity.sparsity;
+    const std::vector<size_t>& rows = _hessSparsity.rows;
+    const std::vector<size_t>& cols = _hessSparsity.cols;
+
+    std::vector<size_t> color;
+    size_t nColors = colorSparsityStar(sparsity, color);
+
+    // the colors of the (symmetric) neighbours of each variable
+    std::vector<std::map<size_t, size_t> > neighbourColors(n);
+    {
+        std::vector<std::set<size_t> > adj(n);
+        for (size_t i = 0; i < n; i++) {
+            for (size_t j : sparsity[i]) {
+                if (i != j) {
+                    adj[i].insert(j);
+                    adj[j].insert(i);
+                }
+            }
+        }
+        for (size_t i = 0; i < n; i++) {
+            for (size_t j : adj[i]) {
+                neighbourColors[i][color[j]]++;
+            }
+        }
+    }
+
+    auto isNonZero = [&](size_t i, size_t j) -> bool {
+        return sparsity[i].find(j) != sparsity[i].end() || sparsity[j].find(i) != sparsity[j].end();
+    };
+
+    // hessInfo[color].indexes{rows of the compressed Hessian}
+    std::map<size_t, CompressedVectorInfo> hessInfo;
+    std::map<size_t, std::map<size_t, size_t> > compressedPos;
+    std::set<size_t> zeros; // structural zeros requested by the user
+
+    for (size_t e = 0; e < rows.size(); e++) {
+        size_t i = rows[e];
+        size_t j = cols[e];
+        if (!isNonZero(i, j)) {
+            zeros.insert(e);
+            continue;
+        }
+
+        /**
+         * H(i,j) is the only element in row i with the color of column j
+         * or (from the symmetry) H(j,i) is the only element in row j with
+         * the color of column i
+         */
+        size_t row, c;
+        if (i == j || neighbourColors[i].at(color[j]) == 1) {
+            row = i;
+            c = color[j];
+        } else {
+            CPPADCG_ASSERT_UNKNOWN(neighbourColors[j].at(color[i]) == 1)
+            row = j;
+            c = color[i];
+        }
+
+        CompressedVectorInfo& info = hessInfo[c];
+        std::map<size_t, size_t>& pos = compressedPos[c];
+        auto itPos = pos.find(row);
+        if (itPos == pos.end()) {
+            pos[row] = info.indexes.size();
+            info.indexes.push_back(row);
+            info.locations.emplace_back();
+            info.locations.back().insert(e);
+        } else {
+            info.locations[itPos->second].insert(e);
+        }
+    }
+
+    if (!zeros.empty()) {
+        // all the structural zeros are provided by the first color
+        CompressedVectorInfo& info = hessInfo[0];
+        info.indexes.push_back(n);
+        info.locations.push_back(zeros);
+    }
+
+    if (hessInfo.empty()) {
+        generateSparseHessianSourceDirectly(); // nothing to compress
+        return;
+    }
+
+    determineCompressedOrder(hessInfo);
+
+    size_t maxCompressedSize = 0;
+    for (const auto& it : hessInfo) {
+        if (it.second.indexes.size() > maxCompressedSize && !it.second.ordered)
+            maxCompressedSize = it.second.indexes.size();
+    }
+
+    /**
+     * Generate one compressed second order directional function for each
+     * color (using the same arguments as the reverse two functions)
+     */
+    std::string functionName = _name + "_" + FUNCTION_SPARSE_HESSIAN;
+    std::string colorSuffix = "color";
+
+    startingJob("'sparse Hessian (" + std::to_string(nColors) + " colors)'", JobTimer::GRAPH);
+
+    CodeHandler<Base> handler;
+    handler.setJobTimer(_jobTimer);
+    prepareCodeHandler(handler);
+
+    vector<CGBase> tx0(n);
+    handler.makeVariables(tx0);
+    if (_x.size() > 0) {
+        for (size_t j = 0; j < n; j++) {
+            tx0[j].setValue(_x[j]);
+        }
+    }
+
+    CGBase tx1;
+    handler.makeVariable(tx1);
+    if (_x.size() > 0) {
+        tx1.setValue(Base(1.0));
+    }
+
+    vector<CGBase> py(m);
+    handler.makeVariables(py);
+    if (_x.size() > 0) {
+        for (size_t i = 0; i < m; i++) {
+            py[i].setValue(Base(1.0));
+        }
+    }
+
+    vector<CGBase> w(2 * m, Base(0));
+    for (size_t i = 0; i < m; i++) {
+        w[i * 2 + 1] = py[i];
+    }
+
+    _fun.Forward(0, tx0);
+
+    std::vector<DirectionalFunction> functions;
+    functions.reserve(hessInfo.size());
+    for (const auto& it : hessInfo) {
+        size_t c = it.first;
+        const CompressedVectorInfo& info = it.second;
+
+        vector<CGBase> dx(n, Base(0));
+        for (size_t j = 0; j < n; j++) {
+            if (color[j] == c)
+                dx[j] = tx1;
+        }
+        _fun.Forward(1, dx);
+        vector<CGBase> dw = _fun.Reverse(2, w);
+
+        DirectionalFunction f;
+        f.name = functionName + "_" + colorSuffix + std::to_string(c);
+        f.jobName = "sparse Hessian (color " + std::to_string(c) + ")";
+        f.dependents.resize(info.indexes.size());
+        for (size_t k = 0; k < info.indexes.size(); k++) {
+            size_t j = info.indexes[k];
+            if (j < n) {
+                f.dependents[k] = dw[j * 2];
+            } else {
+                f.dependents[k] = CGBase(Base(0)); // structural zeros
+            }
+        }
+        functions.push_back(std::move(f));
+    }
+
+    finishedJob();
+
+    startingJob("'sparse Hessian colors'", JobTimer::SOURCE_GENERATION);
+
+    generateDirectionalSources(handler, functions, [this, n](CodeHandler<Base>& h,
+                                                             LanguageC<Base>& langC,
+                                                             vector<CGBase>& dependents,
+                                                             std::vector<std::string>& atomicFunctions,
+                                                             const std::string& subJobName) {
+        std::ostringstream code;
+        std::unique_ptr<VariableNameGenerator<Base> > nameGen(createVariableNameGenerator("hess"));
+        LangCDefaultReverse2VarNameGenerator<Base> nameGenRev2(nameGen.get(), n, 1);
+
+        h.generateCode(code, langC, dependents, nameGenRev2, atomicFunctions, subJobName);
+    });
+
+    finishedJob();
+
+    /**
+     * the sparse Hessian calls the compressed functions
+     */
+    if (!_multiThreading || multiThreadingType == MultiThreadingType::NONE) {
+        _sources[functionName + ".c"] = generateSparseHessianRev2SingleThreadSource(functionName, hessInfo, maxCompressedSize, functionName, colorSuffix);
+    } else {
+        _sources[functionName + ".c"] = generateSparseHessianRev2MultiThreadSource(functionName, hessInfo, maxCompressedSize, functionName, colorSuffix, multiThreadingType);
+    }
+
+    _cache.str("");
+}
+
+} // END cg namespace
+} // END CppAD namespace
+
+#endif
@@ -26,7 +26,28 @@ void ModelCSourceGen<Base>::generateZeroSource() {
 
     CodeHandler<Base> handler;
     handler.setJobTimer(_jobTimer);
+    prepareCodeHandler(handler);
 
+    std::vector<CGBase> dep = prepareForward0(handler);
+
+    finishedJob();
+
+    LanguageC<Base> langC(_baseTypeName);
+    langC.setMaxAssignmentsPerFunction(_maxAssignPerFunc, &_sources);
+    langC.setMaxOperationsPerAssignment(_maxOperationsPerAssignment);
+    langC.setParameterPrecision(_parameterPrecision);
+    langC.setDirectAtomicFunctions(_directAtomicFunctions);
+    langC.setLoopVectorization(_loopVectorization);
+    langC.setGenerateFunction(_name + "_" + FUNCTION_FORWAD_ZERO);
+
+    std::ostringstream code;
+    std::unique_ptr<VariableNameGenerator<Base> > nameGen(createVariableNameGenerator());
+
+    handler.generateCode(code, langC, dep, *nameGen, _atomicFunctions, jobName);
+}
+
+template<class Base>
+std::vector<CG<Base> > ModelCSourceGen<Base>::prepareForward0(CodeHandler<Base>& handler) {
     std::vector<CGBase> indVars(_fun.Domain());
     handler.makeVariables(indVars);
     if (_x.size() > 0) {
@@ -35,29 +56,14 @@ void ModelCSourceGen<Base>::generateZeroSource() {
         }
     }
 
-    std::vector<CGBase> dep;
-
     if (_loopTapes.empty()) {
-        dep = _fun.Forward(0, indVars);
+        return _fun.Forward(0, indVars);
     } else {
         /**
          * Contains loops
          */
-        dep = prepareForward0WithLoops(handler, indVars);
+        return prepareForward0WithLoops(handler, indVars);
     }
-
-    finishedJob();
-
-    LanguageC<Base> langC(_baseTypeName);
-    langC.setMaxAssignmentsPerFunction(_maxAssignPerFunc, &_sources);
-    langC.setMaxOperationsPerAssignment(_maxOperationsPerAssignment);
-    langC.setParameterPrecision(_parameterPrecision);
-    langC.setGenerateFunction(_name + "_" + FUNCTION_FORWAD_ZERO);
-
-    std::ostringstream code;
-    std::unique_ptr<VariableNameGenerator<Base> > nameGen(createVariableNameGenerator());
-
-    handler.generateCode(code, langC, dep, *nameGen, _atomicFunctions, jobName);
 }
 
 
@@ -84,6 +84,7 @@ void ModelCSourceGen<Base>::generateSparseForwardOneSourcesWithAtomics(const std
 
         CodeHandler<Base> handler;
         handler.setJobTimer(_jobTimer);
+        prepareCodeHandler(handler);
 
         vector<CGBase> indVars(n);
         handler.makeVariables(indVars);
@@ -117,6 +118,8 @@ void ModelCSourceGen<Base>::generateSparseForwardOneSourcesWithAtomics(const std
         langC.setMaxAssignmentsPerFunction(_maxAssignPerFunc, &_sources);
         langC.setMaxOperationsPerAssignment(_maxOperationsPerAssignment);
         langC.setParameterPrecision(_parameterPrecision);
+        langC.setDirectAtomicFunctions(_directAtomicFunctions);
+        langC.setLoopVectorization(_loopVectorization);
         _cache.str("");
         _cache << _name << "_" << FUNCTION_SPARSE_FORWARD_ONE << "_indep" << j;
         langC.setGenerateFunction(_cache.str());
@@ -140,6 +143,7 @@ void ModelCSourceGen<Base>::generateSparseForwardOneSourcesNoAtomics(const std::
 
     CodeHandler<Base> handler;
     handler.setJobTimer(_jobTimer);
+    prepareCodeHandler(handler);
 
     vector<CGBase> x(n);
     handler.makeVariables(x);
@@ -191,29 +195,34 @@ void ModelCSourceGen<Base>::generateSparseForwardOneSourcesNoAtomics(const std::
     /**
      * Create source for each independent/column
      */
-    typename std::map<size_t, vector<CGBase> >::iterator itJ;
-    for (itJ = jac.begin(); itJ != jac.end(); ++itJ) {
-        size_t j = itJ->first;
-        vector<CGBase>& dyCustom = itJ->second;
+    std::vector<DirectionalFunction> functions;
+    functions.reserve(jac.size());
+    for (auto& itJ : jac) {
+        size_t j = itJ.first;
 
-        _cache.str("");
-        _cache << "model (forward one, indep " << j << ")";
-        const std::string subJobName = _cache.str();
-
-        LanguageC<Base> langC(_baseTypeName);
-        langC.setMaxAssignmentsPerFunction(_maxAssignPerFunc, &_sources);
-        langC.setMaxOperationsPerAssignment(_maxOperationsPerAssignment);
-        langC.setParameterPrecision(_parameterPrecision);
+        DirectionalFunction f;
         _cache.str("");
         _cache << _name << "_" << FUNCTION_SPARSE_FORWARD_ONE << "_indep" << j;
-        langC.setGenerateFunction(_cache.str());
+        f.name = _cache.str();
+        _cache.str("");
+        _cache << "model (forward one, indep " << j << ")";
+        f.jobName = _cache.str();
+        f.dependents = std::move(itJ.second);
+        functions.push_back(std::move(f));
+    }
+    _cache.str("");
 
+    generateDirectionalSources(handler, functions, [this, n](CodeHandler<Base>& h,
+                                                             LanguageC<Base>& langC,
+                                                             vector<CGBase>& dyCustom,
+                                                             std::vector<std::string>& atomicFunctions,
+                                                             const std::string& subJobName) {
         std::ostringstream code;
         std::unique_ptr<VariableNameGenerator<Base> > nameGen(createVariableNameGenerator("dy"));
         LangCDefaultHessianVarNameGenerator<Base> nameGenHess(nameGen.get(), "dx", n);
 
-        handler.generateCode(code, langC, dyCustom, nameGenHess, _atomicFunctions, subJobName);
-    }
+        h.generateCode(code, langC, dyCustom, nameGenHess, atomicFunctions, subJobName);
+    });
 }
 
 template<class Base>
@@ -28,6 +28,7 @@ void ModelCSourceGen<Base>::generateHessianSource() {
 
     CodeHandler<Base> handler;
     handler.setJobTimer(_jobTimer);
+    prepareCodeHandler(handler);
 
     size_t m = _fun.Range();
     size_t n = _fun.Domain();
@@ -66,6 +67,8 @@ void ModelCSourceGen<Base>::generateHessianSource() {
     langC.setMaxAssignmentsPerFunction(_maxAssignPerFunc, &_sources);
     langC.setMaxOperationsPerAssignment(_maxOperationsPerAssignment);
     langC.setParameterPrecision(_parameterPrecision);
+    langC.setDirectAtomicFunctions(_directAtomicFunctions);
+    langC.setLoopVectorization(_loopVectorization);
     langC.setGenerateFunction(_name + "_" + FUNCTION_HESSIAN);
 
     std::ostringstream code;
@@ -82,7 +85,9 @@ void ModelCSourceGen<Base>::generateSparseHessianSource(MultiThreadingType multi
      */
     determineHessianSparsity();
 
-    if (_sparseHessianReusesRev2 && _reverseTwo) {
+    if (_sparseHessianColoring && _loopTapes.empty()) {
+        generateSparseHessianColoredSource(multiThreadingType);
+    } else if (_sparseHessianReusesRev2 && _reverseTwo) {
         generateSparseHessianSourceFromRev2(multiThreadingType);
     } else {
         generateSparseHessianSourceDirectly();
@@ -94,6 +99,37 @@ void ModelCSourceGen<Base>::generateSparseHessianSourceDirectly() {
     using std::vector;
 
     const std::string jobName = "sparse Hessian";
+    size_t n = _fun.Domain();
+
+    startingJob("'" + jobName + "'", JobTimer::GRAPH);
+
+    CodeHandler<Base> handler;
+    handler.setJobTimer(_jobTimer);
+    prepareCodeHandler(handler);
+
+    vector<CGBase> hess = prepareSparseHessian(handler);
+
+    finishedJob();
+
+    LanguageC<Base> langC(_baseTypeName);
+    langC.setMaxAssignmentsPerFunction(_maxAssignPerFunc, &_sources);
+    langC.setMaxOperationsPerAssignment(_maxOperationsPerAssignment);
+    langC.setParameterPrecision(_parameterPrecision);
+    langC.setDirectAtomicFunctions(_directAtomicFunctions);
+    langC.setLoopVectorization(_loopVectorization);
+    langC.setGenerateFunction(_name + "_" + FUNCTION_SPARSE_HESSIAN);
+
+    std::ostringstream code;
+    std::unique_ptr<VariableNameGenerator<Base> > nameGen(createVariableNameGenerator("hess"));
+    LangCDefaultHessianVarNameGenerator<Base> nameGenHess(nameGen.get(), n);
+
+    handler.generateCode(code, langC, hess, nameGenHess, _atomicFunctions, jobName);
+}
+
+template<class Base>
+std::vector<CG<Base> > ModelCSourceGen<Base>::prepareSparseHessian(CodeHandler<Base>& handler) {
+    using std::vector;
+
     size_t m = _fun.Range();
     size_t n = _fun.Domain();
 
@@ -155,14 +191,6 @@ void ModelCSourceGen<Base>::generateSparseHessianSourceDirectly() {
         }
     }
 
-    /**
-     * 
-     */
-    startingJob("'" + jobName + "'", JobTimer::GRAPH);
-
-    CodeHandler<Base> handler;
-    handler.setJobTimer(_jobTimer);
-
     // independent variables
     vector<CGBase> indVars(n);
     handler.makeVariables(indVars);
@@ -208,19 +236,7 @@ void ModelCSourceGen<Base>::generateSparseHessianSourceDirectly() {
                                              duplicates);
     }
 
-    finishedJob();
-
-    LanguageC<Base> langC(_baseTypeName);
-    langC.setMaxAssignmentsPerFunction(_maxAssignPerFunc, &_sources);
-    langC.setMaxOperationsPerAssignment(_maxOperationsPerAssignment);
-    langC.setParameterPrecision(_parameterPrecision);
-    langC.setGenerateFunction(_name + "_" + FUNCTION_SPARSE_HESSIAN);
-
-    std::ostringstream code;
-    std::unique_ptr<VariableNameGenerator<Base> > nameGen(createVariableNameGenerator("hess"));
-    LangCDefaultHessianVarNameGenerator<Base> nameGenHess(nameGen.get(), n);
-
-    handler.generateCode(code, langC, hess, nameGenHess, _atomicFunctions, jobName);
+    return hess;
 }
 
 template<class Base>
@@ -250,26 +266,7 @@ void ModelCSourceGen<Base>::generateSparseHessianSourceFromRev2(MultiThreadingTy
      * determine to which functions we can provide the hessian row directly
      * without needing a temporary array (compressed)
      */
-    for (auto& it : hessInfo) {
-        const std::vector<size_t>& els = it.second.indexes;
-        const std::vector<set<size_t> >& location = it.second.locations;
-        CPPADCG_ASSERT_UNKNOWN(els.size() == location.size());
-        CPPADCG_ASSERT_UNKNOWN(els.size() > 0);
-
-        bool passed = true;
-        size_t hessRowStart = *location[0].begin();
-        for (size_t e = 0; e < els.size(); e++) {
-            if (location[e].size() > 1) {
-                passed = false; // too many elements
-                break;
-            }
-            if (*location[e].begin() != hessRowStart + e) {
-                passed = false; // wrong order
-                break;
-            }
-        }
-        it.second.ordered = passed;
-    }
+    determineCompressedOrder(hessInfo);
 
     /**
      * determine the maximum size of the temporary array
@@ -432,6 +429,15 @@ std::string ModelCSourceGen<Base>::generateSparseHessianRev2MultiThreadSource(co
         _cache << "}\n";
     }
 
+    /**
+     * Group the rows into jobs (based on previous measurements)
+     */
+    std::vector<float> jobTimes;
+    std::vector<std::vector<size_t> > jobs = groupJobsByElapsedTime(hessInfo, _hessJobTimings, jobTimes);
+    std::vector<std::string> jobFunctions;
+    std::vector<size_t> jobOffsets;
+    printJobFunctions(_cache, functionName, hessInfo, functionRev2, rev2Suffix, jobs, argsDcl, langC.getArgumentAtomic(), jobFunctions, jobOffsets);
+
     _cache << "\n"
             "typedef void (*cppadcg_function_type) (" << argsDcl << ");\n";
 
@@ -448,6 +454,7 @@ std::string ModelCSourceGen<Base>::generateSparseHessianRev2MultiThreadSource(co
         assert(multiThreadingType == MultiThreadingType::PTHREADS);
 
         printFileStartPThreads(_cache, _baseTypeName);
+        printFileJobTimingsPThreads(_cache, functionName, hessInfo, jobs, jobTimes);
     }
 
     /**
@@ -455,25 +462,16 @@ std::string ModelCSourceGen<Base>::generateSparseHessianRev2MultiThreadSource(co
      */
     _cache << "\n"
             "void " << functionName << "(" << argsDcl << ") {\n"
-            "   static const cppadcg_function_type p[" << hessInfo.size() << "] = {";
-    for (const auto& it : hessInfo) {
-        size_t index = it.first;
-        if (index != hessInfo.begin()->first) _cache << ", ";
-        if (it.second.ordered) {
-            _cache << functionRev2 << "_" << rev2Suffix << index;
-        } else {
-            _cache << functionRev2 << "_" << rev2Suffix << index << "_wrap";
-        }
+            "   static const cppadcg_function_type p[" << jobs.size() << "] = {";
+    for (size_t k = 0; k < jobs.size(); ++k) {
+        if (k != 0) _cache << ", ";
+        _cache << jobFunctions[k];
     }
     _cache << "};\n"
-            "   static const long offset["<< hessInfo.size() <<"] = {";
-    for (const auto& it : hessInfo) {
-        if (it.first != hessInfo.begin()->first) _cache << ", ";
-        if (it.second.ordered) {
-            _cache << *it.second.locations[0].begin();
-        } else {
-            _cache << "0";
-        }
+            "   static const long offset["<< jobs.size() <<"] = {";
+    for (size_t k = 0; k < jobs.size(); ++k) {
+        if (k != 0) _cache << ", ";
+        _cache << jobOffsets[k];
     }
     _cache << "};\n"
             "   " << _baseTypeName << " inLocal1 = 1;\n"
@@ -484,20 +482,20 @@ std::string ModelCSourceGen<Base>::generateSparseHessianRev2MultiThreadSource(co
             "\n";
 
     if(multiThreadingType == MultiThreadingType::OPENMP) {
-        printFunctionStartOpenMP(_cache, hessInfo.size());
+        printFunctionStartOpenMP(_cache, jobs.size());
         _cache << "\n";
-        printLoopStartOpenMP(_cache, hessInfo.size());
+        printLoopStartOpenMP(_cache, jobs.size());
         _cache << "      outLocal[0] = &hess[offset[i]];\n"
                 "      (*p[i])(" << argsLocal << ");\n";
-        printLoopEndOpenMP(_cache, hessInfo.size());
+        printLoopEndOpenMP(_cache, jobs.size());
         _cache << "\n";
 
     } else {
         assert(multiThreadingType == MultiThreadingType::PTHREADS);
 
-        printFunctionStartPThreads(_cache, hessInfo.size());
+        printFunctionStartPThreads(_cache, jobs.size());
         _cache << "\n"
-                "   for(i = 0; i < " << hessInfo.size() << "; ++i) {\n"
+                "   for(i = 0; i < " << jobs.size() << "; ++i) {\n"
                 "      args[i] = (ExecArgStruct*) malloc(sizeof(ExecArgStruct));\n"
                 "      args[i]->func = p[i];\n"
                 "      args[i]->in = inLocal;\n"
@@ -505,7 +503,7 @@ std::string ModelCSourceGen<Base>::generateSparseHessianRev2MultiThreadSource(co
                 "      args[i]->atomicFun = " << langC .getArgumentAtomic() << ";\n"
                 "   }\n"
                 "\n";
-        printFunctionEndPThreads(_cache, hessInfo.size());
+        printFunctionEndPThreads(_cache, jobs.size());
     }
 
     _cache << "\n"
@@ -77,6 +77,18 @@ const std::string ModelCSourceGen<Base>::FUNCTION_INFO = "info";
 template<class Base>
 const std::string ModelCSourceGen<Base>::FUNCTION_ATOMIC_FUNC_NAMES = "atomic_functions";
 
+template<class Base>
+const std::string ModelCSourceGen<Base>::FUNCTION_LINKED_ATOMIC_FUNC_NAMES = "linked_atomic_functions";
+
+template<class Base>
+const std::string ModelCSourceGen<Base>::FUNCTION_DIRECT_ATOMIC = "direct_atomic";
+
+template<class Base>
+const std::string ModelCSourceGen<Base>::FUNCTION_BATCH_SUFFIX = "_batch";
+
+template<class Base>
+const std::string ModelCSourceGen<Base>::FUNCTION_JOB_TIMINGS_SUFFIX = "_job_timings";
+
 template<class Base>
 const std::string ModelCSourceGen<Base>::CONST = "const";
 
@@ -142,6 +154,19 @@ void ModelCSourceGen<Base>::generateSources(MultiThreadingType multiThreadingTyp
         generateSparseHessianSource(multiThreadingType);
     }
 
+    if (_batch && (_zero || _sparseJacobian || _sparseHessian)) {
+        std::unique_ptr<VariableNameGenerator<Base> > nameGen(createVariableNameGenerator());
+        size_t nInd = nameGen->getIndependent().size();
+        size_t nDep = nameGen->getDependent().size();
+
+        if (_zero)
+            generateBatchSource(FUNCTION_FORWAD_ZERO, nInd, nDep, nDep);
+        if (_sparseJacobian)
+            generateBatchSource(FUNCTION_SPARSE_JACOBIAN, nInd, 1, nDep);
+        if (_sparseHessian)
+            generateBatchSource(FUNCTION_SPARSE_HESSIAN, nInd + 1, 1, nDep); // the multipliers are the last input
+    }
+
     if (_sparseJacobian || _forwardOne || _reverseOne) {
         generateJacobianSparsitySource();
     }
@@ -154,12 +179,20 @@ void ModelCSourceGen<Base>::generateSources(MultiThreadingType multiThreadingTyp
 
     generateAtomicFuncNames();
 
+    if (!_directAtomicFunctions.empty()) {
+        generateLinkedAtomicFuncNames();
+    }
+
+    if (_directAtomic) {
+        generateDirectAtomicSource();
+    }
+
     finishedJob();
 }
 
 template<class Base>
 void ModelCSourceGen<Base>::generateLoops() {
-    if (_relatedDepCandidates.empty()) {
+    if (_relatedDepCandidates.empty() && !_detectRelatedDependents) {
         return; //nothing to do
     }
 
@@ -178,7 +211,21 @@ void ModelCSourceGen<Base>::generateLoops() {
 
     std::vector<CGBase> yy = _fun.Forward(0, xx);
 
+    if (_relatedDepCandidates.empty()) {
+        _relatedDepCandidates = DependentPatternMatcher<Base>::findRelatedDependentCandidates(yy, _minRelatedDependents);
+
+        if (_jobTimer != nullptr && _jobTimer->isVerbose()) {
+            std::cout << " related dependent groups: " << _relatedDepCandidates.size() << std::endl;
+        }
+
+        if (_relatedDepCandidates.empty()) {
+            finishedJob();
+            return; // no repeated expressions
+        }
+    }
+
     DependentPatternMatcher<Base> matcher(_relatedDepCandidates, yy, xx);
+    matcher.setMaxThreads(_maxSourceGenerationJobs);
     matcher.generateTapes(_funNoLoops, _loopTapes);
 
     finishedJob();
@@ -234,6 +281,258 @@ void ModelCSourceGen<Base>::generateAtomicFuncNames() {
     _sources[funcName + ".c"] = _cache.str();
 }
 
+template<class Base>
+void ModelCSourceGen<Base>::generateLinkedAtomicFuncNames() {
+    std::vector<std::string> linked;
+    for (const std::string& name : _atomicFunctions) {
+        if (_directAtomicFunctions.find(name) != _directAtomicFunctions.end())
+            linked.push_back(name);
+    }
+    if (linked.empty())
+        return;
+
+    std::string funcName = _name + "_" + FUNCTION_LINKED_ATOMIC_FUNC_NAMES;
+    size_t n = linked.size();
+    _cache.str("");
+    LanguageC<Base>::printFunctionDeclaration(_cache, "void", funcName, {"const char*** names",
+                                                                         "unsigned long* n"});
+    _cache << " {\n"
+            "   static const char* atomic[" << n << "] = {";
+    for (size_t i = 0; i < n; i++) {
+        if (i > 0) _cache << ", ";
+        _cache << "\"" << linked[i] << "\"";
+    }
+    _cache << "};\n"
+            "   *names = atomic;\n"
+            "   *n = " << n << ";\n"
+            "}\n\n";
+
+    _sources[funcName + ".c"] = _cache.str();
+}
+
+template<class Base>
+bool ModelCSourceGen<Base>::isDirectAtomicSupported() {
+    if (!_zero)
+        return false;
+
+    std::unique_ptr<VariableNameGenerator<Base> > nameGen(createVariableNameGenerator());
+    return nameGen->getIndependent().size() == 1 && nameGen->getDependent().size() == 1;
+}
+
+template<class Base>
+void ModelCSourceGen<Base>::generateDirectAtomicSource() {
+    size_t m = _fun.Range();
+    size_t n = _fun.Domain();
+    // larger compressed arrays are allocated in the heap
+    const size_t maxStackSize = 1024;
+
+    std::string prefix = _name + "_" + FUNCTION_DIRECT_ATOMIC;
+
+    LanguageC<Base> langC(_baseTypeName);
+    std::string argsDcl = langC.generateDefaultFunctionArgumentsDcl();
+    std::string args = langC.generateDefaultFunctionArguments();
+
+    auto declareCompressed = [&](size_t size) {
+        if (size <= maxStackSize) {
+            _cache << "   " << _baseTypeName << " compressed[" << std::max<size_t>(size, 1) << "];\n";
+        } else {
+            _cache << "   " << _baseTypeName << "* compressed;\n";
+        }
+    };
+    auto allocateCompressed = [&](size_t size, const std::string& indent) {
+        if (size > maxStackSize) {
+            _cache << indent << "compressed = (" << _baseTypeName << "*) malloc(" << size << " * sizeof(" << _baseTypeName << "));\n"
+                   << indent << "if (compressed == NULL)\n"
+                   << indent << "   return 0; // failure to allocate memory\n";
+        }
+    };
+    auto freeCompressed = [&](size_t size, const std::string& indent) {
+        if (size > maxStackSize) {
+            _cache << indent << "free(compressed);\n";
+        }
+    };
+    /**
+     * evaluates a sparse directional function for each non-zero
+     * direction (dir) and accumulates the compressed results into res
+     */
+    auto printDirections = [&](const std::string& sparseFunction,
+                               const std::string& sparsityFunction,
+                               const std::string& dir,
+                               const std::string& dirValues,
+                               const std::string& res,
+                               size_t size) {
+        allocateCompressed(size, "      ");
+        _cache << "      for (d = 0; d < " << dir << ".nnz; d++) {\n"
+                "         k = " << dir << ".idx[d];\n"
+                "         " << _name << "_" << sparsityFunction << "(k, &pos, &nnz);\n"
+                "\n"
+                "         in[1] = &" << dirValues << "[d];\n"
+                "         out[0] = compressed;\n";
+        if (!_loopTapes.empty()) {
+            _cache << "         for (e = 0; e < nnz; e++)\n"
+                    "            compressed[e] = 0;\n"
+                    "\n";
+        }
+        _cache << "         ret = " << _name << "_" << sparseFunction << "(k, " << args << ");\n"
+                "         if (ret != 0) {\n";
+        freeCompressed(size, "            ");
+        _cache << "            return 0;\n"
+                "         }\n"
+                "\n"
+                "         for (e = 0; e < nnz; e++)\n"
+                "            " << res << "[pos[e]] += compressed[e];\n"
+                "      }\n";
+        freeCompressed(size, "      ");
+        _cache << "      return 1;\n";
+    };
+
+    _cache.str("");
+    _cache << "#include <stdlib.h>\n"
+            << LanguageC<Base>::ATOMICFUN_STRUCT_DEFINITION << "\n"
+            "\n"
+            "void " << _name << "_" << FUNCTION_FORWAD_ZERO << "(" << argsDcl << ");\n";
+    if (_forwardOne) {
+        _cache << "int " << _name << "_" << FUNCTION_SPARSE_FORWARD_ONE << "(unsigned long pos, " << argsDcl << ");\n"
+                "void " << _name << "_" << FUNCTION_FORWARD_ONE_SPARSITY << "(unsigned long pos, unsigned long const** elements, unsigned long* nnz);\n";
+    }
+    if (_reverseOne) {
+        _cache << "int " << _name << "_" << FUNCTION_SPARSE_REVERSE_ONE << "(unsigned long pos, " << argsDcl << ");\n"
+                "void " << _name << "_" << FUNCTION_REVERSE_ONE_SPARSITY << "(unsigned long pos, unsigned long const** elements, unsigned long* nnz);\n";
+    }
+    if (_reverseTwo) {
+        _cache << "int " << _name << "_" << FUNCTION_SPARSE_REVERSE_TWO << "(unsigned long pos, " << argsDcl << ");\n"
+                "void " << _name << "_" << FUNCTION_REVERSE_TWO_SPARSITY << "(unsigned long pos, unsigned long const** elements, unsigned long* nnz);\n";
+    }
+    _cache << "\n";
+
+    /**
+     * forward mode
+     */
+    LanguageC<Base>::printFunctionDeclaration(_cache, "int", prefix + "_forward", {"int q",
+                                                                                  "int p",
+                                                                                  "const Array tx[]",
+                                                                                  "Array* ty",
+                                                                                  langC.generateArgumentAtomicDcl()});
+    _cache << " {\n"
+            "   " << _baseTypeName << " const* in[2];\n"
+            "   " << _baseTypeName << "* out[1];\n";
+    if (_forwardOne) {
+        declareCompressed(m);
+        _cache << "   " << _baseTypeName << "* y;\n"
+                "   unsigned long const* pos;\n"
+                "   unsigned long d, e, k, nnz;\n"
+                "   int ret;\n";
+    }
+    _cache << "\n"
+            "   in[0] = (" << _baseTypeName << " const*) tx[0].data;\n"
+            "   if (p == 0) {\n"
+            "      out[0] = (" << _baseTypeName << "*) ty->data;\n"
+            "      " << _name << "_" << FUNCTION_FORWAD_ZERO << "(" << args << ");\n"
+            "      return 1;\n"
+            "   }\n";
+    if (_forwardOne) {
+        _cache << "   if (p == 1) {\n"
+                "      y = (" << _baseTypeName << "*) ty->data;\n"
+                "      for (e = 0; e < " << m << "; e++)\n"
+                "         y[e] = 0;\n";
+        printDirections(FUNCTION_SPARSE_FORWARD_ONE, FUNCTION_FORWARD_ONE_SPARSITY,
+                        "tx[1]", "((" + _baseTypeName + " const*) tx[1].data)", "y", m);
+        _cache << "   }\n";
+    }
+    _cache << "   return 0; // not available\n"
+            "}\n"
+            "\n";
+
+    /**
+     * reverse mode
+     */
+    LanguageC<Base>::printFunctionDeclaration(_cache, "int", prefix + "_reverse", {"int p",
+                                                                                  "const Array tx[]",
+                                                                                  "Array* px",
+                                                                                  "const Array py[]",
+                                                                                  langC.generateArgumentAtomicDcl()});
+    _cache << " {\n";
+    if (_reverseOne || _reverseTwo) {
+        _cache << "   " << _baseTypeName << " const* in[3];\n"
+                "   " << _baseTypeName << "* out[1];\n";
+        declareCompressed(n);
+        _cache << "   " << _baseTypeName << "* x2;\n"
+                "   unsigned long const* pos;\n"
+                "   unsigned long d, e, k, nnz;\n"
+                "   int ret;\n"
+                "\n"
+                "   in[0] = (" << _baseTypeName << " const*) tx[0].data;\n"
+                "   x2 = (" << _baseTypeName << "*) px->data;\n"
+                "   for (e = 0; e < " << n << "; e++)\n"
+                "      x2[e] = 0;\n"
+                "\n";
+        if (_reverseOne) {
+            _cache << "   if (p == 0) {\n";
+            printDirections(FUNCTION_SPARSE_REVERSE_ONE, FUNCTION_REVERSE_ONE_SPARSITY,
+                            "py[0]", "((" + _baseTypeName + " const*) py[0].data)", "x2", n);
+            _cache << "   }\n";
+        }
+        if (_reverseTwo) {
+            _cache << "   if (p == 1) {\n"
+                    "      in[2] = (" << _baseTypeName << " const*) py[1].data;\n";
+            printDirections(FUNCTION_SPARSE_REVERSE_TWO, FUNCTION_REVERSE_TWO_SPARSITY,
+                            "tx[1]", "((" + _baseTypeName + " const*) tx[1].data)", "x2", n);
+            _cache << "   }\n";
+        }
+    }
+    _cache << "   return 0; // not available\n"
+            "}\n";
+
+    _sources[prefix + ".c"] = _cache.str();
+    _cache.str("");
+}
+
+template<class Base>
+void ModelCSourceGen<Base>::generateBatchSource(const std::string& function,
+                                                size_t nIn,
+                                                size_t nOut,
+                                                size_t nOutTotal) {
+    LanguageC<Base> langC(_baseTypeName);
+    std::string argsDcl = langC.generateDefaultFunctionArgumentsDcl();
+    std::vector<std::string> argsDcl2 = langC.generateDefaultFunctionArgumentsDcl2();
+    const std::string& in = langC.getArgumentIn();
+    const std::string& out = langC.getArgumentOut();
+
+    std::string model_function = _name + "_" + function;
+    std::string batch_function = model_function + FUNCTION_BATCH_SUFFIX;
+
+    _cache.str("");
+    _cache << LanguageC<Base>::ATOMICFUN_STRUCT_DEFINITION << "\n\n";
+    _cache << "void " << model_function << "(" << argsDcl << ");\n\n";
+    LanguageC<Base>::printFunctionDeclaration(_cache, "void", batch_function, {"unsigned long nPoints",
+                                                                               argsDcl2[0],
+                                                                               "unsigned long const* inStride",
+                                                                               argsDcl2[1],
+                                                                               "unsigned long const* outStride",
+                                                                               argsDcl2[2]});
+    _cache << " {\n"
+            "   unsigned long p;\n"
+            "   " << _baseTypeName << " const* inP[" << nIn << "];\n"
+            "   " << _baseTypeName << "* outP[" << nOutTotal << "];\n";
+    for (size_t k = nOut; k < nOutTotal; ++k) {
+        _cache << "   outP[" << k << "] = " << out << "[" << k << "]; // not used\n";
+    }
+    _cache << "\n"
+            "   for(p = 0; p < nPoints; p++) {\n";
+    for (size_t k = 0; k < nIn; ++k) {
+        _cache << "      inP[" << k << "] = " << in << "[" << k << "] + p * inStride[" << k << "];\n";
+    }
+    for (size_t k = 0; k < nOut; ++k) {
+        _cache << "      outP[" << k << "] = " << out << "[" << k << "] + p * outStride[" << k << "];\n";
+    }
+    _cache << "      " << model_function << "(inP, outP, " << langC.getArgumentAtomic() << ");\n"
+            "   }\n"
+            "}\n";
+
+    _sources[batch_function + ".c"] = _cache.str();
+    _cache.str("");
+}
+
 template<class Base>
 bool ModelCSourceGen<Base>::isAtomicsUsed() {
     if (_zeroEvaluated) {
@@ -661,6 +960,83 @@ void ModelCSourceGen<Base>::printFileStartPThreads(std::ostringstream& cache,
             "}\n";
 }
 
+template<class Base>
+void ModelCSourceGen<Base>::printFileJobTimingsPThreads(std::ostringstream& cache,
+                                                        const std::string& functionName,
+                                                        const std::map<size_t, CompressedVectorInfo>& info,
+                                                        const std::vector<std::vector<size_t> >& jobs,
+                                                        const std::vector<float>& jobTimes) {
+    size_t size = jobs.size();
+
+    /**
+     * start from previously measured times (if available)
+     */
+    std::vector<size_t> order(size);
+    for (size_t i = 0; i < size; ++i) {
+        order[i] = i;
+    }
+    if (!jobTimes.empty()) {
+        // same ordering as cppadcg_thpool_update_order() (descending time)
+        std::vector<size_t> sorted(order);
+        std::stable_sort(sorted.begin(), sorted.end(), [&](size_t a, size_t b) {
+            return jobTimes[a] < jobTimes[b];
+        });
+        for (size_t i = 0; i < size; ++i) {
+            order[sorted[i]] = size - i - 1;
+        }
+    }
+
+    cache << "\n"
+            "static float ref_elapsed[" << size << "] = {";
+    for (size_t i = 0; i < size; ++i) {
+        if (i != 0) cache << ", ";
+        if (jobTimes.empty()) {
+            cache << "0";
+        } else {
+            char value[32];
+            std::snprintf(value, sizeof(value), "%.6e", jobTimes[i]);
+            cache << value;
+        }
+    }
+    cache << "};\n"
+            "static int order[" << size << "] = {";
+    for (size_t i = 0; i < size; ++i) {
+        if (i != 0) cache << ", ";
+        cache << order[i];
+    }
+    cache << "};\n"
+            "static unsigned int n_meas = 0;\n"
+            "static const unsigned long job_start[" << (size + 1) << "] = {0";
+    size_t start = 0;
+    for (const auto& job : jobs) {
+        start += job.size();
+        cache << ", " << start;
+    }
+    cache << "};\n"
+            "static const unsigned long job_indexes[" << info.size() << "] = {";
+    bool first = true;
+    for (const auto& job : jobs) {
+        for (size_t index : job) {
+            if (!first) cache << ", ";
+            cache << index;
+            first = false;
+        }
+    }
+    cache << "};\n"
+            "\n"
+            "void " << functionName << FUNCTION_JOB_TIMINGS_SUFFIX << "(float const** elapsed,\n"
+            "        unsigned long const** jobStart,\n"
+            "        unsigned long const** indexes,\n"
+            "        unsigned long* nJobs,\n"
+            "        unsigned int* nMeas) {\n"
+            "   *elapsed = ref_elapsed;\n"
+            "   *jobStart = job_start;\n"
+            "   *indexes = job_indexes;\n"
+            "   *nJobs = " << size << ";\n"
+            "   *nMeas = n_meas;\n"
+            "}\n";
+}
+
 template<class Base>
 void ModelCSourceGen<Base>::printFunctionStartPThreads(std::ostringstream& cache,
                                                        size_t size) {
@@ -677,24 +1053,15 @@ void ModelCSourceGen<Base>::printFunctionStartPThreads(std::ostringstream& cache
     cache << "   static cppadcg_thpool_function_type execute_functions[" << size << "] = ";
     repeatFill("exec_func");
     cache << "\n";
-    cache << "   static float ref_elapsed[" << size << "] = ";
-    repeatFill("0");
-    cache << "\n";
+    // ref_elapsed, order, and n_meas are defined at file scope (see printFileJobTimingsPThreads())
     cache << "   static float elapsed[" << size << "] = ";
     repeatFill("0");
     cache << "\n"
-            "   static int order[" << size << "] = {";
-    for (size_t i = 0; i < size; ++i) {
-        if (i != 0) cache << ", ";
-        cache << i;
-    }
-    cache << "};\n"
             "   static int job2Thread[" << size << "] = ";
     repeatFill("-1");
     cache << "\n"
             "   static int last_elapsed_changed = 1;\n"
             "   unsigned int nBench = cppadcg_thpool_get_n_time_meas();\n"
-            "   static unsigned int n_meas = 0;\n"
             "   int do_benchmark = " << (size > 0 ? "(n_meas < nBench && !cppadcg_thpool_is_disabled())" : "0") << ";\n"
             "   float* elapsed_p = do_benchmark ? elapsed : NULL;\n";
 }
@@ -718,6 +1085,106 @@ void ModelCSourceGen<Base>::printFunctionEndPThreads(std::ostringstream& cache,
             "   }\n";
 }
 
+template<class Base>
+inline std::vector<std::vector<size_t> > ModelCSourceGen<Base>::groupJobsByElapsedTime(const std::map<size_t, CompressedVectorInfo>& info,
+                                                                                      const std::map<size_t, float>& timings,
+                                                                                      std::vector<float>& jobTimes) {
+    std::vector<std::vector<size_t> > jobs;
+    jobs.reserve(info.size());
+    jobTimes.clear();
+
+    float total = 0;
+    float maxTime = 0;
+    size_t nKnown = 0;
+    for (const auto& it : info) {
+        auto itt = timings.find(it.first);
+        if (itt != timings.end()) {
+            total += itt->second;
+            maxTime = std::max(maxTime, itt->second);
+            nKnown++;
+        }
+    }
+
+    if (nKnown == 0 || maxTime <= 0) {
+        // no information: one job per column/row
+        for (const auto& it : info) {
+            jobs.push_back({it.first});
+        }
+        return jobs;
+    }
+
+    /**
+     * Consecutive columns/rows are grouped while the job does not take
+     * longer than the slowest column/row (which cannot be split anyway)
+     */
+    const float avgTime = total / nKnown; // used for new columns/rows
+    for (const auto& it : info) {
+        auto itt = timings.find(it.first);
+        float t = (itt != timings.end()) ? itt->second : avgTime;
+
+        if (jobs.empty() || jobTimes.back() + t > maxTime) {
+            jobs.emplace_back();
+            jobTimes.push_back(0);
+        }
+        jobs.back().push_back(it.first);
+        jobTimes.back() += t;
+    }
+
+    return jobs;
+}
+
+template<class Base>
+inline void ModelCSourceGen<Base>::printJobFunctions(std::ostringstream& cache,
+                                                     const std::string& functionName,
+                                                     const std::map<size_t, CompressedVectorInfo>& info,
+                                                     const std::string& function,
+                                                     const std::string& suffix,
+                                                     const std::vector<std::vector<size_t> >& jobs,
+                                                     const std::string& argsDcl,
+                                                     const std::string& atomicArg,
+                                                     std::vector<std::string>& jobFunctions,
+                                                     std::vector<size_t>& jobOffsets) {
+    jobFunctions.resize(jobs.size());
+    jobOffsets.resize(jobs.size());
+
+    auto memberFunction = [&](size_t index, size_t& offset) -> std::string {
+        const CompressedVectorInfo& vInfo = info.at(index);
+        if (vInfo.ordered) {
+            offset = *vInfo.locations[0].begin();
+            return function + "_" + suffix + std::to_string(index);
+        } else {
+            offset = 0;
+            return function + "_" + suffix + std::to_string(index) + "_wrap";
+        }
+    };
+
+    for (size_t k = 0; k < jobs.size(); ++k) {
+        const std::vector<size_t>& job = jobs[k];
+        if (job.size() == 1) {
+            jobFunctions[k] = memberFunction(job[0], jobOffsets[k]);
+            continue;
+        }
+
+        /**
+         * several columns/rows evaluated by the same job
+         */
+        jobFunctions[k] = functionName + "_job" + std::to_string(k);
+        jobOffsets[k] = 0;
+
+        cache << "\n"
+                "static void " << jobFunctions[k] << "(" << argsDcl << ") {\n"
+                "   " << _baseTypeName << " * outLocal[1];\n";
+        for (size_t index : job) {
+            size_t offset;
+            std::string f = memberFunction(index, offset);
+            cache << "\n"
+                    "   outLocal[0] = &out[0][" << offset << "];\n"
+                    "   " << f << "(in, outLocal, " << atomicArg << ");\n";
+        }
+        cache << "}\n";
+    }
+}
+
 template<class Base>
 void ModelCSourceGen<Base>::printFileStartOpenMP(std::ostringstream& cache) {
     cache << CPPADCG_OPENMP_H_FILE << "\n"
@@ -802,6 +1269,172 @@ void ModelCSourceGen<Base>::printLoopEndOpenMP(std::ostringstream& cache,
 
 }
 
+template<class Base>
+void ModelCSourceGen<Base>::generateDirectionalSources(CodeHandler<Base>& handler,
+                                                       std::vector<DirectionalFunction>& functions,
+                                                       const DirectionalCodeGenerator& generate) {
+    using namespace std::chrono;
+
+    auto prepareLanguage = [this](LanguageC<Base>& langC,
+                                  const std::string& functionName,
+                                  std::map<std::string, std::string>* sources) {
+        langC.setMaxAssignmentsPerFunction(_maxAssignPerFunc, sources);
+        langC.setMaxOperationsPerAssignment(_maxOperationsPerAssignment);
+        langC.setParameterPrecision(_parameterPrecision);
+        langC.setDirectAtomicFunctions(_directAtomicFunctions);
+        langC.setLoopVectorization(_loopVectorization);
+        langC.setGenerateFunction(functionName);
+    };
+
+    const size_t n = functions.size();
+    size_t nThreads = std::min(_maxSourceGenerationJobs, n);
+
+    if (nThreads <= 1 || !_atomicFunctions.empty() || !handler.getAtomicFunctions().empty() ||
+            _graphOptimizer != nullptr) {
+        // atomic functions are not saved with the operation graph
+        // (the graph used by each thread could not be loaded) and the
+        // optimization passes are not required to be thread-safe
+        for (DirectionalFunction& f : functions) {
+            LanguageC<Base> langC(_baseTypeName);
+            prepareLanguage(langC, f.name, &_sources);
+            generate(handler, langC, f.dependents, _atomicFunctions, f.jobName);
+        }
+        return;
+    }
+
+    /**
+     * The code handler cannot be shared by several threads:
+     * each thread uses its own copy of the operation graph
+     */
+    std::vector<size_t> start(n + 1, 0);
+    for (size_t i = 0; i < n; ++i) {
+        start[i + 1] = start[i] + functions[i].dependents.size();
+    }
+    std::vector<CGBase> allDependents;
+    allDependents.reserve(start[n]);
+    for (const DirectionalFunction& f : functions) {
+        allDependents.insert(allDependents.end(), f.dependents.begin(), f.dependents.end());
+    }
+
+    std::ostringstream graphOut;
+    handler.saveGraph(graphOut, allDependents);
+    const std::string graph = graphOut.str();
+
+    /**
+     * a generated function which was still not reported
+     */
+    struct GeneratedJob {
+        size_t index;
+        steady_clock::time_point beginTime;
+        std::map<std::string, std::string> sources;
+    };
+
+    std::mutex mutex;
+    std::condition_variable finished;
+    std::deque<GeneratedJob> generated;
+    std::exception_ptr error;
+    std::atomic<size_t> next(0);
+    std::atomic<bool> abort(false);
+    size_t running = nThreads;
+
+    auto worker = [&]() {
+        try {
+            CodeHandler<Base> localHandler;
+            prepareCodeHandler(localHandler);
+            std::vector<CGBase> indep, dep;
+            localHandler.loadGraph(graph.data(), graph.size(), indep, dep);
+            std::vector<std::string> atomicFunctions(_atomicFunctions);
+
+            while (!abort) {
+                size_t i = next++;
+                if (i >= n)
+                    break;
+
+                steady_clock::time_point beginTime = steady_clock::now();
+
+                GeneratedJob job{i, beginTime, {}};
+                std::vector<CGBase> fDep(dep.begin() + start[i], dep.begin() + start[i + 1]);
+                LanguageC<Base> langC(_baseTypeName);
+                prepareLanguage(langC, functions[i].name, &job.sources);
+
+                generate(localHandler, langC, fDep, atomicFunctions, functions[i].jobName);
+
+                std::lock_guard<std::mutex> lock(mutex);
+                generated.push_back(std::move(job));
+                finished.notify_one();
+            }
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (error == nullptr)
+                error = std::current_exception();
+            abort = true;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        running--;
+        finished.notify_one();
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(nThreads);
+
+    auto joinAll = [&]() {
+        abort = true;
+        for (std::thread& t : threads) {
+            if (t.joinable())
+                t.join();
+        }
+    };
+
+    try {
+        for (size_t t = 0; t < nThreads; ++t) {
+            threads.emplace_back(worker);
+        }
+
+        /**
+         * sources are collected and progress is reported only by this
+         * thread so that the job timer keeps a consistent job stack
+         */
+        const size_t countWidth = std::to_string(n).size();
+        size_t count = 0;
+
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            finished.wait(lock, [&]() { return !generated.empty() || running == 0; });
+
+            if (generated.empty() || error != nullptr)
+                break;
+
+            GeneratedJob job = std::move(generated.front());
+            generated.pop_front();
+            lock.unlock();
+
+            for (auto& it : job.sources) {
+                _sources[it.first] = std::move(it.second);
+            }
+
+            count++;
+            if (_jobTimer != nullptr) {
+                std::ostringstream os;
+                os << "[" << std::setw(countWidth) << std::setfill(' ') << std::right << count << "/" << n << "]";
+                _jobTimer->startingJob("source for '" + functions[job.index].jobName + "'", JobTypeHolder<>::DEFAULT, os.str(), job.beginTime);
+                _jobTimer->finishedJob();
+            }
+
+            lock.lock();
+        }
+    } catch (...) {
+        joinAll();
+        throw;
+    }
+
+    joinAll();
+
+    if (error != nullptr) {
+        std::rethrow_exception(error);
+    }
+}
+
 template<class Base>
 void ModelCSourceGen<Base>::startingJob(const std::string& jobName,
                                         const JobType& type) {
@@ -28,6 +28,7 @@ void ModelCSourceGen<Base>::generateJacobianSource() {
 
     CodeHandler<Base> handler;
     handler.setJobTimer(_jobTimer);
+    prepareCodeHandler(handler);
 
     vector<CGBase> indVars(_fun.Domain());
     handler.makeVariables(indVars);
@@ -55,6 +56,8 @@ void ModelCSourceGen<Base>::generateJacobianSource() {
     langC.setMaxAssignmentsPerFunction(_maxAssignPerFunc, &_sources);
     langC.setMaxOperationsPerAssignment(_maxOperationsPerAssignment);
     langC.setParameterPrecision(_parameterPrecision);
+    langC.setDirectAtomicFunctions(_directAtomicFunctions);
+    langC.setLoopVectorization(_loopVectorization);
     langC.setGenerateFunction(_name + "_" + FUNCTION_JACOBIAN);
 
     std::ostringstream code;
@@ -64,31 +67,33 @@ void ModelCSourceGen<Base>::generateJacobianSource() {
 }
 
 template<class Base>
-void ModelCSourceGen<Base>::generateSparseJacobianSource(MultiThreadingType multiThreadingType) {
-    size_t m = _fun.Range();
-    size_t n = _fun.Domain();
-
-    /**
-     * Determine the sparsity pattern
-     */
-    determineJacobianSparsity();
-
-    bool forwardMode;
-
+bool ModelCSourceGen<Base>::isSparseJacobianForwardMode() {
     if (_jacMode == JacobianADMode::Automatic) {
         if (_custom_jac.defined) {
-            forwardMode = estimateBestJacobianADMode(_jacSparsity.rows, _jacSparsity.cols);
+            return estimateBestJacobianADMode(_jacSparsity.rows, _jacSparsity.cols);
         } else {
-            forwardMode = n <= m;
+            return _fun.Domain() <= _fun.Range();
         }
     } else {
-        forwardMode = _jacMode == JacobianADMode::Forward;
+        return _jacMode == JacobianADMode::Forward;
     }
+}
+
+template<class Base>
+void ModelCSourceGen<Base>::generateSparseJacobianSource(MultiThreadingType multiThreadingType) {
+    /**
+     * Determine the sparsity pattern
+     */
+    determineJacobianSparsity();
+
+    bool forwardMode = isSparseJacobianForwardMode();
 
     /**
      * call the appropriate method for source code generation
      */
-    if (_sparseJacobianReusesOne && _forwardOne && forwardMode) {
+    if (_sparseJacobianColoring && _loopTapes.empty()) {
+        generateSparseJacobianColoredSource(forwardMode, multiThreadingType);
+    } else if (_sparseJacobianReusesOne && _forwardOne && forwardMode) {
         generateSparseJacobianForRevSource(true, multiThreadingType);
     } else if (_sparseJacobianReusesOne && _reverseOne && !forwardMode) {
         generateSparseJacobianForRevSource(false, multiThreadingType);
@@ -103,15 +108,36 @@ void ModelCSourceGen<Base>::generateSparseJacobianSource(bool forward) {
 
     const std::string jobName = "sparse Jacobian";
 
-    //size_t m = _fun.Range();
-    size_t n = _fun.Domain();
-
     startingJob("'" + jobName + "'", JobTimer::GRAPH);
 
     CodeHandler<Base> handler;
     handler.setJobTimer(_jobTimer);
+    prepareCodeHandler(handler);
+
+    vector<CGBase> jac = prepareSparseJacobian(handler, forward);
+
+    finishedJob();
+
+    LanguageC<Base> langC(_baseTypeName);
+    langC.setMaxAssignmentsPerFunction(_maxAssignPerFunc, &_sources);
+    langC.setMaxOperationsPerAssignment(_maxOperationsPerAssignment);
+    langC.setParameterPrecision(_parameterPrecision);
+    langC.setDirectAtomicFunctions(_directAtomicFunctions);
+    langC.setLoopVectorization(_loopVectorization);
+    langC.setGenerateFunction(_name + "_" + FUNCTION_SPARSE_JACOBIAN);
+
+    std::ostringstream code;
+    std::unique_ptr<VariableNameGenerator<Base> > nameGen(createVariableNameGenerator("jac"));
+
+    handler.generateCode(code, langC, jac, *nameGen, _atomicFunctions, jobName);
+}
+
+template<class Base>
+std::vector<CG<Base> > ModelCSourceGen<Base>::prepareSparseJacobian(CodeHandler<Base>& handler,
+                                                                    bool forward) {
+    size_t n = _fun.Domain();
 
-    vector<CGBase> indVars(n);
+    std::vector<CGBase> indVars(n);
     handler.makeVariables(indVars);
     if (_x.size() > 0) {
         for (size_t i = 0; i < n; i++) {
@@ -119,7 +145,7 @@ void ModelCSourceGen<Base>::generateSparseJacobianSource(bool forward) {
         }
     }
 
-    vector<CGBase> jac(_jacSparsity.rows.size());
+    std::vector<CGBase> jac(_jacSparsity.rows.size());
     if (_loopTapes.empty()) {
         //printSparsityPattern(_jacSparsity.sparsity, "jac sparsity");
         CppAD::sparse_jacobian_work work;
@@ -133,18 +159,7 @@ void ModelCSourceGen<Base>::generateSparseJacobianSource(bool forward) {
         jac = prepareSparseJacobianWithLoops(handler, indVars, forward);
     }
 
-    finishedJob();
-
-    LanguageC<Base> langC(_baseTypeName);
-    langC.setMaxAssignmentsPerFunction(_maxAssignPerFunc, &_sources);
-    langC.setMaxOperationsPerAssignment(_maxOperationsPerAssignment);
-    langC.setParameterPrecision(_parameterPrecision);
-    langC.setGenerateFunction(_name + "_" + FUNCTION_SPARSE_JACOBIAN);
-
-    std::ostringstream code;
-    std::unique_ptr<VariableNameGenerator<Base> > nameGen(createVariableNameGenerator("jac"));
-
-    handler.generateCode(code, langC, jac, *nameGen, _atomicFunctions, jobName);
+    return jac;
 }
 
 template<class Base>
@@ -189,26 +204,7 @@ void ModelCSourceGen<Base>::generateSparseJacobianForRevSource(bool forward,
      * determine to which functions we can provide the jacobian row/column
      * directly without needing a temporary array (compressed)
      */
-    for (auto& it : jacInfo) {
-        const std::vector<size_t>& els = it.second.indexes;
-        const std::vector<set<size_t> >& location = it.second.locations;
-        CPPADCG_ASSERT_UNKNOWN(els.size() == location.size());
-        CPPADCG_ASSERT_UNKNOWN(els.size() > 0);
-
-        bool passed = true;
-        size_t jacArrayStart = *location[0].begin();
-        for (size_t e = 0; e < els.size(); e++) {
-            if (location[e].size() > 1) {
-                passed = false; // too many elements
-                break;
-            }
-            if (*location[e].begin() != jacArrayStart + e) {
-                passed = false; // wrong order
-                break;
-            }
-        }
-        it.second.ordered = passed;
-    }
+    determineCompressedOrder(jacInfo);
 
     size_t maxCompressedSize = 0;
     map<size_t, bool>::const_iterator itOrd;
@@ -376,6 +372,15 @@ std::string ModelCSourceGen<Base>::generateSparseJacobianForRevMultiThreadSource
         _cache << "}\n";
     }
 
+    /**
+     * Group the columns/rows into jobs (based on previous measurements)
+     */
+    std::vector<float> jobTimes;
+    std::vector<std::vector<size_t> > jobs = groupJobsByElapsedTime(jacInfo, _jacJobTimings, jobTimes);
+    std::vector<std::string> jobFunctions;
+    std::vector<size_t> jobOffsets;
+    printJobFunctions(_cache, functionName, jacInfo, functionRevFor, revForSuffix, jobs, argsDcl, langC.getArgumentAtomic(), jobFunctions, jobOffsets);
+
     _cache << "\n"
             "typedef void (*cppadcg_function_type) (" << argsDcl << ");\n";
 
@@ -391,6 +396,7 @@ std::string ModelCSourceGen<Base>::generateSparseJacobianForRevMultiThreadSource
         assert(multiThreadingType == MultiThreadingType::PTHREADS);
 
         printFileStartPThreads(_cache, _baseTypeName);
+        printFileJobTimingsPThreads(_cache, functionName, jacInfo, jobs, jobTimes);
     }
 
     /**
@@ -398,25 +404,16 @@ std::string ModelCSourceGen<Base>::generateSparseJacobianForRevMultiThreadSource
      */
     _cache << "\n"
             "void " << functionName << "(" << argsDcl << ") {\n"
-            "   static const cppadcg_function_type p[" << jacInfo.size() << "] = {";
-    for (const auto& it : jacInfo) {
-        size_t index = it.first;
-        if (index != jacInfo.begin()->first) _cache << ", ";
-        if (it.second.ordered) {
-            _cache << functionRevFor << "_" << revForSuffix << index;
-        } else {
-            _cache << functionRevFor << "_" << revForSuffix << index << "_wrap";
-        }
+            "   static const cppadcg_function_type p[" << jobs.size() << "] = {";
+    for (size_t k = 0; k < jobs.size(); ++k) {
+        if (k != 0) _cache << ", ";
+        _cache << jobFunctions[k];
     }
     _cache << "};\n"
-            "   static const long offset["<< jacInfo.size() <<"] = {";
-    for (const auto& it : jacInfo) {
-        if (it.first != jacInfo.begin()->first) _cache << ", ";
-        if (it.second.ordered) {
-            _cache << *it.second.locations[0].begin();
-        } else {
-            _cache << "0";
-        }
+            "   static const long offset["<< jobs.size() <<"] = {";
+    for (size_t k = 0; k < jobs.size(); ++k) {
+        if (k != 0) _cache << ", ";
+        _cache << jobOffsets[k];
     }
     _cache << "};\n"
             "   " << _baseTypeName << " inLocal1 = 1;\n"
@@ -427,20 +424,20 @@ std::string ModelCSourceGen<Base>::generateSparseJacobianForRevMultiThreadSource
             "\n";
 
     if(multiThreadingType == MultiThreadingType::OPENMP) {
-        printFunctionStartOpenMP(_cache, jacInfo.size());
+        printFunctionStartOpenMP(_cache, jobs.size());
         _cache << "\n";
-        printLoopStartOpenMP(_cache, jacInfo.size());
+        printLoopStartOpenMP(_cache, jobs.size());
         _cache << "      outLocal[0] = &jac[offset[i]];\n"
                 "      (*p[i])(" << argsLocal << ");\n";
-        printLoopEndOpenMP(_cache, jacInfo.size());
+        printLoopEndOpenMP(_cache, jobs.size());
         _cache << "\n";
 
     } else {
         assert(multiThreadingType == MultiThreadingType::PTHREADS);
 
-        printFunctionStartPThreads(_cache, jacInfo.size());
+        printFunctionStartPThreads(_cache, jobs.size());
         _cache << "\n"
-                "   for(i = 0; i < " << jacInfo.size() << "; ++i) {\n"
+                "   for(i = 0; i < " << jobs.size() << "; ++i) {\n"
                 "      args[i] = (ExecArgStruct*) malloc(sizeof(ExecArgStruct));\n"
                 "      args[i]->func = p[i];\n"
                 "      args[i]->in = inLocal;\n"
@@ -448,7 +445,7 @@ std::string ModelCSourceGen<Base>::generateSparseJacobianForRevMultiThreadSource
                 "      args[i]->atomicFun = " << langC.getArgumentAtomic() << ";\n"
                 "   }\n"
                 "\n";
-        printFunctionEndPThreads(_cache, jacInfo.size());
+        printFunctionEndPThreads(_cache, jobs.size());
     }
 
     _cache << "\n"
@@ -88,6 +88,7 @@ void ModelCSourceGen<Base>::generateSparseReverseOneSourcesWithAtomics(const std
 
         CodeHandler<Base> handler;
         handler.setJobTimer(_jobTimer);
+        prepareCodeHandler(handler);
 
         vector<CGBase> indVars(_fun.Domain());
         handler.makeVariables(indVars);
@@ -122,6 +123,8 @@ void ModelCSourceGen<Base>::generateSparseReverseOneSourcesWithAtomics(const std
         langC.setMaxAssignmentsPerFunction(_maxAssignPerFunc, &_sources);
         langC.setMaxOperationsPerAssignment(_maxOperationsPerAssignment);
         langC.setParameterPrecision(_parameterPrecision);
+        langC.setDirectAtomicFunctions(_directAtomicFunctions);
+        langC.setLoopVectorization(_loopVectorization);
         _cache.str("");
         _cache << _name << "_" << FUNCTION_SPARSE_REVERSE_ONE << "_dep" << i;
         langC.setGenerateFunction(_cache.str());
@@ -146,6 +149,7 @@ void ModelCSourceGen<Base>::generateSparseReverseOneSourcesNoAtomics(const std::
 
     CodeHandler<Base> handler;
     handler.setJobTimer(_jobTimer);
+    prepareCodeHandler(handler);
 
     vector<CGBase> x(n);
     handler.makeVariables(x);
@@ -197,29 +201,34 @@ void ModelCSourceGen<Base>::generateSparseReverseOneSourcesNoAtomics(const std::
     /**
      * Create source for each equation/row
      */
-    typename std::map<size_t, vector<CGBase> >::iterator itI;
-    for (itI = jac.begin(); itI != jac.end(); ++itI) {
-        size_t i = itI->first;
-        vector<CGBase>& dwCustom = itI->second;
+    std::vector<DirectionalFunction> functions;
+    functions.reserve(jac.size());
+    for (auto& itI : jac) {
+        size_t i = itI.first;
 
-        _cache.str("");
-        _cache << "model (reverse one, dep " << i << ")";
-        const std::string subJobName = _cache.str();
-
-        LanguageC<Base> langC(_baseTypeName);
-        langC.setMaxAssignmentsPerFunction(_maxAssignPerFunc, &_sources);
-        langC.setMaxOperationsPerAssignment(_maxOperationsPerAssignment);
-        langC.setParameterPrecision(_parameterPrecision);
+        DirectionalFunction f;
         _cache.str("");
         _cache << _name << "_" << FUNCTION_SPARSE_REVERSE_ONE << "_dep" << i;
-        langC.setGenerateFunction(_cache.str());
+        f.name = _cache.str();
+        _cache.str("");
+        _cache << "model (reverse one, dep " << i << ")";
+        f.jobName = _cache.str();
+        f.dependents = std::move(itI.second);
+        functions.push_back(std::move(f));
+    }
+    _cache.str("");
 
+    generateDirectionalSources(handler, functions, [this, n](CodeHandler<Base>& h,
+                                                             LanguageC<Base>& langC,
+                                                             vector<CGBase>& dwCustom,
+                                                             std::vector<std::string>& atomicFunctions,
+                                                             const std::string& subJobName) {
         std::ostringstream code;
         std::unique_ptr<VariableNameGenerator<Base> > nameGen(createVariableNameGenerator("dw"));
         LangCDefaultHessianVarNameGenerator<Base> nameGenHess(nameGen.get(), "py", n);
 
-        handler.generateCode(code, langC, dwCustom, nameGenHess, _atomicFunctions, subJobName);
-    }
+        h.generateCode(code, langC, dwCustom, nameGenHess, atomicFunctions, subJobName);
+    });
 }
 
 template<class Base>
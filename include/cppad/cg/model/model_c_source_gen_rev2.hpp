@@ -88,6 +88,7 @@ void ModelCSourceGen<Base>::generateSparseReverseTwoSourcesWithAtomics(const std
 
         CodeHandler<Base> handler;
         handler.setJobTimer(_jobTimer);
+        prepareCodeHandler(handler);
 
         vector<CGBase> tx0(n);
         handler.makeVariables(tx0);
@@ -130,6 +131,8 @@ void ModelCSourceGen<Base>::generateSparseReverseTwoSourcesWithAtomics(const std
         langC.setMaxAssignmentsPerFunction(_maxAssignPerFunc, &_sources);
         langC.setMaxOperationsPerAssignment(_maxOperationsPerAssignment);
         langC.setParameterPrecision(_parameterPrecision);
+        langC.setDirectAtomicFunctions(_directAtomicFunctions);
+        langC.setLoopVectorization(_loopVectorization);
         _cache.str("");
         _cache << _name << "_" << FUNCTION_SPARSE_REVERSE_TWO << "_indep" << j;
         langC.setGenerateFunction(_cache.str());
@@ -167,6 +170,7 @@ void ModelCSourceGen<Base>::generateSparseReverseTwoSourcesNoAtomics(const std::
     // we can use a new handler to reduce memory usage
     CodeHandler<Base> handler;
     handler.setJobTimer(_jobTimer);
+    prepareCodeHandler(handler);
 
     vector<CGBase> tx0(n);
     handler.makeVariables(tx0);
@@ -216,33 +220,39 @@ void ModelCSourceGen<Base>::generateSparseReverseTwoSourcesNoAtomics(const std::
     /**
      * Generate one function for each independent variable
      */
+    std::vector<DirectionalFunction> functions;
+    functions.reserve(hess.size());
     for (const auto& it : hess) {
         size_t j = it.first;
         const vector<CGBase>& row = it.second;
 
+        DirectionalFunction f;
+        _cache.str("");
+        _cache << _name << "_" << FUNCTION_SPARSE_REVERSE_TWO << "_indep" << j;
+        f.name = _cache.str();
         _cache.str("");
         _cache << "model (reverse two, indep " << j << ")";
-        const std::string subJobName = _cache.str();
+        f.jobName = _cache.str();
 
-        vector<CGBase> pxCustom(row.size());
+        f.dependents.resize(row.size());
         for (size_t e = 0; e < row.size(); e++) {
-            pxCustom[e] = row[e] * tx1;
+            f.dependents[e] = row[e] * tx1;
         }
+        functions.push_back(std::move(f));
+    }
+    _cache.str("");
 
-        LanguageC<Base> langC(_baseTypeName);
-        langC.setMaxAssignmentsPerFunction(_maxAssignPerFunc, &_sources);
-        langC.setMaxOperationsPerAssignment(_maxOperationsPerAssignment);
-        langC.setParameterPrecision(_parameterPrecision);
-        _cache.str("");
-        _cache << _name << "_" << FUNCTION_SPARSE_REVERSE_TWO << "_indep" << j;
-        langC.setGenerateFunction(_cache.str());
-
+    generateDirectionalSources(handler, functions, [this, n](CodeHandler<Base>& h,
+                                                             LanguageC<Base>& langC,
+                                                             vector<CGBase>& pxCustom,
+                                                             std::vector<std::string>& atomicFunctions,
+                                                             const std::string& subJobName) {
         std::ostringstream code;
         std::unique_ptr<VariableNameGenerator<Base> > nameGen(createVariableNameGenerator("px"));
         LangCDefaultReverse2VarNameGenerator<Base> nameGenRev2(nameGen.get(), n, 1);
 
-        handler.generateCode(code, langC, pxCustom, nameGenRev2, _atomicFunctions, subJobName);
-    }
+        h.generateCode(code, langC, pxCustom, nameGenRev2, atomicFunctions, subJobName);
+    });
 }
 
 template<class Base>
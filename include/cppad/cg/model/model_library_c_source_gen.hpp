@@ -64,6 +64,12 @@ protected:
      * Parallelization can be disabled locally for each model.
      */
     MultiThreadingType _multiThreading;
+    /**
+     * Whether or not models in this library which are used as atomic
+     * functions by other models in this library are called directly by
+     * the generated code.
+     */
+    bool _directModelLinking;
     /**
      * temporary stream to generate source code
      */
@@ -78,7 +84,8 @@ public:
      *              this object)
      */
     inline ModelLibraryCSourceGen(ModelCSourceGen<Base>& model):
-        _multiThreading(MultiThreadingType::NONE) {
+        _multiThreading(MultiThreadingType::NONE),
+        _directModelLinking(false) {
         CPPADCG_ASSERT_KNOWN(_models.find(model.getName()) == _models.end(),
                              "Another model with the same name was already registered")
 
@@ -158,6 +165,39 @@ public:
         _multiThreading = multiThreading;
     }
 
+    /**
+     * Whether or not models in this library which are used as atomic
+     * functions by other models in this library (e.g. through a
+     * CGAtomicFunBridge with the same name as the model) are called
+     * directly by the generated code.
+     */
+    inline bool isDirectModelLinking() const {
+        return _directModelLinking;
+    }
+
+    /**
+     * Defines whether or not models in this library which are used as
+     * atomic functions by other models in this library (e.g. through a
+     * CGAtomicFunBridge with the same name as the model) are called
+     * directly by the generated code instead of through the LangCAtomicFun
+     * callbacks.
+     * Linked models do not have to be added to the outer models with
+     * GenericModel::addExternalModel() once the library is loaded.
+     *
+     * A model can only be linked if it uses a single input and output
+     * array, if it generates the zero order model, and if all the atomic
+     * functions it uses can also be linked.
+     * The derivatives of the outer models require the corresponding
+     * sparse directional functions of the linked models (forward one,
+     * reverse one, reverse two).
+     * This must be defined before the source code is generated.
+     *
+     * @param link whether or not to link models directly
+     */
+    inline void setDirectModelLinking(bool link) {
+        _directModelLinking = link;
+    }
+
     /**
      * Saves the generated C source code into several files.
      * 
@@ -186,6 +226,13 @@ protected:
 
     virtual void generateThreadPoolSources(std::map<std::string, std::string>& sources);
 
+    /**
+     * Determines which models are called directly by other models in this
+     * library and configures the source generation of all models
+     * (only when direct model linking is enabled).
+     */
+    virtual void linkModels();
+
     static void saveSources(const std::string& sourcesFolder,
                             const std::map<std::string, std::string>& sources);
 
@@ -77,6 +77,8 @@ void ModelLibraryCSourceGen<Base>::saveSources(const std::string& sourcesFolder)
     // create the folder if it does not exist
     system::createFolder(sourcesFolder);
 
+    linkModels();
+
     // save/generate model sources
     for (const auto& it : _models) {
         saveSources(sourcesFolder, it.second->getSources());
@@ -89,6 +91,52 @@ void ModelLibraryCSourceGen<Base>::saveSources(const std::string& sourcesFolder)
     saveSources(sourcesFolder, getCustomSources());
 }
 
+template<class Base>
+void ModelLibraryCSourceGen<Base>::linkModels() {
+    if (!_directModelLinking)
+        return;
+
+    /**
+     * a model can only be linked if all its atomic functions are also
+     * linked since it receives the atomic functions of the outer model
+     */
+    std::set<std::string> linked;
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (const auto& it : _models) {
+            ModelCSourceGen<Base>& model = *it.second;
+            if (linked.find(it.first) != linked.end() || !model.isDirectAtomicSupported())
+                continue;
+
+            bool allLinked = true;
+            for (const auto& itAtom : model.getAtomicsInfo()) {
+                const CGAbstractAtomicFun<Base>* atom = itAtom.second.atom;
+                if (atom == nullptr || linked.find(atom->atomic_name()) == linked.end()) {
+                    allLinked = false;
+                    break;
+                }
+            }
+
+            if (allLinked) {
+                linked.insert(it.first);
+                changed = true;
+            }
+        }
+    }
+
+    for (const auto& it : _models) {
+        ModelCSourceGen<Base>& model = *it.second;
+        model._directAtomic = linked.find(it.first) != linked.end();
+
+        model._directAtomicFunctions.clear();
+        for (const std::string& name : linked) {
+            if (name != it.first)
+                model._directAtomicFunctions[name] = name + "_" + ModelCSourceGen<Base>::FUNCTION_DIRECT_ATOMIC;
+        }
+    }
+}
+
 template<class Base>
 void ModelLibraryCSourceGen<Base>::saveSources(const std::string& sourcesFolder,
                                                const std::map<std::string, std::string>& sources) {
@@ -312,7 +360,7 @@ void ModelLibraryCSourceGen<Base>::generateThreadPoolSources(std::map<std::strin
 
     } else {
         _cache.str("");
-        _cache << "enum ScheduleStrategy {SCHED_STATIC = 1, SCHED_DYNAMIC = 2, SCHED_GUIDED = 3};\n"
+        _cache << "enum ScheduleStrategy {SCHED_STATIC = 1, SCHED_DYNAMIC = 2, SCHED_GUIDED = 3, SCHED_WORK_STEALING = 4};\n"
                 "\n";
         _cache << "void " << FUNCTION_SETTHREADPOOLDISABLED << "(int disabled) {\n";
         _cache << "}\n\n";
@@ -0,0 +1,303 @@
+#ifndef CPPAD_CG_RELOADABLE_MODEL_LIBRARY_INCLUDED
+#define CPPAD_CG_RELOADABLE_MODEL_LIBRARY_INCLUDED
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2020 Joao Leal
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+
+namespace CppAD {
+namespace cg {
+
+/**
+ * A handle to a model library which can be replaced by a new version
+ * while other threads continue to evaluate the models of the previous
+ * version (read-copy-update).
+ *
+ * Threads evaluating models acquire the current version with acquire()
+ * and keep it for as long as they need it (e.g. one solver iteration).
+ * A new version can be loaded in the background with reloadAsync() and
+ * it is only published once it is completely loaded (models already used
+ * in the current version are created beforehand). Threads which have not
+ * released the previous version can continue to use it; previous versions
+ * are only closed by reclaim() (called when a new version is published)
+ * once no other thread holds them, so that a library is never closed by
+ * a thread evaluating models.
+ *
+ * Note that different versions of a dynamic library must use different
+ * file names, otherwise the system would provide the library which is
+ * already loaded.
+ *
+ * @author Joao Leal
+ */
+template<class Base>
+class ReloadableModelLibrary {
+public:
+    using Loader = std::function<std::unique_ptr<ModelLibrary<Base>>()>;
+    using ModelInitializer = std::function<void(GenericModel<Base>&)>;
+
+    /**
+     * A loaded version of a model library.
+     * The models are created only once per version and can be shared by
+     * several threads (see FunctorGenericModel).
+     */
+    class Version {
+    private:
+        const unsigned long _number;
+        // must be destroyed after the models
+        std::unique_ptr<ModelLibrary<Base>> _library;
+        std::map<std::string, std::unique_ptr<GenericModel<Base>>> _models;
+        ModelInitializer _initializer;
+        std::mutex _mutex;
+    public:
+
+        inline Version(unsigned long number,
+                       std::unique_ptr<ModelLibrary<Base>> library,
+                       ModelInitializer initializer) :
+            _number(number),
+            _library(std::move(library)),
+            _initializer(std::move(initializer)) {
+            CPPADCG_ASSERT_KNOWN(_library != nullptr, "Invalid model library")
+        }
+
+        Version(const Version&) = delete;
+        Version& operator=(const Version&) = delete;
+
+        /**
+         * @return the version number (the first version is 1)
+         */
+        inline unsigned long getNumber() const {
+            return _number;
+        }
+
+        inline ModelLibrary<Base>& getLibrary() {
+            return *_library;
+        }
+
+        /**
+         * Provides a model from this version of the library which is
+         * created the first time it is requested.
+         *
+         * @param modelName the model name
+         * @return the model or nullptr if there is no model with that name
+         */
+        inline GenericModel<Base>* model(const std::string& modelName) {
+            std::lock_guard<std::mutex> lock(_mutex);
+
+            std::unique_ptr<GenericModel<Base>>& m = _models[modelName];
+            if (m == nullptr) {
+                m = _library->model(modelName);
+                if (m != nullptr && _initializer) {
+                    _initializer(*m);
+                }
+            }
+            return m.get();
+        }
+
+        /**
+         * @return the names of the models which were already created
+         */
+        inline std::vector<std::string> getCreatedModelNames() {
+            std::lock_guard<std::mutex> lock(_mutex);
+
+            std::vector<std::string> names;
+            for (const auto& it : _models) {
+                if (it.second != nullptr)
+                    names.push_back(it.first);
+            }
+            return names;
+        }
+    };
+
+    using VersionPtr = std::shared_ptr<Version>;
+
+protected:
+    /**
+     * the current version (only accessed atomically)
+     */
+    VersionPtr _current;
+    /**
+     * previous versions which might still be in use
+     */
+    std::vector<VersionPtr> _retired;
+    /**
+     * called for every new model (e.g. to add atomic functions)
+     */
+    ModelInitializer _initializer;
+    /**
+     * the result of the last background reload
+     */
+    std::shared_future<unsigned long> _reload;
+    /**
+     * protects _retired, _initializer, _reload and the version numbers
+     */
+    mutable std::mutex _mutex;
+    unsigned long _lastNumber;
+public:
+
+    /**
+     * @param library the first version of the model library
+     * @param initializer a function called for every model created
+     *                    by any version of the library (optional)
+     */
+    inline explicit ReloadableModelLibrary(std::unique_ptr<ModelLibrary<Base>> library,
+                                           ModelInitializer initializer = nullptr) :
+        _initializer(std::move(initializer)),
+        _lastNumber(1) {
+        std::atomic_store(&_current, std::make_shared<Version>(1, std::move(library), _initializer));
+    }
+
+    ReloadableModelLibrary(const ReloadableModelLibrary&) = delete;
+    ReloadableModelLibrary& operator=(const ReloadableModelLibrary&) = delete;
+
+    inline virtual ~ReloadableModelLibrary() {
+        std::shared_future<unsigned long> reload;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            reload = _reload;
+        }
+        if (reload.valid())
+            reload.wait();
+    }
+
+    /**
+     * Provides the current version of the library.
+     * This method is lock-free with respect to reloads and it can be
+     * called simultaneously by several threads. The returned version
+     * remains valid (and loaded) for as long as the caller holds it.
+     */
+    inline VersionPtr acquire() const {
+        return std::atomic_load(&_current);
+    }
+
+    /**
+     * @return the number of the current version
+     */
+    inline unsigned long getVersionNumber() const {
+        return acquire()->getNumber();
+    }
+
+    /**
+     * Publishes a new version of the library which was already loaded.
+     * Models already used in the current version are created before the
+     * new version is made available.
+     *
+     * @param library the new version of the model library
+     * @return the new version number
+     */
+    inline unsigned long swap(std::unique_ptr<ModelLibrary<Base>> library) {
+        CPPADCG_ASSERT_KNOWN(library != nullptr, "Invalid model library")
+
+        ModelInitializer initializer;
+        unsigned long number;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            initializer = _initializer;
+            number = ++_lastNumber;
+        }
+
+        VersionPtr next = std::make_shared<Version>(number, std::move(library), std::move(initializer));
+
+        // warm up: avoid creating these models in the threads evaluating them
+        VersionPtr previous = acquire();
+        for (const std::string& name : previous->getCreatedModelNames()) {
+            next->model(name);
+        }
+
+        previous = std::atomic_exchange(&_current, next);
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _retired.push_back(std::move(previous));
+        }
+
+        reclaim();
+
+        return number;
+    }
+
+    /**
+     * Loads a new version of the library in a background thread and
+     * publishes it once it is completely loaded.
+     * Threads evaluating models are not stopped.
+     *
+     * @param loader creates the new version of the library (e.g. a
+     *               LinuxDynamicLib with a new file name); it is called
+     *               from the background thread
+     * @return the new version number once it is published (exceptions
+     *         thrown by the loader are reported through the future)
+     * @throws CGException if another reload is still in progress
+     */
+    inline std::shared_future<unsigned long> reloadAsync(Loader loader) {
+        std::lock_guard<std::mutex> lock(_mutex);
+
+        if (_reload.valid() && _reload.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            throw CGException("A new version of the model library is still being loaded");
+        }
+
+        _reload = std::async(std::launch::async, [this, loader]() -> unsigned long {
+            std::unique_ptr<ModelLibrary<Base>> library = loader();
+            if (library == nullptr) {
+                throw CGException("Failed to load a new version of the model library");
+            }
+            return swap(std::move(library));
+        }).share();
+
+        return _reload;
+    }
+
+    /**
+     * Whether or not a new version is being loaded in the background.
+     */
+    inline bool isReloading() const {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _reload.valid() && _reload.wait_for(std::chrono::seconds(0)) != std::future_status::ready;
+    }
+
+    /**
+     * Closes the previous versions of the library which are no longer
+     * used by any thread (quiescent).
+     *
+     * @return the number of previous versions which are still in use
+     */
+    inline size_t reclaim() {
+        std::vector<VersionPtr> unused;
+        size_t inUse;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            auto it = std::partition(_retired.begin(), _retired.end(), [](const VersionPtr& v) {
+                return v.use_count() > 1;
+            });
+            unused.assign(std::make_move_iterator(it), std::make_move_iterator(_retired.end()));
+            _retired.erase(it, _retired.end());
+            inUse = _retired.size();
+        }
+        // libraries are closed outside the lock
+        unused.clear();
+
+        return inUse;
+    }
+
+    /**
+     * Defines a function called for every model created by new versions of
+     * the library (e.g. to add atomic functions to the models).
+     */
+    inline void setModelInitializer(ModelInitializer initializer) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _initializer = std::move(initializer);
+    }
+
+};
+
+} // END cg namespace
+} // END CppAD namespace
+
+#endif
@@ -0,0 +1,280 @@
+#ifndef CPPAD_CG_SPARSE_OUTPUT_LAYOUT_INCLUDED
+#define CPPAD_CG_SPARSE_OUTPUT_LAYOUT_INCLUDED
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2020 Joao Leal
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+
+namespace CppAD {
+namespace cg {
+
+/**
+ * Maps the non-zero elements of a sparse matrix, in the order they are
+ * computed by a model (e.g. JacobianSparsity(rows, cols)), into the value
+ * array of a sparse matrix structure owned by the caller (e.g. CSR or CSC).
+ *
+ * The mapping is determined only once so that each evaluation only
+ * requires a single pass over the values.
+ *
+ * @author Joao Leal
+ */
+class SparseOutputLayout {
+protected:
+    /**
+     * number of elements in the model value array
+     */
+    size_t _modelNnz;
+    /**
+     * number of elements in the target value array
+     */
+    size_t _targetNnz;
+    /**
+     * the index of each value in the model array
+     */
+    std::vector<size_t> _source;
+    /**
+     * the position where each value in _source is placed in the target array
+     */
+    std::vector<size_t> _target;
+    /**
+     * positions in the target array which are not computed by the model
+     */
+    std::vector<size_t> _zeros;
+    /**
+     * whether or not the model and the target arrays use the same order
+     */
+    bool _identity;
+public:
+
+    inline SparseOutputLayout() :
+        _modelNnz(0),
+        _targetNnz(0),
+        _identity(true) {
+    }
+
+    /**
+     * Creates a new layout using a compressed sparse row (CSR) or
+     * compressed sparse column (CSC) structure.
+     *
+     * @param modelRows the row indexes of the model values
+     * @param modelCols the column indexes of the model values
+     * @param format the format of the target structure
+     * @param ptr the row (CSR) or column (CSC) pointers of the target
+     *            structure (the number of rows/columns + 1 elements)
+     * @param idx the column (CSR) or row (CSC) indexes of the target
+     *            structure (ptr[ptr.size() - 1] elements)
+     * @param symmetric whether or not the matrix is symmetric, in which
+     *                  case a model value (i, j) can be placed at (j, i)
+     * @throws CGException if a model value is not part of the target
+     *                     structure
+     */
+    inline SparseOutputLayout(const std::vector<size_t>& modelRows,
+                              const std::vector<size_t>& modelCols,
+                              SparseFormat format,
+                              ArrayView<const size_t> ptr,
+                              ArrayView<const size_t> idx,
+                              bool symmetric = false) {
+        std::vector<size_t> rows, cols;
+        toTriplets(format, ptr, idx, rows, cols);
+        determinePositions(modelRows, modelCols, rows, cols, symmetric);
+    }
+
+    /**
+     * Creates a new layout using the row and column index of each
+     * element in the target array.
+     *
+     * @param modelRows the row indexes of the model values
+     * @param modelCols the column indexes of the model values
+     * @param rows the row indexes of the target values
+     * @param cols the column indexes of the target values
+     * @param symmetric whether or not the matrix is symmetric, in which
+     *                  case a model value (i, j) can be placed at (j, i)
+     * @throws CGException if a model value is not part of the target
+     *                     structure
+     */
+    inline SparseOutputLayout(const std::vector<size_t>& modelRows,
+                              const std::vector<size_t>& modelCols,
+                              const std::vector<size_t>& rows,
+                              const std::vector<size_t>& cols,
+                              bool symmetric = false) {
+        determinePositions(modelRows, modelCols, rows, cols, symmetric);
+    }
+
+    /**
+     * @return the number of elements in the model value array
+     */
+    inline size_t getModelSize() const {
+        return _modelNnz;
+    }
+
+    /**
+     * @return the number of elements in the target value array
+     */
+    inline size_t getTargetSize() const {
+        return _targetNnz;
+    }
+
+    /**
+     * Whether or not the model values are already in the order of the
+     * target array, in which case the model can write directly into the
+     * target array.
+     */
+    inline bool isIdentity() const {
+        return _identity;
+    }
+
+    /**
+     * Places the model values in the target array.
+     * Elements of the target structure which are not computed by the
+     * model are set to zero.
+     *
+     * @param values the model values
+     * @param target the target value array
+     */
+    template<class Base>
+    inline void scatter(ArrayView<const Base> values,
+                        ArrayView<Base> target) const {
+        CPPADCG_ASSERT_KNOWN(values.size() == _modelNnz, "Invalid model value array size")
+        CPPADCG_ASSERT_KNOWN(target.size() == _targetNnz, "Invalid target value array size")
+
+        for (size_t p : _zeros) {
+            target[p] = Base(0);
+        }
+        for (size_t e = 0; e < _source.size(); ++e) {
+            target[_target[e]] = values[_source[e]];
+        }
+    }
+
+    /**
+     * Determines the row and column index of each element in a compressed
+     * sparse row (CSR) or compressed sparse column (CSC) structure.
+     *
+     * @param format the format of the structure
+     * @param ptr the row (CSR) or column (CSC) pointers
+     * @param idx the column (CSR) or row (CSC) indexes
+     * @param rows the row indexes (output)
+     * @param cols the column indexes (output)
+     * @throws CGException if the structure is invalid
+     */
+    static inline void toTriplets(SparseFormat format,
+                                  ArrayView<const size_t> ptr,
+                                  ArrayView<const size_t> idx,
+                                  std::vector<size_t>& rows,
+                                  std::vector<size_t>& cols) {
+        if (ptr.empty() || ptr[0] != 0 || ptr[ptr.size() - 1] != idx.size()) {
+            throw CGException("Invalid compressed sparse structure: the pointer array must start with 0 and end with the number of indexes (", idx.size(), ")");
+        }
+
+        rows.resize(idx.size());
+        cols.resize(idx.size());
+
+        for (size_t k = 0; k + 1 < ptr.size(); ++k) {
+            if (ptr[k] > ptr[k + 1]) {
+                throw CGException("Invalid compressed sparse structure: the pointer array is not monotonic at position ", k);
+            }
+            for (size_t e = ptr[k]; e < ptr[k + 1]; ++e) {
+                if (format == SparseFormat::CSR) {
+                    rows[e] = k;
+                    cols[e] = idx[e];
+                } else {
+                    rows[e] = idx[e];
+                    cols[e] = k;
+                }
+            }
+        }
+    }
+
+protected:
+
+    inline void determinePositions(const std::vector<size_t>& modelRows,
+                                   const std::vector<size_t>& modelCols,
+                                   const std::vector<size_t>& rows,
+                                   const std::vector<size_t>& cols,
+                                   bool symmetric) {
+        CPPADCG_ASSERT_KNOWN(modelRows.size() == modelCols.size(), "Invalid model sparsity")
+        if (rows.size() != cols.size()) {
+            throw CGException("The number of row (", rows.size(), ") and column (", cols.size(), ") indexes must be the same");
+        }
+
+        _modelNnz = modelRows.size();
+        _targetNnz = rows.size();
+        _source.clear();
+        _target.clear();
+        _zeros.clear();
+
+        std::map<std::pair<size_t, size_t>, size_t> positions;
+        for (size_t p = 0; p < _targetNnz; ++p) {
+            positions.emplace(std::make_pair(rows[p], cols[p]), p); // duplicates keep the first position
+        }
+
+        std::vector<bool> assigned(_targetNnz, false);
+        std::vector<bool> placed(_modelNnz, false);
+
+        for (size_t e = 0; e < _modelNnz; ++e) {
+            auto it = positions.find(std::make_pair(modelRows[e], modelCols[e]));
+            if (it != positions.end()) {
+                if (!assigned[it->second])
+                    addPosition(e, it->second, assigned, placed);
+                else
+                    placed[e] = true; // repeated model element
+            }
+        }
+
+        if (symmetric) {
+            // the other triangle is only filled when it is not computed by the model
+            for (size_t e = 0; e < _modelNnz; ++e) {
+                if (modelRows[e] == modelCols[e])
+                    continue;
+                auto it = positions.find(std::make_pair(modelCols[e], modelRows[e]));
+                if (it != positions.end()) {
+                    if (!assigned[it->second])
+                        addPosition(e, it->second, assigned, placed);
+                    else
+                        placed[e] = true; // the model also computes (j, i)
+                }
+            }
+        }
+
+        for (size_t e = 0; e < _modelNnz; ++e) {
+            if (!placed[e]) {
+                throw CGException("The element (", modelRows[e], ", ", modelCols[e], ") is not part of the provided sparsity structure");
+            }
+        }
+
+        for (size_t p = 0; p < _targetNnz; ++p) {
+            if (!assigned[p])
+                _zeros.push_back(p);
+        }
+
+        _identity = _modelNnz == _targetNnz && _source.size() == _targetNnz;
+        for (size_t e = 0; _identity && e < _source.size(); ++e) {
+            _identity = _source[e] == _target[e];
+        }
+    }
+
+    inline void addPosition(size_t e,
+                            size_t p,
+                            std::vector<bool>& assigned,
+                            std::vector<bool>& placed) {
+        _source.push_back(e);
+        _target.push_back(p);
+        assigned[p] = true;
+        placed[e] = true;
+    }
+
+};
+
+} // END cg namespace
+} // END CppAD namespace
+
+#endif
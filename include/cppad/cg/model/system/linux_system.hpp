@@ -18,6 +18,7 @@
 
 #if CPPAD_CG_SYSTEM_LINUX
 #include <unistd.h>
+#include <fcntl.h>
 #include <sys/types.h>
 #include <sys/wait.h>
 #include <sys/stat.h>
@@ -70,9 +71,22 @@ public:
 
     inline void create() {
         int fd[2]; /** file descriptors used to communicate between processes*/
+        /**
+         * the pipe must not be inherited by other processes which might be
+         * forked concurrently by other threads (e.g. parallel compilation),
+         * otherwise the end of file would not be detected
+         */
+#ifndef CPPAD_CG_SYSTEM_APPLE
+        if (pipe2(fd, O_CLOEXEC) < 0) {
+            throw CGException("Failed to create pipe");
+        }
+#else
         if (pipe(fd) < 0) {
             throw CGException("Failed to create pipe");
         }
+        fcntl(fd[0], F_SETFD, FD_CLOEXEC);
+        fcntl(fd[1], F_SETFD, FD_CLOEXEC);
+#endif
         read.fd = fd[0];
         read.closed = false;
         write.fd = fd[1];
@@ -195,6 +209,10 @@ inline bool isFile(const std::string& path) {
     return false;
 }
 
+inline unsigned long getProcessId() {
+    return (unsigned long) getpid();
+}
+
 inline void callExecutable(const std::string& executable,
                            const std::vector<std::string>& args,
                            std::string* stdOutErrMessage,
@@ -96,6 +96,13 @@ inline bool isDirectory(const std::string& path);
  */
 inline bool isFile(const std::string& path);
 
+/**
+ * Provides the identifier of the current process (system dependent)
+ *
+ * @return the process identifier
+ */
+inline unsigned long getProcessId();
+
 /**
  * Calls an external executable (system dependent).
  * In the case of an error during execution an exception will be thrown.
@@ -18,7 +18,8 @@
 
 enum ScheduleStrategy {SCHED_STATIC = 1,
                        SCHED_DYNAMIC = 2,
-                       SCHED_GUIDED = 3
+                       SCHED_GUIDED = 3,
+                       SCHED_WORK_STEALING = 4
                       };
 
 static volatile int cppadcg_openmp_enabled = 1; // false
@@ -63,7 +64,7 @@ enum ScheduleStrategy cppadcg_openmp_get_scheduler_strategy() {
 }
 
 void cppadcg_openmp_apply_scheduler_strategy() {
-    if (schedule_strategy == SCHED_DYNAMIC) {
+    if (schedule_strategy == SCHED_DYNAMIC || schedule_strategy == SCHED_WORK_STEALING) {
         omp_set_schedule(omp_sched_dynamic, 1);
     } else if (schedule_strategy == SCHED_GUIDED) {
         omp_set_schedule(omp_sched_guided, 0);
@@ -21,6 +21,7 @@
 #include <unistd.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
 #include <pthread.h>
 #include <errno.h>
 #include <time.h>
@@ -34,7 +35,8 @@
 
 enum ScheduleStrategy {SCHED_STATIC = 1,
                        SCHED_DYNAMIC = 2,
-                       SCHED_GUIDED = 3
+                       SCHED_GUIDED = 3,
+                       SCHED_WORK_STEALING = 4
                        };
 
 enum ElapsedTimeReference {ELAPSED_TIME_AVG,
@@ -107,6 +109,14 @@ typedef struct WorkGroup {
     struct timespec endTime;             /* final time (verbose only)      */
 } WorkGroup;
 
+/* Jobs distributed among the threads (SCHED_WORK_STEALING scheduling only) */
+typedef struct WorkStealingBatch {
+    Job* jobs;                           /* jobs grouped by thread                                  */
+    uint64_t* ranges;                    /* jobs of each thread [begin, end) packed as begin<<32|end */
+    int num_ranges;                      /* number of ranges (one per thread)                       */
+    int pending;                         /* number of jobs not completed yet (atomic)               */
+} WorkStealingBatch;
+
 /* Job queue */
 typedef struct JobQueue {
     pthread_mutex_t rwmutex;             /* used for queue r/w access */
@@ -138,6 +148,7 @@ typedef struct ThPool {
     pthread_mutex_t thcount_lock;        /* used for thread count etc */
     pthread_cond_t threads_all_idle;     /* signal to thpool_wait     */
     JobQueue* jobqueue;                  /* pointer to the job queue  */
+    WorkStealingBatch* ws_batch;         /* jobs in the thread deques (protected by thcount_lock) */
     volatile int threads_keepalive;
 } ThPool;
 
@@ -386,6 +397,13 @@ static int jobqueue_push_static_jobs(ThPool* thpool,
 static WorkGroup* jobqueue_pull(ThPool* thpool, int id);
 static void  jobqueue_destroy(ThPool* thpool);
 
+static int   stealing_push_jobs(ThPool* thpool,
+                                Job* newjobs[],
+                                int nJobs);
+static int   stealing_run_jobs(ThPool* thpool,
+                               Thread* thread);
+static void  stealing_batch_destroy(WorkStealingBatch* batch);
+
 static void  bsem_init(BSem *bsem, int value);
 static void  bsem_reset(BSem *bsem);
 static void  bsem_post(BSem *bsem);
@@ -483,6 +501,7 @@ struct ThPool* thpool_init(int num_threads) {
     thpool->num_threads_alive = 0;
     thpool->num_threads_working = 0;
     thpool->threads_keepalive = 1;
+    thpool->ws_batch = NULL;
 
     /* Initialize the job queue */
     if (jobqueue_init(thpool) == -1) {
@@ -607,6 +626,8 @@ static int thpool_add_jobs(ThPool* thpool,
     /* add jobs to queue */
     if (schedule_strategy == SCHED_STATIC && avgElapsed != NULL && order != NULL && nJobs > 0 && avgElapsed[0] > 0) {
         return jobqueue_push_static_jobs(thpool, newjobs, avgElapsed, job2Thread, nJobs, lastElapsedChanged);
+    } else if (schedule_strategy == SCHED_WORK_STEALING && nJobs > 1) {
+        return stealing_push_jobs(thpool, newjobs, nJobs);
     } else {
         jobqueue_multipush(thpool->jobqueue, newjobs, nJobs);
         return 0;
@@ -792,14 +813,22 @@ static int jobqueue_push_static_jobs(ThPool* thpool,
  * @param threadpool     the threadpool to wait for
  */
 static void thpool_wait(ThPool* thpool) {
+    WorkStealingBatch* batch;
+
     pthread_mutex_lock(&thpool->thcount_lock);
-    while (thpool->jobqueue->len || thpool->jobqueue->group_front || thpool->num_threads_working) {  //// PROBLEM HERE!!!! len is not locked!!!!
+    while (thpool->jobqueue->len || thpool->jobqueue->group_front || thpool->num_threads_working ||
+           (thpool->ws_batch != NULL && __atomic_load_n(&thpool->ws_batch->pending, __ATOMIC_ACQUIRE) > 0)) {  //// PROBLEM HERE!!!! len is not locked!!!!
         pthread_cond_wait(&thpool->threads_all_idle, &thpool->thcount_lock);
     }
     thpool->jobqueue->total_time = 0;
     thpool->jobqueue->highest_expected_return = 0;
+    /* no thread can access the batch since they are all idle */
+    batch = thpool->ws_batch;
+    thpool->ws_batch = NULL;
     pthread_mutex_unlock(&thpool->thcount_lock);
 
+    stealing_batch_destroy(batch);
+
     thpool_cleanup(thpool);
 }
 
@@ -905,6 +934,9 @@ static void thpool_destroy(ThPool* thpool) {
     /* cleanup current work groups */
     thpool_cleanup(thpool);
 
+    stealing_batch_destroy(thpool->ws_batch);
+    thpool->ws_batch = NULL;
+
     /* Job queue cleanup */
     jobqueue_destroy(thpool);
     free(thpool->jobqueue);
@@ -1006,6 +1038,9 @@ static void* thread_do(Thread* thread) {
         pthread_mutex_unlock(&thpool->thcount_lock);
 
         while (thpool->threads_keepalive) {
+            /* Execute the jobs in the thread deques (work stealing) */
+            stealing_run_jobs(thpool, thread);
+
             /* Read job from queue and execute it */
             pthread_mutex_lock(&queue->rwmutex);
             workGroup = jobqueue_pull(thpool, thread->id);
@@ -1368,6 +1403,288 @@ static void jobqueue_destroy(ThPool* thpool) {
 
 
 
+/* ========================= WORK STEALING ========================== */
+
+/**
+ * The jobs of each thread are stored in a contiguous range of the batch.
+ * The owner thread takes jobs from the beginning of its range while the
+ * other threads steal from its end. Both ends are packed in a single
+ * 64 bit integer so that they can be updated with a single
+ * compare-and-swap without any lock.
+ */
+static inline uint64_t stealing_pack(uint32_t begin,
+                                     uint32_t end) {
+    return (((uint64_t) begin) << 32) | end;
+}
+
+/**
+ * Takes the first job from a range.
+ *
+ * @return 1 if a job was retrieved, 0 otherwise
+ */
+static int stealing_pop_front(uint64_t* range,
+                              uint32_t* index) {
+    uint64_t old = __atomic_load_n(range, __ATOMIC_ACQUIRE);
+    uint32_t begin, end;
+
+    for (;;) {
+        begin = (uint32_t) (old >> 32);
+        end = (uint32_t) old;
+        if (begin >= end)
+            return 0;
+
+        if (__atomic_compare_exchange_n(range, &old, stealing_pack(begin + 1, end), 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            *index = begin;
+            return 1;
+        }
+    }
+}
+
+/**
+ * Takes the last job from a range (used by other threads).
+ *
+ * @return 1 if a job was retrieved, 0 otherwise
+ */
+static int stealing_pop_back(uint64_t* range,
+                             uint32_t* index) {
+    uint64_t old = __atomic_load_n(range, __ATOMIC_ACQUIRE);
+    uint32_t begin, end;
+
+    for (;;) {
+        begin = (uint32_t) (old >> 32);
+        end = (uint32_t) old;
+        if (begin >= end)
+            return 0;
+
+        if (__atomic_compare_exchange_n(range, &old, stealing_pack(begin, end - 1), 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            *index = end - 1;
+            return 1;
+        }
+    }
+}
+
+static int stealing_has_jobs(WorkStealingBatch* batch) {
+    int i;
+    uint64_t r;
+    for (i = 0; i < batch->num_ranges; ++i) {
+        r = __atomic_load_n(&batch->ranges[i], __ATOMIC_ACQUIRE);
+        if ((uint32_t) (r >> 32) < (uint32_t) r)
+            return 1;
+    }
+    return 0;
+}
+
+static void stealing_batch_destroy(WorkStealingBatch* batch) {
+    if (batch == NULL)
+        return;
+    free(batch->jobs);
+    free(batch->ranges);
+    free(batch);
+}
+
+/**
+ * Distributes jobs among the thread deques.
+ * The provided job order is used as a hint for the initial placement:
+ * with timing information each job is given to the least loaded thread,
+ * otherwise jobs are distributed in contiguous blocks.
+ * Falls back to the shared job queue if a previous batch has not been
+ * completed yet.
+ */
+static int stealing_push_jobs(ThPool* thpool,
+                              Job* newjobs[],
+                              int nJobs) {
+    int i, j, t, best;
+    int num_threads = thpool->num_threads;
+    int use_time = 1; // true
+    int* job2thread;
+    int* n_jobs;
+    float* durations;
+    WorkStealingBatch* batch;
+
+    batch = (WorkStealingBatch*) malloc(sizeof(WorkStealingBatch));
+    job2thread = (int*) malloc(nJobs * sizeof(int));
+    n_jobs = (int*) malloc(num_threads * sizeof(int));
+    durations = (float*) malloc(num_threads * sizeof(float));
+    if (batch != NULL) {
+        batch->jobs = (Job*) malloc(nJobs * sizeof(Job));
+        batch->ranges = (uint64_t*) malloc(num_threads * sizeof(uint64_t));
+    }
+    if (batch == NULL || batch->jobs == NULL || batch->ranges == NULL || job2thread == NULL || n_jobs == NULL || durations == NULL) {
+        fprintf(stderr, "stealing_push_jobs(): Could not allocate memory\n");
+        stealing_batch_destroy(batch);
+        free(job2thread);
+        free(n_jobs);
+        free(durations);
+        jobqueue_multipush(thpool->jobqueue, newjobs, nJobs);
+        return 0;
+    }
+    batch->num_ranges = num_threads;
+    batch->pending = nJobs;
+
+    for (t = 0; t < num_threads; ++t) {
+        n_jobs[t] = 0;
+        durations[t] = 0;
+    }
+
+    for (j = 0; j < nJobs; ++j) {
+        if (newjobs[j]->avgElapsed == NULL || *newjobs[j]->avgElapsed <= 0) {
+            use_time = 0;
+            break;
+        }
+    }
+
+    /**
+     * initial placement
+     */
+    for (j = 0; j < nJobs; ++j) {
+        if (use_time) {
+            best = 0;
+            for (t = 1; t < num_threads; ++t) {
+                if (durations[t] < durations[best])
+                    best = t;
+            }
+            durations[best] += *newjobs[j]->avgElapsed;
+        } else {
+            best = (int) (((int64_t) j * num_threads) / nJobs);
+        }
+        job2thread[j] = best;
+        n_jobs[best]++;
+    }
+
+    /**
+     * place jobs in contiguous ranges (keeping the provided order)
+     */
+    i = 0;
+    for (t = 0; t < num_threads; ++t) {
+        batch->ranges[t] = stealing_pack((uint32_t) i, (uint32_t) (i + n_jobs[t]));
+        n_jobs[t] = i; // now used as the insertion position
+        i = (int) (uint32_t) batch->ranges[t];
+    }
+    for (j = 0; j < nJobs; ++j) {
+        t = job2thread[j];
+        batch->jobs[n_jobs[t]++] = *newjobs[j]; // copy
+    }
+
+    if (cppadcg_pool_verbose) {
+        for (t = 0; t < num_threads; ++t) {
+            fprintf(stdout, "stealing_push_jobs(): thread %i given %i jobs",
+                    t, (int) ((uint32_t) batch->ranges[t] - (uint32_t) (batch->ranges[t] >> 32)));
+            if (use_time)
+                fprintf(stdout, " for %e s\n", durations[t]);
+            else
+                fprintf(stdout, "\n");
+        }
+    }
+
+    free(job2thread);
+    free(n_jobs);
+    free(durations);
+
+    /**
+     * publish
+     */
+    pthread_mutex_lock(&thpool->thcount_lock);
+    if (thpool->ws_batch != NULL) {
+        pthread_mutex_unlock(&thpool->thcount_lock);
+
+        // the previous jobs have not been waited for
+        if (cppadcg_pool_verbose) {
+            fprintf(stdout, "stealing_push_jobs(): using the shared job queue (previous jobs not completed)\n");
+        }
+        stealing_batch_destroy(batch);
+        jobqueue_multipush(thpool->jobqueue, newjobs, nJobs);
+        return 0;
+    }
+    __atomic_store_n(&thpool->ws_batch, batch, __ATOMIC_RELEASE);
+    pthread_mutex_unlock(&thpool->thcount_lock);
+
+    for (j = 0; j < nJobs; ++j) {
+        free(newjobs[j]);
+    }
+
+    bsem_post_all(thpool->jobqueue->has_jobs);
+
+    return 0;
+}
+
+/**
+ * Executes a single job (measuring its duration when requested).
+ */
+static void stealing_execute_job(Job* job) {
+    float elapsed;
+    int info;
+    struct timespec cputime;
+    int do_benchmark = job->elapsed != NULL;
+
+    if (do_benchmark) {
+        elapsed = -get_thread_time(&cputime, &info);
+    }
+
+    (*job->function)(job->arg);
+
+    if (do_benchmark && info == 0) {
+        elapsed += get_thread_time(&cputime, &info);
+        if (info == 0) {
+            (*job->elapsed) = elapsed;
+        }
+    }
+}
+
+/**
+ * Executes the jobs of the current thread and then steals jobs from the
+ * other threads until there are no more jobs in the batch.
+ *
+ * Notice: the caller must be accounted in num_threads_working
+ *
+ * @return the number of executed jobs
+ */
+static int stealing_run_jobs(ThPool* thpool,
+                             Thread* thread) {
+    WorkStealingBatch* batch;
+    uint32_t index;
+    int executed = 0;
+    int stolen = 0;
+    int n, t, v;
+
+    batch = __atomic_load_n(&thpool->ws_batch, __ATOMIC_ACQUIRE);
+    if (batch == NULL)
+        return 0;
+
+    n = batch->num_ranges;
+    t = thread->id < n ? thread->id : 0;
+
+    /* wake up another thread if there is still work to do */
+    if (stealing_has_jobs(batch)) {
+        bsem_post(thpool->jobqueue->has_jobs);
+    }
+
+    for (;;) {
+        if (stealing_pop_front(&batch->ranges[t], &index)) {
+            // own job
+        } else {
+            // steal from the other threads
+            for (v = 1; v < n; ++v) {
+                if (stealing_pop_back(&batch->ranges[(t + v) % n], &index))
+                    break;
+            }
+            if (v == n)
+                break; // no more jobs
+            stolen++;
+        }
+
+        stealing_execute_job(&batch->jobs[index]);
+        executed++;
+
+        __atomic_sub_fetch(&batch->pending, 1, __ATOMIC_ACQ_REL);
+    }
+
+    if (cppadcg_pool_verbose && executed > 0) {
+        fprintf(stdout, "stealing_run_jobs(): thread %i executed %i jobs (%i stolen)\n", thread->id, executed, stolen);
+    }
+
+    return executed;
+}
+
 /* ======================== SYNCHRONISATION ========================= */
 
 
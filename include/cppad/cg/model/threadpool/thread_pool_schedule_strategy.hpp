@@ -21,7 +21,8 @@ namespace cg {
 enum class ThreadPoolScheduleStrategy {
     STATIC = 1, // all jobs are assigned to a thread at the beginning
     DYNAMIC = 2, // each thread only executes a single job at a time
-    GUIDED = 3 // each thread can execute multiple jobs before returning to the pool
+    GUIDED = 3, // each thread can execute multiple jobs before returning to the pool
+    WORK_STEALING = 4 // jobs are distributed among the threads which steal jobs from each other once they run out of work
 };
 
 }
@@ -0,0 +1,160 @@
+#ifndef CPPAD_CG_OBJECT_ARENA_INCLUDED
+#define CPPAD_CG_OBJECT_ARENA_INCLUDED
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2019 Joao Leal
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+
+namespace CppAD {
+namespace cg {
+
+/**
+ * Provides memory for objects of a single type from large contiguous
+ * chunks (slabs) instead of individual heap allocations.
+ * Released slots are reused by later allocations and all the memory is
+ * only returned to the system by clear() or on destruction.
+ *
+ * This class only manages raw memory: objects must be constructed with
+ * placement new and destroyed explicitly before their memory is released.
+ *
+ * @tparam T the object type
+ */
+template<class T>
+class ObjectArena {
+private:
+    union Slot {
+        Slot* next;
+        alignas(T) unsigned char data[sizeof(T)];
+    };
+
+    struct Chunk {
+        std::unique_ptr<Slot[]> slots;
+        size_t size;
+    };
+private:
+    /**
+     * allocated memory chunks (each one larger than the previous one)
+     */
+    std::vector<Chunk> chunks_;
+    /**
+     * number of slots used in the last chunk
+     */
+    size_t used_;
+    /**
+     * the number of slots in the first chunk
+     */
+    size_t firstChunkSize_;
+    /**
+     * the maximum number of slots in a chunk
+     */
+    size_t maxChunkSize_;
+    /**
+     * released slots which can be reused
+     */
+    Slot* free_;
+    /**
+     * number of currently allocated slots
+     */
+    size_t allocated_;
+public:
+
+    inline explicit ObjectArena(size_t firstChunkSize = 64,
+                                size_t maxChunkSize = 1u << 20u) :
+        used_(0),
+        firstChunkSize_(std::max<size_t>(firstChunkSize, 1)),
+        maxChunkSize_(std::max<size_t>(maxChunkSize, firstChunkSize_)),
+        free_(nullptr),
+        allocated_(0) {
+    }
+
+    ObjectArena(const ObjectArena&) = delete;
+
+    ObjectArena& operator=(const ObjectArena&) = delete;
+
+    /**
+     * Provides uninitialized memory for a single object of type T.
+     */
+    inline void* allocate() {
+        Slot* s;
+        if (free_ != nullptr) {
+            s = free_;
+            free_ = free_->next;
+        } else {
+            if (chunks_.empty() || used_ == chunks_.back().size) {
+                size_t size = chunks_.empty() ? firstChunkSize_ : std::min<size_t>(chunks_.back().size * 2, maxChunkSize_);
+                chunks_.push_back(Chunk{std::unique_ptr<Slot[]>(new Slot[size]), size});
+                used_ = 0;
+            }
+            s = &chunks_.back().slots[used_++];
+        }
+        allocated_++;
+        return s->data;
+    }
+
+    /**
+     * Releases the memory of an object previously provided by allocate().
+     * The object must have already been destroyed.
+     */
+    inline void deallocate(void* p) {
+        CPPADCG_ASSERT_UNKNOWN(owns(p))
+        Slot* s = reinterpret_cast<Slot*>(p);
+        s->next = free_;
+        free_ = s;
+        allocated_--;
+    }
+
+    /**
+     * Determines whether or not the memory of an object was provided by
+     * this arena.
+     */
+    inline bool owns(const void* p) const {
+        std::less<const void*> less;
+        // search newer (larger) chunks first
+        for (auto it = chunks_.rbegin(); it != chunks_.rend(); ++it) {
+            const Slot* begin = it->slots.get();
+            if (!less(p, begin) && less(p, begin + it->size))
+                return true;
+        }
+        return false;
+    }
+
+    /**
+     * The number of objects currently allocated
+     */
+    inline size_t size() const {
+        return allocated_;
+    }
+
+    /**
+     * The number of memory chunks requested to the system
+     */
+    inline size_t getChunkCount() const {
+        return chunks_.size();
+    }
+
+    /**
+     * Releases all the memory.
+     * All objects must have already been destroyed.
+     */
+    inline void clear() {
+        chunks_.clear();
+        used_ = 0;
+        free_ = nullptr;
+        allocated_ = 0;
+    }
+};
+
+} // END cg namespace
+} // END CppAD namespace
+
+#endif
@@ -0,0 +1,132 @@
+#ifndef CPPAD_CG_ALGEBRAIC_SIMPLIFICATION_PASS_INCLUDED
+#define CPPAD_CG_ALGEBRAIC_SIMPLIFICATION_PASS_INCLUDED
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2020 Joao Leal
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+
+namespace CppAD {
+namespace cg {
+
+/**
+ * Removes algebraic identities which were not simplified while the
+ * operations were recorded (e.g. after constant folding or after loading a
+ * saved graph):
+ *  - x + 0, 0 + x, x - 0, x * 1, 1 * x, x / 1 -> x
+ *  - x * 0, 0 * x, 0 / x -> 0 (as in the CG arithmetic, it does not
+ *    consider that x could be infinity or NaN)
+ *  - 0 - x, x * -1, -1 * x, x / -1 -> -x
+ *  - -(-x) -> x
+ *  - x + (-y) -> x - y, (-x) + y -> y - x, x - (-y) -> x + y
+ *
+ * @author Joao Leal
+ */
+template<class Base>
+class AlgebraicSimplificationPass : public GraphRewritePass<Base> {
+public:
+    using Node = OperationNode<Base>;
+    using Arg = Argument<Base>;
+public:
+
+    inline AlgebraicSimplificationPass() :
+        GraphRewritePass<Base>("algebraic simplification") {
+    }
+
+protected:
+
+    bool rewrite(CodeHandler<Base>& handler,
+                 Node& node,
+                 Arg& result) override {
+        const std::vector<Arg>& args = node.getArguments();
+        const Base zero(0.0);
+        const Base one(1.0);
+        const Base minusOne(-1.0);
+
+        switch (node.getOperationType()) {
+            case CGOpCode::Add:
+                CPPADCG_ASSERT_UNKNOWN(args.size() == 2)
+                if (this->isParameter(args[0], zero)) {
+                    result = args[1];
+                } else if (this->isParameter(args[1], zero)) {
+                    result = args[0];
+                } else if (this->isOperation(args[1], CGOpCode::UnMinus)) {
+                    result = *handler.makeNode(CGOpCode::Sub, {args[0], args[1].getOperation()->getArguments()[0]});
+                } else if (this->isOperation(args[0], CGOpCode::UnMinus)) {
+                    result = *handler.makeNode(CGOpCode::Sub, {args[1], args[0].getOperation()->getArguments()[0]});
+                } else {
+                    return false;
+                }
+                return true;
+
+            case CGOpCode::Sub:
+                CPPADCG_ASSERT_UNKNOWN(args.size() == 2)
+                if (this->isParameter(args[1], zero)) {
+                    result = args[0];
+                } else if (this->isParameter(args[0], zero) && args[1].getOperation() != nullptr) {
+                    result = *handler.makeNode(CGOpCode::UnMinus, args[1]);
+                } else if (this->isOperation(args[1], CGOpCode::UnMinus)) {
+                    result = *handler.makeNode(CGOpCode::Add, {args[0], args[1].getOperation()->getArguments()[0]});
+                } else {
+                    return false;
+                }
+                return true;
+
+            case CGOpCode::Mul:
+                CPPADCG_ASSERT_UNKNOWN(args.size() == 2)
+                if (this->isParameter(args[0], zero) || this->isParameter(args[1], zero)) {
+                    result = Arg(zero);
+                } else if (this->isParameter(args[0], one)) {
+                    result = args[1];
+                } else if (this->isParameter(args[1], one)) {
+                    result = args[0];
+                } else if (this->isParameter(args[0], minusOne) && args[1].getOperation() != nullptr) {
+                    result = *handler.makeNode(CGOpCode::UnMinus, args[1]);
+                } else if (this->isParameter(args[1], minusOne) && args[0].getOperation() != nullptr) {
+                    result = *handler.makeNode(CGOpCode::UnMinus, args[0]);
+                } else {
+                    return false;
+                }
+                return true;
+
+            case CGOpCode::Div:
+                CPPADCG_ASSERT_UNKNOWN(args.size() == 2)
+                if (this->isParameter(args[0], zero)) {
+                    result = Arg(zero);
+                } else if (this->isParameter(args[1], one)) {
+                    result = args[0];
+                } else if (this->isParameter(args[1], minusOne) && args[0].getOperation() != nullptr) {
+                    result = *handler.makeNode(CGOpCode::UnMinus, args[0]);
+                } else {
+                    return false;
+                }
+                return true;
+
+            case CGOpCode::UnMinus:
+                CPPADCG_ASSERT_UNKNOWN(args.size() == 1)
+                if (this->isOperation(args[0], CGOpCode::UnMinus)) {
+                    result = args[0].getOperation()->getArguments()[0];
+                    return true;
+                }
+                return false;
+
+            default:
+                return false;
+        }
+    }
+
+};
+
+} // END cg namespace
+} // END CppAD namespace
+
+#endif
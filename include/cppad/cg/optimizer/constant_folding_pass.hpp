@@ -0,0 +1,156 @@
+#ifndef CPPAD_CG_CONSTANT_FOLDING_PASS_INCLUDED
+#define CPPAD_CG_CONSTANT_FOLDING_PASS_INCLUDED
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2020 Joao Leal
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+
+namespace CppAD {
+namespace cg {
+
+/**
+ * Replaces operations whose arguments are all parameters by their result.
+ * Comparisons between parameters are replaced by the selected branch.
+ * Since the graph is processed from the independent variables to the
+ * dependents, folded values are propagated to the following operations.
+ *
+ * @author Joao Leal
+ */
+template<class Base>
+class ConstantFoldingPass : public GraphRewritePass<Base> {
+public:
+    using CGB = CG<Base>;
+    using Node = OperationNode<Base>;
+    using Arg = Argument<Base>;
+public:
+
+    inline ConstantFoldingPass() :
+        GraphRewritePass<Base>("constant folding") {
+    }
+
+protected:
+
+    bool rewrite(CodeHandler<Base>& handler,
+                 Node& node,
+                 Arg& result) override {
+        const std::vector<Arg>& args = node.getArguments();
+        CGOpCode op = node.getOperationType();
+
+        switch (op) {
+            case CGOpCode::ComLt:
+            case CGOpCode::ComLe:
+            case CGOpCode::ComEq:
+            case CGOpCode::ComGe:
+            case CGOpCode::ComGt:
+            case CGOpCode::ComNe: {
+                CPPADCG_ASSERT_UNKNOWN(args.size() == 4)
+                if (args[0].getParameter() == nullptr || args[1].getParameter() == nullptr)
+                    return false;
+
+                const Base& left = *args[0].getParameter();
+                const Base& right = *args[1].getParameter();
+                bool c;
+                if (op == CGOpCode::ComLt) c = left < right;
+                else if (op == CGOpCode::ComLe) c = left <= right;
+                else if (op == CGOpCode::ComEq) c = left == right;
+                else if (op == CGOpCode::ComGe) c = left >= right;
+                else if (op == CGOpCode::ComGt) c = left > right;
+                else c = left != right;
+
+                result = c ? args[2] : args[3];
+                return true;
+            }
+            default:
+                break;
+        }
+
+        if (args.empty())
+            return false;
+        for (const Arg& a : args) {
+            if (a.getParameter() == nullptr)
+                return false;
+        }
+
+        CGB value;
+        if (!fold(op, args, value))
+            return false;
+
+        CPPADCG_ASSERT_UNKNOWN(value.isParameter())
+        result = Arg(value.getValue());
+        return true;
+    }
+
+    /**
+     * Evaluates an operation with parameter arguments using the same
+     * rules as the CG arithmetic.
+     *
+     * @return false if the operation cannot be folded
+     */
+    static inline bool fold(CGOpCode op,
+                            const std::vector<Arg>& args,
+                            CGB& value) {
+        CGB a(*args[0].getParameter());
+
+        if (args.size() == 1) {
+            switch (op) {
+                case CGOpCode::Abs: value = CppAD::abs(a); return true;
+                case CGOpCode::Acos: value = CppAD::acos(a); return true;
+                case CGOpCode::Asin: value = CppAD::asin(a); return true;
+                case CGOpCode::Atan: value = CppAD::atan(a); return true;
+                case CGOpCode::Cosh: value = CppAD::cosh(a); return true;
+                case CGOpCode::Cos: value = CppAD::cos(a); return true;
+                case CGOpCode::Exp: value = CppAD::exp(a); return true;
+                case CGOpCode::Log: value = CppAD::log(a); return true;
+                case CGOpCode::Sign: value = CppAD::sign(a); return true;
+                case CGOpCode::Sinh: value = CppAD::sinh(a); return true;
+                case CGOpCode::Sin: value = CppAD::sin(a); return true;
+                case CGOpCode::Sqrt: value = CppAD::sqrt(a); return true;
+                case CGOpCode::Tanh: value = CppAD::tanh(a); return true;
+                case CGOpCode::Tan: value = CppAD::tan(a); return true;
+                case CGOpCode::UnMinus: value = -a; return true;
+#if CPPAD_USE_CPLUSPLUS_2011
+                case CGOpCode::Acosh: value = CppAD::acosh(a); return true;
+                case CGOpCode::Asinh: value = CppAD::asinh(a); return true;
+                case CGOpCode::Atanh: value = CppAD::atanh(a); return true;
+                case CGOpCode::Erf: value = CppAD::erf(a); return true;
+                case CGOpCode::Erfc: value = CppAD::erfc(a); return true;
+                case CGOpCode::Expm1: value = CppAD::expm1(a); return true;
+                case CGOpCode::Log1p: value = CppAD::log1p(a); return true;
+#endif
+                default:
+                    return false;
+            }
+
+        } else if (args.size() == 2) {
+            CGB b(*args[1].getParameter());
+
+            switch (op) {
+                case CGOpCode::Add: value = a + b; return true;
+                case CGOpCode::Sub: value = a - b; return true;
+                case CGOpCode::Mul: value = a * b; return true;
+                case CGOpCode::Div: value = a / b; return true;
+                case CGOpCode::Pow: value = CppAD::pow(a, b); return true;
+                default:
+                    return false;
+            }
+        }
+
+        return false;
+    }
+
+};
+
+} // END cg namespace
+} // END CppAD namespace
+
+#endif
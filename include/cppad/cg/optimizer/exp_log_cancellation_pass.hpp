@@ -0,0 +1,82 @@
+#ifndef CPPAD_CG_EXP_LOG_CANCELLATION_PASS_INCLUDED
+#define CPPAD_CG_EXP_LOG_CANCELLATION_PASS_INCLUDED
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2020 Joao Leal
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+
+namespace CppAD {
+namespace cg {
+
+/**
+ * Removes pairs of inverse functions:
+ *  - exp(log(x)) -> x
+ *  - log(exp(x)) -> x
+ *  - expm1(log1p(x)) -> x
+ *  - log1p(expm1(x)) -> x
+ *
+ * The replacements are only equivalent inside the domain of the inner
+ * function and when it does not overflow (e.g. exp(log(x)) is NaN for
+ * negative values of x), therefore this pass is disabled by default.
+ *
+ * @author Joao Leal
+ */
+template<class Base>
+class ExpLogCancellationPass : public GraphRewritePass<Base> {
+public:
+    using Node = OperationNode<Base>;
+    using Arg = Argument<Base>;
+public:
+
+    inline explicit ExpLogCancellationPass(bool enabled = false) :
+        GraphRewritePass<Base>("exp/log cancellation", enabled) {
+    }
+
+protected:
+
+    bool rewrite(CodeHandler<Base>& handler,
+                 Node& node,
+                 Arg& result) override {
+        CGOpCode inner;
+        switch (node.getOperationType()) {
+            case CGOpCode::Exp:
+                inner = CGOpCode::Log;
+                break;
+            case CGOpCode::Log:
+                inner = CGOpCode::Exp;
+                break;
+            case CGOpCode::Expm1:
+                inner = CGOpCode::Log1p;
+                break;
+            case CGOpCode::Log1p:
+                inner = CGOpCode::Expm1;
+                break;
+            default:
+                return false;
+        }
+
+        const std::vector<Arg>& args = node.getArguments();
+        CPPADCG_ASSERT_UNKNOWN(args.size() == 1)
+        if (!this->isOperation(args[0], inner))
+            return false;
+
+        result = args[0].getOperation()->getArguments()[0];
+        return true;
+    }
+
+};
+
+} // END cg namespace
+} // END CppAD namespace
+
+#endif
@@ -0,0 +1,77 @@
+#ifndef CPPAD_CG_GRAPH_OPTIMIZATION_PASS_INCLUDED
+#define CPPAD_CG_GRAPH_OPTIMIZATION_PASS_INCLUDED
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2020 Joao Leal
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+
+namespace CppAD {
+namespace cg {
+
+/**
+ * A transformation of the operation graph used by the dependent variables
+ * of a CodeHandler which is applied by a GraphOptimizer before source code
+ * generation.
+ *
+ * @author Joao Leal
+ */
+template<class Base>
+class GraphOptimizationPass {
+protected:
+    /**
+     * the pass name (used in job reports)
+     */
+    std::string _name;
+    /**
+     * whether or not the pass is applied by the GraphOptimizer
+     */
+    bool _enabled;
+public:
+
+    inline explicit GraphOptimizationPass(std::string name,
+                                          bool enabled = true) :
+        _name(std::move(name)),
+        _enabled(enabled) {
+    }
+
+    inline virtual ~GraphOptimizationPass() = default;
+
+    inline const std::string& getName() const {
+        return _name;
+    }
+
+    inline bool isEnabled() const {
+        return _enabled;
+    }
+
+    inline void setEnabled(bool enabled) {
+        _enabled = enabled;
+    }
+
+    /**
+     * Applies this pass to the operation graph.
+     *
+     * @param handler the code handler which manages the operation nodes
+     * @param dependent the dependent variables (they might be replaced by
+     *                  equivalent variables or parameters)
+     * @return the number of changes to the operation graph
+     */
+    virtual size_t optimize(CodeHandler<Base>& handler,
+                            ArrayView<CG<Base> >& dependent) = 0;
+
+};
+
+} // END cg namespace
+} // END CppAD namespace
+
+#endif
@@ -0,0 +1,188 @@
+#ifndef CPPAD_CG_GRAPH_OPTIMIZER_INCLUDED
+#define CPPAD_CG_GRAPH_OPTIMIZER_INCLUDED
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2020 Joao Leal
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+
+namespace CppAD {
+namespace cg {
+
+/**
+ * An ordered list of optimization passes applied to the operation graph
+ * of a CodeHandler before source code generation
+ * (see CodeHandler::setGraphOptimizer()).
+ * Model libraries use it through ModelCSourceGen::setGraphOptimizer(),
+ * which applies it to the C source code (also used by LLVM model
+ * libraries) and to the bytecode models.
+ * The graph is only modified when CodeHandler::generateCode() is called,
+ * therefore an Evaluator only benefits from the passes if it is used
+ * afterwards with the same graph.
+ *
+ * The enabled passes are applied in order and repeated while they change
+ * the graph (up to a maximum number of iterations).
+ * The execution time of each pass is reported to the JobTimer of the
+ * CodeHandler (if there is one).
+ *
+ * @author Joao Leal
+ */
+template<class Base>
+class GraphOptimizer {
+public:
+    using CGB = CG<Base>;
+protected:
+    /**
+     * the optimization passes (in the order they are applied)
+     */
+    std::vector<std::unique_ptr<GraphOptimizationPass<Base> > > _passes;
+    /**
+     * the maximum number of times the list of passes is applied
+     */
+    size_t _maxIterations;
+public:
+
+    /**
+     * Creates a new optimizer.
+     *
+     * @param defaultPasses whether or not to add the default passes:
+     *                      constant folding, algebraic simplification,
+     *                      power reduction, exp/log cancellation (disabled),
+     *                      and reciprocal division (disabled)
+     */
+    inline explicit GraphOptimizer(bool defaultPasses = true) :
+        _maxIterations(3) {
+        if (defaultPasses) {
+            addPass(std::unique_ptr<GraphOptimizationPass<Base> >(new ConstantFoldingPass<Base>()));
+            addPass(std::unique_ptr<GraphOptimizationPass<Base> >(new AlgebraicSimplificationPass<Base>()));
+            addPass(std::unique_ptr<GraphOptimizationPass<Base> >(new PowerReductionPass<Base>()));
+            addPass(std::unique_ptr<GraphOptimizationPass<Base> >(new ExpLogCancellationPass<Base>()));
+            addPass(std::unique_ptr<GraphOptimizationPass<Base> >(new ReciprocalDivisionPass<Base>()));
+        }
+    }
+
+    GraphOptimizer(const GraphOptimizer&) = delete;
+    GraphOptimizer& operator=(const GraphOptimizer&) = delete;
+
+    inline virtual ~GraphOptimizer() = default;
+
+    /**
+     * Adds a new pass which will be applied after the existing ones.
+     *
+     * @param pass the new pass
+     * @return the added pass
+     */
+    inline GraphOptimizationPass<Base>& addPass(std::unique_ptr<GraphOptimizationPass<Base> > pass) {
+        CPPADCG_ASSERT_KNOWN(pass != nullptr, "Invalid graph optimization pass")
+        if (getPass(pass->getName()) != nullptr) {
+            throw CGException("Another graph optimization pass with the name '", pass->getName(), "' already exists");
+        }
+        _passes.push_back(std::move(pass));
+        return *_passes.back();
+    }
+
+    /**
+     * Provides a pass with a given name.
+     *
+     * @return the pass or nullptr if there is no pass with that name
+     */
+    inline GraphOptimizationPass<Base>* getPass(const std::string& name) const {
+        for (const auto& p : _passes) {
+            if (p->getName() == name)
+                return p.get();
+        }
+        return nullptr;
+    }
+
+    inline const std::vector<std::unique_ptr<GraphOptimizationPass<Base> > >& getPasses() const {
+        return _passes;
+    }
+
+    /**
+     * Enables or disables a pass.
+     *
+     * @param name the pass name
+     * @param enabled whether or not the pass should be applied
+     * @throws CGException if there is no pass with the provided name
+     */
+    inline void setPassEnabled(const std::string& name,
+                               bool enabled) {
+        GraphOptimizationPass<Base>* pass = getPass(name);
+        if (pass == nullptr) {
+            throw CGException("There is no graph optimization pass with the name '", name, "'");
+        }
+        pass->setEnabled(enabled);
+    }
+
+    inline size_t getMaxIterations() const {
+        return _maxIterations;
+    }
+
+    /**
+     * Defines the maximum number of times the list of passes is applied
+     * (passes are only repeated while they change the graph).
+     */
+    inline void setMaxIterations(size_t maxIterations) {
+        _maxIterations = maxIterations;
+    }
+
+    /**
+     * Applies the enabled passes to the operation graph.
+     *
+     * @param handler the code handler which manages the operation nodes
+     * @param dependent the dependent variables (they might be replaced by
+     *                  equivalent variables or parameters)
+     * @return the total number of changes to the operation graph
+     */
+    virtual size_t optimize(CodeHandler<Base>& handler,
+                            ArrayView<CGB>& dependent) {
+        JobTimer* timer = handler.getJobTimer();
+        size_t total = 0;
+
+        for (size_t it = 0; it < _maxIterations; ++it) {
+            size_t changes = 0;
+
+            for (const auto& pass : _passes) {
+                if (!pass->isEnabled())
+                    continue;
+
+                if (timer != nullptr) {
+                    timer->startingJob("'" + pass->getName() + "'", JobTypeHolder<>::GRAPH_OPTIMIZATION);
+                }
+
+                changes += pass->optimize(handler, dependent);
+
+                if (timer != nullptr) {
+                    timer->finishedJob();
+                }
+            }
+
+            total += changes;
+            if (changes == 0)
+                break;
+        }
+
+        return total;
+    }
+
+    inline size_t optimize(CodeHandler<Base>& handler,
+                           std::vector<CGB>& dependent) {
+        ArrayView<CGB> deps(dependent);
+        return optimize(handler, deps);
+    }
+
+};
+
+} // END cg namespace
+} // END CppAD namespace
+
+#endif
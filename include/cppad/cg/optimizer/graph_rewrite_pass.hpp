@@ -0,0 +1,174 @@
+#ifndef CPPAD_CG_GRAPH_REWRITE_PASS_INCLUDED
+#define CPPAD_CG_GRAPH_REWRITE_PASS_INCLUDED
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2020 Joao Leal
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+
+namespace CppAD {
+namespace cg {
+
+/**
+ * An optimization pass which replaces individual operation nodes by
+ * equivalent expressions.
+ *
+ * The graph is visited depth first, so the arguments of a node have
+ * already been replaced when rewrite() is called for that node (e.g. the
+ * result of a folded constant is used by the following operations).
+ * The replaced nodes are not modified, only the nodes that use them.
+ * Parameters are only used directly as arguments of arithmetic operations
+ * and mathematical functions.
+ * Nodes with a name are never replaced.
+ * Only the arguments and dependents which are actually replaced are
+ * reported as changes (so that the optimizer can reach a fixed point).
+ *
+ * @author Joao Leal
+ */
+template<class Base>
+class GraphRewritePass : public GraphOptimizationPass<Base> {
+public:
+    using CGB = CG<Base>;
+    using Node = OperationNode<Base>;
+    using Arg = Argument<Base>;
+public:
+
+    inline explicit GraphRewritePass(std::string name,
+                                     bool enabled = true) :
+        GraphOptimizationPass<Base>(std::move(name), enabled) {
+    }
+
+    size_t optimize(CodeHandler<Base>& handler,
+                    ArrayView<CGB>& dependent) override {
+        const size_t nNodes = handler.getManagedNodesCount();
+        std::vector<Arg> replacement(nNodes);
+        size_t changes = 0;
+
+        // new nodes are never replaced
+        auto find = [&](const Node* n) -> const Arg* {
+            size_t p = n->getHandlerPosition();
+            if (p < nNodes && isDefined(replacement[p]))
+                return &replacement[p];
+            return nullptr;
+        };
+
+        auto startAnalysis = [&handler](OperationStackData<Base>& stackEl,
+                                        OperationStack<Base>& stack) {
+            Node& node = stackEl.node();
+            if (handler.isVisited(node))
+                return false;
+
+            handler.markVisited(node);
+            stack.pushNodeArguments(node, 0);
+            return true;
+        };
+
+        auto endAnalysis = [&](OperationStackData<Base>& stackEl) {
+            Node& node = stackEl.node();
+            size_t pos = node.getHandlerPosition();
+            if (pos >= nNodes)
+                return; // not managed by this handler
+
+            // all arguments have already been processed
+            bool parameters = CodeHandler<Base>::isHashConsingCandidate(node.getOperationType());
+            for (Arg& a : node.getArguments()) {
+                Node* arg = a.getOperation();
+                if (arg != nullptr) {
+                    const Arg* rep = find(arg);
+                    if (rep != nullptr && (parameters || rep->getOperation() != nullptr)) {
+                        a = *rep;
+                        changes++;
+                    }
+                }
+            }
+
+            if (node.getName() != nullptr)
+                return;
+
+            Arg result;
+            if (rewrite(handler, node, result)) {
+                CPPADCG_ASSERT_UNKNOWN(isDefined(result))
+                CPPADCG_ASSERT_UNKNOWN(result.getOperation() != &node)
+                replacement[pos] = std::move(result);
+            }
+        };
+
+        handler.startNewOperationTreeVisit();
+
+        for (size_t i = 0; i < dependent.size(); ++i) {
+            Node* node = dependent[i].getOperationNode();
+            if (node != nullptr && !handler.isVisited(*node)) {
+                depthFirstGraphNavigation(*node,
+                                          0,
+                                          startAnalysis,
+                                          endAnalysis,
+                                          true);
+            }
+        }
+
+        /**
+         * dependents which were replaced
+         */
+        for (size_t i = 0; i < dependent.size(); ++i) {
+            Node* node = dependent[i].getOperationNode();
+            if (node == nullptr)
+                continue;
+
+            const Arg* rep = find(node);
+            if (rep != nullptr) {
+                CGB dep = rep->getOperation() != nullptr ? CGB(*rep->getOperation()) : CGB(*rep->getParameter());
+                if (dependent[i].isValueDefined() && rep->getOperation() != nullptr)
+                    dep.setValue(dependent[i].getValue());
+                dependent[i] = dep;
+                changes++;
+            }
+        }
+
+        return changes;
+    }
+
+protected:
+
+    /**
+     * Determines an equivalent expression for an operation node.
+     *
+     * @param handler the code handler which manages the node (it can be
+     *                used to create new nodes)
+     * @param node the node to be replaced (its arguments were already
+     *             rewritten)
+     * @param result the replacement for the node (a node or a parameter)
+     * @return true if the node should be replaced by result
+     */
+    virtual bool rewrite(CodeHandler<Base>& handler,
+                         Node& node,
+                         Arg& result) = 0;
+
+    static inline bool isDefined(const Arg& arg) {
+        return arg.getOperation() != nullptr || arg.getParameter() != nullptr;
+    }
+
+    static inline bool isParameter(const Arg& arg,
+                                   const Base& value) {
+        return arg.getParameter() != nullptr && *arg.getParameter() == value;
+    }
+
+    static inline bool isOperation(const Arg& arg,
+                                   CGOpCode op) {
+        return arg.getOperation() != nullptr && arg.getOperation()->getOperationType() == op;
+    }
+
+};
+
+} // END cg namespace
+} // END CppAD namespace
+
+#endif
@@ -0,0 +1,125 @@
+#ifndef CPPAD_CG_POWER_REDUCTION_PASS_INCLUDED
+#define CPPAD_CG_POWER_REDUCTION_PASS_INCLUDED
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2020 Joao Leal
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+
+namespace CppAD {
+namespace cg {
+
+/**
+ * Replaces powers with a small integer exponent by multiplications
+ * (strength reduction):
+ *  - pow(x, 0) -> 1
+ *  - pow(x, 1) -> x
+ *  - pow(x, 2) -> x * x
+ *  - pow(x, k) -> products of x determined by exponentiation by squaring
+ *  - pow(x, -k) -> 1 / pow(x, k)
+ *
+ * The results for exponents larger than 2 might differ from pow() in the
+ * last bits.
+ *
+ * @author Joao Leal
+ */
+template<class Base>
+class PowerReductionPass : public GraphRewritePass<Base> {
+public:
+    using Node = OperationNode<Base>;
+    using Arg = Argument<Base>;
+protected:
+    /**
+     * the largest absolute value of the exponents which are replaced
+     */
+    size_t _maxExponent;
+public:
+
+    inline explicit PowerReductionPass(size_t maxExponent = 8) :
+        GraphRewritePass<Base>("power reduction"),
+        _maxExponent(maxExponent) {
+    }
+
+    inline size_t getMaxExponent() const {
+        return _maxExponent;
+    }
+
+    /**
+     * Defines the largest absolute value of the integer exponents which
+     * are replaced by multiplications.
+     */
+    inline void setMaxExponent(size_t maxExponent) {
+        _maxExponent = maxExponent;
+    }
+
+protected:
+
+    bool rewrite(CodeHandler<Base>& handler,
+                 Node& node,
+                 Arg& result) override {
+        if (node.getOperationType() != CGOpCode::Pow)
+            return false;
+
+        const std::vector<Arg>& args = node.getArguments();
+        CPPADCG_ASSERT_UNKNOWN(args.size() == 2)
+        if (args[0].getOperation() == nullptr || args[1].getParameter() == nullptr)
+            return false;
+
+        const Base& exponent = *args[1].getParameter();
+        const Base maxExponent(double(_maxExponent));
+        if (!(exponent <= maxExponent && exponent >= -maxExponent))
+            return false; // also excludes NaN
+
+        int k = CppAD::Integer(exponent);
+        if (Base(k) != exponent)
+            return false;
+
+        size_t absK = size_t(k < 0 ? -k : k);
+
+        if (absK == 0) {
+            result = Arg(Base(1.0)); // pow(x, 0) is 1 even for infinity and NaN
+            return true;
+        }
+
+        // exponentiation by squaring
+        Arg power;
+        Arg square = args[0];
+        bool first = true;
+        while (absK > 0) {
+            if (absK & 1u) {
+                if (first) {
+                    power = square;
+                    first = false;
+                } else {
+                    power = *handler.makeNode(CGOpCode::Mul, {power, square});
+                }
+            }
+            absK >>= 1u;
+            if (absK > 0) {
+                square = *handler.makeNode(CGOpCode::Mul, {square, square});
+            }
+        }
+
+        if (k < 0) {
+            result = *handler.makeNode(CGOpCode::Div, {Arg(Base(1.0)), power});
+        } else {
+            result = power;
+        }
+        return true;
+    }
+
+};
+
+} // END cg namespace
+} // END CppAD namespace
+
+#endif
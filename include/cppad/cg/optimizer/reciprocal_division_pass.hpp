@@ -0,0 +1,149 @@
+#ifndef CPPAD_CG_RECIPROCAL_DIVISION_PASS_INCLUDED
+#define CPPAD_CG_RECIPROCAL_DIVISION_PASS_INCLUDED
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2020 Joao Leal
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+
+namespace CppAD {
+namespace cg {
+
+/**
+ * Replaces divisions by multiplications with a reciprocal:
+ *  - x / c -> x * (1 / c) for a parameter c
+ *  - x1 / y, x2 / y, ... -> r = 1 / y; x1 * r, x2 * r, ... when the same
+ *    variable y is the denominator of several divisions
+ *
+ * The results might differ from the divisions in the last bits,
+ * therefore this pass is disabled by default.
+ *
+ * @author Joao Leal
+ */
+template<class Base>
+class ReciprocalDivisionPass : public GraphRewritePass<Base> {
+public:
+    using CGB = CG<Base>;
+    using Node = OperationNode<Base>;
+    using Arg = Argument<Base>;
+protected:
+    /**
+     * the number of divisions which use each node as the denominator
+     */
+    std::vector<size_t> _divisions;
+    /**
+     * the reciprocal of each denominator (created when needed)
+     */
+    std::map<Node*, Node*> _reciprocals;
+public:
+
+    inline explicit ReciprocalDivisionPass(bool enabled = false) :
+        GraphRewritePass<Base>("reciprocal division", enabled) {
+    }
+
+    size_t optimize(CodeHandler<Base>& handler,
+                    ArrayView<CGB>& dependent) override {
+        countDivisions(handler, dependent);
+
+        size_t changes = GraphRewritePass<Base>::optimize(handler, dependent);
+
+        _divisions.clear();
+        _reciprocals.clear();
+
+        return changes;
+    }
+
+protected:
+
+    bool rewrite(CodeHandler<Base>& handler,
+                 Node& node,
+                 Arg& result) override {
+        if (node.getOperationType() != CGOpCode::Div)
+            return false;
+
+        const std::vector<Arg>& args = node.getArguments();
+        CPPADCG_ASSERT_UNKNOWN(args.size() == 2)
+        if (this->isParameter(args[0], Base(1.0)))
+            return false; // already a reciprocal
+
+        if (args[1].getParameter() != nullptr) {
+            const Base& denominator = *args[1].getParameter();
+            if (denominator == Base(0.0) || args[0].getOperation() == nullptr)
+                return false;
+
+            result = *handler.makeNode(CGOpCode::Mul, {args[0], Arg(Base(1.0) / denominator)});
+            return true;
+        }
+
+        Node* denominator = args[1].getOperation();
+        size_t p = denominator->getHandlerPosition();
+        if (p >= _divisions.size() || _divisions[p] < 2)
+            return false;
+
+        Node*& reciprocal = _reciprocals[denominator];
+        if (reciprocal == nullptr) {
+            reciprocal = handler.makeNode(CGOpCode::Div, {Arg(Base(1.0)), args[1]});
+        }
+
+        result = *handler.makeNode(CGOpCode::Mul, {args[0], *reciprocal});
+        return true;
+    }
+
+    inline void countDivisions(CodeHandler<Base>& handler,
+                               ArrayView<CGB>& dependent) {
+        _divisions.assign(handler.getManagedNodesCount(), 0);
+        _reciprocals.clear();
+
+        auto startAnalysis = [&](OperationStackData<Base>& stackEl,
+                                 OperationStack<Base>& stack) {
+            Node& node = stackEl.node();
+            if (handler.isVisited(node))
+                return false;
+
+            handler.markVisited(node);
+
+            if (node.getOperationType() == CGOpCode::Div && node.getName() == nullptr) {
+                const std::vector<Arg>& args = node.getArguments();
+                if (args[1].getOperation() != nullptr && !this->isParameter(args[0], Base(1.0))) {
+                    size_t p = args[1].getOperation()->getHandlerPosition();
+                    if (p < _divisions.size())
+                        _divisions[p]++;
+                }
+            }
+
+            stack.pushNodeArguments(node, 0);
+            return true;
+        };
+
+        auto endAnalysis = [](OperationStackData<Base>& stackEl) {
+        };
+
+        handler.startNewOperationTreeVisit();
+
+        for (size_t i = 0; i < dependent.size(); ++i) {
+            Node* node = dependent[i].getOperationNode();
+            if (node != nullptr && !handler.isVisited(*node)) {
+                depthFirstGraphNavigation(*node,
+                                          0,
+                                          startAnalysis,
+                                          endAnalysis,
+                                          true);
+            }
+        }
+    }
+
+};
+
+} // END cg namespace
+} // END CppAD namespace
+
+#endif
@@ -99,6 +99,8 @@ private:
     CodeHandlerVector<Base, size_t> origShareNodeId_;
     /// used to mark visited nodes and indexed nodes
     size_t color_;
+    /// the maximum number of threads used to determine the equation patterns
+    size_t maxThreads_;
 public:
 
     /**
@@ -121,13 +123,89 @@ public:
         independents_(independents),
         idCounter_(0),
         origShareNodeId_(*handler_),
-        color_(0) {
+        color_(0),
+        maxThreads_(1) {
         CPPADCG_ASSERT_UNKNOWN(independents_.size() > 0)
         CPPADCG_ASSERT_UNKNOWN(independents_[0].getCodeHandler() != nullptr)
         equations_.reserve(relatedDepCandidates_.size());
         origShareNodeId_.adjustSize();
     }
 
+    /**
+     * Provides the maximum number of threads used to determine the
+     * equation patterns.
+     */
+    inline size_t getMaxThreads() const {
+        return maxThreads_;
+    }
+
+    /**
+     * Defines the maximum number of threads used to determine the
+     * equation patterns of the groups of related dependents (each
+     * group is processed by a single thread).
+     *
+     * @param maxThreads the maximum number of threads (0 uses the number
+     *                   of hardware threads)
+     */
+    inline void setMaxThreads(size_t maxThreads) {
+        maxThreads_ = maxThreads == 0 ? std::max<size_t>(std::thread::hardware_concurrency(), 1) : maxThreads;
+    }
+
+    /**
+     * Proposes groups of dependents which might share the same expression
+     * pattern (candidates for DependentPatternMatcher) by comparing the
+     * structure of their expressions.
+     * Dependents in the same group are not guaranteed to have the same
+     * pattern, e.g. they can use independent variables which cannot be
+     * indexed.
+     *
+     * @param dependents The dependent variable values
+     * @param minGroupSize the minimum number of dependents in a group
+     * @return groups of related dependent indexes sorted by their first
+     *         dependent
+     */
+    static std::vector<std::set<size_t> > findRelatedDependentCandidates(const std::vector<CGBase>& dependents,
+                                                                         size_t minGroupSize = 2) {
+        CodeHandler<Base>* handler = nullptr;
+        for (const CGBase& dep : dependents) {
+            if (dep.isVariable()) {
+                handler = dep.getCodeHandler();
+                break;
+            }
+        }
+        if (handler == nullptr)
+            return std::vector<std::set<size_t> >(); // only parameters
+
+        CodeHandlerVector<Base, size_t> nodeFingerprint(*handler);
+        CodeHandlerVector<Base, bool> evaluated(*handler);
+        nodeFingerprint.adjustSize();
+        evaluated.adjustSize();
+        evaluated.fill(false);
+
+        std::map<size_t, std::set<size_t> > fingerprint2Deps;
+        for (size_t i = 0; i < dependents.size(); ++i) {
+            if (dependents[i].isVariable()) {
+                size_t f = createFingerprint(*dependents[i].getOperationNode(), nodeFingerprint, evaluated);
+                fingerprint2Deps[f].insert(i);
+            }
+        }
+
+        std::map<size_t, std::set<size_t> > first2Group;
+        for (auto& it : fingerprint2Deps) {
+            if (it.second.size() >= std::max<size_t>(minGroupSize, 2)) {
+                size_t first = *it.second.begin();
+                first2Group[first].swap(it.second);
+            }
+        }
+
+        std::vector<std::set<size_t> > groups;
+        groups.reserve(first2Group.size());
+        for (auto& it : first2Group) {
+            groups.push_back(std::move(it.second));
+        }
+        return groups;
+    }
+
     const std::vector<EquationPattern<Base>*>& getEquationPatterns() const {
         return equations_;
     }
@@ -785,55 +863,84 @@ private:
 
     std::vector<EquationPattern<Base>*> findRelatedVariables() {
         eqCurr_ = nullptr;
-        CodeHandlerVector<Base, size_t> varColor(*handler_);
-        color_ = 1; // used to mark visited nodes
 
-        varColor.adjustSize();
-        varColor.fill(0);
+        const size_t rSize = relatedDepCandidates_.size();
 
-        size_t rSize = relatedDepCandidates_.size();
-        for (size_t r = 0; r < rSize; r++) {
-            const std::set<size_t>& candidates = relatedDepCandidates_[r];
-            std::set<size_t> used;
+        /**
+         * dependents can only have the same pattern if they have the same
+         * fingerprint
+         */
+        std::vector<size_t> fingerprints = createFingerprints();
 
-            eqCurr_ = nullptr;
+        std::vector<std::vector<EquationPattern<Base>*> > groupEquations(rSize);
 
-            std::set<size_t>::const_iterator itRef;
-            for (itRef = candidates.begin(); itRef != candidates.end(); ++itRef) {
-                size_t iDepRef = *itRef;
+        size_t nThreads = std::min(maxThreads_, rSize);
 
-                // check if it has already been used
-                if (used.find(iDepRef) != used.end()) {
-                    continue;
-                }
+        if (nThreads <= 1) {
+            CodeHandlerVector<Base, size_t> varColor(*handler_);
+            varColor.adjustSize();
+            varColor.fill(0);
+            color_ = 1; // used to mark visited nodes
 
-                if (eqCurr_ == nullptr || !used.empty()) {
-                    eqCurr_ = new EquationPattern<Base>(dependents_[iDepRef], iDepRef);
-                    equations_.push_back(eqCurr_);
-                }
+            for (size_t r = 0; r < rSize; r++) {
+                findEquationPatterns(relatedDepCandidates_[r], fingerprints, varColor, color_, groupEquations[r]);
+            }
 
-                auto it = itRef;
-                for (++it; it != candidates.end(); ++it) {
-                    size_t iDep = *it;
-                    // check if it has already been used
-                    if (used.find(iDep) != used.end()) {
-                        continue;
-                    }
+        } else {
+            /**
+             * groups are independent: each thread uses its own node colors
+             * (created here since the code handler is not thread safe)
+             */
+            std::vector<CodeHandlerVector<Base, size_t> > varColors(nThreads, CodeHandlerVector<Base, size_t>(*handler_));
+            for (CodeHandlerVector<Base, size_t>& varColor : varColors) {
+                varColor.adjustSize();
+                varColor.fill(0);
+            }
 
-                    if (eqCurr_->testAdd(iDep, dependents_[iDep], color_, varColor)) {
-                        used.insert(iDep);
+            std::atomic<size_t> next(0);
+            std::mutex mutex;
+            std::exception_ptr error;
+
+            auto worker = [&](size_t t) {
+                try {
+                    size_t color = 1; // used to mark visited nodes
+                    while (true) {
+                        size_t r = next++;
+                        if (r >= rSize)
+                            break;
+                        findEquationPatterns(relatedDepCandidates_[r], fingerprints, varColors[t], color, groupEquations[r]);
                     }
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (error == nullptr)
+                        error = std::current_exception();
+                    next = rSize;
                 }
+            };
 
-                if (eqCurr_->dependents.size() == 1) {
-                    // nothing found :(
-                    delete eqCurr_;
-                    eqCurr_ = nullptr;
-                    equations_.pop_back();
+            std::vector<std::thread> threads;
+            threads.reserve(nThreads);
+            for (size_t t = 0; t < nThreads; ++t) {
+                threads.emplace_back(worker, t);
+            }
+            for (std::thread& t : threads) {
+                t.join();
+            }
+
+            if (error != nullptr) {
+                for (auto& eqs : groupEquations) {
+                    for (EquationPattern<Base>* eq : eqs)
+                        delete eq;
                 }
+                std::rethrow_exception(error);
             }
         }
 
+        // same order as a sequential search
+        for (auto& eqs : groupEquations) {
+            equations_.insert(equations_.end(), eqs.begin(), eqs.end());
+        }
+
         /**
          * Determine the independents that don't change from iteration to
          * iteration
@@ -845,6 +952,142 @@ private:
         return equations_;
     }
 
+    /**
+     * Determines the equation patterns in a group of dependents which are
+     * believed to have the same expression pattern.
+     * Only dependents with the same fingerprint are compared.
+     *
+     * @param candidates the dependent indexes in the group
+     * @param fingerprints the structural fingerprint of each dependent
+     * @param varColor used to mark visited nodes
+     * @param color the first color which can be used to mark nodes
+     * @param equations the equation patterns found (output)
+     */
+    void findEquationPatterns(const std::set<size_t>& candidates,
+                              const std::vector<size_t>& fingerprints,
+                              CodeHandlerVector<Base, size_t>& varColor,
+                              size_t& color,
+                              std::vector<EquationPattern<Base>*>& equations) const {
+        // dependents with the same fingerprint (in the original order)
+        std::map<size_t, std::vector<size_t> > buckets;
+        std::vector<size_t> bucketPos;
+        bucketPos.reserve(candidates.size());
+        for (size_t iDep : candidates) {
+            std::vector<size_t>& bucket = buckets[fingerprints[iDep]];
+            bucketPos.push_back(bucket.size());
+            bucket.push_back(iDep);
+        }
+
+        std::set<size_t> used;
+
+        size_t c = 0;
+        for (auto itRef = candidates.begin(); itRef != candidates.end(); ++itRef, ++c) {
+            size_t iDepRef = *itRef;
+
+            // check if it has already been used
+            if (used.find(iDepRef) != used.end()) {
+                continue;
+            }
+
+            const std::vector<size_t>& bucket = buckets.at(fingerprints[iDepRef]);
+            if (bucket.size() - bucketPos[c] == 1) {
+                continue; // nothing to compare with
+            }
+
+            std::unique_ptr<EquationPattern<Base> > eq(new EquationPattern<Base>(dependents_[iDepRef], iDepRef));
+
+            for (size_t b = bucketPos[c] + 1; b < bucket.size(); ++b) {
+                size_t iDep = bucket[b];
+                // check if it has already been used
+                if (used.find(iDep) != used.end()) {
+                    continue;
+                }
+
+                if (eq->testAdd(iDep, dependents_[iDep], color, varColor)) {
+                    used.insert(iDep);
+                }
+            }
+
+            if (eq->dependents.size() > 1) {
+                equations.push_back(eq.release());
+            } // else nothing found :(
+        }
+    }
+
+    /**
+     * Determines a structural fingerprint for each dependent.
+     * Dependents with the same expression pattern (see EquationPattern)
+     * always have the same fingerprint.
+     *
+     * @return the fingerprint of each dependent
+     */
+    std::vector<size_t> createFingerprints() {
+        CodeHandlerVector<Base, size_t> nodeFingerprint(*handler_);
+        CodeHandlerVector<Base, bool> evaluated(*handler_);
+        nodeFingerprint.adjustSize();
+        evaluated.adjustSize();
+        evaluated.fill(false);
+
+        std::vector<size_t> fingerprints(dependents_.size(), 0);
+        for (const std::set<size_t>& candidates : relatedDepCandidates_) {
+            for (size_t iDep : candidates) {
+                const CGBase& dep = dependents_[iDep];
+                if (dep.isVariable()) {
+                    fingerprints[iDep] = createFingerprint(*dep.getOperationNode(), nodeFingerprint, evaluated);
+                } else {
+                    fingerprints[iDep] = 1; // parameter
+                }
+            }
+        }
+
+        return fingerprints;
+    }
+
+    static inline size_t combineFingerprint(size_t seed,
+                                            size_t value) {
+        return seed ^ (value + 0x9e3779b9 + (seed << 6) + (seed >> 2));
+    }
+
+    static size_t createFingerprint(OperationNode<Base>& node,
+                                    CodeHandlerVector<Base, size_t>& nodeFingerprint,
+                                    CodeHandlerVector<Base, bool>& evaluated) {
+        // aliases are ignored by EquationPattern unless they are used to identify indexed independents
+        OperationNode<Base>* n = &node;
+        while (n->getOperationType() == CGOpCode::Alias) {
+            OperationNode<Base>* arg = n->getArguments()[0].getOperation();
+            if (arg == nullptr || arg->getOperationType() == CGOpCode::Inv)
+                break;
+            n = arg;
+        }
+
+        if (evaluated[*n])
+            return nodeFingerprint[*n];
+
+        size_t f = combineFingerprint(2, size_t(n->getOperationType()));
+
+        for (size_t i : n->getInfo()) {
+            f = combineFingerprint(f, i);
+        }
+
+        const std::vector<Argument<Base> >& args = n->getArguments();
+        f = combineFingerprint(f, args.size());
+        for (const Argument<Base>& a : args) {
+            OperationNode<Base>* argOp = a.getOperation();
+            if (argOp == nullptr) {
+                f = combineFingerprint(f, 3); // parameter (values are not considered)
+            } else if (argOp->getOperationType() == CGOpCode::Inv) {
+                f = combineFingerprint(f, 4); // the independent can change between iterations
+            } else {
+                f = combineFingerprint(f, createFingerprint(*argOp, nodeFingerprint, evaluated));
+            }
+        }
+
+        evaluated[*n] = true;
+        nodeFingerprint[*n] = f;
+
+        return f;
+    }
+
     /**
      * Finds nodes which can be shared with other equation patterns
      *
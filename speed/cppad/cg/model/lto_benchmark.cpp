@@ -0,0 +1,170 @@
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2020 Joao Leal
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+
+#include "model_benchmark.hpp"
+
+using namespace CppAD;
+using namespace CppAD::cg;
+using namespace std;
+
+namespace {
+
+using CGD = CG<double>;
+using ADCG = AD<CGD>;
+
+void printUsage(const char* program) {
+    cerr << "Usage: " << program << " [options]\n"
+            "\n"
+            "Compares the speed of the sparse Jacobian of a model library compiled\n"
+            "one file at a time against the same library compiled with link-time\n"
+            "optimization (functions from different source files can be inlined).\n"
+            "\n"
+            "Options:\n"
+            "  --size <n>         number of independent variables (default: 200)\n"
+            "  --assign <n>       maximum number of assignments per source file\n"
+            "                     (default: 50)\n"
+            "  --compiler <path>  path to gcc or clang (default: /usr/bin/gcc)\n"
+            "  --repeat <n>       number of timed samples (default: 100)\n";
+}
+
+size_t parseSize(const char* arg) {
+    char* end;
+    unsigned long v = std::strtoul(arg, &end, 10);
+    if (*end != '\0') {
+        throw CGException("Invalid number '", arg, "'");
+    }
+    return v;
+}
+
+/**
+ * A chain of equations where each equation depends on 3 consecutive
+ * variables
+ */
+unique_ptr<ADFun<CGD>> tapeModel(size_t n) {
+    vector<ADCG> x(n, 1.0);
+    CppAD::Independent(x);
+
+    vector<ADCG> y(n - 2);
+    for (size_t i = 0; i < n - 2; ++i) {
+        y[i] = sin(x[i]) * x[i + 1] + exp(0.1 * x[i + 2]) * x[i] * x[i] - x[i + 1] / (1.0 + x[i + 2] * x[i + 2]);
+    }
+
+    return unique_ptr<ADFun<CGD>>(new ADFun<CGD>(x, y));
+}
+
+ModelBenchmark::ModelRun runBenchmark(ADFun<CGD>& fun,
+                                      ModelBenchmark& benchmark,
+                                      const string& compilerPath,
+                                      size_t maxAssignPerFunc,
+                                      bool lto) {
+    const string name = lto ? "lto" : "per_file";
+
+    ModelCSourceGen<double> compHelp(fun, name);
+    compHelp.setCreateForwardZero(false);
+    compHelp.setCreateForwardOne(true);
+    compHelp.setCreateReverseOne(true);
+    compHelp.setCreateSparseJacobian(true);
+    compHelp.setMaxAssignmentsPerFunc(maxAssignPerFunc);
+
+    ModelLibraryCSourceGen<double> compDynHelp(compHelp);
+
+    unique_ptr<AbstractCCompiler<double>> compiler;
+    if (compilerPath.find("clang") != string::npos) {
+        compiler.reset(new ClangCompiler<double>(compilerPath));
+    } else {
+        compiler.reset(new GccCompiler<double>(compilerPath));
+    }
+    compiler->setLinkTimeOptimization(lto);
+    compiler->setTemporaryFolder("cppadcg_tmp_" + name);
+
+    DynamicModelLibraryProcessor<double> p(compDynHelp, "cppadcg_lto_benchmark_" + name);
+    unique_ptr<DynamicLib<double>> dynamicLib = p.createDynamicLibrary(*compiler);
+    unique_ptr<GenericModel<double>> model = dynamicLib->model(name);
+
+    ModelBenchmark::ModelRun run;
+    run.name = name;
+    run.n = model->Domain();
+    run.m = model->Range();
+    run.results = benchmark.run(*model);
+
+    return run;
+}
+
+const ModelBenchmark::Result& findSparseJacobian(const ModelBenchmark::ModelRun& run) {
+    for (const ModelBenchmark::Result& r : run.results) {
+        if (r.function == "sparse_jacobian")
+            return r;
+    }
+    throw CGException("No sparse Jacobian in '", run.name, "'");
+}
+
+} // END namespace
+
+int main(int argc, char** argv) {
+    try {
+        size_t n = 200;
+        size_t maxAssignPerFunc = 50;
+        string compilerPath = "/usr/bin/gcc";
+
+        ModelBenchmark benchmark;
+
+        for (int i = 1; i < argc; ++i) {
+            string arg = argv[i];
+            if (i + 1 >= argc) {
+                printUsage(argv[0]);
+                return 1;
+            }
+
+            if (arg == "--size") {
+                n = parseSize(argv[++i]);
+            } else if (arg == "--assign") {
+                maxAssignPerFunc = parseSize(argv[++i]);
+            } else if (arg == "--compiler") {
+                compilerPath = argv[++i];
+            } else if (arg == "--repeat") {
+                benchmark.setRepetitions(parseSize(argv[++i]));
+            } else {
+                printUsage(argv[0]);
+                return 1;
+            }
+        }
+
+        if (n < 3) {
+            throw CGException("The model requires at least 3 independent variables");
+        }
+
+        unique_ptr<ADFun<CGD>> fun = tapeModel(n);
+
+        ModelBenchmark::ModelRun perFile = runBenchmark(*fun, benchmark, compilerPath, maxAssignPerFunc, false);
+        ModelBenchmark::printTable(cout, perFile);
+
+        ModelBenchmark::ModelRun lto = runBenchmark(*fun, benchmark, compilerPath, maxAssignPerFunc, true);
+        ModelBenchmark::printTable(cout, lto);
+
+        const ModelBenchmark::Result& jacPerFile = findSparseJacobian(perFile);
+        const ModelBenchmark::Result& jacLto = findSparseJacobian(lto);
+
+        cout << "\nsparse Jacobian (nnz=" << jacLto.nnz << ")\n"
+             << "  per file: " << jacPerFile.median << " ns\n"
+             << "  LTO:      " << jacLto.median << " ns\n"
+             << "  speedup:  " << (jacPerFile.median / jacLto.median) << std::endl;
+
+    } catch (const CGException& e) {
+        cerr << e.what() << endl;
+        return 1;
+    }
+
+    return 0;
+}
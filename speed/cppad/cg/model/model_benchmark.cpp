@@ -0,0 +1,148 @@
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2020 Joao Leal
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+
+#include <fstream>
+
+#include "model_benchmark.hpp"
+
+using namespace CppAD;
+using namespace CppAD::cg;
+using namespace std;
+
+namespace {
+
+void printUsage(const char* program) {
+    cerr << "Usage: " << program << " <library> [options] [model ...]\n"
+            "\n"
+            "Measures the execution time of the functions of the models in a compiled\n"
+            "model library (all models are used if none is specified).\n"
+            "\n"
+            "Options:\n"
+            "  --warmup <n>       number of calls which are not timed (default: 10)\n"
+            "  --repeat <n>       number of timed samples (default: 100)\n"
+            "  --min-sample <ns>  minimum duration of each sample (default: 10000)\n"
+            "  --seed <n>         seed for the values of the independent variables\n"
+            "  --threads <n>      number of threads used by the library thread pool\n"
+            "                     (0 disables the thread pool)\n"
+            "  --tag <label>      label saved in the JSON output (e.g. compiler flags)\n"
+            "  --output <file>    JSON output file (default: standard output)\n";
+}
+
+size_t parseSize(const char* arg) {
+    char* end;
+    unsigned long v = std::strtoul(arg, &end, 10);
+    if (*end != '\0') {
+        throw CGException("Invalid number '", arg, "'");
+    }
+    return v;
+}
+
+} // END namespace
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    try {
+        string library = argv[1];
+        string tag;
+        string output;
+        vector<string> names;
+        int threads = -1;
+
+        ModelBenchmark benchmark;
+
+        for (int i = 2; i < argc; ++i) {
+            string arg = argv[i];
+            if (arg[0] == '-' && i + 1 >= argc) {
+                printUsage(argv[0]);
+                return 1;
+            }
+
+            if (arg == "--warmup") {
+                benchmark.setWarmup(parseSize(argv[++i]));
+            } else if (arg == "--repeat") {
+                benchmark.setRepetitions(parseSize(argv[++i]));
+            } else if (arg == "--min-sample") {
+                benchmark.setMinSampleTime(double(parseSize(argv[++i])));
+            } else if (arg == "--seed") {
+                benchmark.setSeed((unsigned int) parseSize(argv[++i]));
+            } else if (arg == "--threads") {
+                threads = int(parseSize(argv[++i]));
+            } else if (arg == "--tag") {
+                tag = argv[++i];
+            } else if (arg == "--output") {
+                output = argv[++i];
+            } else if (arg[0] == '-') {
+                printUsage(argv[0]);
+                return 1;
+            } else {
+                names.push_back(arg);
+            }
+        }
+
+        LinuxDynamicLib<double> dynamicLib(library);
+
+        if (threads == 0) {
+            dynamicLib.setThreadPoolDisabled(true);
+        } else if (threads > 0) {
+            dynamicLib.setThreadNumber(threads);
+        }
+
+        if (names.empty()) {
+            set<string> all = dynamicLib.getModelNames();
+            names.assign(all.begin(), all.end());
+        }
+
+        vector<ModelBenchmark::ModelRun> runs;
+        for (const string& name : names) {
+            unique_ptr<GenericModel<double>> model = dynamicLib.model(name);
+            if (model == nullptr) {
+                throw CGException("Model '", name, "' not found in '", library, "'");
+            }
+            if (!model->getAtomicFunctionNames().empty()) {
+                cerr << "Skipping model '" << name << "' since it requires atomic functions" << endl;
+                continue;
+            }
+
+            ModelBenchmark::ModelRun run;
+            run.name = name;
+            run.n = model->Domain();
+            run.m = model->Range();
+            run.results = benchmark.run(*model);
+
+            ModelBenchmark::printTable(cerr, run);
+            runs.push_back(std::move(run));
+        }
+
+        if (output.empty()) {
+            benchmark.printJSON(cout, runs, library, tag);
+        } else {
+            ofstream file(output);
+            if (!file) {
+                throw CGException("Failed to open '", output, "'");
+            }
+            benchmark.printJSON(file, runs, library, tag);
+        }
+
+    } catch (const CGException& e) {
+        cerr << e.what() << endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,429 @@
+#ifndef CPPAD_CG_MODEL_BENCHMARK_INCLUDED
+#define CPPAD_CG_MODEL_BENCHMARK_INCLUDED
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2020 Joao Leal
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+
+#include <cppad/cg/cppadcg.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <iomanip>
+#include <random>
+
+namespace CppAD {
+namespace cg {
+
+/**
+ * Measures the execution time of the functions of a compiled model
+ * (the generated code only, not the code generation).
+ *
+ * Each available function is called a number of times to warm up the caches
+ * and then timed several times. Very fast functions are called repeatedly
+ * within each sample so that the clock resolution does not dominate the
+ * measurement.
+ */
+class ModelBenchmark {
+public:
+    using Base = double;
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * The statistics for one function of a model
+     */
+    struct Result {
+        /// function name (e.g. sparse_jacobian)
+        std::string function;
+        /// the number of elements computed by the function (used to determine ns/nnz)
+        size_t nnz;
+        /// the number of calls inside each sample
+        size_t callsPerSample;
+        /// the time of each call (ns) for each sample
+        std::vector<double> samples;
+        double min;
+        double median;
+        double mean;
+        double p99;
+        double max;
+        double stdDev;
+    };
+
+    /**
+     * The results for all the functions of a model
+     */
+    struct ModelRun {
+        std::string name;
+        /// number of independent variables
+        size_t n;
+        /// number of dependent variables
+        size_t m;
+        std::vector<Result> results;
+    };
+private:
+    /**
+     * A function of a model which can be benchmarked
+     */
+    struct Entry {
+        std::string name;
+        size_t nnz;
+        std::function<void()> call;
+    };
+private:
+    size_t _warmup;
+    size_t _repeat;
+    /// minimum duration of each sample (ns)
+    double _minSampleTime;
+    unsigned int _seed;
+public:
+
+    inline ModelBenchmark() :
+        _warmup(10),
+        _repeat(100),
+        _minSampleTime(1e4),
+        _seed(0) {
+    }
+
+    /**
+     * Defines the number of calls (per function) which are not timed
+     */
+    inline void setWarmup(size_t warmup) {
+        _warmup = warmup;
+    }
+
+    inline size_t getWarmup() const {
+        return _warmup;
+    }
+
+    /**
+     * Defines the number of timed samples (per function)
+     */
+    inline void setRepetitions(size_t repeat) {
+        CPPADCG_ASSERT_KNOWN(repeat > 0, "The number of repetitions must be positive")
+        _repeat = repeat;
+    }
+
+    inline size_t getRepetitions() const {
+        return _repeat;
+    }
+
+    /**
+     * Defines the minimum duration of each sample (in nanoseconds).
+     * Functions faster than this are called several times in each sample.
+     */
+    inline void setMinSampleTime(double ns) {
+        _minSampleTime = ns;
+    }
+
+    inline double getMinSampleTime() const {
+        return _minSampleTime;
+    }
+
+    /**
+     * Defines the seed used to generate the values of the independent
+     * variables (uniformly distributed in [0.5, 1.5])
+     */
+    inline void setSeed(unsigned int seed) {
+        _seed = seed;
+    }
+
+    inline unsigned int getSeed() const {
+        return _seed;
+    }
+
+    /**
+     * Benchmarks all the functions available in a model.
+     *
+     * @param model the model
+     * @return the statistics for each function
+     */
+    inline std::vector<Result> run(GenericModel<Base>& model) {
+        const size_t n = model.Domain();
+        const size_t m = model.Range();
+
+        std::mt19937 gen(_seed);
+        std::uniform_real_distribution<Base> dist(0.5, 1.5);
+
+        std::vector<Base> x(n), w(m), tx(2 * n), ty(2 * m), px(2 * n), py(2 * m);
+        for (size_t j = 0; j < n; ++j) {
+            x[j] = dist(gen);
+            tx[j * 2] = x[j];
+            tx[j * 2 + 1] = dist(gen);
+        }
+        for (size_t i = 0; i < m; ++i) {
+            w[i] = dist(gen);
+            py[i * 2] = 0; // required by reverse two
+            py[i * 2 + 1] = w[i];
+        }
+
+        // direction used by the sparse directional functions
+        size_t idx = 0;
+        Base dir = 1;
+
+        std::vector<Base> y(m), jac(m * n), hess(n * n), dx(n), dy(m), sjac, shess;
+        std::vector<size_t> row, col;
+
+        std::vector<Entry> entries;
+
+        if (model.isForwardZeroAvailable()) {
+            entries.push_back(Entry{"forward_zero", m, [&]() {
+                model.ForwardZero(ArrayView<const Base>(x), ArrayView<Base>(y));
+            }});
+        }
+        if (model.isForwardOneAvailable()) {
+            entries.push_back(Entry{"forward_one", m, [&]() {
+                model.ForwardOne(ArrayView<const Base>(tx), ArrayView<Base>(ty));
+            }});
+        }
+        if (model.isSparseForwardOneAvailable() && n > 0) {
+            entries.push_back(Entry{"sparse_forward_one", m, [&]() {
+                model.ForwardOne(ArrayView<const Base>(x), 1, &idx, &dir, ArrayView<Base>(dy));
+            }});
+        }
+        if (model.isReverseOneAvailable()) {
+            entries.push_back(Entry{"reverse_one", n, [&]() {
+                model.ReverseOne(ArrayView<const Base>(x), ArrayView<const Base>(y),
+                                 ArrayView<Base>(px.data(), n), ArrayView<const Base>(w));
+            }});
+        }
+        if (model.isSparseReverseOneAvailable() && m > 0) {
+            entries.push_back(Entry{"sparse_reverse_one", n, [&]() {
+                model.ReverseOne(ArrayView<const Base>(x), ArrayView<Base>(dx), 1, &idx, &dir);
+            }});
+        }
+        if (model.isReverseTwoAvailable()) {
+            entries.push_back(Entry{"reverse_two", n, [&]() {
+                model.ReverseTwo(ArrayView<const Base>(tx), ArrayView<const Base>(ty),
+                                 ArrayView<Base>(px), ArrayView<const Base>(py));
+            }});
+        }
+        if (model.isSparseReverseTwoAvailable() && n > 0) {
+            entries.push_back(Entry{"sparse_reverse_two", n, [&]() {
+                model.ReverseTwo(ArrayView<const Base>(x), 1, &idx, &dir,
+                                 ArrayView<Base>(dx), ArrayView<const Base>(w));
+            }});
+        }
+        if (model.isJacobianAvailable()) {
+            entries.push_back(Entry{"jacobian", m * n, [&]() {
+                model.Jacobian(ArrayView<const Base>(x), ArrayView<Base>(jac));
+            }});
+        }
+        if (model.isHessianAvailable()) {
+            entries.push_back(Entry{"hessian", n * n, [&]() {
+                model.Hessian(ArrayView<const Base>(x), ArrayView<const Base>(w), ArrayView<Base>(hess));
+            }});
+        }
+        if (model.isSparseJacobianAvailable()) {
+            model.JacobianSparsity(row, col);
+            sjac.resize(row.size());
+            entries.push_back(Entry{"sparse_jacobian", sjac.size(), [&]() {
+                size_t const* r;
+                size_t const* c;
+                model.SparseJacobian(ArrayView<const Base>(x), ArrayView<Base>(sjac), &r, &c);
+            }});
+        }
+        if (model.isSparseHessianAvailable()) {
+            model.HessianSparsity(row, col);
+            shess.resize(row.size());
+            entries.push_back(Entry{"sparse_hessian", shess.size(), [&]() {
+                size_t const* r;
+                size_t const* c;
+                model.SparseHessian(ArrayView<const Base>(x), ArrayView<const Base>(w), ArrayView<Base>(shess), &r, &c);
+            }});
+        }
+
+        std::vector<Result> results;
+        results.reserve(entries.size());
+        for (Entry& e : entries) {
+            results.push_back(measure(e));
+        }
+
+        return results;
+    }
+
+    /**
+     * Prints the results in JSON
+     *
+     * @param out the output stream
+     * @param runs the results for each model
+     * @param library the path to the model library
+     * @param tag a user defined label for this run (e.g. the compiler flags)
+     */
+    inline void printJSON(std::ostream& out,
+                          const std::vector<ModelRun>& runs,
+                          const std::string& library,
+                          const std::string& tag) const {
+        out << "{\n";
+        out << "  \"version\": " << quote(CPPAD_CG_VERSION) << ",\n";
+        out << "  \"library\": " << quote(library) << ",\n";
+        out << "  \"tag\": " << quote(tag) << ",\n";
+        out << "  \"warmup\": " << _warmup << ",\n";
+        out << "  \"repetitions\": " << _repeat << ",\n";
+        out << "  \"seed\": " << _seed << ",\n";
+        out << "  \"models\": [";
+        for (size_t k = 0; k < runs.size(); ++k) {
+            const ModelRun& r = runs[k];
+            out << (k == 0 ? "\n" : ",\n");
+            out << "    {\n";
+            out << "      \"name\": " << quote(r.name) << ",\n";
+            out << "      \"n\": " << r.n << ",\n";
+            out << "      \"m\": " << r.m << ",\n";
+            out << "      \"functions\": [";
+            for (size_t f = 0; f < r.results.size(); ++f) {
+                const Result& s = r.results[f];
+                out << (f == 0 ? "\n" : ",\n");
+                out << "        {"
+                    << "\"name\": " << quote(s.function)
+                    << ", \"nnz\": " << s.nnz
+                    << ", \"samples\": " << s.samples.size()
+                    << ", \"calls_per_sample\": " << s.callsPerSample
+                    << ", \"min_ns\": " << number(s.min)
+                    << ", \"median_ns\": " << number(s.median)
+                    << ", \"mean_ns\": " << number(s.mean)
+                    << ", \"p99_ns\": " << number(s.p99)
+                    << ", \"max_ns\": " << number(s.max)
+                    << ", \"stddev_ns\": " << number(s.stdDev)
+                    << ", \"ns_per_nnz\": " << (s.nnz > 0 ? number(s.median / s.nnz) : "null")
+                    << "}";
+            }
+            out << (r.results.empty() ? "]\n" : "\n      ]\n");
+            out << "    }";
+        }
+        out << (runs.empty() ? "]\n" : "\n  ]\n");
+        out << "}" << std::endl;
+    }
+
+    /**
+     * Prints a human readable table with the results
+     */
+    inline static void printTable(std::ostream& out,
+                                  const ModelRun& run) {
+        out << run.name << " (n=" << run.n << ", m=" << run.m << ")\n";
+        out << std::left << std::setw(20) << "  function"
+            << std::right << std::setw(10) << "nnz"
+            << std::setw(14) << "median (ns)"
+            << std::setw(14) << "p99 (ns)"
+            << std::setw(12) << "ns/nnz" << "\n";
+        for (const Result& s : run.results) {
+            out << "  " << std::left << std::setw(18) << s.function
+                << std::right << std::setw(10) << s.nnz
+                << std::setw(14) << s.median
+                << std::setw(14) << s.p99
+                << std::setw(12) << (s.nnz > 0 ? s.median / s.nnz : 0.0) << "\n";
+        }
+        out << std::flush;
+    }
+
+private:
+
+    inline Result measure(Entry& e) const {
+        Result r;
+        r.function = e.name;
+        r.nnz = e.nnz;
+
+        // warm up and estimate the time of each call
+        auto t0 = Clock::now();
+        for (size_t i = 0; i < _warmup; ++i) {
+            e.call();
+        }
+        double warmupTime = std::chrono::duration<double, std::nano>(Clock::now() - t0).count();
+
+        size_t calls = 1;
+        if (_warmup > 0 && warmupTime > 0) {
+            double callTime = warmupTime / _warmup;
+            calls = std::max<size_t>(1, size_t(std::ceil(_minSampleTime / callTime)));
+        }
+        r.callsPerSample = calls;
+
+        r.samples.resize(_repeat);
+        for (size_t s = 0; s < _repeat; ++s) {
+            auto start = Clock::now();
+            for (size_t c = 0; c < calls; ++c) {
+                e.call();
+            }
+            auto end = Clock::now();
+            r.samples[s] = std::chrono::duration<double, std::nano>(end - start).count() / calls;
+        }
+
+        // statistics
+        std::vector<double> sorted(r.samples);
+        std::sort(sorted.begin(), sorted.end());
+        size_t ns = sorted.size();
+
+        r.min = sorted.front();
+        r.max = sorted.back();
+        r.median = ns % 2 == 1 ? sorted[ns / 2] : (sorted[ns / 2 - 1] + sorted[ns / 2]) / 2;
+        r.p99 = percentile(sorted, 0.99);
+
+        double sum = 0;
+        for (double v : sorted)
+            sum += v;
+        r.mean = sum / ns;
+
+        double var = 0;
+        for (double v : sorted)
+            var += (v - r.mean) * (v - r.mean);
+        r.stdDev = ns > 1 ? std::sqrt(var / (ns - 1)) : 0.0;
+
+        return r;
+    }
+
+    /**
+     * Linear interpolation between the closest ranks
+     */
+    static inline double percentile(const std::vector<double>& sorted,
+                                    double p) {
+        double rank = p * (sorted.size() - 1);
+        auto lo = size_t(std::floor(rank));
+        auto hi = size_t(std::ceil(rank));
+        return sorted[lo] + (rank - lo) * (sorted[hi] - sorted[lo]);
+    }
+
+    static inline std::string number(double v) {
+        std::ostringstream ss;
+        ss.precision(6);
+        ss << std::fixed << v;
+        return ss.str();
+    }
+
+    static inline std::string quote(const std::string& s) {
+        std::string q = "\"";
+        for (char c : s) {
+            switch (c) {
+                case '"':
+                    q += "\\\"";
+                    break;
+                case '\\':
+                    q += "\\\\";
+                    break;
+                case '\n':
+                    q += "\\n";
+                    break;
+                case '\t':
+                    q += "\\t";
+                    break;
+                default:
+                    q += c;
+            }
+        }
+        q += "\"";
+        return q;
+    }
+};
+
+} // END cg namespace
+} // END CppAD namespace
+
+#endif
@@ -0,0 +1,175 @@
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2019 Joao Leal
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+#include "CppADCGTest.hpp"
+
+using namespace CppAD;
+using namespace CppAD::cg;
+
+namespace {
+
+size_t countOccurrences(const std::string& str,
+                        const std::string& sub) {
+    size_t count = 0;
+    for (size_t pos = str.find(sub); pos != std::string::npos; pos = str.find(sub, pos + sub.size())) {
+        count++;
+    }
+    return count;
+}
+
+/**
+ * Provides access to the generated model sources
+ */
+class SourcesProcessor : public ModelLibraryProcessor<double> {
+public:
+    inline explicit SourcesProcessor(ModelLibraryCSourceGen<double>& libSourceGen) :
+        ModelLibraryProcessor<double>(libSourceGen) {
+    }
+
+    inline std::map<std::string, std::string> sources(ModelCSourceGen<double>& model) {
+        return getSources(model);
+    }
+};
+
+std::string generateForwardZero(ADFun<CGD>& fun,
+                                bool hashConsing,
+                                bool eliminateCSE) {
+    ModelCSourceGen<double> sourceGen(fun, "cse_model");
+    sourceGen.setHashConsing(hashConsing);
+    sourceGen.setEliminateCommonSubexpressions(eliminateCSE);
+
+    ModelLibraryCSourceGen<double> libSourceGen(sourceGen);
+
+    std::string code;
+    for (const auto& it : SourcesProcessor(libSourceGen).sources(sourceGen)) {
+        if (it.first.find(ModelCSourceGen<double>::FUNCTION_FORWAD_ZERO) != std::string::npos)
+            code += it.second;
+    }
+    return code;
+}
+
+} // END namespace
+
+TEST_F(CppADCGTest, HashConsing) {
+    CodeHandler<double> handler;
+    handler.setHashConsing(true);
+
+    std::vector<CGD> x(2);
+    handler.makeVariables(x);
+
+    CGD s1 = sin(x[0]);
+    CGD s2 = sin(x[0]);
+    ASSERT_EQ(s1.getOperationNode(), s2.getOperationNode());
+
+    // commutative operations
+    CGD m1 = s1 * x[1];
+    CGD m2 = x[1] * s2;
+    ASSERT_EQ(m1.getOperationNode(), m2.getOperationNode());
+
+    CGD a1 = x[0] + 2.0 * x[1];
+    CGD a2 = x[1] * 2.0 + x[0];
+    ASSERT_EQ(a1.getOperationNode(), a2.getOperationNode());
+
+    // not commutative
+    CGD d1 = x[0] - x[1];
+    CGD d2 = x[1] - x[0];
+    ASSERT_NE(d1.getOperationNode(), d2.getOperationNode());
+
+    // different parameters
+    CGD p1 = x[0] * 2.0;
+    CGD p2 = x[0] * 3.0;
+    ASSERT_NE(p1.getOperationNode(), p2.getOperationNode());
+
+    handler.setHashConsing(false);
+    CGD s3 = sin(x[0]);
+    ASSERT_NE(s1.getOperationNode(), s3.getOperationNode());
+}
+
+TEST_F(CppADCGTest, EliminateCommonSubexpressions) {
+    CodeHandler<double> handler;
+
+    std::vector<CGD> x(2);
+    handler.makeVariables(x);
+
+    std::vector<CGD> y(2);
+    y[0] = sin(x[0]) * x[1] + x[1] * sin(x[0]);
+    y[1] = sin(x[0]) * x[1];
+
+    ArrayView<CGD> yv(y);
+    size_t merged = handler.eliminateCommonSubexpressions(yv);
+
+    // 2 sin and 2 multiplications
+    ASSERT_EQ(merged, 4u);
+    ASSERT_EQ(y[0].getOperationNode()->getArguments()[0].getOperation(),
+              y[0].getOperationNode()->getArguments()[1].getOperation());
+    ASSERT_EQ(y[1].getOperationNode(),
+              y[0].getOperationNode()->getArguments()[0].getOperation());
+
+    LanguageC<double> langC("double");
+    LangCDefaultVariableNameGenerator<double> nameGen;
+
+    std::ostringstream code;
+    handler.generateCode(code, langC, y, nameGen);
+
+    ASSERT_EQ(countOccurrences(code.str(), "sin("), 1u);
+}
+
+TEST_F(CppADCGTest, EliminateCommonSubexpressionsGenerateCode) {
+    CodeHandler<double> handler;
+    handler.setEliminateCommonSubexpressions(true);
+
+    std::vector<CGD> x(3);
+    handler.makeVariables(x);
+
+    std::vector<CGD> y(3);
+    y[0] = exp(x[0] + x[2]) * cos(x[1]);
+    y[1] = cos(x[1]) * exp(x[2] + x[0]);
+    y[2] = exp(x[0] + x[2]) / x[1];
+
+    LanguageC<double> langC("double");
+    LangCDefaultVariableNameGenerator<double> nameGen;
+
+    std::ostringstream code;
+    handler.generateCode(code, langC, y, nameGen);
+
+    ASSERT_EQ(y[0].getOperationNode(), y[1].getOperationNode());
+    ASSERT_EQ(countOccurrences(code.str(), "exp("), 1u);
+    ASSERT_EQ(countOccurrences(code.str(), "cos("), 1u);
+}
+
+TEST_F(CppADCGTest, EliminateCommonSubexpressionsModel) {
+    using ADCG = AD<CGD>;
+
+    std::vector<ADCG> u(3, 1.0);
+    CppAD::Independent(u);
+
+    std::vector<ADCG> v(3);
+    v[0] = exp(u[0] + u[2]) * cos(u[1]);
+    v[1] = cos(u[1]) * exp(u[2] + u[0]);
+    v[2] = exp(u[0] + u[2]) / u[1];
+
+    ADFun<CGD> fun(u, v);
+
+    std::string code = generateForwardZero(fun, false, false);
+    ASSERT_EQ(countOccurrences(code, "exp("), 3u);
+
+    // the options are used by the code handlers of the model
+    code = generateForwardZero(fun, false, true);
+    ASSERT_EQ(countOccurrences(code, "exp("), 1u);
+    ASSERT_EQ(countOccurrences(code, "cos("), 1u);
+
+    code = generateForwardZero(fun, true, false);
+    ASSERT_EQ(countOccurrences(code, "exp("), 1u);
+    ASSERT_EQ(countOccurrences(code, "cos("), 1u);
+}
@@ -0,0 +1,72 @@
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2020 Joao Leal
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+#include "CppADCGEvaluatorTest.hpp"
+
+using namespace CppAD;
+using namespace CppAD::cg;
+
+TEST_F(CppADCGEvaluatorTest, IterativeRepeated) {
+    CodeHandler<double> handler;
+
+    std::vector<CGD> x(2);
+    handler.makeVariables(x);
+
+    std::vector<CGD> y(3);
+    y[0] = sin(x[0]) * x[1] + exp(x[1]);
+    y[1] = y[0] / (1.0 + x[0] * x[0]);
+    y[2] = 2.0;
+
+    Evaluator<double, double, CGD> recursive(handler);
+    Evaluator<double, double, CGD> iterative(handler);
+    iterative.setIterative(true);
+    ASSERT_TRUE(iterative.isIterative());
+
+    // the same evaluator is reused with different values
+    for (size_t r = 0; r < 3; ++r) {
+        std::vector<CGD> xNew{0.5 + r, 1.5 - r};
+
+        std::vector<CGD> yRef = recursive.evaluate(xNew, y);
+        std::vector<CGD> yNew = iterative.evaluate(xNew, y);
+
+        ASSERT_EQ(yNew.size(), y.size());
+        for (size_t i = 0; i < y.size(); i++) {
+            ASSERT_TRUE(yNew[i].isParameter());
+            ASSERT_EQ(yNew[i].getValue(), yRef[i].getValue());
+        }
+    }
+}
+
+TEST_F(CppADCGEvaluatorTest, IterativeDeepGraph) {
+    const size_t depth = 500000;
+
+    CodeHandler<double> handler;
+
+    std::vector<CGD> x(1);
+    handler.makeVariables(x);
+
+    std::vector<CGD> y(1);
+    y[0] = x[0];
+    for (size_t i = 0; i < depth; ++i) {
+        y[0] = y[0] * 0.5 + 1.0;
+    }
+
+    Evaluator<double, double, CGD> evaluator(handler);
+    evaluator.setIterative(true);
+
+    std::vector<CGD> xNew{2.0};
+    std::vector<CGD> yNew = evaluator.evaluate(xNew, y);
+
+    ASSERT_NEAR(yNew[0].getValue(), 2.0, 1e-10);
+}
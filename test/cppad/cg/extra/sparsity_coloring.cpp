@@ -0,0 +1,156 @@
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2020 Joao Leal
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+#include "CppADCGTest.hpp"
+
+using namespace CppAD;
+using namespace CppAD::cg;
+
+namespace {
+
+using SparsitySet = std::vector<std::set<size_t> >;
+
+SparsitySet bandedSparsity(size_t n,
+                           size_t bandwidth) {
+    SparsitySet s(n);
+    for (size_t i = 0; i < n; i++) {
+        for (size_t j = (i >= bandwidth ? i - bandwidth : 0); j < std::min(n, i + bandwidth + 1); j++) {
+            s[i].insert(j);
+        }
+    }
+    return s;
+}
+
+SparsitySet arrowSparsity(size_t n) {
+    SparsitySet s(n);
+    for (size_t i = 0; i < n; i++) {
+        s[i].insert(i);
+        s[i].insert(0);
+        s[0].insert(i);
+    }
+    return s;
+}
+
+void checkColumnColoring(const SparsitySet& s,
+                         size_t n,
+                         const std::vector<size_t>& color) {
+    ASSERT_EQ(color.size(), n);
+    for (const auto& row : s) {
+        std::set<size_t> used;
+        for (size_t j : row) {
+            ASSERT_LT(color[j], n);
+            ASSERT_TRUE(used.insert(color[j]).second) << "two columns with the same color in a row";
+        }
+    }
+}
+
+/**
+ * Every element must be directly recoverable from the compressed Hessian
+ */
+void checkStarColoring(const SparsitySet& s,
+                       const std::vector<size_t>& color) {
+    size_t n = s.size();
+    std::vector<std::set<size_t> > adj(n);
+    for (size_t i = 0; i < n; i++) {
+        for (size_t j : s[i]) {
+            if (i != j) {
+                adj[i].insert(j);
+                adj[j].insert(i);
+            }
+        }
+    }
+
+    auto unique = [&](size_t i, size_t j) -> bool {
+        for (size_t k : adj[i]) {
+            if (k != j && color[k] == color[j])
+                return false;
+        }
+        return true;
+    };
+
+    for (size_t i = 0; i < n; i++) {
+        for (size_t j : adj[i]) {
+            ASSERT_NE(color[i], color[j]);
+            ASSERT_TRUE(unique(i, j) || unique(j, i)) << "element (" << i << ", " << j << ") cannot be recovered";
+        }
+    }
+}
+
+} // END namespace
+
+TEST_F(CppADCGTest, SparsityColoringColumns) {
+    const size_t n = 20;
+    SparsitySet s = bandedSparsity(n, 1);
+
+    std::vector<size_t> color;
+    ASSERT_EQ(colorSparsityColumns(s, n, color), 3u);
+    checkColumnColoring(s, n, color);
+
+    s = bandedSparsity(n, 2);
+    ASSERT_EQ(colorSparsityColumns(s, n, color), 5u);
+    checkColumnColoring(s, n, color);
+
+    // a column without elements
+    s = bandedSparsity(n, 1);
+    for (auto& row : s)
+        row.erase(4);
+    colorSparsityColumns(s, n, color);
+    ASSERT_EQ(color[4], n);
+
+    // rows
+    s = arrowSparsity(n);
+    ASSERT_EQ(colorSparsityColumns(s, n, color), n);
+    ASSERT_EQ(colorSparsityRows(s, n, color), n);
+
+    SparsitySet rect(3);
+    rect[0] = {0, 1, 2, 3};
+    rect[1] = {4};
+    rect[2] = {5, 6};
+    ASSERT_EQ(colorSparsityRows(rect, 7, color), 1u);
+    ASSERT_EQ(colorSparsityColumns(rect, 7, color), 4u);
+}
+
+TEST_F(CppADCGTest, SparsityColoringStar) {
+    const size_t n = 20;
+    std::vector<size_t> color;
+
+    SparsitySet s = bandedSparsity(n, 1);
+    size_t nColors = colorSparsityStar(s, color);
+    ASSERT_LE(nColors, 3u);
+    checkStarColoring(s, color);
+
+    s = bandedSparsity(n, 3);
+    nColors = colorSparsityStar(s, color);
+    ASSERT_LT(nColors, n);
+    checkStarColoring(s, color);
+
+    // the arrow pattern requires only 2 colors (distance-2 coloring requires n)
+    s = arrowSparsity(n);
+    ASSERT_EQ(colorSparsityStar(s, color), 2u);
+    checkStarColoring(s, color);
+
+    // a grid
+    const size_t nx = 5;
+    SparsitySet grid(nx * nx);
+    for (size_t i = 0; i < nx; i++) {
+        for (size_t j = 0; j < nx; j++) {
+            size_t v = i * nx + j;
+            grid[v].insert(v);
+            if (i + 1 < nx) grid[v].insert(v + nx);
+            if (j + 1 < nx) grid[v].insert(v + 1);
+        }
+    }
+    colorSparsityStar(grid, color);
+    checkStarColoring(grid, color);
+}
@@ -0,0 +1,274 @@
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2020 Joao Leal
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+#include "CppADCGTest.hpp"
+
+using namespace CppAD;
+using namespace CppAD::cg;
+
+namespace {
+
+using Node = OperationNode<double>;
+using Arg = Argument<double>;
+
+size_t countOccurrences(const std::string& str,
+                        const std::string& sub) {
+    size_t count = 0;
+    for (size_t pos = str.find(sub); pos != std::string::npos; pos = str.find(sub, pos + sub.size())) {
+        count++;
+    }
+    return count;
+}
+
+std::vector<double> evaluate(CodeHandler<double>& handler,
+                             const std::vector<double>& x,
+                             const std::vector<CGD>& y) {
+    Evaluator<double, double, CGD> evaluator(handler);
+
+    std::vector<CGD> xNew(x.begin(), x.end());
+    std::vector<CGD> yNew = evaluator.evaluate(xNew, y);
+
+    std::vector<double> values(yNew.size());
+    for (size_t i = 0; i < yNew.size(); ++i) {
+        values[i] = yNew[i].getValue();
+    }
+    return values;
+}
+
+class OptimizationJobCounter : public JobListener {
+public:
+    size_t started = 0;
+    size_t ended = 0;
+
+    void jobStarted(const std::vector<Job>& jobs) override {
+        if (&jobs.back().getType() == &JobTimer::GRAPH_OPTIMIZATION)
+            started++;
+    }
+
+    void jobEndended(const std::vector<Job>& jobs,
+                     duration elapsed) override {
+        if (&jobs.back().getType() == &JobTimer::GRAPH_OPTIMIZATION)
+            ended++;
+    }
+};
+
+class SourcesProcessor : public ModelLibraryProcessor<double> {
+public:
+    inline explicit SourcesProcessor(ModelLibraryCSourceGen<double>& libSourceGen) :
+        ModelLibraryProcessor<double>(libSourceGen) {
+    }
+
+    inline std::map<std::string, std::string> sources(ModelCSourceGen<double>& model) {
+        return getSources(model);
+    }
+};
+
+std::string generateForwardZero(ADFun<CGD>& fun,
+                                GraphOptimizer<double>* optimizer) {
+    ModelCSourceGen<double> sourceGen(fun, "optimized_model");
+    sourceGen.setGraphOptimizer(optimizer);
+
+    ModelLibraryCSourceGen<double> libSourceGen(sourceGen);
+
+    std::string code;
+    for (const auto& it : SourcesProcessor(libSourceGen).sources(sourceGen)) {
+        if (it.first.find(ModelCSourceGen<double>::FUNCTION_FORWAD_ZERO) != std::string::npos)
+            code += it.second;
+    }
+    return code;
+}
+
+} // END namespace
+
+TEST_F(CppADCGTest, GraphOptimizerPasses) {
+    CodeHandler<double> handler;
+
+    std::vector<CGD> x(2);
+    handler.makeVariables(x);
+
+    // operations created directly so that they are not simplified by the CG arithmetic
+    Node* five = handler.makeNode(CGOpCode::Add, {Arg(2.0), Arg(3.0)});
+    Node* x0Times1 = handler.makeNode(CGOpCode::Mul, {Arg(*x[0].getOperationNode()), Arg(1.0)});
+
+    std::vector<CGD> y(7);
+    y[0] = CGD(*handler.makeNode(CGOpCode::Add, {*x0Times1, Arg(0.0)}));
+    y[1] = CGD(*handler.makeNode(CGOpCode::Mul, {*five, Arg(*x[1].getOperationNode())}));
+    y[2] = CGD(*handler.makeNode(CGOpCode::Pow, {Arg(*x[0].getOperationNode()), Arg(2.0)}));
+    y[3] = CGD(*handler.makeNode(CGOpCode::Pow, {Arg(*x[1].getOperationNode()), Arg(-3.0)}));
+    y[4] = CGD(*handler.makeNode(CGOpCode::Exp, Arg(*handler.makeNode(CGOpCode::Log, Arg(*x[0].getOperationNode())))));
+    y[5] = CGD(*handler.makeNode(CGOpCode::Sin, Arg(*handler.makeNode(CGOpCode::Mul, {Arg(0.0), Arg(*x[1].getOperationNode())}))));
+    y[6] = CGD(*handler.makeNode(CGOpCode::Div, {*handler.makeNode(CGOpCode::Sub, {Arg(0.0), Arg(*x[0].getOperationNode())}), Arg(-1.0)}));
+
+    std::vector<double> xv{1.3, 0.7};
+    std::vector<double> yRef = evaluate(handler, xv, y);
+
+    GraphOptimizer<double> optimizer;
+    ASSERT_THROW(optimizer.setPassEnabled("missing", true), CGException);
+    optimizer.setPassEnabled("exp/log cancellation", true);
+
+    ArrayView<CGD> yv(y);
+    ASSERT_GT(optimizer.optimize(handler, yv), 0u);
+
+    // x * 1 + 0
+    ASSERT_EQ(y[0].getOperationNode(), x[0].getOperationNode());
+
+    // (2 + 3) * x1
+    Node* n1 = y[1].getOperationNode();
+    ASSERT_EQ(n1->getOperationType(), CGOpCode::Mul);
+    ASSERT_TRUE(n1->getArguments()[0].getParameter() != nullptr);
+    ASSERT_EQ(*n1->getArguments()[0].getParameter(), 5.0);
+
+    // pow(x0, 2)
+    Node* n2 = y[2].getOperationNode();
+    ASSERT_EQ(n2->getOperationType(), CGOpCode::Mul);
+    ASSERT_EQ(n2->getArguments()[0].getOperation(), x[0].getOperationNode());
+    ASSERT_EQ(n2->getArguments()[1].getOperation(), x[0].getOperationNode());
+
+    // pow(x1, -3)
+    ASSERT_EQ(y[3].getOperationNode()->getOperationType(), CGOpCode::Div);
+
+    // exp(log(x0))
+    ASSERT_EQ(y[4].getOperationNode(), x[0].getOperationNode());
+
+    // sin(0 * x1)
+    ASSERT_TRUE(y[5].isParameter());
+    ASSERT_EQ(y[5].getValue(), 0.0);
+
+    // (0 - x0) / -1
+    ASSERT_EQ(y[6].getOperationNode(), x[0].getOperationNode());
+
+    std::vector<double> yOpt = evaluate(handler, xv, y);
+    ASSERT_TRUE(compareValues(yOpt, yRef));
+}
+
+TEST_F(CppADCGTest, GraphOptimizerFixedPoint) {
+    CodeHandler<double> handler;
+
+    std::vector<CGD> x(1);
+    handler.makeVariables(x);
+
+    // the folded constant cannot be used by the alias
+    Node* five = handler.makeNode(CGOpCode::Add, {Arg(2.0), Arg(3.0)});
+
+    std::vector<CGD> y(1);
+    y[0] = CGD(*handler.makeNode(CGOpCode::Alias, *five));
+
+    GraphOptimizer<double> optimizer;
+
+    ArrayView<CGD> yv(y);
+    ASSERT_EQ(optimizer.optimize(handler, yv), 0u);
+    ASSERT_EQ(y[0].getOperationNode()->getArguments()[0].getOperation(), five);
+}
+
+TEST_F(CppADCGTest, GraphOptimizerReciprocalDivision) {
+    CodeHandler<double> handler;
+
+    std::vector<CGD> x(3);
+    handler.makeVariables(x);
+
+    CGD d = x[2] + 1.0;
+    std::vector<CGD> y(3);
+    y[0] = x[0] / d;
+    y[1] = x[1] / d;
+    y[2] = x[0] / 4.0;
+
+    std::vector<double> xv{1.3, 0.7, 2.5};
+    std::vector<double> yRef = evaluate(handler, xv, y);
+
+    GraphOptimizer<double> optimizer;
+    optimizer.setPassEnabled("reciprocal division", true);
+    optimizer.optimize(handler, y);
+
+    for (size_t i = 0; i < y.size(); ++i) {
+        ASSERT_EQ(y[i].getOperationNode()->getOperationType(), CGOpCode::Mul);
+    }
+    // the same reciprocal is used
+    ASSERT_EQ(y[0].getOperationNode()->getArguments()[1].getOperation(),
+              y[1].getOperationNode()->getArguments()[1].getOperation());
+    ASSERT_EQ(*y[2].getOperationNode()->getArguments()[1].getParameter(), 0.25);
+
+    std::vector<double> yOpt = evaluate(handler, xv, y);
+    ASSERT_TRUE(compareValues(yOpt, yRef));
+}
+
+TEST_F(CppADCGTest, GraphOptimizerGenerateCode) {
+    CodeHandler<double> handler;
+
+    JobTimer timer;
+    OptimizationJobCounter counter;
+    timer.addListener(counter);
+    handler.setJobTimer(&timer);
+
+    GraphOptimizer<double> optimizer;
+    handler.setGraphOptimizer(&optimizer);
+    ASSERT_EQ(handler.getGraphOptimizer(), &optimizer);
+
+    std::vector<CGD> x(2);
+    handler.makeVariables(x);
+
+    std::vector<CGD> y(2);
+    y[0] = pow(x[0], 2.0) + pow(x[1], 4.0);
+    y[1] = pow(x[0] * x[1], 2.5);
+
+    LanguageC<double> langC("double");
+    LangCDefaultVariableNameGenerator<double> nameGen;
+
+    std::ostringstream code;
+    handler.generateCode(code, langC, y, nameGen);
+
+    ASSERT_EQ(countOccurrences(code.str(), "pow("), 1u);
+
+    // only the enabled passes are reported
+    ASSERT_GT(counter.started, 0u);
+    ASSERT_EQ(counter.started, counter.ended);
+    ASSERT_EQ(counter.started % 3, 0u);
+
+    // without power reduction
+    optimizer.setPassEnabled("power reduction", false);
+
+    std::vector<CGD> y2(1);
+    y2[0] = pow(x[1], 3.0);
+
+    std::ostringstream code2;
+    handler.generateCode(code2, langC, y2, nameGen);
+
+    ASSERT_EQ(countOccurrences(code2.str(), "pow("), 1u);
+}
+
+TEST_F(CppADCGTest, GraphOptimizerModel) {
+    using ADCG = CppAD::AD<CGD>;
+
+    std::vector<ADCG> u(2, 1.0);
+    CppAD::Independent(u);
+
+    std::vector<ADCG> v(2);
+    v[0] = exp(log(u[0])) * u[1];
+    v[1] = log(exp(u[1])) + u[0];
+
+    ADFun<CGD> fun(u, v);
+
+    GraphOptimizer<double> optimizer;
+    optimizer.setPassEnabled("exp/log cancellation", true);
+
+    std::string original = generateForwardZero(fun, nullptr);
+    std::string optimized = generateForwardZero(fun, &optimizer);
+
+    ASSERT_EQ(countOccurrences(original, "exp("), 2u);
+    ASSERT_EQ(countOccurrences(original, "log("), 2u);
+
+    // the operations cancel each other in the optimized model
+    ASSERT_EQ(countOccurrences(optimized, "exp("), 0u);
+    ASSERT_EQ(countOccurrences(optimized, "log("), 0u);
+    ASSERT_LT(optimized.size(), original.size());
+}
@@ -0,0 +1,126 @@
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2020 Joao Leal
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+#include "CppADCGTest.hpp"
+
+using namespace CppAD;
+using namespace CppAD::cg;
+
+namespace {
+
+std::string generateC(CodeHandler<double>& handler,
+                      std::vector<CG<double> >& dep) {
+    LanguageC<double> langC("double");
+    LangCDefaultVariableNameGenerator<double> nameGen;
+
+    std::ostringstream code;
+    handler.generateCode(code, langC, dep, nameGen);
+    return code.str();
+}
+
+} // END namespace
+
+TEST_F(CppADCGTest, GraphSerializationTaped) {
+    using ADCG = AD<CGD>;
+
+    std::vector<ADCG> u(3, 1.0);
+    CppAD::Independent(u);
+
+    std::vector<ADCG> v(3);
+    v[0] = cos(u[0]) * u[2] + exp(u[1]) - 2.5;
+    v[1] = CondExpGt(u[0], u[1], pow(u[1], u[2]), u[0] / u[2]);
+    v[2] = sqrt(u[0] * u[0] + 1.0);
+
+    ADFun<CGD> fun(u, v);
+
+    CodeHandler<double> handler;
+    std::vector<CGD> x(3);
+    handler.makeVariables(x);
+    std::vector<CGD> y = fun.Forward(0, x);
+
+    std::stringstream data;
+    handler.saveGraph(data, y);
+
+    CodeHandler<double> handler2;
+    std::vector<CGD> x2, y2;
+    handler2.loadGraph(data, x2, y2);
+
+    ASSERT_EQ(x2.size(), x.size());
+    ASSERT_EQ(y2.size(), y.size());
+    ASSERT_EQ(handler2.getManagedNodesCount(), handler.getManagedNodesCount());
+
+    ASSERT_EQ(generateC(handler2, y2), generateC(handler, y));
+}
+
+TEST_F(CppADCGTest, GraphSerializationParameters) {
+    CodeHandler<double> handler;
+    std::vector<CGD> x(2);
+    handler.makeVariables(x);
+
+    std::vector<CGD> y(3);
+    y[0] = x[0] * 3.0;
+    y[1] = 1.5; // a parameter dependent
+    y[2] = x[1];
+
+    std::string data;
+    {
+        std::ostringstream out;
+        handler.saveGraph(out, y);
+        data = out.str();
+    }
+
+    // loading from a memory buffer (e.g. memory mapped file)
+    CodeHandler<double> handler2;
+    std::vector<CGD> x2, y2;
+    handler2.loadGraph(data.data(), data.size(), x2, y2);
+
+    ASSERT_EQ(y2.size(), 3u);
+    ASSERT_TRUE(y2[1].isParameter());
+    ASSERT_EQ(y2[1].getValue(), 1.5);
+    ASSERT_EQ(y2[2].getOperationNode(), x2[1].getOperationNode());
+    ASSERT_EQ(generateC(handler2, y2), generateC(handler, y));
+
+    // truncated data
+    CodeHandler<double> handler3;
+    ASSERT_THROW(handler3.loadGraph(data.data(), data.size() - 1, x2, y2), CGException);
+
+    // not a graph
+    ASSERT_THROW(handler3.loadGraph(data.data() + 1, data.size() - 1, x2, y2), CGException);
+}
+
+TEST_F(CppADCGTest, GraphSerializationLargeValues) {
+    CodeHandler<double> handler;
+    std::vector<CGD> x(1);
+    handler.makeVariables(x);
+
+    // the node information is not limited by the size of the data
+    const size_t value = std::numeric_limits<uint32_t>::max();
+    std::vector<CGD> y{CGD(*handler.makeNode(CGOpCode::Alias, {value}, {asArgument(x[0])}))};
+
+    std::string data;
+    {
+        std::ostringstream out;
+        handler.saveGraph(out, y);
+        data = out.str();
+    }
+    ASSERT_LT(data.size(), value);
+
+    CodeHandler<double> handler2;
+    std::vector<CGD> x2, y2;
+    handler2.loadGraph(data.data(), data.size(), x2, y2);
+
+    ASSERT_EQ(y2.size(), 1u);
+    ASSERT_TRUE(y2[0].getOperationNode() != nullptr);
+    ASSERT_EQ(y2[0].getOperationNode()->getInfo(), std::vector<size_t>{value});
+}
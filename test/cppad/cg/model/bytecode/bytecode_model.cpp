@@ -0,0 +1,188 @@
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2020 Joao Leal
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+#include "CppADCGTest.hpp"
+
+using namespace CppAD;
+using namespace CppAD::cg;
+
+namespace {
+
+class SmallModel {
+public:
+    template<class T>
+    std::vector<T> operator()(const std::vector<T>& x) const {
+        std::vector<T> y(5);
+        y[0] = cos(x[0]) * x[2] + exp(x[1]) - 2.5;
+        y[1] = CondExpGt(x[0], x[1], pow(x[1], x[2]), x[0] / x[2]);
+        y[2] = sqrt(x[0] * x[0] + 1.0) * log(x[2]);
+        y[3] = 1.5; // a parameter
+        y[4] = x[1]; // an independent variable
+        return y;
+    }
+};
+
+class LargeModel {
+public:
+    template<class T>
+    std::vector<T> operator()(const std::vector<T>& x) const {
+        // requires more registers than the ones available in the stack
+        std::vector<T> y(x.size());
+        for (size_t i = 0; i < x.size(); ++i) {
+            y[i] = sin(x[i]) * x[(i + 1) % x.size()] + x[i] * x[i];
+        }
+        return y;
+    }
+};
+
+class CppADCGBytecodeTest : public CppADCGTest {
+protected:
+    std::unique_ptr<ADFun<CGD> > _funCG;
+    std::unique_ptr<ADFun<double> > _fun;
+    std::vector<double> _x;
+    std::vector<double> _w;
+public:
+
+    template<class Model>
+    void tape(size_t n, const Model& model) {
+        using ADCG = AD<CGD>;
+
+        std::vector<ADCG> u(n, 1.0);
+        CppAD::Independent(u);
+        std::vector<ADCG> v = model(u);
+        _funCG.reset(new ADFun<CGD>(u, v));
+
+        std::vector<AD<double> > ud(n, 1.0);
+        CppAD::Independent(ud);
+        std::vector<AD<double> > vd = model(ud);
+        _fun.reset(new ADFun<double>(ud, vd));
+
+        _x.resize(n);
+        for (size_t j = 0; j < n; ++j)
+            _x[j] = 0.5 + 0.3 * j;
+
+        _w.resize(vd.size());
+        for (size_t i = 0; i < _w.size(); ++i)
+            _w[i] = 1.0 - 0.25 * i;
+    }
+
+    std::unique_ptr<BytecodeModelLibrary<double> > createLibrary(const std::string& name) {
+        ModelCSourceGen<double> compHelp(*_funCG, name);
+        compHelp.setCreateForwardZero(true);
+        compHelp.setCreateSparseJacobian(true);
+        compHelp.setCreateSparseHessian(true);
+
+        ModelLibraryCSourceGen<double> compDynHelp(compHelp);
+
+        BytecodeModelLibraryProcessor<double> p(compDynHelp);
+        return p.create();
+    }
+
+    void testModel(GenericModel<double>& model) {
+        size_t n = _x.size();
+
+        // zero order
+        std::vector<double> y = model.ForwardZero(_x);
+        ASSERT_TRUE(compareValues(y, _fun->Forward(0, _x)));
+
+        // Jacobian
+        ASSERT_TRUE(model.isSparseJacobianAvailable());
+        std::vector<double> jac = model.SparseJacobian(_x);
+        ASSERT_TRUE(compareValues(jac, _fun->Jacobian(_x)));
+
+        std::vector<double> jacSparse;
+        std::vector<size_t> row, col;
+        model.SparseJacobian(_x, jacSparse, row, col);
+        ASSERT_EQ(jacSparse.size(), row.size());
+        for (size_t e = 0; e < jacSparse.size(); ++e) {
+            ASSERT_NEAR(jacSparse[e], jac[row[e] * n + col[e]], 1e-10);
+        }
+
+        // Hessian
+        ASSERT_TRUE(model.isSparseHessianAvailable());
+        std::vector<double> hess = model.SparseHessian(_x, _w);
+        ASSERT_TRUE(compareValues(hess, _fun->Hessian(_x, _w)));
+
+        ASSERT_TRUE(model.isHessianAvailable());
+        std::vector<double> hessDense = model.Hessian(_x, _w);
+        ASSERT_TRUE(compareValues(hessDense, hess));
+
+        ASSERT_FALSE(model.isForwardOneAvailable());
+        ASSERT_FALSE(model.isReverseTwoAvailable());
+    }
+};
+
+} // END namespace
+
+TEST_F(CppADCGBytecodeTest, ForwardJacobianHessian) {
+    tape(3, SmallModel());
+
+    std::unique_ptr<BytecodeModelLibrary<double> > lib = createLibrary("bytecode_model");
+    ASSERT_EQ(lib->getModelNames().size(), 1u);
+
+    std::unique_ptr<GenericModel<double> > model = lib->model("bytecode_model");
+    ASSERT_TRUE(model != nullptr);
+    ASSERT_EQ(model->Domain(), 3u);
+    ASSERT_EQ(model->Range(), 5u);
+    testModel(*model);
+
+    // the other branch of the conditional expression
+    _x[1] = 0.2;
+    testModel(*model);
+
+    ASSERT_TRUE(lib->model("missing") == nullptr);
+}
+
+TEST_F(CppADCGBytecodeTest, SaveLoad) {
+    tape(3, SmallModel());
+
+    std::string data;
+    {
+        std::unique_ptr<BytecodeModelLibrary<double> > lib = createLibrary("bytecode_model");
+        std::ostringstream out;
+        lib->save(out);
+        data = out.str();
+    }
+
+    BytecodeModelLibrary<double> lib(data.data(), data.size());
+    std::unique_ptr<GenericModel<double> > model = lib.model("bytecode_model");
+    ASSERT_TRUE(model != nullptr);
+    testModel(*model);
+
+    // truncated data
+    ASSERT_THROW(BytecodeModelLibrary<double>(data.data(), data.size() - 1), CGException);
+
+    // not a bytecode library
+    ASSERT_THROW(BytecodeModelLibrary<double>(data.data() + 1, data.size() - 1), CGException);
+}
+
+TEST_F(CppADCGBytecodeTest, ManyRegisters) {
+    const size_t n = 300;
+
+    tape(n, LargeModel());
+
+    std::unique_ptr<BytecodeModelLibrary<double> > lib = createLibrary("large_model");
+    std::unique_ptr<GenericModel<double> > model = lib->model("large_model");
+
+    std::vector<double> y = model->ForwardZero(_x);
+    ASSERT_TRUE(compareValues(y, _fun->Forward(0, _x)));
+
+    std::vector<double> jacBytecode;
+    std::vector<size_t> rows, cols;
+    model->SparseJacobian(_x, jacBytecode, rows, cols);
+    std::vector<double> jacDense = _fun->Jacobian(_x);
+    for (size_t e = 0; e < jacBytecode.size(); ++e) {
+        ASSERT_NEAR(jacBytecode[e], jacDense[rows[e] * n + cols[e]], 1e-10);
+    }
+}
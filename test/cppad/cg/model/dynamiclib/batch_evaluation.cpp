@@ -0,0 +1,167 @@
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2020 Joao Leal
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+#include "CppADCGTest.hpp"
+#include "gccCompilerFlags.hpp"
+
+namespace CppAD {
+namespace cg {
+
+class CppADCGBatchTest : public CppADCGTest {
+protected:
+    const static size_t n;
+    const static size_t m;
+    const static size_t nPoints;
+    std::unique_ptr<ADFun<CGD>> _fun;
+    std::unique_ptr<DynamicLib<double>> _dynamicLib;
+    std::unique_ptr<GenericModel<double>> _model;
+    std::vector<double> _x; // AoS
+    std::vector<double> _w; // AoS
+public:
+
+    inline CppADCGBatchTest() :
+        _x(nPoints * n),
+        _w(nPoints * m) {
+        for (size_t p = 0; p < nPoints; ++p) {
+            for (size_t j = 0; j < n; ++j)
+                _x[p * n + j] = 0.5 + 0.1 * p + 0.3 * j;
+            for (size_t i = 0; i < m; ++i)
+                _w[p * m + i] = 1.0 + 0.2 * p - 0.5 * i;
+        }
+    }
+
+    void SetUp() override {
+        using ADCG = AD<CGD>;
+
+        std::vector<ADCG> u(n, 1.0);
+        CppAD::Independent(u);
+
+        std::vector<ADCG> y(m);
+        y[0] = cos(u[0]) * u[2];
+        y[1] = u[1] * u[2] + sin(u[0]);
+
+        _fun.reset(new ADFun<CGD>(u, y));
+    }
+
+    void TearDown() override {
+        _model.reset(nullptr);
+        _dynamicLib.reset(nullptr);
+        _fun.reset(nullptr);
+    }
+
+    void createModel(bool batch) {
+        ModelCSourceGen<double> compHelp(*_fun, "batch_model");
+        compHelp.setCreateForwardZero(true);
+        compHelp.setCreateSparseJacobian(true);
+        compHelp.setCreateSparseHessian(true);
+        compHelp.setCreateBatchEvaluation(batch);
+
+        ModelLibraryCSourceGen<double> compDynHelp(compHelp);
+
+        GccCompiler<double> compiler;
+        prepareTestCompilerFlags(compiler);
+
+        DynamicModelLibraryProcessor<double> p(compDynHelp, batch ? "batch_lib" : "batch_lib_no_batch");
+        _dynamicLib = p.createDynamicLibrary(compiler);
+        _model = _dynamicLib->model("batch_model");
+    }
+
+    static std::vector<double> toSoA(const std::vector<double>& aos, size_t size) {
+        std::vector<double> soa(aos.size());
+        for (size_t p = 0; p < nPoints; ++p) {
+            for (size_t j = 0; j < size; ++j)
+                soa[j * nPoints + p] = aos[p * size + j];
+        }
+        return soa;
+    }
+
+    void testBatch() {
+        std::vector<size_t> jacRow, jacCol, hessRow, hessCol;
+        _model->JacobianSparsity(jacRow, jacCol);
+        _model->HessianSparsity(hessRow, hessCol);
+        size_t jacNnz = jacRow.size();
+        size_t hessNnz = hessRow.size();
+
+        // single point evaluations
+        std::vector<double> y(nPoints * m), jac(nPoints * jacNnz), hess(nPoints * hessNnz), hessShared(nPoints * hessNnz);
+        size_t const* row;
+        size_t const* col;
+        for (size_t p = 0; p < nPoints; ++p) {
+            ArrayView<const double> xp(&_x[p * n], n);
+            _model->ForwardZero(xp, ArrayView<double>(&y[p * m], m));
+            _model->SparseJacobian(xp, ArrayView<double>(&jac[p * jacNnz], jacNnz), &row, &col);
+            _model->SparseHessian(xp, ArrayView<const double>(&_w[p * m], m),
+                                  ArrayView<double>(&hess[p * hessNnz], hessNnz), &row, &col);
+            _model->SparseHessian(xp, ArrayView<const double>(&_w[0], m),
+                                  ArrayView<double>(&hessShared[p * hessNnz], hessNnz), &row, &col);
+        }
+
+        // arrays of structures
+        std::vector<double> yb(y.size()), jacb(jac.size()), hessb(hess.size());
+        _model->ForwardZeroBatch(nPoints, _x, yb);
+        ASSERT_TRUE(compareValues(yb, y));
+
+        _model->SparseJacobianBatch(nPoints, _x, jacb);
+        ASSERT_TRUE(compareValues(jacb, jac));
+
+        _model->SparseHessianBatch(nPoints, _x, _w, hessb);
+        ASSERT_TRUE(compareValues(hessb, hess));
+
+        _model->SparseHessianBatch(nPoints, _x, ArrayView<const double>(&_w[0], m), hessb);
+        ASSERT_TRUE(compareValues(hessb, hessShared));
+
+        // structure of arrays
+        std::vector<double> xSoA = toSoA(_x, n);
+        std::vector<double> wSoA = toSoA(_w, m);
+
+        _model->ForwardZeroBatch(nPoints, xSoA, yb, BatchLayout::SoA);
+        ASSERT_TRUE(compareValues(yb, toSoA(y, m)));
+
+        _model->SparseJacobianBatch(nPoints, xSoA, jacb, BatchLayout::SoA);
+        ASSERT_TRUE(compareValues(jacb, toSoA(jac, jacNnz)));
+
+        _model->SparseHessianBatch(nPoints, xSoA, wSoA, hessb, BatchLayout::SoA);
+        ASSERT_TRUE(compareValues(hessb, toSoA(hess, hessNnz)));
+
+        _model->SparseHessianBatch(nPoints, xSoA, ArrayView<const double>(&_w[0], m), hessb, BatchLayout::SoA);
+        ASSERT_TRUE(compareValues(hessb, toSoA(hessShared, hessNnz)));
+
+        // no points
+        std::vector<double> empty;
+        _model->SparseJacobianBatch(0, empty, empty, BatchLayout::SoA);
+        _model->SparseHessianBatch(0, empty, empty, empty, BatchLayout::SoA);
+    }
+
+};
+
+const size_t CppADCGBatchTest::n = 3;
+const size_t CppADCGBatchTest::m = 2;
+const size_t CppADCGBatchTest::nPoints = 7;
+
+} // END cg namespace
+} // END CppAD namespace
+
+using namespace CppAD;
+using namespace CppAD::cg;
+
+TEST_F(CppADCGBatchTest, BatchEvaluation) {
+    createModel(true);
+    testBatch();
+}
+
+TEST_F(CppADCGBatchTest, BatchEvaluationFallback) {
+    // the library does not provide batch functions
+    createModel(false);
+    testBatch();
+}
@@ -0,0 +1,113 @@
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2020 Joao Leal
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+#include <dirent.h>
+#include "CppADCGTest.hpp"
+#include "gccCompilerFlags.hpp"
+
+using namespace CppAD;
+using namespace CppAD::cg;
+
+namespace {
+
+/**
+ * Deletes a folder and the files inside it when it goes out of scope
+ */
+class TemporaryFolder {
+private:
+    std::string _path;
+public:
+    inline explicit TemporaryFolder(std::string path) :
+        _path(std::move(path)) {
+    }
+
+    TemporaryFolder(const TemporaryFolder& orig) = delete;
+    TemporaryFolder& operator=(const TemporaryFolder& rhs) = delete;
+
+    inline ~TemporaryFolder() {
+        DIR* dir = opendir(_path.c_str());
+        if (dir != nullptr) {
+            while (struct dirent* entry = readdir(dir)) {
+                std::string name = entry->d_name;
+                if (name != "." && name != "..")
+                    std::remove(system::createPath(_path, name).c_str());
+            }
+            closedir(dir);
+        }
+        std::remove(_path.c_str());
+    }
+};
+
+} // END namespace
+
+TEST_F(CppADCGTest, CompileCache) {
+    // make sure the sources were never cached by previous executions
+    const std::string stamp = "/* " + std::to_string(std::chrono::system_clock::now().time_since_epoch().count()) + " */\n";
+
+    std::map<std::string, std::string> sources;
+    sources["cache_a.c"] = stamp + "double cache_a(double x) { return 2.0 * x; }\n";
+    sources["cache_b.c"] = stamp + "double cache_b(double x) { return 3.0 * x; }\n";
+
+    const std::string cacheFolder = "cppadcg_cache_test";
+    const std::string sourcesFolder = "cppadcg_cache_test_sources";
+    TemporaryFolder cacheCleanup(cacheFolder);
+    TemporaryFolder sourcesCleanup(sourcesFolder);
+
+    {
+        GccCompiler<double> compiler;
+        prepareTestCompilerFlags(compiler);
+        compiler.setCacheFolder(cacheFolder);
+        ASSERT_EQ(compiler.getCacheFolder(), cacheFolder);
+
+        compiler.compileSources(sources, true);
+        ASSERT_EQ(compiler.getObjectFiles().size(), sources.size());
+    }
+
+    // only the modified source should be compiled (and saved to disk)
+    sources["cache_b.c"] = stamp + "double cache_b(double x) { return 4.0 * x; }\n";
+
+    {
+        GccCompiler<double> compiler;
+        prepareTestCompilerFlags(compiler);
+        compiler.setCacheFolder(cacheFolder);
+        compiler.setSaveToDiskFirst(true);
+        compiler.setSourcesFolder(sourcesFolder);
+
+        compiler.compileSources(sources, true);
+        ASSERT_EQ(compiler.getObjectFiles().size(), sources.size());
+        for (const std::string& file : compiler.getObjectFiles()) {
+            ASSERT_TRUE(system::isFile(file));
+        }
+
+        ASSERT_FALSE(system::isFile(system::createPath(sourcesFolder, "cache_a.c")));
+        ASSERT_TRUE(system::isFile(system::createPath(sourcesFolder, "cache_b.c")));
+    }
+
+    // different compilation flags must not use the cached files
+    {
+        GccCompiler<double> compiler;
+        prepareTestCompilerFlags(compiler);
+        compiler.addCompileFlag("-DCPPADCG_CACHE_TEST");
+        compiler.setCacheFolder(cacheFolder);
+        compiler.setSaveToDiskFirst(true);
+        compiler.setSourcesFolder(sourcesFolder);
+
+        std::remove(system::createPath(sourcesFolder, "cache_b.c").c_str());
+
+        compiler.compileSources(sources, true);
+
+        ASSERT_TRUE(system::isFile(system::createPath(sourcesFolder, "cache_a.c")));
+        ASSERT_TRUE(system::isFile(system::createPath(sourcesFolder, "cache_b.c")));
+    }
+}
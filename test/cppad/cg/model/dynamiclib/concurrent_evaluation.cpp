@@ -0,0 +1,115 @@
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2020 Joao Leal
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+#include <thread>
+
+#include "CppADCGTest.hpp"
+#include "gccCompilerFlags.hpp"
+
+using namespace CppAD;
+using namespace CppAD::cg;
+
+/**
+ * Evaluates the same model object simultaneously from several threads
+ */
+TEST(CppADCGConcurrentTest, SameModelSeveralThreads) {
+    using CGD = CG<double>;
+    using ADCG = AD<CGD>;
+
+    const size_t n = 3;
+    const size_t m = 2;
+    const size_t nThreads = 4;
+    const size_t nRepeat = 200;
+
+    std::vector<ADCG> u(n, 1.0);
+    CppAD::Independent(u);
+
+    std::vector<ADCG> y(m);
+    y[0] = cos(u[0]) * u[2] + exp(u[1]);
+    y[1] = u[1] * u[2] / (1 + u[0] * u[0]);
+
+    ADFun<CGD> fun(u, y);
+
+    ModelCSourceGen<double> compHelp(fun, "concurrent_model");
+    compHelp.setCreateForwardZero(true);
+    compHelp.setCreateSparseJacobian(true);
+    compHelp.setCreateSparseHessian(true);
+    compHelp.setCreateForwardOne(true);
+    compHelp.setCreateReverseOne(true);
+
+    ModelLibraryCSourceGen<double> compDynHelp(compHelp);
+
+    GccCompiler<double> compiler;
+    prepareTestCompilerFlags(compiler);
+
+    DynamicModelLibraryProcessor<double> p(compDynHelp, "concurrent_lib");
+    std::unique_ptr<DynamicLib<double>> dynamicLib = p.createDynamicLibrary(compiler);
+    std::unique_ptr<GenericModel<double>> model = dynamicLib->model("concurrent_model");
+
+    std::vector<size_t> jacRow, jacCol, hessRow, hessCol;
+    model->JacobianSparsity(jacRow, jacCol);
+    model->HessianSparsity(hessRow, hessCol);
+    const size_t jacNnz = jacRow.size();
+    const size_t hessNnz = hessRow.size();
+
+    // different points for each thread
+    std::vector<std::vector<double> > x(nThreads, std::vector<double>(n)), w(nThreads, std::vector<double>(m));
+    std::vector<std::vector<double> > yRef(nThreads), jacRef(nThreads), hessRef(nThreads), pxRef(nThreads);
+    for (size_t t = 0; t < nThreads; ++t) {
+        for (size_t j = 0; j < n; ++j)
+            x[t][j] = 0.5 + 0.25 * t - 0.1 * j;
+        for (size_t i = 0; i < m; ++i)
+            w[t][i] = 1.0 - 0.3 * t + 0.2 * i;
+
+        size_t const* row;
+        size_t const* col;
+        yRef[t].resize(m);
+        jacRef[t].resize(jacNnz);
+        hessRef[t].resize(hessNnz);
+        pxRef[t].resize(n);
+        size_t idx = 1;
+        ArrayView<const double> xt(x[t]), wt(w[t]);
+        model->ForwardZero(xt, ArrayView<double>(yRef[t]));
+        model->SparseJacobian(xt, ArrayView<double>(jacRef[t]), &row, &col);
+        model->SparseHessian(xt, wt, ArrayView<double>(hessRef[t]), &row, &col);
+        model->ReverseOne(xt, ArrayView<double>(pxRef[t]), 1, &idx, &w[t][1]);
+    }
+
+    // evaluate simultaneously
+    std::vector<int> failures(nThreads, 0);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < nThreads; ++t) {
+        threads.emplace_back([&, t]() {
+            std::vector<double> yt(m), jac(jacNnz), hess(hessNnz), px(n);
+            size_t const* row;
+            size_t const* col;
+            size_t idx = 1;
+            ArrayView<const double> xt(x[t]), wt(w[t]);
+            for (size_t r = 0; r < nRepeat; ++r) {
+                model->ForwardZero(xt, ArrayView<double>(yt));
+                model->SparseJacobian(xt, ArrayView<double>(jac), &row, &col);
+                model->SparseHessian(xt, wt, ArrayView<double>(hess), &row, &col);
+                model->ReverseOne(xt, ArrayView<double>(px), 1, &idx, &w[t][1]);
+                if (yt != yRef[t] || jac != jacRef[t] || hess != hessRef[t] || px != pxRef[t])
+                    failures[t]++;
+            }
+        });
+    }
+    for (auto& th : threads)
+        th.join();
+
+    for (size_t t = 0; t < nThreads; ++t) {
+        ASSERT_EQ(failures[t], 0);
+    }
+}
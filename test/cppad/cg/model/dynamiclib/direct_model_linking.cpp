@@ -0,0 +1,109 @@
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2020 Joao Leal
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+#include "CppADCGTest.hpp"
+#include "gccCompilerFlags.hpp"
+
+using namespace CppAD;
+using namespace CppAD::cg;
+
+namespace {
+
+using CGD = CG<double>;
+using ADCG = AD<CGD>;
+
+/**
+ * Compiles a library with an inner model and an outer model which uses
+ * the inner model as an atomic function
+ */
+std::unique_ptr<DynamicLib<double>> createLibrary(const std::string& libName,
+                                                  bool link) {
+    // inner model
+    std::vector<ADCG> u(2, 1.0);
+    CppAD::Independent(u);
+
+    std::vector<ADCG> z(2);
+    z[0] = u[0] * u[1];
+    z[1] = sin(u[0]) + u[1] * u[1];
+
+    ADFun<CGD> funInner(u, z);
+
+    // outer model
+    CGAtomicFunBridge<double> atomicInner("inner", funInner, true);
+
+    std::vector<ADCG> u2(3, 1.0);
+    CppAD::Independent(u2);
+
+    std::vector<ADCG> ax{u2[0], u2[1] * u2[2]}, az(2);
+    atomicInner(ax, az);
+
+    std::vector<ADCG> y(2);
+    y[0] = az[0] * u2[2];
+    y[1] = az[1] + exp(u2[0]);
+
+    ADFun<CGD> funOuter(u2, y);
+
+    ModelCSourceGen<double> compHelpInner(funInner, "inner");
+    compHelpInner.setCreateForwardOne(true);
+    compHelpInner.setCreateReverseOne(true);
+    compHelpInner.setCreateReverseTwo(true);
+
+    ModelCSourceGen<double> compHelpOuter(funOuter, "outer");
+    compHelpOuter.setCreateSparseJacobian(true);
+    compHelpOuter.setCreateSparseHessian(true);
+
+    ModelLibraryCSourceGen<double> compDynHelp(compHelpInner, compHelpOuter);
+    compDynHelp.setDirectModelLinking(link);
+
+    GccCompiler<double> compiler;
+    prepareTestCompilerFlags(compiler);
+
+    DynamicModelLibraryProcessor<double> p(compDynHelp, libName);
+    return p.createDynamicLibrary(compiler);
+}
+
+} // END namespace
+
+TEST(CppADCGDirectModelLinkingTest, LinkedInnerModel) {
+    std::unique_ptr<DynamicLib<double>> libRef = createLibrary("direct_linking_ref", false);
+    std::unique_ptr<DynamicLib<double>> libLinked = createLibrary("direct_linking", true);
+
+    std::unique_ptr<GenericModel<double>> innerRef = libRef->model("inner");
+    std::unique_ptr<GenericModel<double>> outerRef = libRef->model("outer");
+    outerRef->addExternalModel(*innerRef);
+
+    // the inner model does not have to be provided
+    std::unique_ptr<GenericModel<double>> outer = libLinked->model("outer");
+    ASSERT_EQ(outer->getAtomicFunctionNames(), std::vector<std::string>{"inner"});
+
+    std::vector<double> x{0.5, 1.3, -0.7};
+    std::vector<double> w{1.5, -0.4};
+
+    ASSERT_TRUE(compareValues(outer->ForwardZero(x), outerRef->ForwardZero(x)));
+
+    std::vector<double> jac, jacRef;
+    std::vector<size_t> row, col, rowRef, colRef;
+    outer->SparseJacobian(x, jac, row, col);
+    outerRef->SparseJacobian(x, jacRef, rowRef, colRef);
+    ASSERT_EQ(row, rowRef);
+    ASSERT_EQ(col, colRef);
+    ASSERT_TRUE(compareValues(jac, jacRef));
+
+    std::vector<double> hess, hessRef;
+    outer->SparseHessian(x, w, hess, row, col);
+    outerRef->SparseHessian(x, w, hessRef, rowRef, colRef);
+    ASSERT_EQ(row, rowRef);
+    ASSERT_EQ(col, colRef);
+    ASSERT_TRUE(compareValues(hess, hessRef));
+}
@@ -0,0 +1,165 @@
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2020 Joao Leal
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+#include "CppADCGTest.hpp"
+#include "gccCompilerFlags.hpp"
+
+using namespace CppAD;
+using namespace CppAD::cg;
+
+namespace {
+
+template<class T>
+std::vector<T> lazyModel(const std::vector<T>& x, double c) {
+    std::vector<T> y(2);
+    y[0] = cos(x[0]) * x[1] + c;
+    y[1] = x[0] * x[1] * x[1];
+    return y;
+}
+
+using SparsityFunction = void (*)(unsigned long const**, unsigned long const**, unsigned long*);
+
+SparsityFunction jacobianSparsity = nullptr;
+size_t jacobianSparsityCalls = 0;
+
+void countingJacobianSparsity(unsigned long const** row,
+                              unsigned long const** col,
+                              unsigned long* nnz) {
+    jacobianSparsityCalls++;
+    (*jacobianSparsity)(row, col, nnz);
+}
+
+/**
+ * Records the functions requested by the models and counts the calls to
+ * the Jacobian sparsity functions.
+ */
+class LoadCountingLib : public LinuxDynamicLib<double> {
+public:
+    std::map<std::string, size_t> loaded;
+
+    explicit LoadCountingLib(std::string dynLibName) :
+        LinuxDynamicLib<double>(std::move(dynLibName), RTLD_LAZY) {
+    }
+
+    void* loadFunction(const std::string& functionName, bool required = true) override {
+        loaded[functionName]++;
+
+        void* f = LinuxDynamicLib<double>::loadFunction(functionName, required);
+        const std::string& suffix = ModelCSourceGen<double>::FUNCTION_JACOBIAN_SPARSITY;
+        if (f != nullptr && functionName.size() > suffix.size() &&
+            functionName.compare(functionName.size() - suffix.size(), suffix.size(), suffix) == 0) {
+            jacobianSparsity = reinterpret_cast<SparsityFunction>(f);
+            return reinterpret_cast<void*>(&countingJacobianSparsity);
+        }
+        return f;
+    }
+
+    inline size_t loadCount(const std::string& modelName,
+                            const std::string& function) const {
+        auto it = loaded.find(modelName + "_" + function);
+        return it != loaded.end() ? it->second : 0;
+    }
+};
+
+} // END namespace
+
+/**
+ * Models are created without resolving all the functions in the library
+ * (which is opened with RTLD_LAZY).
+ */
+TEST_F(CppADCGTest, LazyLoading) {
+    using ADCG = AD<CGD>;
+    const size_t n = 2;
+    const size_t nModels = 3;
+
+    std::vector<std::unique_ptr<ADFun<CGD>>> funs(nModels);
+    std::vector<std::unique_ptr<ModelCSourceGen<double>>> sources(nModels);
+    for (size_t k = 0; k < nModels; ++k) {
+        std::vector<ADCG> u(n, 1.0);
+        CppAD::Independent(u);
+        std::vector<ADCG> y = lazyModel(u, double(k));
+        funs[k].reset(new ADFun<CGD>(u, y));
+
+        sources[k].reset(new ModelCSourceGen<double>(*funs[k], "lazy_model_" + std::to_string(k)));
+        sources[k]->setCreateForwardZero(true);
+        sources[k]->setCreateSparseJacobian(true);
+        sources[k]->setCreateForwardOne(true);
+    }
+
+    ModelLibraryCSourceGen<double> compDynHelp(*sources[0], *sources[1], *sources[2]);
+
+    GccCompiler<double> compiler;
+    prepareTestCompilerFlags(compiler);
+
+    DynamicModelLibraryProcessor<double> p(compDynHelp, "lazy_lib");
+    p.getOptions()["dlOpenMode"] = "lazy";
+    std::unique_ptr<DynamicLib<double>> dynamicLib = p.createDynamicLibrary(compiler);
+
+    // the same library opened again so that the requested functions are recorded
+    using Gen = ModelCSourceGen<double>;
+    const std::string name = "lazy_model_2";
+    LoadCountingLib countingLib(p.getLibraryName() + system::SystemInfo<>::DYNAMIC_LIB_EXTENSION);
+
+    std::vector<double> x{0.5, 1.5};
+    std::unique_ptr<FunctorGenericModel<double>> model = countingLib.modelFunctor(name);
+    ASSERT_TRUE(model != nullptr);
+    GenericModel<double>& m = *model;
+
+    // no evaluation function is resolved when the model is created
+    ASSERT_EQ(countingLib.loadCount(name, Gen::FUNCTION_FORWAD_ZERO), 0u);
+    ASSERT_EQ(countingLib.loadCount(name, Gen::FUNCTION_SPARSE_JACOBIAN), 0u);
+    ASSERT_EQ(countingLib.loadCount(name, Gen::FUNCTION_JACOBIAN_SPARSITY), 0u);
+    ASSERT_EQ(countingLib.loadCount(name, Gen::FUNCTION_FORWARD_ONE), 0u);
+
+    std::vector<double> y = m.ForwardZero(x);
+    ASSERT_TRUE(compareValues(y, lazyModel(x, 2.0)));
+    y = m.ForwardZero(x);
+    ASSERT_TRUE(compareValues(y, lazyModel(x, 2.0)));
+
+    // only the used function is resolved (once)
+    ASSERT_EQ(countingLib.loadCount(name, Gen::FUNCTION_FORWAD_ZERO), 1u);
+    ASSERT_EQ(countingLib.loadCount(name, Gen::FUNCTION_SPARSE_JACOBIAN), 0u);
+    ASSERT_EQ(countingLib.loadCount(name, Gen::FUNCTION_JACOBIAN_SPARSITY), 0u);
+
+    // the sparsity pattern is only loaded once
+    std::vector<size_t> rows, cols, rows2, cols2;
+    m.JacobianSparsity(rows, cols);
+    std::vector<double> jac;
+    m.SparseJacobian(x, jac, rows2, cols2);
+    m.SparseJacobian(x, jac, rows2, cols2);
+    ASSERT_EQ(rows, rows2);
+    ASSERT_EQ(cols, cols2);
+    ASSERT_EQ(jac.size(), 4u);
+    ASSERT_EQ(countingLib.loadCount(name, Gen::FUNCTION_JACOBIAN_SPARSITY), 1u);
+    ASSERT_EQ(countingLib.loadCount(name, Gen::FUNCTION_SPARSE_JACOBIAN), 1u);
+    ASSERT_EQ(jacobianSparsityCalls, 1u);
+
+    // the functions of the other models are never resolved
+    for (const auto& it : countingLib.loaded) {
+        ASSERT_EQ(it.first.find("lazy_model_0"), std::string::npos);
+        ASSERT_EQ(it.first.find("lazy_model_1"), std::string::npos);
+    }
+
+    ASSERT_TRUE(model->isForwardOneAvailable());
+    ASSERT_FALSE(model->isReverseTwoAvailable());
+    ASSERT_FALSE(model->isSparseHessianAvailable());
+
+    ASSERT_NO_THROW(model->resolveFunctions());
+
+    // functions cannot be resolved after the library is closed
+    std::unique_ptr<FunctorGenericModel<double>> model2 = dynamicLib->modelFunctor("lazy_model_1");
+    dynamicLib.reset();
+    ASSERT_FALSE(model2->isForwardZeroAvailable());
+    ASSERT_FALSE(model2->isSparseJacobianAvailable());
+}
@@ -0,0 +1,77 @@
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2020 Joao Leal
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+#include "CppADCGTest.hpp"
+#include "gccCompilerFlags.hpp"
+
+using namespace CppAD;
+using namespace CppAD::cg;
+
+TEST_F(CppADCGTest, LinkTimeOptimization) {
+    using ADCG = AD<CGD>;
+
+    std::vector<ADCG> u(3, 1.0);
+    CppAD::Independent(u);
+
+    std::vector<ADCG> y(2);
+    y[0] = cos(u[0]) * u[2];
+    y[1] = u[1] * u[2] + sin(u[0]);
+
+    ADFun<CGD> fun(u, y);
+
+    ModelCSourceGen<double> compHelp(fun, "lto_model");
+    compHelp.setCreateSparseJacobian(true);
+    compHelp.setCreateSparseHessian(true);
+    compHelp.setMaxAssignmentsPerFunc(1); // several source files
+
+    ModelLibraryCSourceGen<double> compDynHelp(compHelp);
+
+    GccCompiler<double> compiler;
+    prepareTestCompilerFlags(compiler);
+    compiler.setLinkTimeOptimization(true);
+    ASSERT_TRUE(compiler.isLinkTimeOptimization());
+
+    DynamicModelLibraryProcessor<double> p(compDynHelp, "lto_lib");
+    std::unique_ptr<DynamicLib<double>> dynamicLib = p.createDynamicLibrary(compiler);
+    std::unique_ptr<GenericModel<double>> model = dynamicLib->model("lto_model");
+    ASSERT_TRUE(model != nullptr);
+
+    std::vector<double> x{0.5, 0.8, 1.2};
+    std::vector<double> w{1.5, -0.7};
+
+    std::vector<double> jac, jacRef;
+    std::vector<size_t> row, col;
+    model->SparseJacobian(x, jac, row, col);
+
+    std::vector<double> jacDense(2 * 3, 0.0);
+    jacDense[0 * 3 + 0] = -std::sin(x[0]) * x[2];
+    jacDense[0 * 3 + 2] = std::cos(x[0]);
+    jacDense[1 * 3 + 0] = std::cos(x[0]);
+    jacDense[1 * 3 + 1] = x[2];
+    jacDense[1 * 3 + 2] = x[1];
+    for (size_t e = 0; e < row.size(); ++e)
+        jacRef.push_back(jacDense[row[e] * 3 + col[e]]);
+    ASSERT_TRUE(compareValues(jac, jacRef));
+
+    std::vector<double> hess, hessRef;
+    model->SparseHessian(x, w, hess, row, col);
+
+    std::vector<double> hessDense(3 * 3, 0.0);
+    hessDense[0 * 3 + 0] = -w[0] * std::cos(x[0]) * x[2] - w[1] * std::sin(x[0]);
+    hessDense[0 * 3 + 2] = hessDense[2 * 3 + 0] = -w[0] * std::sin(x[0]);
+    hessDense[1 * 3 + 2] = hessDense[2 * 3 + 1] = w[1];
+    for (size_t e = 0; e < row.size(); ++e)
+        hessRef.push_back(hessDense[row[e] * 3 + col[e]]);
+    ASSERT_TRUE(compareValues(hess, hessRef));
+}
@@ -0,0 +1,75 @@
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2020 Joao Leal
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+#include "CppADCGTest.hpp"
+#include "gccCompilerFlags.hpp"
+
+using namespace CppAD;
+using namespace CppAD::cg;
+
+namespace {
+
+std::map<std::string, std::string> createSources(size_t n) {
+    std::map<std::string, std::string> sources;
+    for (size_t i = 0; i < n; ++i) {
+        std::string name = "parallel_" + std::to_string(i);
+        sources[name + ".c"] = "double " + name + "(double x) {\n"
+                               "   return x * " + std::to_string(i + 1) + ".0;\n"
+                               "}\n";
+    }
+    return sources;
+}
+
+}
+
+TEST_F(CppADCGTest, ParallelCompile) {
+    std::map<std::string, std::string> sources = createSources(12);
+
+    GccCompiler<double> compiler;
+    prepareTestCompilerFlags(compiler);
+    compiler.setTemporaryFolder("cppadcg_tmp_parallel");
+    compiler.setMaxJobs(4);
+    ASSERT_EQ(compiler.getMaxJobs(), 4);
+
+    JobTimer timer;
+    compiler.compileSources(sources, true, &timer);
+
+    ASSERT_EQ(timer.getJobCount(), 0);
+    ASSERT_EQ(compiler.getObjectFiles().size(), sources.size());
+    for (const std::string& file : compiler.getObjectFiles()) {
+        ASSERT_TRUE(system::isFile(file));
+    }
+}
+
+TEST_F(CppADCGTest, ParallelCompileError) {
+    std::map<std::string, std::string> sources = createSources(12);
+    sources["parallel_5.c"] = "double parallel_5(double x) { return x * ; }\n";
+
+    GccCompiler<double> compiler;
+    prepareTestCompilerFlags(compiler);
+    compiler.setTemporaryFolder("cppadcg_tmp_parallel_error");
+    compiler.setMaxJobs(4);
+
+    JobTimer timer;
+    ASSERT_THROW(compiler.compileSources(sources, true, &timer), CGException);
+    ASSERT_EQ(timer.getJobCount(), 0);
+}
+
+TEST_F(CppADCGTest, MaxJobsDefault) {
+    GccCompiler<double> compiler;
+    ASSERT_GE(compiler.getMaxJobs(), 1);
+
+    compiler.setMaxJobs(0);
+    ASSERT_GE(compiler.getMaxJobs(), 1);
+}
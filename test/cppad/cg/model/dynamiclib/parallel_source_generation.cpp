@@ -0,0 +1,157 @@
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2020 Joao Leal
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+#include "CppADCGTest.hpp"
+#include "gccCompilerFlags.hpp"
+
+using namespace CppAD;
+using namespace CppAD::cg;
+
+namespace {
+
+template<class T>
+std::vector<T> directionalModel(const std::vector<T>& x) {
+    size_t n = x.size();
+    std::vector<T> y(n);
+    for (size_t i = 0; i < n; ++i) {
+        y[i] = sin(x[i]) * x[(i + 1) % n] + x[(i + 2) % n] * x[i] * x[i];
+    }
+    return y;
+}
+
+/**
+ * Provides access to the generated model sources
+ */
+class SourcesProcessor : public ModelLibraryProcessor<double> {
+public:
+    inline explicit SourcesProcessor(ModelLibraryCSourceGen<double>& libSourceGen) :
+        ModelLibraryProcessor<double>(libSourceGen) {
+    }
+
+    inline std::map<std::string, std::string> sources(ModelCSourceGen<double>& model) {
+        return getSources(model);
+    }
+};
+
+std::unique_ptr<ModelCSourceGen<double>> createSourceGen(ADFun<CGD>& fun,
+                                                         size_t maxJobs) {
+    std::unique_ptr<ModelCSourceGen<double>> sourceGen(new ModelCSourceGen<double>(fun, "dir_model"));
+    sourceGen->setCreateForwardOne(true);
+    sourceGen->setCreateReverseOne(true);
+    sourceGen->setCreateReverseTwo(true);
+    sourceGen->setMaxSourceGenerationJobs(maxJobs);
+    return sourceGen;
+}
+
+} // END namespace
+
+/**
+ * The directional functions created concurrently must be the same as the
+ * ones created by a single thread.
+ */
+TEST_F(CppADCGTest, ParallelSourceGeneration) {
+    using ADCG = AD<CGD>;
+    const size_t n = 12;
+
+    std::vector<ADCG> u(n, 1.0);
+    CppAD::Independent(u);
+    std::vector<ADCG> v = directionalModel(u);
+    ADFun<CGD> fun(u, v);
+
+    std::unique_ptr<ModelCSourceGen<double>> sequential = createSourceGen(fun, 1);
+    std::unique_ptr<ModelCSourceGen<double>> concurrent = createSourceGen(fun, 4);
+    ASSERT_EQ(sequential->getMaxSourceGenerationJobs(), 1u);
+    ASSERT_EQ(concurrent->getMaxSourceGenerationJobs(), 4u);
+
+    ModelLibraryCSourceGen<double> seqLibSourceGen(*sequential);
+    ModelLibraryCSourceGen<double> conLibSourceGen(*concurrent);
+
+    std::map<std::string, std::string> seqSources = SourcesProcessor(seqLibSourceGen).sources(*sequential);
+    std::map<std::string, std::string> conSources = SourcesProcessor(conLibSourceGen).sources(*concurrent);
+
+    ASSERT_EQ(seqSources.size(), conSources.size());
+    for (const auto& it : seqSources) {
+        auto itCon = conSources.find(it.first);
+        ASSERT_TRUE(itCon != conSources.end()) << it.first;
+        ASSERT_EQ(it.second, itCon->second) << it.first;
+    }
+
+    /**
+     * evaluate the functions created concurrently
+     */
+    GccCompiler<double> compiler;
+    prepareTestCompilerFlags(compiler);
+
+    DynamicModelLibraryProcessor<double> p(conLibSourceGen, "dir_model_lib");
+    std::unique_ptr<DynamicLib<double>> dynamicLib = p.createDynamicLibrary(compiler);
+    std::unique_ptr<GenericModel<double>> model = dynamicLib->model("dir_model");
+    ASSERT_TRUE(model != nullptr);
+
+    std::vector<AD<double>> ud(n, 1.0);
+    CppAD::Independent(ud);
+    std::vector<AD<double>> vd = directionalModel(ud);
+    ADFun<double> funD(ud, vd);
+
+    std::vector<double> x(n);
+    for (size_t j = 0; j < n; ++j)
+        x[j] = 0.5 + 0.1 * j;
+    std::vector<double> y = funD.Forward(0, x);
+
+    // forward one
+    std::vector<double> tx(2 * n, 0.0), ty(2 * n, 0.0);
+    for (size_t j = 0; j < n; ++j) {
+        tx[j * 2] = x[j];
+        ty[j * 2] = y[j];
+    }
+    for (size_t j = 0; j < n; ++j) {
+        tx[j * 2 + 1] = 1.0;
+        std::vector<double> dx(n, 0.0);
+        dx[j] = 1.0;
+        std::vector<double> dyOrig = funD.Forward(1, dx);
+
+        std::vector<double> dy = model->ForwardOne(tx);
+        for (size_t i = 0; i < n; ++i) {
+            ASSERT_NEAR(dy[i * 2 + 1], dyOrig[i], 1e-10);
+        }
+        tx[j * 2 + 1] = 0.0;
+    }
+
+    // reverse one
+    for (size_t i = 0; i < n; ++i) {
+        std::vector<double> w(n, 0.0);
+        w[i] = 1.0;
+        std::vector<double> dwOrig = funD.Reverse(1, w);
+        std::vector<double> dw = model->ReverseOne(x, y, w);
+        ASSERT_TRUE(compareValues(dw, dwOrig));
+    }
+
+    // reverse two
+    std::vector<double> py(2 * n, 0.0);
+    for (size_t i = 0; i < n; ++i) {
+        py[i * 2 + 1] = 1.0 - 0.05 * i;
+    }
+    for (size_t j = 0; j < n; ++j) {
+        std::vector<double> dx(n, 0.0);
+        dx[j] = 1.0;
+        funD.Forward(1, dx);
+        std::vector<double> ddwOrig = funD.Reverse(2, py);
+
+        tx[j * 2 + 1] = 1.0;
+        std::vector<double> ddw = model->ReverseTwo(tx, ty, py);
+        tx[j * 2 + 1] = 0.0;
+        for (size_t k = 0; k < n; ++k) {
+            ASSERT_NEAR(ddw[k * 2], ddwOrig[k * 2], 1e-10);
+        }
+    }
+}
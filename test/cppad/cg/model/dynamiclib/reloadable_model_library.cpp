@@ -0,0 +1,129 @@
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2020 Joao Leal
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+#include <thread>
+
+#include "CppADCGTest.hpp"
+#include "gccCompilerFlags.hpp"
+
+using namespace CppAD;
+using namespace CppAD::cg;
+
+namespace {
+
+/**
+ * Compiles a model library where y = factor * x
+ */
+std::unique_ptr<DynamicLib<double>> createLibrary(double factor,
+                                                  const std::string& libName,
+                                                  bool load) {
+    using CGD = CG<double>;
+    using ADCG = AD<CGD>;
+
+    std::vector<ADCG> u(1, 1.0);
+    CppAD::Independent(u);
+
+    std::vector<ADCG> y(1);
+    y[0] = factor * u[0];
+
+    ADFun<CGD> fun(u, y);
+
+    ModelCSourceGen<double> compHelp(fun, "reload_model");
+    compHelp.setCreateForwardZero(true);
+
+    ModelLibraryCSourceGen<double> compDynHelp(compHelp);
+
+    GccCompiler<double> compiler;
+    prepareTestCompilerFlags(compiler);
+
+    DynamicModelLibraryProcessor<double> p(compDynHelp, libName);
+    return p.createDynamicLibrary(compiler, load);
+}
+
+double evaluate(ReloadableModelLibrary<double>::Version& version,
+                double x) {
+    GenericModel<double>* model = version.model("reload_model");
+    std::vector<double> xv{x}, yv(1);
+    model->ForwardZero(ArrayView<const double>(xv), ArrayView<double>(yv));
+    return yv[0];
+}
+
+} // END namespace
+
+TEST(CppADCGReloadableModelLibraryTest, ReloadWhileEvaluating) {
+    using VersionPtr = ReloadableModelLibrary<double>::VersionPtr;
+
+    // the second version is only compiled here and loaded in the background
+    createLibrary(3.0, "reload_lib_v2", false);
+
+    std::atomic<size_t> initialized(0);
+    ReloadableModelLibrary<double> lib(createLibrary(2.0, "reload_lib_v1", true),
+                                       [&](GenericModel<double>&) { initialized++; });
+    ASSERT_EQ(lib.getVersionNumber(), 1u);
+
+    VersionPtr v1 = lib.acquire();
+    ASSERT_EQ(evaluate(*v1, 1.5), 3.0);
+    ASSERT_TRUE(v1->model("missing") == nullptr);
+    ASSERT_EQ(initialized.load(), 1u);
+
+    std::atomic<bool> stop(false);
+    std::atomic<bool> failed(false);
+    std::atomic<unsigned long> lastSeen(0);
+
+    std::thread reader([&]() {
+        while (!stop) {
+            VersionPtr v = lib.acquire();
+            double y = evaluate(*v, 1.5);
+            double expected = v->getNumber() == 1 ? 3.0 : 4.5;
+            if (y != expected)
+                failed = true;
+            lastSeen = v->getNumber();
+        }
+    });
+
+    std::shared_future<unsigned long> reload = lib.reloadAsync([]() {
+        return std::unique_ptr<ModelLibrary<double>>(new LinuxDynamicLib<double>("reload_lib_v2" + system::SystemInfo<>::DYNAMIC_LIB_EXTENSION));
+    });
+    ASSERT_EQ(reload.get(), 2u);
+    ASSERT_FALSE(lib.isReloading());
+    ASSERT_EQ(lib.getVersionNumber(), 2u);
+
+    // the model used in the first version was created before publishing the new version
+    ASSERT_EQ(initialized.load(), 2u);
+
+    while (lastSeen != 2) {
+        std::this_thread::yield();
+    }
+    stop = true;
+    reader.join();
+    ASSERT_FALSE(failed);
+
+    // the previous version can still be used while it is held
+    ASSERT_EQ(evaluate(*v1, 1.5), 3.0);
+    ASSERT_EQ(lib.reclaim(), 1u);
+
+    std::weak_ptr<ReloadableModelLibrary<double>::Version> released = v1;
+    v1.reset();
+    ASSERT_EQ(lib.reclaim(), 0u);
+    ASSERT_TRUE(released.expired());
+
+    ASSERT_EQ(evaluate(*lib.acquire(), 1.5), 4.5);
+
+    // failed loads do not change the current version
+    std::shared_future<unsigned long> failedReload = lib.reloadAsync([]() {
+        return std::unique_ptr<ModelLibrary<double>>();
+    });
+    ASSERT_THROW(failedReload.get(), CGException);
+    ASSERT_EQ(lib.getVersionNumber(), 2u);
+}
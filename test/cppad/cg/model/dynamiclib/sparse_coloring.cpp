@@ -0,0 +1,204 @@
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2020 Joao Leal
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+#include "CppADCGTest.hpp"
+#include "gccCompilerFlags.hpp"
+
+using namespace CppAD;
+using namespace CppAD::cg;
+
+namespace {
+
+/**
+ * A banded model
+ */
+template<class T>
+std::vector<T> bandedModel(const std::vector<T>& x) {
+    size_t n = x.size();
+    std::vector<T> y(n);
+    for (size_t i = 0; i < n; ++i) {
+        y[i] = x[i] * x[i] * 0.5;
+        if (i > 0)
+            y[i] += cos(x[i - 1]) * x[i];
+        if (i + 1 < n)
+            y[i] += x[i + 1] * x[i + 1] * x[i];
+    }
+    return y;
+}
+
+/**
+ * Provides access to the generated model sources
+ */
+class SourcesProcessor : public ModelLibraryProcessor<double> {
+public:
+    inline explicit SourcesProcessor(ModelLibraryCSourceGen<double>& libSourceGen) :
+        ModelLibraryProcessor<double>(libSourceGen) {
+    }
+
+    inline std::map<std::string, std::string> sources(ModelCSourceGen<double>& model) {
+        return getSources(model);
+    }
+};
+
+class CppADCGSparseColoringTest : public CppADCGTest {
+protected:
+    static const size_t n = 12;
+    std::unique_ptr<ADFun<CGD>> _funCG;
+    std::unique_ptr<ADFun<double>> _fun;
+    std::vector<double> _x;
+    std::vector<double> _w;
+    std::vector<double> _jac;
+    std::vector<double> _hess;
+public:
+
+    void SetUp() override {
+        using ADCG = AD<CGD>;
+
+        std::vector<ADCG> u(n, 1.0);
+        CppAD::Independent(u);
+        std::vector<ADCG> v = bandedModel(u);
+        _funCG.reset(new ADFun<CGD>(u, v));
+
+        std::vector<AD<double>> ud(n, 1.0);
+        CppAD::Independent(ud);
+        std::vector<AD<double>> vd = bandedModel(ud);
+        _fun.reset(new ADFun<double>(ud, vd));
+
+        _x.resize(n);
+        _w.resize(n);
+        for (size_t j = 0; j < n; ++j) {
+            _x[j] = 0.5 + 0.1 * j;
+            _w[j] = 1.0 - 0.05 * j;
+        }
+
+        _jac = _fun->Jacobian(_x);
+        _hess = _fun->Hessian(_x, _w);
+    }
+
+    void testModel(GenericModel<double>& model) {
+        std::vector<double> jac, hess;
+        std::vector<size_t> row, col;
+
+        model.SparseJacobian(_x, jac, row, col);
+        ASSERT_EQ(jac.size(), row.size());
+        for (size_t e = 0; e < jac.size(); ++e) {
+            ASSERT_NEAR(jac[e], _jac[row[e] * n + col[e]], 1e-10) << "(" << row[e] << ", " << col[e] << ")";
+        }
+
+        model.SparseHessian(_x, _w, hess, row, col);
+        ASSERT_EQ(hess.size(), row.size());
+        for (size_t e = 0; e < hess.size(); ++e) {
+            ASSERT_NEAR(hess[e], _hess[row[e] * n + col[e]], 1e-10) << "(" << row[e] << ", " << col[e] << ")";
+        }
+    }
+
+    std::unique_ptr<ModelCSourceGen<double>> createSourceGen(const std::string& name,
+                                                             JacobianADMode mode) {
+        std::unique_ptr<ModelCSourceGen<double>> sourceGen(new ModelCSourceGen<double>(*_funCG, name));
+        sourceGen->setCreateSparseJacobian(true);
+        sourceGen->setCreateSparseHessian(true);
+        sourceGen->setSparseJacobianColoring(true);
+        sourceGen->setSparseHessianColoring(true);
+        sourceGen->setJacobianADMode(mode);
+        return sourceGen;
+    }
+};
+
+} // END namespace
+
+TEST_F(CppADCGSparseColoringTest, JacobianHessian) {
+    std::unique_ptr<ModelCSourceGen<double>> forward = createSourceGen("coloring_forward", JacobianADMode::Forward);
+    std::unique_ptr<ModelCSourceGen<double>> reverse = createSourceGen("coloring_reverse", JacobianADMode::Reverse);
+
+    /**
+     * custom elements (in a different order, with repeated elements, and
+     * with structural zeros)
+     */
+    std::unique_ptr<ModelCSourceGen<double>> custom = createSourceGen("coloring_custom", JacobianADMode::Forward);
+    std::vector<size_t> jacRow{5, 0, 3, 0, 11, 2, 7};
+    std::vector<size_t> jacCol{4, 1, 3, 9, 11, 3, 8};
+    custom->setCustomSparseJacobianElements(jacRow, jacCol);
+    std::vector<size_t> hessRow{1, 0, 2, 5, 4, 3, 10};
+    std::vector<size_t> hessCol{0, 1, 1, 5, 7, 4, 11};
+    custom->setCustomSparseHessianElements(hessRow, hessCol);
+
+    ModelLibraryCSourceGen<double> libSourceGen(*forward, *reverse, *custom);
+
+    GccCompiler<double> compiler;
+    prepareTestCompilerFlags(compiler);
+
+    DynamicModelLibraryProcessor<double> p(libSourceGen, "coloring_lib");
+    std::unique_ptr<DynamicLib<double>> dynamicLib = p.createDynamicLibrary(compiler);
+
+    // one compressed function for each color (tridiagonal Jacobian and Hessian)
+    std::map<std::string, std::string> sources = SourcesProcessor(libSourceGen).sources(*forward);
+    size_t nJacColors = 0, nHessColors = 0;
+    for (const auto& it : sources) {
+        if (it.first.find("coloring_forward_sparse_jacobian_color") == 0)
+            nJacColors++;
+        else if (it.first.find("coloring_forward_sparse_hessian_color") == 0)
+            nHessColors++;
+    }
+    ASSERT_EQ(nJacColors, 3u);
+    ASSERT_GT(nHessColors, 0u);
+    ASSERT_LE(nHessColors, 3u);
+
+    for (const std::string& name : {"coloring_forward", "coloring_reverse", "coloring_custom"}) {
+        std::unique_ptr<GenericModel<double>> model = dynamicLib->model(name);
+        ASSERT_TRUE(model != nullptr);
+        testModel(*model);
+    }
+}
+
+TEST_F(CppADCGSparseColoringTest, AtomicConcurrentSourceGeneration) {
+    using ADCG = AD<CGD>;
+
+    /**
+     * the outer model only calls the banded model as an atomic function
+     */
+    CGAtomicFunBridge<double> atomicBanded("coloring_banded", *_funCG, true);
+
+    std::vector<ADCG> u(n, 1.0);
+    CppAD::Independent(u);
+    std::vector<ADCG> v(n);
+    atomicBanded(u, v);
+    ADFun<CGD> funOuter(u, v);
+
+    ModelCSourceGen<double> inner(*_funCG, "coloring_banded");
+    inner.setCreateForwardOne(true);
+    inner.setCreateReverseOne(true);
+    inner.setCreateReverseTwo(true);
+
+    ModelCSourceGen<double> outer(funOuter, "coloring_outer");
+    outer.setCreateSparseJacobian(true);
+    outer.setCreateSparseHessian(true);
+    outer.setSparseJacobianColoring(true);
+    outer.setSparseHessianColoring(true);
+    outer.setMaxSourceGenerationJobs(4); // atomic functions require a single thread
+
+    ModelLibraryCSourceGen<double> libSourceGen(inner, outer);
+
+    GccCompiler<double> compiler;
+    prepareTestCompilerFlags(compiler);
+
+    DynamicModelLibraryProcessor<double> p(libSourceGen, "coloring_atomic_lib");
+    std::unique_ptr<DynamicLib<double>> dynamicLib = p.createDynamicLibrary(compiler);
+
+    std::unique_ptr<GenericModel<double>> innerModel = dynamicLib->model("coloring_banded");
+    std::unique_ptr<GenericModel<double>> outerModel = dynamicLib->model("coloring_outer");
+    ASSERT_TRUE(outerModel != nullptr);
+    outerModel->addExternalModel(*innerModel);
+
+    testModel(*outerModel);
+}
@@ -0,0 +1,227 @@
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2020 Joao Leal
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+#include "CppADCGTest.hpp"
+#include "gccCompilerFlags.hpp"
+
+namespace CppAD {
+namespace cg {
+
+class CppADCGSparseLayoutTest : public CppADCGTest {
+protected:
+    const static size_t n;
+    const static size_t m;
+    std::unique_ptr<ADFun<CGD>> _fun;
+    std::unique_ptr<DynamicLib<double>> _dynamicLib;
+    std::unique_ptr<GenericModel<double>> _model;
+    std::vector<double> _x;
+    std::vector<double> _w;
+public:
+
+    inline CppADCGSparseLayoutTest() :
+        _x{0.5, 0.8, 1.2},
+        _w{1.5, -0.7} {
+    }
+
+    void SetUp() override {
+        using ADCG = AD<CGD>;
+
+        std::vector<ADCG> u(n, 1.0);
+        CppAD::Independent(u);
+
+        std::vector<ADCG> y(m);
+        y[0] = cos(u[0]) * u[2];
+        y[1] = u[1] * u[2] + sin(u[0]);
+
+        _fun.reset(new ADFun<CGD>(u, y));
+    }
+
+    void TearDown() override {
+        _model.reset(nullptr);
+        _dynamicLib.reset(nullptr);
+        _fun.reset(nullptr);
+    }
+
+    void createModel(const std::string& libName,
+                     const std::function<void(ModelCSourceGen<double>&)>& configure = nullptr) {
+        ModelCSourceGen<double> compHelp(*_fun, "layout_model");
+        compHelp.setCreateSparseJacobian(true);
+        compHelp.setCreateSparseHessian(true);
+        if (configure)
+            configure(compHelp);
+
+        ModelLibraryCSourceGen<double> compDynHelp(compHelp);
+
+        GccCompiler<double> compiler;
+        prepareTestCompilerFlags(compiler);
+
+        DynamicModelLibraryProcessor<double> p(compDynHelp, libName);
+        _dynamicLib = p.createDynamicLibrary(compiler);
+        _model = _dynamicLib->model("layout_model");
+    }
+
+    /**
+     * Jacobian values using the row and column indexes of each element
+     */
+    std::vector<double> jacobian(const std::vector<size_t>& rows,
+                                 const std::vector<size_t>& cols) const {
+        std::vector<double> jac(m * n, 0.0);
+        jac[0 * n + 0] = -std::sin(_x[0]) * _x[2];
+        jac[0 * n + 2] = std::cos(_x[0]);
+        jac[1 * n + 0] = std::cos(_x[0]);
+        jac[1 * n + 1] = _x[2];
+        jac[1 * n + 2] = _x[1];
+
+        std::vector<double> values(rows.size());
+        for (size_t e = 0; e < rows.size(); ++e)
+            values[e] = jac[rows[e] * n + cols[e]];
+        return values;
+    }
+
+    /**
+     * Hessian values using the row and column indexes of each element
+     */
+    std::vector<double> hessian(const std::vector<size_t>& rows,
+                                const std::vector<size_t>& cols) const {
+        std::vector<double> hess(n * n, 0.0);
+        hess[0 * n + 0] = -_w[0] * std::cos(_x[0]) * _x[2] - _w[1] * std::sin(_x[0]);
+        hess[0 * n + 2] = hess[2 * n + 0] = -_w[0] * std::sin(_x[0]);
+        hess[1 * n + 2] = hess[2 * n + 1] = _w[1];
+
+        std::vector<double> values(rows.size());
+        for (size_t e = 0; e < rows.size(); ++e)
+            values[e] = hess[rows[e] * n + cols[e]];
+        return values;
+    }
+
+    void testJacobian(SparseFormat format,
+                      const std::vector<size_t>& ptr,
+                      const std::vector<size_t>& idx) {
+        _model->setSparseJacobianLayout(format, ptr, idx);
+        ASSERT_TRUE(_model->getSparseJacobianLayout() != nullptr);
+
+        std::vector<size_t> rows, cols;
+        SparseOutputLayout::toTriplets(format, ptr, idx, rows, cols);
+
+        std::vector<double> values(idx.size(), 99.0);
+        _model->SparseJacobianToLayout(_x, values);
+        ASSERT_TRUE(compareValues(values, jacobian(rows, cols)));
+    }
+
+    void testHessian(SparseFormat format,
+                     const std::vector<size_t>& ptr,
+                     const std::vector<size_t>& idx) {
+        _model->setSparseHessianLayout(format, ptr, idx);
+
+        std::vector<size_t> rows, cols;
+        SparseOutputLayout::toTriplets(format, ptr, idx, rows, cols);
+
+        std::vector<double> values(idx.size(), 99.0);
+        _model->SparseHessianToLayout(_x, _w, values);
+        ASSERT_TRUE(compareValues(values, hessian(rows, cols)));
+    }
+
+};
+
+const size_t CppADCGSparseLayoutTest::n = 3;
+const size_t CppADCGSparseLayoutTest::m = 2;
+
+} // END cg namespace
+} // END CppAD namespace
+
+using namespace CppAD;
+using namespace CppAD::cg;
+
+TEST_F(CppADCGSparseLayoutTest, SparseOutputLayout) {
+    std::vector<size_t> modelRows{0, 1, 1};
+    std::vector<size_t> modelCols{2, 0, 1};
+
+    // CSR with an additional element (0, 0)
+    std::vector<size_t> ptr{0, 2, 4};
+    std::vector<size_t> idx{0, 2, 0, 1};
+    SparseOutputLayout layout(modelRows, modelCols, SparseFormat::CSR, ptr, idx);
+    ASSERT_FALSE(layout.isIdentity());
+    ASSERT_EQ(layout.getModelSize(), 3u);
+    ASSERT_EQ(layout.getTargetSize(), 4u);
+
+    std::vector<double> values{1.0, 2.0, 3.0};
+    std::vector<double> target(4, 99.0);
+    layout.scatter(ArrayView<const double>(values), ArrayView<double>(target));
+    ASSERT_EQ(target, (std::vector<double>{0.0, 1.0, 2.0, 3.0}));
+
+    // same order
+    SparseOutputLayout identity(modelRows, modelCols, modelRows, modelCols);
+    ASSERT_TRUE(identity.isIdentity());
+
+    // symmetric
+    SparseOutputLayout upper(std::vector<size_t>{2}, std::vector<size_t>{0},
+                             std::vector<size_t>{0}, std::vector<size_t>{2}, true);
+    ASSERT_EQ(upper.getTargetSize(), 1u);
+
+    // missing element
+    std::vector<size_t> ptr2{0, 1, 3};
+    std::vector<size_t> idx2{0, 0, 1};
+    ASSERT_THROW(SparseOutputLayout(modelRows, modelCols, SparseFormat::CSR, ptr2, idx2), CGException);
+
+    // invalid structure
+    std::vector<size_t> ptr3{0, 3, 2};
+    ASSERT_THROW(SparseOutputLayout(modelRows, modelCols, SparseFormat::CSR, ptr3, idx2), CGException);
+}
+
+TEST_F(CppADCGSparseLayoutTest, SparseLayoutPermutation) {
+    createModel("layout_lib");
+
+    std::vector<double> values(5);
+    ASSERT_THROW(_model->SparseJacobianToLayout(_x, values), CGException);
+
+    // CSR with an additional element (0, 1)
+    testJacobian(SparseFormat::CSR, {0, 3, 6}, {0, 1, 2, 0, 1, 2});
+
+    // CSC
+    testJacobian(SparseFormat::CSC, {0, 2, 3, 5}, {0, 1, 1, 0, 1});
+    ASSERT_FALSE(_model->getSparseJacobianLayout()->isIdentity());
+
+    // missing element (1, 1)
+    std::vector<size_t> ptr{0, 2, 2, 4};
+    std::vector<size_t> idx{0, 1, 0, 1};
+    ASSERT_THROW(_model->setSparseJacobianLayout(SparseFormat::CSC, ptr, idx), CGException);
+
+    // upper triangle (CSR) with an additional diagonal element (1, 1)
+    testHessian(SparseFormat::CSR, {0, 2, 4, 4}, {0, 2, 1, 2});
+
+    // lower triangle (CSC)
+    testHessian(SparseFormat::CSC, {0, 2, 3, 3}, {0, 2, 2});
+
+    // both triangles (CSR)
+    testHessian(SparseFormat::CSR, {0, 2, 3, 5}, {0, 2, 2, 0, 1});
+}
+
+TEST_F(CppADCGSparseLayoutTest, SparseLayoutGenerated) {
+    std::vector<size_t> jacPtr{0, 2, 3, 5};
+    std::vector<size_t> jacIdx{0, 1, 1, 0, 1};
+    std::vector<size_t> hessPtr{0, 2, 3, 3};
+    std::vector<size_t> hessIdx{0, 2, 2};
+
+    createModel("layout_lib_csc", [&](ModelCSourceGen<double>& compHelp) {
+        compHelp.setCustomSparseJacobianElements(SparseFormat::CSC, jacPtr, jacIdx);
+        compHelp.setCustomSparseHessianElements(SparseFormat::CSC, hessPtr, hessIdx);
+    });
+
+    // the library already provides the values in the order of the caller
+    testJacobian(SparseFormat::CSC, jacPtr, jacIdx);
+    ASSERT_TRUE(_model->getSparseJacobianLayout()->isIdentity());
+
+    testHessian(SparseFormat::CSC, hessPtr, hessIdx);
+    ASSERT_TRUE(_model->getSparseHessianLayout()->isIdentity());
+}
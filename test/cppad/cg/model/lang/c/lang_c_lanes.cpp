@@ -0,0 +1,146 @@
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2020 Joao Leal
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+#include <dlfcn.h>
+
+#include "CppADCGTest.hpp"
+#include "gccCompilerFlags.hpp"
+
+namespace CppAD {
+namespace cg {
+
+class CppADCGTestLangCLanes : public CppADCGTest {
+protected:
+    using Base = double;
+    using CGD = CppAD::cg::CG<Base>;
+    using ADCG = CppAD::AD<CGD>;
+    using LaneFunction = void (*)(Base const* const*, Base* const*, LangCAtomicFun);
+    static const size_t n = 3;
+    static const size_t m = 4;
+    static const size_t lanes = 4;
+public:
+
+    void testLanes(size_t maxAssignPerFunction,
+                   const std::string& library) {
+        // points (one lane vector per variable)
+        std::vector<Base> x(n * lanes);
+        for (size_t l = 0; l < lanes; ++l) {
+            x[0 * lanes + l] = -1.0 + 0.7 * l;
+            x[1 * lanes + l] = 0.5 + 0.25 * l;
+            x[2 * lanes + l] = 2.0 - 0.9 * l;
+        }
+
+        /**
+         * generate the source code
+         */
+        std::vector<ADCG> u(n, 1.0);
+        CppAD::Independent(u);
+        std::vector<ADCG> y = model(u);
+        ADFun<CGD> fun(u, y);
+
+        CodeHandler<Base> handler;
+        std::vector<CGD> indVars(n);
+        handler.makeVariables(indVars);
+
+        std::vector<CGD> vals = fun.Forward(0, indVars);
+
+        LanguageCLanes<Base> langC("double", lanes);
+        ASSERT_EQ(langC.getLaneTypeName(), "cppadcg_double4");
+        LangCDefaultVariableNameGenerator<Base> nameGen;
+
+        std::map<std::string, std::string> sources;
+        langC.setMaxAssignmentsPerFunction(maxAssignPerFunction, &sources);
+        langC.setGenerateFunction("lanes_model");
+
+        std::ostringstream code;
+        handler.generateCode(code, langC, vals, nameGen);
+
+        if (this->verbose_) {
+            for (const auto& it : sources) {
+                std::cout << "\n" << it.first << ":\n" << it.second << std::endl;
+            }
+        }
+
+        /**
+         * compile and evaluate
+         */
+        GccCompiler<Base> compiler;
+        prepareTestCompilerFlags(compiler);
+        compiler.compileSources(sources, true);
+        compiler.buildDynamic(library);
+        compiler.cleanup();
+
+        void* libHandle = dlopen(library.c_str(), RTLD_NOW);
+        ASSERT_TRUE(libHandle != nullptr);
+
+        auto f = reinterpret_cast<LaneFunction>(dlsym(libHandle, "lanes_model"));
+        ASSERT_TRUE(f != nullptr);
+
+        std::vector<Base> yLanes(m * lanes);
+        const Base* in[1] = {x.data()};
+        Base* out[1] = {yLanes.data()};
+        (*f)(in, out, LangCAtomicFun{nullptr, nullptr, nullptr});
+
+        dlclose(libHandle);
+
+        /**
+         * compare with the evaluation of each point
+         */
+        std::vector<AD<Base>> ux(n);
+        CppAD::Independent(ux);
+        std::vector<AD<Base>> uy = model(ux);
+        ADFun<Base> funD(ux, uy);
+
+        for (size_t l = 0; l < lanes; ++l) {
+            std::vector<Base> xp(n), yExpected;
+            for (size_t j = 0; j < n; ++j)
+                xp[j] = x[j * lanes + l];
+            yExpected = funD.Forward(0, xp);
+
+            std::vector<Base> yp(m);
+            for (size_t i = 0; i < m; ++i)
+                yp[i] = yLanes[i * lanes + l];
+
+            ASSERT_TRUE(compareValues(yp, yExpected));
+        }
+    }
+
+protected:
+
+    template<class T>
+    static std::vector<T> model(const std::vector<T>& x) {
+        std::vector<T> y(m);
+        T a = sin(x[0]) * x[1] + exp(x[2]) / 2.0;
+        y[0] = CondExpLt(x[0], T(0.0), a * x[1], cos(a));
+        y[1] = CondExpGe(x[2], x[1], sqrt(abs(x[0])), pow(x[1], x[2]));
+        y[2] = sign(x[0]) * tanh(a) - 3.0;
+        y[3] = 5.0;
+        return y;
+    }
+
+};
+
+} // END cg namespace
+} // END CppAD namespace
+
+using namespace CppAD;
+using namespace CppAD::cg;
+
+TEST_F(CppADCGTestLangCLanes, SingleFunction) {
+    testLanes(0, "./liblanes_single.so");
+}
+
+TEST_F(CppADCGTestLangCLanes, MultipleFunctions) {
+    testLanes(2, "./liblanes_multiple.so");
+}
@@ -127,6 +127,33 @@ TEST_F(CppADCGThreadPoolStaticTest, Hessian) {
 namespace CppAD {
 namespace cg {
 
+class CppADCGThreadPoolWorkStealingTest : public ThreadPoolTest {
+public:
+    explicit CppADCGThreadPoolWorkStealingTest() :
+            ThreadPoolTest(MultiThreadingType::PTHREADS) {
+        this->_multithreadDisabled = false;
+        this->_multithreadScheduler = ThreadPoolScheduleStrategy::WORK_STEALING;
+    }
+};
+
+} // END cg namespace
+} // END CppAD namespace
+
+TEST_F(CppADCGThreadPoolWorkStealingTest, ForwardZero) {
+    this->testForwardZero();
+}
+
+TEST_F(CppADCGThreadPoolWorkStealingTest, Jacobian) {
+    this->testJacobian();
+}
+
+TEST_F(CppADCGThreadPoolWorkStealingTest, Hessian) {
+    this->testHessian();
+}
+
+namespace CppAD {
+namespace cg {
+
 class CppADCGThreadPoolDynamicCustomTest : public ThreadPoolTest {
 public:
     explicit CppADCGThreadPoolDynamicCustomTest() :
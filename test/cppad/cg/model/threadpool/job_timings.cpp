@@ -0,0 +1,170 @@
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2020 Joao Leal
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+#include "CppADCGTest.hpp"
+#include "gccCompilerFlags.hpp"
+
+using namespace CppAD;
+using namespace CppAD::cg;
+
+namespace {
+
+/**
+ * Provides access to the generated model sources
+ */
+class SourcesProcessor : public ModelLibraryProcessor<double> {
+public:
+    inline explicit SourcesProcessor(ModelLibraryCSourceGen<double>& libSourceGen) :
+        ModelLibraryProcessor<double>(libSourceGen) {
+    }
+
+    inline std::map<std::string, std::string> sources(ModelCSourceGen<double>& model) {
+        return getSources(model);
+    }
+};
+
+/**
+ * Determines the number of jobs of a function using the pthread pool
+ * from its source code
+ */
+size_t countJobs(const std::string& source) {
+    const std::string key = "job_start[";
+    size_t p = source.find(key);
+    if (p == std::string::npos)
+        return 0;
+    p += key.size();
+    return std::stoul(source.substr(p, source.find(']', p) - p)) - 1;
+}
+
+class CppADCGJobTimingsTest : public CppADCGTest {
+protected:
+    using ADCG = AD<CGD>;
+    const size_t n = 6;
+    const size_t m = 6;
+    std::unique_ptr<ADFun<CGD>> _fun;
+    std::unique_ptr<ADFun<double>> _funD;
+    std::vector<double> _x;
+    std::vector<double> _w;
+public:
+
+    template<class T>
+    std::vector<T> model(const std::vector<T>& x) const {
+        std::vector<T> y(m);
+        for (size_t i = 0; i < m; ++i) {
+            y[i] = cos(x[i]) * x[(i + 1) % n];
+        }
+        // a more expensive row
+        for (size_t j = 0; j < n; ++j) {
+            y[0] += exp(x[j]) * sin(x[j] * x[0]);
+        }
+        return y;
+    }
+
+    void SetUp() override {
+        std::vector<ADCG> u(n, 1.0);
+        CppAD::Independent(u);
+        std::vector<ADCG> y = model(u);
+        _fun.reset(new ADFun<CGD>(u, y));
+
+        std::vector<AD<double>> ud(n, 1.0);
+        CppAD::Independent(ud);
+        std::vector<AD<double>> yd = model(ud);
+        _funD.reset(new ADFun<double>(ud, yd));
+
+        _x.resize(n);
+        for (size_t j = 0; j < n; ++j)
+            _x[j] = 0.5 + 0.1 * j;
+        _w.assign(m, 1.0);
+    }
+
+    std::unique_ptr<DynamicLib<double>> createLibrary(const std::string& libName,
+                                                      const std::map<size_t, float>& jacTimings,
+                                                      const std::map<size_t, float>& hessTimings,
+                                                      size_t& nJacJobs) {
+        ModelCSourceGen<double> compHelp(*_fun, "timings_model");
+        compHelp.setCreateSparseJacobian(true);
+        compHelp.setCreateSparseHessian(true);
+        compHelp.setCreateReverseOne(true);
+        compHelp.setCreateReverseTwo(true);
+        compHelp.setMultiThreading(true);
+        compHelp.setSparseJacobianJobTimings(jacTimings);
+        compHelp.setSparseHessianJobTimings(hessTimings);
+
+        ModelLibraryCSourceGen<double> compDynHelp(compHelp);
+        compDynHelp.setMultiThreading(MultiThreadingType::PTHREADS);
+
+        GccCompiler<double> compiler;
+        prepareTestCompilerFlags(compiler);
+        compiler.addCompileFlag("-pthread");
+
+        DynamicModelLibraryProcessor<double> p(compDynHelp, libName);
+        std::unique_ptr<DynamicLib<double>> lib = p.createDynamicLibrary(compiler);
+
+        std::map<std::string, std::string> sources = SourcesProcessor(compDynHelp).sources(compHelp);
+        nJacJobs = countJobs(sources["timings_model_" + ModelCSourceGen<double>::FUNCTION_SPARSE_JACOBIAN + ".c"]);
+
+        lib->setThreadNumber(2);
+        lib->setThreadPoolNumberOfTimeMeas(3);
+        return lib;
+    }
+
+    void evaluate(GenericModel<double>& model,
+                  size_t nEval) {
+        std::vector<double> jac, hess;
+        std::vector<size_t> row, col;
+        for (size_t k = 0; k < nEval; ++k) {
+            model.SparseJacobian(_x, jac, row, col);
+            model.SparseHessian(_x, _w, hess, row, col);
+        }
+
+        ASSERT_TRUE(compareValues(model.SparseJacobian(_x), _funD->Jacobian(_x)));
+        ASSERT_TRUE(compareValues(model.SparseHessian(_x, _w), _funD->Hessian(_x, _w)));
+    }
+};
+
+} // END namespace
+
+TEST_F(CppADCGJobTimingsTest, ProfileGuidedGeneration) {
+    std::map<size_t, float> jacTimings, hessTimings;
+    size_t nJacJobs1, nJacJobs2;
+    {
+        std::unique_ptr<DynamicLib<double>> lib = createLibrary("job_timings_1", jacTimings, hessTimings, nJacJobs1);
+        std::unique_ptr<FunctorGenericModel<double>> model = lib->modelFunctor("timings_model");
+
+        ASSERT_TRUE(model->getSparseJacobianJobTimings().empty()); // nothing measured yet
+
+        evaluate(*model, 5);
+
+        jacTimings = model->getSparseJacobianJobTimings();
+        hessTimings = model->getSparseHessianJobTimings();
+    }
+    ASSERT_EQ(jacTimings.size(), m); // one job per row/column
+    ASSERT_EQ(nJacJobs1, m);
+    ASSERT_FALSE(hessTimings.empty());
+
+    // make the first row dominant so that the other rows are grouped
+    jacTimings[0] = 1;
+    for (size_t i = 1; i < m; ++i)
+        jacTimings[i] = 0.25;
+
+    std::unique_ptr<DynamicLib<double>> lib = createLibrary("job_timings_2", jacTimings, hessTimings, nJacJobs2);
+    ASSERT_GT(nJacJobs2, 0u);
+    ASSERT_LT(nJacJobs2, nJacJobs1);
+
+    std::unique_ptr<FunctorGenericModel<double>> model = lib->modelFunctor("timings_model");
+    evaluate(*model, 5);
+
+    std::map<size_t, float> jacTimings2 = model->getSparseJacobianJobTimings();
+    ASSERT_EQ(jacTimings2.size(), m);
+}
@@ -241,6 +241,16 @@ TEST_F(PThreadPoolTest, GuidedJac) {
     ASSERT_TRUE(compareValues(jac, out0));
 }
 
+TEST_F(PThreadPoolTest, WorkStealingJac) {
+    cppadcg_thpool_set_scheduler_strategy(SCHED_WORK_STEALING);
+
+    pooldynamic_sparse_jacobian(in.data(), out.data(), atomicFun); // no elapsed time measurements
+
+    pooldynamic_sparse_jacobian(in.data(), out.data(), atomicFun); // placement using the elapsed times
+
+    ASSERT_TRUE(compareValues(jac, out0));
+}
+
 TEST_F(PThreadPoolTest, StaticJac) {
     cppadcg_thpool_set_scheduler_strategy(SCHED_STATIC);
 
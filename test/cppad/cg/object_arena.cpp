@@ -0,0 +1,79 @@
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2019 Joao Leal
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+#include "CppADCGTest.hpp"
+
+using namespace CppAD;
+using namespace CppAD::cg;
+
+TEST_F(CppADCGTest, ObjectArena) {
+    ObjectArena<std::string> arena(4, 16);
+
+    std::vector<std::string*> objs;
+    for (size_t i = 0; i < 100; ++i) {
+        objs.push_back(new(arena.allocate()) std::string(std::to_string(i)));
+    }
+
+    ASSERT_EQ(arena.size(), 100u);
+    ASSERT_EQ(arena.getChunkCount(), 8u); // 4 + 8 + 16 * 6
+
+    std::string other("other");
+    ASSERT_FALSE(arena.owns(&other));
+    for (size_t i = 0; i < objs.size(); ++i) {
+        ASSERT_TRUE(arena.owns(objs[i]));
+        ASSERT_EQ(*objs[i], std::to_string(i));
+    }
+
+    // released memory is reused
+    std::string* s = objs[50];
+    s->~basic_string();
+    arena.deallocate(s);
+    ASSERT_EQ(arena.size(), 99u);
+
+    objs[50] = new(arena.allocate()) std::string("new");
+    ASSERT_EQ(objs[50], s);
+    ASSERT_EQ(arena.getChunkCount(), 8u);
+
+    for (std::string* o : objs) {
+        o->~basic_string();
+        arena.deallocate(o);
+    }
+    ASSERT_EQ(arena.size(), 0u);
+
+    arena.clear();
+    ASSERT_EQ(arena.getChunkCount(), 0u);
+}
+
+TEST_F(CppADCGTest, CodeHandlerNodeArena) {
+    CodeHandler<double> handler(10);
+
+    std::vector<CGD> x(2);
+    handler.makeVariables(x);
+
+    size_t start = handler.getManagedNodesCount();
+
+    CGD y = x[0];
+    for (size_t i = 0; i < 1000; ++i) {
+        y = y * x[1] + 1.0;
+    }
+    ASSERT_EQ(handler.getManagedNodesCount(), start + 2000);
+
+    y = CGD(); // do not keep references to the nodes which will be deleted
+    handler.deleteManagedNodes(start, handler.getManagedNodesCount());
+    ASSERT_EQ(handler.getManagedNodesCount(), start);
+
+    // new nodes are placed after the remaining ones
+    CGD z = sin(x[0]);
+    ASSERT_EQ(z.getOperationNode()->getHandlerPosition(), start);
+}
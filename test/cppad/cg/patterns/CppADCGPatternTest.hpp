@@ -41,6 +41,8 @@ protected:
     Base hessianEpsilonR_;
     std::vector<std::set<size_t> > customJacSparsity_;
     std::vector<std::set<size_t> > customHessSparsity_;
+    size_t maxPatternThreads_;
+    bool loopVectorization_;
 private:
     std::unique_ptr<DefaultPatternTestModel<CG<Base> > > modelMem_;
 public:
@@ -54,7 +56,9 @@ public:
         epsilonA_(std::numeric_limits<Base>::epsilon() * 1e2),
         epsilonR_(std::numeric_limits<Base>::epsilon() * 1e2),
         hessianEpsilonA_(std::numeric_limits<Base>::epsilon() * 1e2),
-        hessianEpsilonR_(std::numeric_limits<Base>::epsilon() * 1e2) {
+        hessianEpsilonR_(std::numeric_limits<Base>::epsilon() * 1e2),
+        maxPatternThreads_(1),
+        loopVectorization_(false) {
         //this->verbose_ = true;
     }
 
@@ -255,6 +259,7 @@ public:
         std::vector<CGD> yy = fun.Forward(0, xx);
 
         DependentPatternMatcher<double> matcher(depCandidates, yy, xx);
+        matcher.setMaxThreads(maxPatternThreads_);
 
         LoopFreeModel<Base>* nonLoopTape;
         SmartSetPointer<LoopModel<Base> > loopTapes;
@@ -397,6 +402,7 @@ public:
         compHelpL.setRelatedDependents(relatedDepCandidates);
         compHelpL.setTypicalIndependentValues(xTypical);
         compHelpL.setParameterPrecision(std::numeric_limits<Base>::digits10 + 4);
+        compHelpL.setLoopVectorization(loopVectorization_);
 
         if (!customJacSparsity_.empty())
             compHelpL.setCustomSparseJacobianElements(customJacSparsity_);
@@ -253,6 +253,66 @@ TEST_F(CppADCGPatternTest, CommonTmp3) {
     testLibCreation("modelCommonTmp3", m, n, 6);
 }
 
+TEST_F(CppADCGPatternTest, CommonTmp3Vectorized) {
+    size_t m = 3;
+    size_t n = 3;
+
+    setModel(modelCommonTmp3);
+    loopVectorization_ = true;
+
+    // temporaries inside the loop become local to each iteration
+    testLibCreation("modelCommonTmp3Vec", m, n, 6);
+}
+
+TEST_F(CppADCGPatternTest, CommonTmp3Threads) {
+    size_t m = 3;
+    size_t n = 3;
+    size_t repeat = 6;
+
+    setModel(modelCommonTmp3);
+    maxPatternThreads_ = 3;
+
+    size_t nonIndexed = 1; // expected non-indexed variables (outside the loop)
+
+    std::vector<std::vector<std::set<size_t> > > loops(1);
+    testPatternDetection(m, n, repeat, loops, nonIndexed);
+
+    // a single group with different expression patterns
+    std::vector<std::set<size_t> > depCandidates(1);
+    for (size_t i = 0; i < m * repeat; i++)
+        depCandidates[0].insert(i);
+
+    std::vector<Base> xb(n * repeat, 0.5);
+    testPatternDetection(xb, repeat, depCandidates, loops, nonIndexed);
+}
+
+TEST_F(CppADCGPatternTest, DetectRelatedDependents) {
+    size_t m = 3;
+    size_t n = 3;
+    size_t repeat = 6;
+
+    setModel(modelCommonTmp3);
+
+    std::vector<Base> xb(n * repeat, 0.5);
+    std::unique_ptr<ADFun<CGD> > fun(tapeModel(repeat, xb));
+
+    CodeHandler<double> h;
+    std::vector<CGD> xx(xb.size());
+    h.makeVariables(xx);
+    std::vector<CGD> yy = fun->Forward(0, xx);
+
+    std::vector<std::set<size_t> > depCandidates = DependentPatternMatcher<double>::findRelatedDependentCandidates(yy);
+    ASSERT_EQ(depCandidates, createRelatedDepCandidates(m, repeat));
+
+    // groups must have a minimum size
+    ASSERT_TRUE(DependentPatternMatcher<double>::findRelatedDependentCandidates(yy, repeat + 1).empty());
+
+    size_t nonIndexed = 1; // expected non-indexed variables (outside the loop)
+
+    std::vector<std::vector<std::set<size_t> > > loops(1);
+    testPatternDetection(xb, repeat, depCandidates, loops, nonIndexed);
+}
+
 /**
  * @test All variables are indexed but keep the same index after a given
  *       iteration
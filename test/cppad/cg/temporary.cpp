@@ -59,6 +59,24 @@ public:
 using namespace CppAD;
 using namespace CppAD::cg;
 
+namespace {
+
+/**
+ * Provides access to the generated model sources
+ */
+class SourcesProcessor : public ModelLibraryProcessor<double> {
+public:
+    inline explicit SourcesProcessor(ModelLibraryCSourceGen<double>& libSourceGen) :
+        ModelLibraryProcessor<double>(libSourceGen) {
+    }
+
+    inline std::map<std::string, std::string> sources(ModelCSourceGen<double>& model) {
+        return getSources(model);
+    }
+};
+
+} // END namespace
+
 TEST_F(CppADCGTempTest, NoTemporary) {
     size_t n = 3;
     size_t m = 2;
@@ -148,3 +166,72 @@ TEST_F(CppADCGTempTest, Temporary3) {
     ADFun<CGD> f(ind, dep);
     testModel(f, 1, 0);
 }
+
+TEST_F(CppADCGTempTest, MinimizeLiveTemporaries) {
+    auto generate = [](bool minimize) {
+        CodeHandler<double> handler;
+        handler.setMinimizeLiveTemporaries(minimize);
+        EXPECT_EQ(handler.isMinimizeLiveTemporaries(), minimize);
+
+        std::vector<CGD> x(2);
+        handler.makeVariables(x);
+
+        // left is evaluated first in the original order and it is kept
+        // while the variables required by right are determined
+        CGD left = sin(x[0]);
+        CGD r1 = cos(x[1]);
+        CGD r2 = exp(x[1]);
+        CGD right = r1 * r1 + r2 * r2;
+
+        std::vector<CGD> y(1);
+        y[0] = left * left + right * right;
+
+        LanguageC<double> langC("double");
+        LangCDefaultVariableNameGenerator<double> nameGen;
+
+        std::ostringstream code;
+        handler.generateCode(code, langC, y, nameGen);
+
+        return handler.getTemporaryVariableCount();
+    };
+
+    ASSERT_EQ(generate(false), 3u);
+    ASSERT_EQ(generate(true), 2u);
+}
+
+TEST_F(CppADCGTempTest, MinimizeLiveTemporariesModel) {
+    std::vector<ADCGD> u(2, 1.0);
+    CppAD::Independent(u);
+
+    ADCGD left = sin(u[0]);
+    ADCGD r1 = cos(u[1]);
+    ADCGD r2 = exp(u[1]);
+    ADCGD right = r1 * r1 + r2 * r2;
+
+    std::vector<ADCGD> v(1);
+    v[0] = left * left + right * right;
+
+    ADFun<CGD> fun(u, v);
+
+    // the size of the array with the temporary variables of forward zero
+    auto generate = [&fun](bool minimize) -> size_t {
+        ModelCSourceGen<double> sourceGen(fun, "live_model");
+        sourceGen.setMinimizeLiveTemporaries(minimize);
+        ModelLibraryCSourceGen<double> libSourceGen(sourceGen);
+
+        std::map<std::string, std::string> sources = SourcesProcessor(libSourceGen).sources(sourceGen);
+        const std::string& code = sources["live_model_" + ModelCSourceGen<double>::FUNCTION_FORWAD_ZERO + ".c"];
+
+        const std::string dcl = "double v[";
+        size_t p = code.find(dcl);
+        if (p == std::string::npos)
+            return 0;
+        p += dcl.size();
+        return std::stoul(code.substr(p, code.find(']', p) - p));
+    };
+
+    size_t tmpDefault = generate(false);
+    size_t tmpMinimized = generate(true);
+    ASSERT_GT(tmpMinimized, 0u);
+    ASSERT_LT(tmpMinimized, tmpDefault);
+}